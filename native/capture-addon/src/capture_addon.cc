@@ -0,0 +1,3065 @@
+#include <node_api.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+#include "capture_backend.h"
+#include "cursor_sprite.h"
+#include "frame_delta.h"
+#include "frame_pacer.h"
+#include "frame_pipe.h"
+#include "frame_pipeline.h"
+#include "frame_pool.h"
+#include "frame_queue.h"
+#include "frame_ring.h"
+#include "hdr_source.h"
+#include "replay_source.h"
+#include "stage_stats.h"
+#include "synthetic_source.h"
+#include "thread_pool.h"
+#include "tile_change.h"
+#include "tone_map.h"
+#include "tone_map_fixed.h"
+#include "triple_buffer.h"
+
+namespace {
+
+using capture_addon::kBackendName;
+using pixel_pipeline::ToneMapConfig;
+
+constexpr int64_t kMaxCapturePixels = 3840LL * 2160LL;
+constexpr size_t kMaxFrameBytes = static_cast<size_t>(kMaxCapturePixels * 4LL);
+constexpr int64_t kDefaultMaxOutputPixels = 640LL * 360LL;
+constexpr int32_t kDefaultFramePoolDepth = 4;
+constexpr int32_t kMinFramePoolDepth = 2;
+constexpr int32_t kMaxFramePoolDepth = 16;
+constexpr double kDefaultTargetFps = 60.0;
+// Every Nth frame also splits the fused process stage into scale, tonemap and
+// convert; the extra clock reads per row stay off the other frames.
+constexpr uint32_t kStageSampleInterval = 16;
+constexpr double kMaxTargetFps = 240.0;
+constexpr int32_t kMaxFrameQueueDepth = 16;
+constexpr int32_t kMaxProcessThreads = pixel_pipeline::ThreadPool::kMaxWorkers + 1;
+constexpr int32_t kAutoProcessThreadsCap = 8;
+constexpr int32_t kDefaultViewportMargin = 64;
+constexpr size_t kMaxOutputLevels = 8;
+// Brightest value of the synthetic HDR ramps, in scRGB units (8.0 = 640 nits).
+constexpr float kSyntheticHdrPeak = 8.0f;
+
+bool IsCoverageTestFlagEnabled(const char* name) {
+  const char* value = std::getenv(name);
+  if (!value) {
+    return false;
+  }
+  return value[0] == '1';
+}
+
+napi_value MakeObject(napi_env env) {
+  napi_value out;
+  assert(napi_create_object(env, &out) == napi_ok);
+  return out;
+}
+
+napi_value MakeString(napi_env env, const char* value) {
+  napi_value out;
+  assert(napi_create_string_utf8(env, value, NAPI_AUTO_LENGTH, &out) == napi_ok);
+  return out;
+}
+
+napi_value MakeString(napi_env env, const std::string& value) {
+  napi_value out;
+  assert(napi_create_string_utf8(env, value.c_str(), NAPI_AUTO_LENGTH, &out) == napi_ok);
+  return out;
+}
+
+napi_value MakeBool(napi_env env, bool value) {
+  napi_value out;
+  assert(napi_get_boolean(env, value, &out) == napi_ok);
+  return out;
+}
+
+napi_value MakeInt32(napi_env env, int32_t value) {
+  napi_value out;
+  assert(napi_create_int32(env, value, &out) == napi_ok);
+  return out;
+}
+
+napi_value MakeDouble(napi_env env, double value) {
+  napi_value out;
+  assert(napi_create_double(env, value, &out) == napi_ok);
+  return out;
+}
+
+void SetNamed(napi_env env, napi_value obj, const char* key, napi_value value) {
+  assert(napi_set_named_property(env, obj, key, value) == napi_ok);
+}
+
+napi_value GetFirstArg(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1] = {nullptr};
+  assert(napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr) == napi_ok);
+  if (argc < 1 || argv[0] == nullptr) {
+    return nullptr;
+  }
+  napi_valuetype type = napi_undefined;
+  assert(napi_typeof(env, argv[0], &type) == napi_ok);
+  if (type != napi_object) {
+    return nullptr;
+  }
+  return argv[0];
+}
+
+bool GetNamedProperty(napi_env env, napi_value obj, const char* key, napi_value* out) {
+  if (obj == nullptr) {
+    return false;
+  }
+  bool has = false;
+  if (napi_has_named_property(env, obj, key, &has) != napi_ok || !has) {
+    return false;
+  }
+  return napi_get_named_property(env, obj, key, out) == napi_ok;
+}
+
+bool GetNamedBool(napi_env env, napi_value obj, const char* key, bool fallback = false) {
+  napi_value value;
+  if (!GetNamedProperty(env, obj, key, &value)) {
+    return fallback;
+  }
+  bool out = fallback;
+  if (napi_get_value_bool(env, value, &out) != napi_ok) {
+    return fallback;
+  }
+  return out;
+}
+
+double GetNamedNumber(napi_env env, napi_value obj, const char* key, double fallback = 0.0) {
+  napi_value value;
+  if (!GetNamedProperty(env, obj, key, &value)) {
+    return fallback;
+  }
+  double out = fallback;
+  if (napi_get_value_double(env, value, &out) != napi_ok) {
+    return fallback;
+  }
+  return out;
+}
+
+int32_t GetNamedInt32(napi_env env, napi_value obj, const char* key, int32_t fallback = 0) {
+  napi_value value;
+  if (!GetNamedProperty(env, obj, key, &value)) {
+    return fallback;
+  }
+  int32_t out = fallback;
+  if (napi_get_value_int32(env, value, &out) != napi_ok) {
+    return fallback;
+  }
+  return out;
+}
+
+bool GetStringValue(napi_env env, napi_value value, std::string* out) {
+  size_t length = 0;
+  if (napi_get_value_string_utf8(env, value, nullptr, 0, &length) != napi_ok) {
+    return false;
+  }
+  std::string text(length, '\0');
+  if (napi_get_value_string_utf8(env, value, &text[0], length + 1, &length) != napi_ok) {
+    return false;
+  }
+  text.resize(length);
+  *out = std::move(text);
+  return true;
+}
+
+std::string GetNamedString(napi_env env, napi_value obj, const char* key, const std::string& fallback = "") {
+  napi_value value;
+  std::string out;
+  if (!GetNamedProperty(env, obj, key, &value) || !GetStringValue(env, value, &out)) {
+    return fallback;
+  }
+  return out;
+}
+
+// Where a session's frames come from. `desktop` is GDI capture (Windows
+// only); `synthetic` and `replay` feed the same pipeline on every platform.
+enum class CaptureBackend {
+  kDesktop = 0,
+  kSynthetic,
+  kReplay,
+};
+
+const char* CaptureBackendName(CaptureBackend backend) {
+  switch (backend) {
+    case CaptureBackend::kSynthetic:
+      return "synthetic";
+    case CaptureBackend::kReplay:
+      return "replay";
+    case CaptureBackend::kDesktop:
+    default:
+      return "desktop";
+  }
+}
+
+// Test flag: makes `synthetic` the default backend, so payloads written for
+// desktop capture run unchanged on Linux CI.
+bool IsSyntheticSourceEnabled() {
+  return IsCoverageTestFlagEnabled("CURSORCINE_NATIVE_TEST_SYNTHETIC_SOURCE");
+}
+
+bool IsDesktopCaptureAvailable() {
+#if defined(_WIN32)
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool IsCaptureAvailable() {
+  return IsDesktopCaptureAvailable() || IsSyntheticSourceEnabled();
+}
+
+struct CaptureRect {
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t width = 0;
+  int32_t height = 0;
+};
+
+// outputs: one pyramid level below the main output, an RGBA8 frame reduced
+// from the level above it.
+struct OutputLevel {
+  int32_t width = 0;
+  int32_t height = 0;
+  int32_t stride = 0;
+  // 2x reductions from the level above: 1 unless this level's maxPixels
+  // skips sizes, in which case the ones in between go through levelScratch.
+  int32_t steps = 1;
+};
+
+struct CaptureSession {
+  int32_t sessionId = 0;
+  bool hdrLikely = false;
+  CaptureRect rect;
+  // setViewport: the part of `rect` (in its own pixels) frames are captured
+  // from and scaled to the fixed output size; all of it by default. A new
+  // region is only queued in `pendingViewport` and applied when the next
+  // frame starts, so a continuous session's capture thread never sees it
+  // change mid-frame.
+  CaptureRect viewport;
+  std::mutex viewportMutex;
+  bool viewportPending = false;  // guarded by viewportMutex
+  CaptureRect pendingViewport;   // guarded by viewportMutex
+  ToneMapConfig toneMap;
+  pixel_pipeline::ScalerMode scaler = pixel_pipeline::ScalerMode::kNearest;
+  pixel_pipeline::YuvRange yuvRange = pixel_pipeline::YuvRange::kLimited;
+  // Output frames are laid out as pipeline.output (RGBA8, NV12 or I420).
+  pixel_pipeline::FramePipeline pipeline;
+  // Threads (caller included) that share one frame's processing in row
+  // bands; helpers come from the process-wide pool.
+  int32_t threads = 1;
+  CaptureBackend backend = CaptureBackend::kDesktop;
+  // synthetic/replay: the surface each frame is rendered or read into, in
+  // `sourceFormat`.
+  std::vector<uint8_t> sourceSurface;
+  // rgba16f/rgb10a2 sources are tone-mapped with `sourceToneMap` into
+  // `decodedSurface` (BGRA8) first; the pipeline then only swizzles.
+  pixel_pipeline::SourceFormat sourceFormat = pixel_pipeline::SourceFormat::kBgra8;
+  pixel_pipeline::ToneMapParams sourceToneMap;
+  std::vector<uint8_t> decodedSurface;
+  uint32_t syntheticFrame = 0;
+  std::unique_ptr<pixel_pipeline::ReplaySource> replay;
+#if defined(_WIN32)
+  HDC desktopDc = nullptr;
+  HDC captureDc = nullptr;
+  HBITMAP bitmap = nullptr;
+  HGDIOBJ oldBitmap = nullptr;
+  void* bitmapBits = nullptr;
+#endif
+  int32_t outputWidth = 0;
+  int32_t outputHeight = 0;
+  int32_t outputStride = 0;
+  std::shared_ptr<pixel_pipeline::FramePool> framePool;
+  // outputs: the levels below the main output, largest first, each with its
+  // own pool of the same depth.
+  std::vector<OutputLevel> levels;
+  std::vector<std::shared_ptr<pixel_pipeline::FramePool>> levelPools;
+  std::vector<uint8_t> levelScratch;
+  // Wall-clock time the last frame's capture started.
+  double captureTimestampMs = 0.0;
+  double captureMs = 0.0;
+  double processMs = 0.0;
+  // Desktop only: finding the cursor (and drawing it, when GDI has to),
+  // part of captureMs.
+  double cursorMs = 0.0;
+  // Desktop only: cursor shapes seen so far, already at output scale, and
+  // where this frame's cursor lands. The fused pass blends it after scaling;
+  // a null sprite means no cursor or one GDI already drew into the capture.
+  pixel_pipeline::CursorSpriteCache cursorSprites;
+  pixel_pipeline::CursorOverlay cursor;
+  // changeDetection: `tiles` hashes each source frame and only the output
+  // under changed tiles (and the old and new cursor) is reprocessed into
+  // `tileOutput`, which then becomes the frame. `dirtyRects`/`unchanged`
+  // describe the last frame against the one before it.
+  std::unique_ptr<pixel_pipeline::TileChangeTracker> tiles;
+  std::vector<uint8_t> tileOutput;
+  pixel_pipeline::CursorOverlay tileCursor;
+  std::vector<pixel_pipeline::DirtyRect> dirtyRects;
+  bool unchanged = false;
+  // Per-stage histograms for getStats; a frame whose stages add up to more
+  // than frameBudgetMs (one frame interval at targetFps) counts as over budget.
+  pixel_pipeline::StageStats stats;
+  double frameBudgetMs = 0.0;
+  uint32_t stageSample = 0;
+  // Held by JS-facing calls that capture into or read out of this session,
+  // so one session's slow frame never blocks another session.
+  std::mutex captureMutex;
+  // continuous: a native thread paced by `pacer` captures into `frames`
+  // (dropPolicy latest-only) or `queue` (queue-N) and readLatest consumes
+  // from it; the pull reads are refused.
+  bool continuous = false;
+  double targetFps = 0.0;
+  std::unique_ptr<pixel_pipeline::FramePacer> pacer;
+  std::unique_ptr<pixel_pipeline::TripleBuffer> frames;
+  std::unique_ptr<pixel_pipeline::FrameQueue> queue;
+  // sharedRing: the capture thread renders into named shared memory instead,
+  // for readers in other processes (openFrameRing); readLatest reads it back
+  // through `ringReader`. The read position is guarded by captureMutex.
+  std::unique_ptr<pixel_pipeline::FrameRingWriter> ring;
+  std::unique_ptr<pixel_pipeline::FrameRingReader> ringReader;
+  uint64_t ringReadSequence = 0;
+  uint64_t ringDropped = 0;
+  // encoderPipe: the capture thread renders each frame into a slab of
+  // `encoder`, whose writer thread streams it to an encoder's stdin (or a
+  // pipe one reads). It copies the frame into the channel above only for a
+  // shared ring or once readLatest attached a reader.
+  std::unique_ptr<pixel_pipeline::FramePipe> encoder;
+  std::atomic<bool> latestReaderAttached{false};
+  int32_t encoderCloseTimeoutMs = pixel_pipeline::kFramePipeDefaultCloseTimeoutMs;
+  std::thread captureThread;
+  std::mutex captureThreadMutex;
+  std::condition_variable captureThreadWake;
+  bool captureThreadStop = false;  // guarded by captureThreadMutex
+  std::atomic<uint64_t> captureFailures{0};
+
+  ~CaptureSession() {
+    StopCaptureThread();
+#if defined(_WIN32)
+    if (captureDc && oldBitmap) {
+      SelectObject(captureDc, oldBitmap);
+      oldBitmap = nullptr;
+    }
+    if (bitmap) {
+      DeleteObject(bitmap);
+      bitmap = nullptr;
+    }
+    if (captureDc) {
+      DeleteDC(captureDc);
+      captureDc = nullptr;
+    }
+    if (desktopDc) {
+      ReleaseDC(nullptr, desktopDc);
+      desktopDc = nullptr;
+    }
+#endif
+  }
+
+  void StopCaptureThread() {
+    if (!captureThread.joinable()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(captureThreadMutex);
+      captureThreadStop = true;
+    }
+    captureThreadWake.notify_all();
+    // A capture thread held by encoder backpressure is released by closing
+    // the pipe, which writes out what is already queued first.
+    if (encoder) {
+      encoder->Close(encoderCloseTimeoutMs);
+    }
+    captureThread.join();
+  }
+};
+
+// Only guards the map itself (lookup/insert/erase). Callers keep the session
+// alive through their shared_ptr, so a session erased by stopCapture is
+// destroyed when its last in-flight read lets go of it.
+std::mutex g_sessionsMutex;
+std::unordered_map<int32_t, std::shared_ptr<CaptureSession>> g_sessions;
+int32_t g_nextSessionId = 1;
+
+std::shared_ptr<CaptureSession> FindSession(int32_t sessionId) {
+  std::lock_guard<std::mutex> lock(g_sessionsMutex);
+  const auto it = g_sessions.find(sessionId);
+  return it == g_sessions.end() ? nullptr : it->second;
+}
+
+// Off Windows only synthetic/replay sessions exist, so the per-session entry
+// points answer NOT_WINDOWS unless `sessionId` names one of them.
+bool IsSessionReachable(int32_t sessionId) {
+  return IsCaptureAvailable() || (sessionId > 0 && FindSession(sessionId) != nullptr);
+}
+
+CaptureRect GetDefaultVirtualScreenRect() {
+  CaptureRect rect;
+#if defined(_WIN32)
+  rect.x = GetSystemMetrics(SM_XVIRTUALSCREEN);
+  rect.y = GetSystemMetrics(SM_YVIRTUALSCREEN);
+  rect.width = GetSystemMetrics(SM_CXVIRTUALSCREEN);
+  rect.height = GetSystemMetrics(SM_CYVIRTUALSCREEN);
+  if (rect.width <= 0 || rect.height <= 0) {
+    rect.x = 0;
+    rect.y = 0;
+    rect.width = std::max(1, GetSystemMetrics(SM_CXSCREEN));
+    rect.height = std::max(1, GetSystemMetrics(SM_CYSCREEN));
+  }
+#else
+  rect.width = 1920;
+  rect.height = 1080;
+#endif
+  return rect;
+}
+
+CaptureRect ResolveCaptureRect(napi_env env, napi_value payload) {
+  CaptureRect rect = GetDefaultVirtualScreenRect();
+  napi_value displayHint;
+  if (!GetNamedProperty(env, payload, "displayHint", &displayHint)) {
+    return rect;
+  }
+  napi_value bounds;
+  if (!GetNamedProperty(env, displayHint, "bounds", &bounds)) {
+    return rect;
+  }
+
+  int32_t x = GetNamedInt32(env, bounds, "x", rect.x);
+  int32_t y = GetNamedInt32(env, bounds, "y", rect.y);
+  int32_t width = GetNamedInt32(env, bounds, "width", rect.width);
+  int32_t height = GetNamedInt32(env, bounds, "height", rect.height);
+
+  const double scaleFactor = GetNamedNumber(env, displayHint, "scaleFactor", 1.0);
+  if (scaleFactor > 1.01 && width > 0 && height > 0) {
+    const int32_t sx = static_cast<int32_t>(std::llround(static_cast<double>(x) * scaleFactor));
+    const int32_t sy = static_cast<int32_t>(std::llround(static_cast<double>(y) * scaleFactor));
+    const int32_t sw = static_cast<int32_t>(std::llround(static_cast<double>(width) * scaleFactor));
+    const int32_t sh = static_cast<int32_t>(std::llround(static_cast<double>(height) * scaleFactor));
+    const CaptureRect vr = GetDefaultVirtualScreenRect();
+    if (sw > 0 && sh > 0 && sw <= (vr.width + 8) && sh <= (vr.height + 8)) {
+      x = sx;
+      y = sy;
+      width = sw;
+      height = sh;
+    }
+  }
+  if (width > 0 && height > 0) {
+    rect.x = x;
+    rect.y = y;
+    rect.width = width;
+    rect.height = height;
+  }
+
+  return rect;
+}
+
+bool ResolveHdrLikely(napi_env env, napi_value payload) {
+  napi_value displayHint;
+  if (!GetNamedProperty(env, payload, "displayHint", &displayHint)) {
+    return false;
+  }
+  return GetNamedBool(env, displayHint, "isHdrLikely", false);
+}
+
+ToneMapConfig ResolveToneMap(napi_env env, napi_value payload) {
+  ToneMapConfig cfg;
+  napi_value toneMap;
+  if (!GetNamedProperty(env, payload, "toneMap", &toneMap)) {
+    return cfg;
+  }
+
+  const double rolloff = GetNamedNumber(env, toneMap, "rolloff", cfg.rolloff);
+  const double saturation = GetNamedNumber(env, toneMap, "saturation", cfg.saturation);
+  cfg.rolloff = static_cast<float>(std::min(1.0, std::max(0.0, rolloff)));
+  cfg.saturation = static_cast<float>(std::min(2.0, std::max(0.0, saturation)));
+  // Unknown profiles keep rec709-rolloff-v1, the only curve older callers know.
+  pixel_pipeline::ParseToneMapProfile(
+      GetNamedString(env, toneMap, "profile", pixel_pipeline::ToneMapProfileName(cfg.profile)), &cfg.profile);
+  // Unknown names keep float arithmetic.
+  pixel_pipeline::ParseToneMapArithmetic(
+      GetNamedString(env, toneMap, "arithmetic", pixel_pipeline::ToneMapArithmeticName(cfg.arithmetic)),
+      &cfg.arithmetic);
+  const double masteringPeakNits = GetNamedNumber(env, toneMap, "masteringPeakNits", cfg.masteringPeakNits);
+  const double targetNits = GetNamedNumber(env, toneMap, "targetNits", cfg.targetNits);
+  cfg.masteringPeakNits = static_cast<float>(std::min(10000.0, std::max(100.0, masteringPeakNits)));
+  cfg.targetNits = static_cast<float>(std::min(10000.0, std::max(48.0, targetNits)));
+  return cfg;
+}
+
+// Unknown names keep the point sampler so older callers behave as before.
+pixel_pipeline::ScalerMode ResolveScaler(napi_env env, napi_value payload) {
+  pixel_pipeline::ScalerMode mode = pixel_pipeline::ScalerMode::kNearest;
+  pixel_pipeline::ParseScalerMode(GetNamedString(env, payload, "scaler", "nearest"), &mode);
+  return mode;
+}
+
+pixel_pipeline::PixelFormat ResolveOutputFormat(napi_env env, napi_value payload) {
+  pixel_pipeline::PixelFormat format = pixel_pipeline::PixelFormat::kRgba8;
+  pixel_pipeline::ParsePixelFormat(GetNamedString(env, payload, "outputFormat", "RGBA8"), &format);
+  return format;
+}
+
+// Unlike the output options an unknown name fails the start: guessing the
+// layout of someone else's pixels would only produce garbage frames.
+bool ResolveSourceFormat(napi_env env, napi_value payload, pixel_pipeline::SourceFormat* out) {
+  return pixel_pipeline::ParseSourceFormat(GetNamedString(env, payload, "sourceFormat", "bgra8"), out);
+}
+
+pixel_pipeline::YuvRange ResolveYuvRange(napi_env env, napi_value payload) {
+  pixel_pipeline::YuvRange range = pixel_pipeline::YuvRange::kLimited;
+  pixel_pipeline::ParseYuvRange(GetNamedString(env, payload, "yuvRange", "limited"), &range);
+  return range;
+}
+
+int64_t ClampMaxOutputPixels(double requested) {
+  if (!std::isfinite(requested) || requested <= 0) {
+    return kDefaultMaxOutputPixels;
+  }
+  const int64_t clamped = static_cast<int64_t>(requested);
+  return std::min(kMaxCapturePixels, std::max<int64_t>(kDefaultMaxOutputPixels, clamped));
+}
+
+int64_t ResolveMaxOutputPixels(napi_env env, napi_value payload) {
+  return ClampMaxOutputPixels(
+      GetNamedNumber(env, payload, "maxOutputPixels", static_cast<double>(kDefaultMaxOutputPixels)));
+}
+
+// outputs: [{ maxPixels }, ...] asks for a frame pyramid. The budgets are
+// sorted largest first; the first sizes the main output (in place of
+// maxOutputPixels) and each further one a level below it. Absent leaves
+// `budgets` empty; a malformed list fails the start.
+bool ResolveOutputBudgets(napi_env env, napi_value payload, std::vector<int64_t>* budgets, std::string* errorMessage) {
+  budgets->clear();
+  napi_value outputs;
+  if (!GetNamedProperty(env, payload, "outputs", &outputs)) {
+    return true;
+  }
+  bool isArray = false;
+  uint32_t count = 0;
+  if (napi_is_array(env, outputs, &isArray) != napi_ok || !isArray ||
+      napi_get_array_length(env, outputs, &count) != napi_ok || count == 0 || count > kMaxOutputLevels) {
+    if (errorMessage) {
+      *errorMessage = "outputs must list 1 to " + std::to_string(kMaxOutputLevels) + " { maxPixels } entries.";
+    }
+    return false;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    napi_value entry = nullptr;
+    assert(napi_get_element(env, outputs, i, &entry) == napi_ok);
+    const double maxPixels = GetNamedNumber(env, entry, "maxPixels", 0.0);
+    if (!std::isfinite(maxPixels) || maxPixels < 1.0) {
+      if (errorMessage) {
+        *errorMessage = "outputs[" + std::to_string(i) + "].maxPixels must be a positive number.";
+      }
+      return false;
+    }
+    budgets->push_back(static_cast<int64_t>(std::min(maxPixels, static_cast<double>(kMaxCapturePixels))));
+  }
+  std::sort(budgets->begin(), budgets->end(), std::greater<int64_t>());
+  return true;
+}
+
+int32_t ResolveFramePoolDepth(napi_env env, napi_value payload) {
+  const int32_t requested = GetNamedInt32(env, payload, "framePoolDepth", kDefaultFramePoolDepth);
+  return std::min(kMaxFramePoolDepth, std::max(kMinFramePoolDepth, requested));
+}
+
+double ResolveTargetFps(napi_env env, napi_value payload) {
+  const double fallback = GetNamedNumber(env, payload, "maxFps", kDefaultTargetFps);
+  const double requested = GetNamedNumber(env, payload, "targetFps", fallback);
+  if (!std::isfinite(requested) || requested <= 0.0) {
+    return kDefaultTargetFps;
+  }
+  return std::min(kMaxTargetFps, std::max(1.0, requested));
+}
+
+// threads: 1 (default) processes on the calling thread, 0 picks one per core
+// up to kAutoProcessThreadsCap.
+int32_t ResolveProcessThreads(napi_env env, napi_value payload) {
+  int32_t requested = GetNamedInt32(env, payload, "threads", 1);
+  if (requested == 0) {
+    requested = std::min(kAutoProcessThreadsCap, static_cast<int32_t>(std::thread::hardware_concurrency()));
+  }
+  return std::min(kMaxProcessThreads, std::max(1, requested));
+}
+
+// dropPolicy: `latest-only` (default) keeps only the newest frame; `queue-N`
+// keeps up to N (1..16) frames in order and drops the oldest when full.
+// Returns the queue depth, 0 for latest-only; unknown names fall back to it.
+int32_t ResolveFrameQueueDepth(napi_env env, napi_value payload) {
+  const std::string policy = GetNamedString(env, payload, "dropPolicy", "latest-only");
+  if (policy.rfind("queue-", 0) != 0) {
+    return 0;
+  }
+  const int32_t depth = std::atoi(policy.c_str() + 6);
+  return depth > 0 ? std::min(kMaxFrameQueueDepth, depth) : 0;
+}
+
+// changeDetection: true uses kDefaultChangeTileSize tiles, { tileSize }
+// picks the tile edge (clamped to 16..256). Returns 0 when it is off.
+int32_t ResolveChangeTileSize(napi_env env, napi_value payload) {
+  napi_value value;
+  if (!GetNamedProperty(env, payload, "changeDetection", &value)) {
+    return 0;
+  }
+  napi_valuetype type = napi_undefined;
+  assert(napi_typeof(env, value, &type) == napi_ok);
+  if (type == napi_object) {
+    const int32_t requested = GetNamedInt32(env, value, "tileSize", pixel_pipeline::kDefaultChangeTileSize);
+    return std::min(pixel_pipeline::kMaxChangeTileSize, std::max(pixel_pipeline::kMinChangeTileSize, requested));
+  }
+  return GetNamedBool(env, payload, "changeDetection", false) ? pixel_pipeline::kDefaultChangeTileSize : 0;
+}
+
+double WallClockMs() {
+  return static_cast<double>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+#if defined(_WIN32)
+// Fallback for cursors whose bitmaps cannot be read: drawn into the capture at
+// source resolution and scaled with the rest of the frame.
+void DrawCursorWithGdi(CaptureSession* session, HCURSOR cursor, int32_t x, int32_t y) {
+  ICONINFO iconInfo;
+  std::memset(&iconInfo, 0, sizeof(iconInfo));
+  if (!GetIconInfo(cursor, &iconInfo)) {
+    return;
+  }
+  DrawIconEx(session->captureDc,
+             x - static_cast<int32_t>(iconInfo.xHotspot),
+             y - static_cast<int32_t>(iconInfo.yHotspot),
+             cursor,
+             0,
+             0,
+             0,
+             nullptr,
+             DI_NORMAL | DI_DEFAULTSIZE);
+  if (iconInfo.hbmMask) {
+    DeleteObject(iconInfo.hbmMask);
+  }
+  if (iconInfo.hbmColor) {
+    DeleteObject(iconInfo.hbmColor);
+  }
+}
+
+// Reads `bitmap` as `lines` top-down rows of `bitCount`-bit DIB pixels.
+bool ReadCursorBitmap(HDC dc,
+                      HBITMAP bitmap,
+                      int32_t width,
+                      int32_t lines,
+                      int32_t bitCount,
+                      std::vector<uint8_t>* out) {
+  struct {
+    BITMAPINFOHEADER header;
+    RGBQUAD colors[2];
+  } info;
+  std::memset(&info, 0, sizeof(info));
+  info.header.biSize = sizeof(BITMAPINFOHEADER);
+  info.header.biWidth = width;
+  info.header.biHeight = -lines;
+  info.header.biPlanes = 1;
+  info.header.biBitCount = static_cast<WORD>(bitCount);
+  info.header.biCompression = BI_RGB;
+  const size_t stride = static_cast<size_t>((width * bitCount + 31) / 32) * 4;
+  out->assign(stride * static_cast<size_t>(lines), 0);
+  return GetDIBits(dc,
+                   bitmap,
+                   0,
+                   static_cast<UINT>(lines),
+                   out->data(),
+                   reinterpret_cast<BITMAPINFO*>(&info),
+                   DIB_RGB_COLORS) == lines;
+}
+
+// The cursor's mask/colour bitmaps as a premultiplied sprite at the session's
+// output scale. Runs once per cursor shape; the result is cached by handle.
+bool LoadCursorSprite(CaptureSession* session, HCURSOR cursor, pixel_pipeline::CursorSprite* sprite) {
+  ICONINFO iconInfo;
+  std::memset(&iconInfo, 0, sizeof(iconInfo));
+  if (!GetIconInfo(cursor, &iconInfo)) {
+    return false;
+  }
+  bool ok = false;
+  BITMAP mask;
+  std::memset(&mask, 0, sizeof(mask));
+  if (iconInfo.hbmMask && GetObject(iconInfo.hbmMask, sizeof(mask), &mask) != 0 && mask.bmWidth > 0) {
+    const int32_t width = static_cast<int32_t>(mask.bmWidth);
+    const int32_t maskLines = static_cast<int32_t>(mask.bmHeight);
+    // Monochrome cursors stack the AND and XOR masks in one bitmap.
+    const int32_t height = iconInfo.hbmColor ? maskLines : maskLines / 2;
+    const int32_t maskStride = (width + 31) / 32 * 4;
+    std::vector<uint8_t> maskBits;
+    pixel_pipeline::CursorSprite full;
+    if (height > 0 && ReadCursorBitmap(session->desktopDc, iconInfo.hbmMask, width, maskLines, 1, &maskBits)) {
+      if (iconInfo.hbmColor) {
+        std::vector<uint8_t> colorBits;
+        ok = ReadCursorBitmap(session->desktopDc, iconInfo.hbmColor, width, height, 32, &colorBits) &&
+            pixel_pipeline::BuildColorCursorSprite(colorBits.data(),
+                                                   width,
+                                                   height,
+                                                   width * 4,
+                                                   maskBits.data(),
+                                                   maskStride,
+                                                   static_cast<int32_t>(iconInfo.xHotspot),
+                                                   static_cast<int32_t>(iconInfo.yHotspot),
+                                                   &full);
+      } else {
+        ok = pixel_pipeline::BuildMonochromeCursorSprite(maskBits.data(),
+                                                         maskBits.data() + static_cast<size_t>(maskStride) * height,
+                                                         width,
+                                                         height,
+                                                         maskStride,
+                                                         static_cast<int32_t>(iconInfo.xHotspot),
+                                                         static_cast<int32_t>(iconInfo.yHotspot),
+                                                         &full);
+      }
+    }
+    if (ok) {
+      pixel_pipeline::ScaleCursorSprite(full,
+                                        static_cast<double>(session->outputWidth) / session->viewport.width,
+                                        static_cast<double>(session->outputHeight) / session->viewport.height,
+                                        sprite);
+    }
+  }
+  if (iconInfo.hbmMask) {
+    DeleteObject(iconInfo.hbmMask);
+  }
+  if (iconInfo.hbmColor) {
+    DeleteObject(iconInfo.hbmColor);
+  }
+  return ok;
+}
+
+bool CaptureDesktop(CaptureSession* session) {
+  if (!session->desktopDc || !session->captureDc || !session->bitmapBits) {
+    return false;
+  }
+  // Only the viewport is copied, to the top-left of the DIB.
+  const CaptureRect& viewport = session->viewport;
+  if (!BitBlt(session->captureDc,
+              0,
+              0,
+              viewport.width,
+              viewport.height,
+              session->desktopDc,
+              session->rect.x + viewport.x,
+              session->rect.y + viewport.y,
+              SRCCOPY | CAPTUREBLT)) {
+    return false;
+  }
+
+  // Composite current system cursor so native path matches desktop capture
+  // behavior (cursor included in recorded frame). Known shapes come from the
+  // sprite cache and are blended at output scale by the pixel pipeline.
+  const auto cursorStart = std::chrono::steady_clock::now();
+  session->cursor = pixel_pipeline::CursorOverlay();
+  CURSORINFO cursorInfo;
+  std::memset(&cursorInfo, 0, sizeof(cursorInfo));
+  cursorInfo.cbSize = sizeof(cursorInfo);
+  if (GetCursorInfo(&cursorInfo) && (cursorInfo.flags & CURSOR_SHOWING) && cursorInfo.hCursor) {
+    const uint64_t key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(cursorInfo.hCursor));
+    const pixel_pipeline::CursorSprite* sprite = session->cursorSprites.Find(key);
+    if (!sprite) {
+      pixel_pipeline::CursorSprite loaded;
+      if (LoadCursorSprite(session, cursorInfo.hCursor, &loaded)) {
+        sprite = session->cursorSprites.Insert(key, std::move(loaded));
+      }
+    }
+    const int32_t cursorX = static_cast<int32_t>(cursorInfo.ptScreenPos.x) - session->rect.x - viewport.x;
+    const int32_t cursorY = static_cast<int32_t>(cursorInfo.ptScreenPos.y) - session->rect.y - viewport.y;
+    if (sprite) {
+      const double scaleX = static_cast<double>(session->outputWidth) / viewport.width;
+      const double scaleY = static_cast<double>(session->outputHeight) / viewport.height;
+      session->cursor = pixel_pipeline::PlaceCursorOverlay(sprite, cursorX, cursorY, scaleX, scaleY);
+    } else {
+      DrawCursorWithGdi(session, cursorInfo.hCursor, cursorX, cursorY);
+    }
+  }
+  session->cursorMs = ElapsedMs(cursorStart);
+  return true;
+}
+#endif
+
+bool IsWholeCapture(const CaptureRect& viewport, const CaptureRect& rect) {
+  return viewport.x == 0 && viewport.y == 0 && viewport.width == rect.width && viewport.height == rect.height;
+}
+
+// Switches to the viewport setViewport queued, if it differs: the scale plan
+// is rebuilt for the new source size, cached cursor sprites (scaled for the
+// old one) are dropped and change detection starts over with a full frame.
+void ApplyPendingViewport(CaptureSession* session) {
+  CaptureRect next;
+  {
+    std::lock_guard<std::mutex> lock(session->viewportMutex);
+    if (!session->viewportPending) {
+      return;
+    }
+    session->viewportPending = false;
+    next = session->pendingViewport;
+  }
+  const CaptureRect& current = session->viewport;
+  if (next.x == current.x && next.y == current.y && next.width == current.width && next.height == current.height) {
+    return;
+  }
+  session->viewport = next;
+  pixel_pipeline::BuildScalePlan(next.width,
+                                 next.height,
+                                 session->outputWidth,
+                                 session->outputHeight,
+                                 &session->pipeline.scale,
+                                 session->scaler);
+  session->cursorSprites.Clear();
+  if (session->tiles) {
+    session->tiles =
+        std::make_unique<pixel_pipeline::TileChangeTracker>(next.width, next.height, session->tiles->tileSize());
+    session->tileCursor = pixel_pipeline::CursorOverlay();
+  }
+}
+
+double NsToMs(int64_t ns) {
+  return static_cast<double>(ns) / 1e6;
+}
+
+// changeDetection's process stage: hashes `surface`, reprocesses the output
+// rects its changed tiles map to (plus wherever the cursor was or is) into
+// session->tileOutput, and copies that out to `output`. The first frame is
+// processed in full. Pooled and caller buffers do not reliably hold the
+// previous frame, so the copy-out is always the whole frame. `timings`, when
+// set, covers only the pixels that were reprocessed.
+void ProcessChangedTiles(CaptureSession* session,
+                         const uint8_t* surface,
+                         uint8_t* output,
+                         int32_t outputStride,
+                         pixel_pipeline::ProcessTimings* timings) {
+  pixel_pipeline::ThreadPool* pool = pixel_pipeline::ThreadPool::Shared();
+  const pixel_pipeline::FramePipeline& pipeline = session->pipeline;
+  const pixel_pipeline::CursorOverlay* cursor = session->cursor.sprite ? &session->cursor : nullptr;
+  const int32_t srcStride = session->rect.width * 4;
+  const int32_t changed = session->tiles->Update(surface, srcStride, pool, session->threads);
+  std::vector<pixel_pipeline::DirtyRect>& rects = session->dirtyRects;
+  if (changed == session->tiles->tilesX() * session->tiles->tilesY()) {
+    pixel_pipeline::ProcessFrameParallel(surface,
+                                         srcStride,
+                                         session->tileOutput.data(),
+                                         session->outputStride,
+                                         pipeline,
+                                         pool,
+                                         session->threads,
+                                         cursor,
+                                         timings);
+    rects.assign(1, pixel_pipeline::DirtyRect{0, 0, session->outputWidth, session->outputHeight});
+  } else {
+    session->tiles->ChangedRects(&rects);
+    for (pixel_pipeline::DirtyRect& rect : rects) {
+      rect = pixel_pipeline::MapSourceRectToOutput(pipeline, rect);
+    }
+    const bool cursorMoved = session->tileCursor.sprite != session->cursor.sprite ||
+                             session->tileCursor.x != session->cursor.x || session->tileCursor.y != session->cursor.y;
+    if (cursorMoved && session->tileCursor.sprite) {
+      rects.push_back(pixel_pipeline::CursorOutputRect(pipeline, session->tileCursor));
+    }
+    if (cursorMoved && cursor) {
+      rects.push_back(pixel_pipeline::CursorOutputRect(pipeline, *cursor));
+    }
+    pixel_pipeline::NormalizeOutputRects(pipeline, &rects);
+    pixel_pipeline::ProcessFrameRects(surface,
+                                      srcStride,
+                                      session->tileOutput.data(),
+                                      session->outputStride,
+                                      pipeline,
+                                      rects,
+                                      pool,
+                                      session->threads,
+                                      cursor,
+                                      timings);
+  }
+  session->tileCursor = session->cursor;
+  session->unchanged = rects.empty();
+
+  if (outputStride == session->outputStride) {
+    std::memcpy(output, session->tileOutput.data(), session->tileOutput.size());
+  } else {
+    const size_t rowBytes = static_cast<size_t>(session->outputWidth) * 4;
+    for (int32_t y = 0; y < session->outputHeight; ++y) {
+      std::memcpy(output + static_cast<size_t>(y) * static_cast<size_t>(outputStride),
+                  session->tileOutput.data() + static_cast<size_t>(y) * static_cast<size_t>(session->outputStride),
+                  rowBytes);
+    }
+  }
+}
+
+// Fills every outputs level from the finished main output, each one reduced
+// from the level above it so the frame is read once per level, not rescaled
+// from the capture.
+void ReduceOutputLevels(CaptureSession* session,
+                        const uint8_t* output,
+                        int32_t outputStride,
+                        uint8_t* const* levelOutputs) {
+  const uint8_t* above = output;
+  int32_t width = session->outputWidth;
+  int32_t height = session->outputHeight;
+  int32_t stride = outputStride;
+  for (size_t i = 0; i < session->levels.size(); ++i) {
+    const OutputLevel& level = session->levels[i];
+    uint8_t* scratch = session->levelScratch.data();
+    for (int32_t step = 1; step <= level.steps; ++step) {
+      const bool last = step == level.steps;
+      uint8_t* dst = last ? levelOutputs[i] : scratch;
+      const int32_t dstStride = last ? level.stride : (width / 2) * 4;
+      pixel_pipeline::ReduceRgbaHalf(
+          above, stride, width, height, dst, dstStride, pixel_pipeline::ThreadPool::Shared(), session->threads);
+      above = dst;
+      width /= 2;
+      height /= 2;
+      stride = dstStride;
+      if (!last) {
+        scratch += static_cast<size_t>(dstStride) * static_cast<size_t>(height);
+      }
+    }
+  }
+}
+
+// CaptureFrame's work, with each stage's duration written to `stages`.
+// Non-null `levelOutputs` (one per session level) also get the outputs
+// pyramid, timed as part of kProcess.
+bool CaptureFrameStages(CaptureSession* session,
+                        uint8_t* output,
+                        int32_t outputStride,
+                        uint8_t* const* levelOutputs,
+                        pixel_pipeline::StageStats::Frame* stages) {
+  if (IsCoverageTestFlagEnabled("CURSORCINE_NATIVE_TEST_FORCE_READ_FAIL")) {
+    return false;
+  }
+  if (!output || session->rect.width <= 0 || session->rect.height <= 0) {
+    return false;
+  }
+  ApplyPendingViewport(session);
+  // Every source below keeps rect.width-pixel rows; the viewport is a window
+  // into them.
+  const CaptureRect& viewport = session->viewport;
+  const size_t viewportOffset =
+      (static_cast<size_t>(viewport.y) * static_cast<size_t>(session->rect.width) + static_cast<size_t>(viewport.x)) *
+      static_cast<size_t>(pixel_pipeline::SourceBytesPerPixel(session->sourceFormat));
+
+  const auto captureStart = std::chrono::steady_clock::now();
+  session->captureTimestampMs = WallClockMs();
+  const uint8_t* surface = nullptr;
+  switch (session->backend) {
+    case CaptureBackend::kSynthetic:
+      if (session->sourceFormat == pixel_pipeline::SourceFormat::kBgra8) {
+        pixel_pipeline::RenderSyntheticFrame(session->sourceSurface.data(),
+                                             session->rect.width,
+                                             session->rect.height,
+                                             session->rect.width * 4,
+                                             session->syntheticFrame++);
+      } else {
+        pixel_pipeline::RenderSyntheticHdrFrame(
+            session->sourceFormat,
+            session->sourceSurface.data(),
+            session->rect.width,
+            session->rect.height,
+            session->rect.width * pixel_pipeline::SourceBytesPerPixel(session->sourceFormat),
+            session->syntheticFrame++,
+            kSyntheticHdrPeak);
+      }
+      surface = session->sourceSurface.data() + viewportOffset;
+      break;
+    case CaptureBackend::kReplay:
+      if (!session->replay || !session->replay->ReadNext(session->sourceSurface.data())) {
+        return false;
+      }
+      surface = session->sourceSurface.data() + viewportOffset;
+      break;
+    case CaptureBackend::kDesktop:
+#if defined(_WIN32)
+      if (!CaptureDesktop(session)) {
+        return false;
+      }
+      surface = reinterpret_cast<const uint8_t*>(session->bitmapBits);
+      break;
+#else
+      return false;
+#endif
+  }
+  session->captureMs = ElapsedMs(captureStart);
+  if (session->backend == CaptureBackend::kDesktop) {
+    stages->Set(pixel_pipeline::CaptureStage::kCursor, session->cursorMs);
+    stages->Set(pixel_pipeline::CaptureStage::kCapture, session->captureMs - session->cursorMs);
+  } else {
+    stages->Set(pixel_pipeline::CaptureStage::kCapture, session->captureMs);
+  }
+
+  const size_t captureBytes =
+      static_cast<size_t>(session->rect.width) * static_cast<size_t>(session->rect.height) * 4;
+  if (captureBytes == 0 || captureBytes > kMaxFrameBytes) {
+    return false;
+  }
+
+  // Single pass from the DIB to finished RGBA: sample (or pass through at 1:1),
+  // tone-map and swizzle each row while it is still in cache; YUV outputs
+  // convert each row pair right after. Multi-threaded
+  // sessions split the output rows into bands across the shared pool.
+  const auto processStart = std::chrono::steady_clock::now();
+  if (session->sourceFormat != pixel_pipeline::SourceFormat::kBgra8) {
+    pixel_pipeline::DecodeHdrSurface(
+        surface,
+        session->rect.width * pixel_pipeline::SourceBytesPerPixel(session->sourceFormat),
+        session->sourceFormat,
+        viewport.width,
+        viewport.height,
+        session->sourceToneMap,
+        session->decodedSurface.data(),
+        session->rect.width * 4,
+        pixel_pipeline::ThreadPool::Shared(),
+        session->threads);
+    surface = session->decodedSurface.data();
+    stages->Set(pixel_pipeline::CaptureStage::kDecode, ElapsedMs(processStart));
+  }
+  const auto pipelineStart = std::chrono::steady_clock::now();
+  const bool sampled = session->stageSample++ % kStageSampleInterval == 0;
+  pixel_pipeline::ProcessTimings timings;
+  if (session->tiles) {
+    ProcessChangedTiles(session, surface, output, outputStride, sampled ? &timings : nullptr);
+  } else {
+    pixel_pipeline::ProcessFrameParallel(surface,
+                                         session->rect.width * 4,
+                                         output,
+                                         outputStride,
+                                         session->pipeline,
+                                         pixel_pipeline::ThreadPool::Shared(),
+                                         session->threads,
+                                         session->cursor.sprite ? &session->cursor : nullptr,
+                                         sampled ? &timings : nullptr);
+  }
+  if (levelOutputs) {
+    ReduceOutputLevels(session, output, outputStride, levelOutputs);
+  }
+  stages->Set(pixel_pipeline::CaptureStage::kProcess, ElapsedMs(pipelineStart));
+  session->processMs = ElapsedMs(processStart);
+  // A tile session frame with nothing changed ran none of these stages.
+  if (sampled && !(session->tiles && session->unchanged)) {
+    stages->Set(pixel_pipeline::CaptureStage::kScale, NsToMs(timings.scaleNs.load()));
+    stages->Set(pixel_pipeline::CaptureStage::kToneMap, NsToMs(timings.toneMapNs.load()));
+    if (session->pipeline.output.format != pixel_pipeline::PixelFormat::kRgba8) {
+      stages->Set(pixel_pipeline::CaptureStage::kConvert, NsToMs(timings.convertNs.load()));
+    }
+  }
+  return true;
+}
+
+// Captures into `output`: outputHeight rows of outputWidth RGBA pixels,
+// `outputStride` bytes apart, or the packed planes of pipeline.output for
+// NV12/I420; `levelOutputs` as for CaptureFrameStages. Every attempt lands
+// in the session's stage stats.
+bool CaptureFrame(CaptureSession* session,
+                  uint8_t* output,
+                  int32_t outputStride,
+                  uint8_t* const* levelOutputs = nullptr) {
+  if (!session) {
+    return false;
+  }
+  pixel_pipeline::StageStats::Frame stages;
+  if (!CaptureFrameStages(session, output, outputStride, levelOutputs, &stages)) {
+    session->stats.RecordFailure();
+    return false;
+  }
+  session->stats.RecordFrame(stages, session->frameBudgetMs);
+  return true;
+}
+
+// Whether an encoder frame is copied into `channel`: a shared ring's readers
+// are in other processes, readLatest's channels wait for its first call.
+bool ChannelHasReader(CaptureSession* /*session*/, pixel_pipeline::FrameRingWriter* /*ring*/) {
+  return true;
+}
+
+template <typename Channel>
+bool ChannelHasReader(CaptureSession* session, Channel* /*channel*/) {
+  return session->latestReaderAttached.load(std::memory_order_acquire);
+}
+
+template <typename Channel>
+void CaptureInto(CaptureSession* session, Channel* channel) {
+  // With an encoder pipe the frame is rendered into its slab and the writer
+  // thread sends it from there; no slab (a dropped or failed encoder frame)
+  // renders into the channel as usual.
+  std::unique_ptr<pixel_pipeline::FrameLease> encoded = session->encoder ? session->encoder->AcquireFrame() : nullptr;
+  uint8_t* output = encoded ? encoded->data() : channel->WriteSlot();
+  if (!CaptureFrame(session, output, session->outputStride)) {
+    session->captureFailures.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (encoded) {
+    const bool publish = ChannelHasReader(session, channel);
+    if (publish) {
+      std::memcpy(channel->WriteSlot(), encoded->data(), encoded->size());
+    }
+    session->encoder->Submit(std::move(encoded));
+    if (!publish) {
+      return;
+    }
+  }
+  pixel_pipeline::TripleBufferMeta* meta = channel->WriteMeta();
+  meta->timestampMs = session->captureTimestampMs;
+  meta->captureMs = session->captureMs;
+  meta->processMs = session->processMs;
+  const bool whole = IsWholeCapture(session->viewport, session->rect);
+  meta->sourceX = session->viewport.x;
+  meta->sourceY = session->viewport.y;
+  meta->sourceWidth = whole ? 0 : session->viewport.width;
+  meta->sourceHeight = whole ? 0 : session->viewport.height;
+  channel->Publish();
+}
+
+// Continuous-mode producer: captures on the pacer's monotonic deadlines,
+// independent of the JS event loop. It blocks (interruptibly) until just
+// before each deadline and spins the rest, so frames start within
+// microseconds of it. A frame that overruns skips the deadlines it missed
+// rather than bursting to catch up.
+void RunCaptureThread(CaptureSession* session) {
+#if defined(_WIN32)
+  timeBeginPeriod(1);
+#endif
+  pixel_pipeline::FramePacer* pacer = session->pacer.get();
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(session->captureThreadMutex);
+      if (session->captureThreadWake.wait_until(
+              lock, pacer->CoarseWakeTime(), [session] { return session->captureThreadStop; })) {
+        break;
+      }
+    }
+    pacer->SpinToDeadline();
+    pacer->BeginFrame(pixel_pipeline::FramePacer::Clock::now());
+    if (session->ring) {
+      CaptureInto(session, session->ring.get());
+    } else if (session->queue) {
+      CaptureInto(session, session->queue.get());
+    } else {
+      CaptureInto(session, session->frames.get());
+    }
+  }
+#if defined(_WIN32)
+  timeEndPeriod(1);
+#endif
+}
+
+// False for an unknown `backend` name: silently capturing the desktop instead
+// of a requested replay would make benchmark numbers meaningless.
+bool ResolveCaptureBackend(napi_env env, napi_value payload, CaptureBackend* out) {
+  const std::string fallback = IsSyntheticSourceEnabled() ? "synthetic" : "desktop";
+  const std::string name = GetNamedString(env, payload, "backend", fallback);
+  for (CaptureBackend backend : {CaptureBackend::kDesktop, CaptureBackend::kSynthetic, CaptureBackend::kReplay}) {
+    if (name == CaptureBackendName(backend)) {
+      *out = backend;
+      return true;
+    }
+  }
+  return false;
+}
+
+// sharedRing: { name, slots } publishes a continuous session's frames into a
+// named shared-memory ring (frame_ring.h) that any process can open by name.
+bool CreateSharedRing(napi_env env, napi_value options, CaptureSession* session, std::string* errorMessage) {
+  pixel_pipeline::FrameRingFormat format;
+  format.width = session->outputWidth;
+  format.height = session->outputHeight;
+  format.stride = session->outputStride;
+  format.format = session->pipeline.output.format;
+  format.range = session->yuvRange;
+  format.frameBytes = session->pipeline.output.byteLength;
+  std::string error;
+  session->ring = pixel_pipeline::FrameRingWriter::Create(
+      GetNamedString(env, options, "name"),
+      format,
+      GetNamedInt32(env, options, "slots", pixel_pipeline::kFrameRingDefaultSlots),
+      &error);
+  if (session->ring) {
+    session->ringReader = pixel_pipeline::FrameRingReader::Open(session->ring->name(), &error);
+  }
+  if (!session->ringReader) {
+    session->ring.reset();
+    if (errorMessage) {
+      *errorMessage = "sharedRing: " + error;
+    }
+    return false;
+  }
+  return true;
+}
+
+// ffmpeg's rawvideo pix_fmt for an output layout; pipeline.output planes
+// are packed the way rawvideo reads them.
+const char* RawVideoPixelFormat(pixel_pipeline::PixelFormat format) {
+  switch (format) {
+    case pixel_pipeline::PixelFormat::kNv12:
+      return "nv12";
+    case pixel_pipeline::PixelFormat::kI420:
+      return "yuv420p";
+    default:
+      return "rgba";
+  }
+}
+
+std::string ExpandEncoderArgument(std::string arg, const CaptureSession& session) {
+  char fps[32];
+  std::snprintf(fps, sizeof(fps), "%.6g", session.targetFps);
+  const std::pair<const char*, std::string> fields[] = {
+      {"{width}", std::to_string(session.outputWidth)},
+      {"{height}", std::to_string(session.outputHeight)},
+      {"{pix_fmt}", RawVideoPixelFormat(session.pipeline.output.format)},
+      {"{fps}", fps},
+  };
+  for (const auto& field : fields) {
+    const size_t keyLength = std::strlen(field.first);
+    for (size_t at = arg.find(field.first); at != std::string::npos; at = arg.find(field.first, at)) {
+      arg.replace(at, keyLength, field.second);
+      at += field.second.size();
+    }
+  }
+  return arg;
+}
+
+// encoderPipe: { command, args, path, depth, backpressure, logPath,
+// closeTimeoutMs } streams a continuous session's frames as rawvideo into
+// `command` (with `args`, where {width}, {height}, {pix_fmt} and {fps} are
+// filled in), started with the frames on its stdin, or into the FIFO or
+// named pipe at `path`. backpressure `block` (default) holds the capture
+// thread while `depth` frames wait for the encoder; `drop` skips frames for
+// it instead.
+bool OpenEncoderPipe(napi_env env, napi_value payload, CaptureSession* session, std::string* errorMessage) {
+  napi_value options;
+  if (!GetNamedProperty(env, payload, "encoderPipe", &options)) {
+    return true;
+  }
+  if (!session->continuous) {
+    if (errorMessage) {
+      *errorMessage = "encoderPipe requires continuous: true.";
+    }
+    return false;
+  }
+  pixel_pipeline::FramePipeOptions pipeOptions;
+  const std::string command = GetNamedString(env, options, "command");
+  pipeOptions.path = GetNamedString(env, options, "path");
+  if (command.empty() == pipeOptions.path.empty()) {
+    if (errorMessage) {
+      *errorMessage = "encoderPipe needs either command or path.";
+    }
+    return false;
+  }
+  if (!command.empty()) {
+    pipeOptions.command.push_back(command);
+    napi_value args;
+    if (GetNamedProperty(env, options, "args", &args)) {
+      bool isArray = false;
+      uint32_t count = 0;
+      bool valid = napi_is_array(env, args, &isArray) == napi_ok && isArray &&
+                   napi_get_array_length(env, args, &count) == napi_ok;
+      for (uint32_t i = 0; valid && i < count; ++i) {
+        napi_value entry = nullptr;
+        assert(napi_get_element(env, args, i, &entry) == napi_ok);
+        std::string arg;
+        valid = GetStringValue(env, entry, &arg);
+        pipeOptions.command.push_back(ExpandEncoderArgument(std::move(arg), *session));
+      }
+      if (!valid) {
+        if (errorMessage) {
+          *errorMessage = "encoderPipe.args must be an array of strings.";
+        }
+        return false;
+      }
+    }
+  }
+  const std::string backpressure = GetNamedString(env, options, "backpressure", "block");
+  if (backpressure != "block" && backpressure != "drop") {
+    if (errorMessage) {
+      *errorMessage = "encoderPipe.backpressure must be block or drop.";
+    }
+    return false;
+  }
+  pipeOptions.dropWhenFull = backpressure == "drop";
+  pipeOptions.logPath = GetNamedString(env, options, "logPath");
+  pipeOptions.frameBytes = session->pipeline.output.byteLength;
+  pipeOptions.depth = GetNamedInt32(env, options, "depth", pixel_pipeline::kFramePipeDefaultDepth);
+  session->encoderCloseTimeoutMs =
+      std::max(0, GetNamedInt32(env, options, "closeTimeoutMs", pixel_pipeline::kFramePipeDefaultCloseTimeoutMs));
+  std::string error;
+  session->encoder = pixel_pipeline::FramePipe::Open(pipeOptions, &error);
+  if (!session->encoder) {
+    if (errorMessage) {
+      *errorMessage = "encoderPipe: " + error;
+    }
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<CaptureSession> CreateSession(napi_env env,
+                                              napi_value payload,
+                                              CaptureBackend backend,
+                                              std::string* errorMessage) {
+  auto session = std::make_unique<CaptureSession>();
+  session->backend = backend;
+  session->rect = ResolveCaptureRect(env, payload);
+  session->viewport.width = session->rect.width;
+  session->viewport.height = session->rect.height;
+  const int64_t pixelCount =
+      static_cast<int64_t>(session->rect.width) * static_cast<int64_t>(session->rect.height);
+  if (session->rect.width <= 0 || session->rect.height <= 0 || pixelCount <= 0) {
+    if (errorMessage) {
+      *errorMessage = "Invalid capture bounds.";
+    }
+    return nullptr;
+  }
+  if (pixelCount > kMaxCapturePixels) {
+    if (errorMessage) {
+      *errorMessage = "FRAME_TOO_LARGE: capture bounds exceed safe native IPC size.";
+    }
+    return nullptr;
+  }
+  if (!ResolveSourceFormat(env, payload, &session->sourceFormat)) {
+    if (errorMessage) {
+      *errorMessage = "sourceFormat must be bgra8, rgba16f or rgb10a2.";
+    }
+    return nullptr;
+  }
+  if (backend == CaptureBackend::kDesktop && session->sourceFormat != pixel_pipeline::SourceFormat::kBgra8) {
+    if (errorMessage) {
+      *errorMessage = "Desktop capture delivers bgra8; sourceFormat " +
+                      std::string(pixel_pipeline::SourceFormatName(session->sourceFormat)) +
+                      " needs the synthetic or replay backend.";
+    }
+    return nullptr;
+  }
+  const bool hdrSource = session->sourceFormat != pixel_pipeline::SourceFormat::kBgra8;
+  // A high-bit-depth source is HDR by construction, whatever the display hint.
+  session->hdrLikely = hdrSource || ResolveHdrLikely(env, payload);
+  session->toneMap = ResolveToneMap(env, payload);
+  session->sourceToneMap = pixel_pipeline::ResolveToneMapParams(true, session->toneMap);
+  session->scaler = ResolveScaler(env, payload);
+  session->yuvRange = ResolveYuvRange(env, payload);
+  std::vector<int64_t> outputBudgets;
+  if (!ResolveOutputBudgets(env, payload, &outputBudgets, errorMessage)) {
+    return nullptr;
+  }
+  const int64_t maxOutputPixels =
+      outputBudgets.empty() ? ResolveMaxOutputPixels(env, payload) : ClampMaxOutputPixels(outputBudgets[0]);
+  pixel_pipeline::ComputeOutputSize(session->rect.width,
+                                    session->rect.height,
+                                    maxOutputPixels,
+                                    &session->outputWidth,
+                                    &session->outputHeight);
+  pixel_pipeline::BuildFramePipeline(session->rect.width,
+                                     session->rect.height,
+                                     session->outputWidth,
+                                     session->outputHeight,
+                                     hdrSource ? false : session->hdrLikely,
+                                     hdrSource ? ToneMapConfig() : session->toneMap,
+                                     &session->pipeline,
+                                     session->scaler,
+                                     ResolveOutputFormat(env, payload),
+                                     session->yuvRange);
+  session->outputStride = session->pipeline.output.planes[0].stride;
+
+  const size_t bytes = session->pipeline.output.byteLength;
+  if (bytes == 0 || bytes > kMaxFrameBytes) {
+    if (errorMessage) {
+      *errorMessage = "FRAME_TOO_LARGE: output frame exceeds safe native IPC size.";
+    }
+    return nullptr;
+  }
+  const int32_t framePoolDepth = ResolveFramePoolDepth(env, payload);
+  session->framePool = pixel_pipeline::FramePool::Create(bytes, framePoolDepth);
+  const int32_t changeTileSize = ResolveChangeTileSize(env, payload);
+  if (changeTileSize > 0) {
+    session->tiles = std::make_unique<pixel_pipeline::TileChangeTracker>(
+        session->rect.width, session->rect.height, changeTileSize);
+    session->tileOutput.assign(bytes, 0);
+  }
+  session->threads = ResolveProcessThreads(env, payload);
+  if (session->threads > 1) {
+    pixel_pipeline::ThreadPool::Shared()->EnsureWorkers(session->threads - 1);
+  }
+  session->continuous = GetNamedBool(env, payload, "continuous", false);
+  if (outputBudgets.size() > 1) {
+    if (session->pipeline.output.format != pixel_pipeline::PixelFormat::kRgba8) {
+      if (errorMessage) {
+        *errorMessage = "outputs levels require outputFormat RGBA8.";
+      }
+      return nullptr;
+    }
+    if (session->continuous) {
+      if (errorMessage) {
+        *errorMessage = "outputs levels are read with readFrame; continuous sessions deliver one frame.";
+      }
+      return nullptr;
+    }
+    int32_t aboveWidth = session->outputWidth;
+    int32_t aboveHeight = session->outputHeight;
+    size_t scratchBytes = 0;
+    for (size_t i = 1; i < outputBudgets.size(); ++i) {
+      OutputLevel level;
+      if (!pixel_pipeline::ComputePyramidLevelSize(
+              aboveWidth, aboveHeight, outputBudgets[i], &level.width, &level.height)) {
+        if (errorMessage) {
+          *errorMessage = "outputs[" + std::to_string(i) + "] leaves no pixels after halving " +
+                          std::to_string(aboveWidth) + "x" + std::to_string(aboveHeight) + ".";
+        }
+        return nullptr;
+      }
+      level.stride = level.width * 4;
+      // Intermediate sizes of a multi-step level, packed one after another.
+      size_t intermediateBytes = 0;
+      for (int32_t w = aboveWidth / 2, h = aboveHeight / 2; w != level.width; w /= 2, h /= 2) {
+        intermediateBytes += static_cast<size_t>(w) * static_cast<size_t>(h) * 4;
+        ++level.steps;
+      }
+      scratchBytes = std::max(scratchBytes, intermediateBytes);
+      session->levels.push_back(level);
+      session->levelPools.push_back(pixel_pipeline::FramePool::Create(
+          static_cast<size_t>(level.stride) * static_cast<size_t>(level.height), framePoolDepth));
+      aboveWidth = level.width;
+      aboveHeight = level.height;
+    }
+    session->levelScratch.assign(scratchBytes, 0);
+  }
+  session->frameBudgetMs = 1000.0 / ResolveTargetFps(env, payload);
+  napi_value sharedRing;
+  const bool hasSharedRing = GetNamedProperty(env, payload, "sharedRing", &sharedRing);
+  if (hasSharedRing && !session->continuous) {
+    if (errorMessage) {
+      *errorMessage = "sharedRing requires continuous: true.";
+    }
+    return nullptr;
+  }
+  if (session->continuous) {
+    session->targetFps = ResolveTargetFps(env, payload);
+    session->pacer = std::make_unique<pixel_pipeline::FramePacer>(session->targetFps);
+    const int32_t queueDepth = ResolveFrameQueueDepth(env, payload);
+    if (hasSharedRing) {
+      if (!CreateSharedRing(env, sharedRing, session.get(), errorMessage)) {
+        return nullptr;
+      }
+    } else if (queueDepth > 0) {
+      session->queue = std::make_unique<pixel_pipeline::FrameQueue>(bytes, queueDepth);
+    } else {
+      session->frames = std::make_unique<pixel_pipeline::TripleBuffer>(bytes);
+    }
+  }
+
+  const size_t sourceBytes =
+      static_cast<size_t>(pixelCount) * static_cast<size_t>(pixel_pipeline::SourceBytesPerPixel(session->sourceFormat));
+  if (hdrSource) {
+    session->decodedSurface.assign(static_cast<size_t>(pixelCount) * 4, 0);
+  }
+  if (backend == CaptureBackend::kSynthetic) {
+    session->sourceSurface.assign(sourceBytes, 0);
+    return session;
+  }
+  if (backend == CaptureBackend::kReplay) {
+    // Frames are rect.width x rect.height pixels in sourceFormat, so the
+    // bounds in displayHint must match the recording.
+    session->sourceSurface.assign(sourceBytes, 0);
+    session->replay = pixel_pipeline::ReplaySource::Open(
+        GetNamedString(env, payload, "replayPath"), session->sourceSurface.size(), errorMessage);
+    if (!session->replay) {
+      return nullptr;
+    }
+    return session;
+  }
+
+#if defined(_WIN32)
+  if (IsCoverageTestFlagEnabled("CURSORCINE_NATIVE_TEST_FAIL_GETDC")) {
+    if (errorMessage) {
+      *errorMessage = "GetDC failed.";
+    }
+    return nullptr;
+  }
+
+  session->desktopDc = GetDC(nullptr);
+  if (!session->desktopDc) {
+    if (errorMessage) {
+      *errorMessage = "GetDC failed.";
+    }
+    return nullptr;
+  }
+
+  if (IsCoverageTestFlagEnabled("CURSORCINE_NATIVE_TEST_FAIL_CREATE_COMPATIBLE_DC")) {
+    if (errorMessage) {
+      *errorMessage = "CreateCompatibleDC failed.";
+    }
+    return nullptr;
+  }
+
+  session->captureDc = CreateCompatibleDC(session->desktopDc);
+  if (!session->captureDc) {
+    if (errorMessage) {
+      *errorMessage = "CreateCompatibleDC failed.";
+    }
+    return nullptr;
+  }
+
+  BITMAPINFO bmi;
+  std::memset(&bmi, 0, sizeof(BITMAPINFO));
+  bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+  bmi.bmiHeader.biWidth = session->rect.width;
+  bmi.bmiHeader.biHeight = -session->rect.height;
+  bmi.bmiHeader.biPlanes = 1;
+  bmi.bmiHeader.biBitCount = 32;
+  bmi.bmiHeader.biCompression = BI_RGB;
+
+  if (IsCoverageTestFlagEnabled("CURSORCINE_NATIVE_TEST_FAIL_CREATE_DIB_SECTION")) {
+    if (errorMessage) {
+      *errorMessage = "CreateDIBSection failed.";
+    }
+    return nullptr;
+  }
+
+  session->bitmap =
+      CreateDIBSection(session->desktopDc, &bmi, DIB_RGB_COLORS, &session->bitmapBits, nullptr, 0);
+  if (!session->bitmap || !session->bitmapBits) {
+    if (errorMessage) {
+      *errorMessage = "CreateDIBSection failed.";
+    }
+    return nullptr;
+  }
+
+  if (IsCoverageTestFlagEnabled("CURSORCINE_NATIVE_TEST_FAIL_SELECT_OBJECT")) {
+    if (errorMessage) {
+      *errorMessage = "SelectObject failed.";
+    }
+    return nullptr;
+  }
+
+  session->oldBitmap = SelectObject(session->captureDc, session->bitmap);
+  if (!session->oldBitmap) {
+    if (errorMessage) {
+      *errorMessage = "SelectObject failed.";
+    }
+    return nullptr;
+  }
+  return session;
+#else
+  if (errorMessage) {
+    *errorMessage = "Windows-only backend.";
+  }
+  return nullptr;
+#endif
+}
+
+// False once napi_create_external_buffer reports that the V8 sandbox
+// (Electron) forbids off-heap backing stores; frames are then rendered
+// straight into a V8-allocated Buffer instead. Only touched on the JS thread.
+bool g_externalBuffersAllowed = true;
+
+void FinalizeFrameLease(napi_env env, void* /*data*/, void* hint) {
+  auto* lease = static_cast<pixel_pipeline::FrameLease*>(hint);
+  int64_t adjusted = 0;
+  napi_adjust_external_memory(env, -static_cast<int64_t>(lease->size()), &adjusted);
+  delete lease;
+}
+
+// Hands the leased slab to JS without copying; the slab returns to the pool
+// when the Buffer is garbage collected. Falls back to a copy (and releases the
+// slab immediately) when external buffers are not allowed.
+napi_value WrapFrameLease(napi_env env, std::unique_ptr<pixel_pipeline::FrameLease> lease, const char** bufferMode) {
+  napi_value out = nullptr;
+  pixel_pipeline::FrameLease* raw = lease.get();
+  const napi_status status =
+      napi_create_external_buffer(env, raw->size(), raw->data(), FinalizeFrameLease, raw, &out);
+  if (status == napi_ok) {
+    lease.release();
+    int64_t adjusted = 0;
+    napi_adjust_external_memory(env, static_cast<int64_t>(raw->size()), &adjusted);
+    *bufferMode = "pooled";
+    return out;
+  }
+  if (status == napi_no_external_buffers_allowed) {
+    g_externalBuffersAllowed = false;
+  }
+  void* dst = nullptr;
+  assert(napi_create_buffer_copy(env, raw->size(), raw->data(), &dst, &out) == napi_ok);
+  *bufferMode = "copied";
+  return out;
+}
+
+// Pool slabs for every outputs level of one read; false, holding none, when
+// any level's pool is exhausted.
+bool AcquireLevelLeases(CaptureSession* session,
+                        std::vector<std::unique_ptr<pixel_pipeline::FrameLease>>* leases,
+                        std::vector<uint8_t*>* outputs) {
+  for (const std::shared_ptr<pixel_pipeline::FramePool>& pool : session->levelPools) {
+    std::unique_ptr<pixel_pipeline::FrameLease> lease = pool->Acquire();
+    if (!lease) {
+      leases->clear();
+      outputs->clear();
+      return false;
+    }
+    outputs->push_back(lease->data());
+    leases->push_back(std::move(lease));
+  }
+  return true;
+}
+
+// V8 Buffers for every outputs level, where external buffers are not allowed.
+bool CreateLevelBuffers(napi_env env,
+                        const CaptureSession* session,
+                        std::vector<napi_value>* buffers,
+                        std::vector<uint8_t*>* outputs) {
+  for (const std::shared_ptr<pixel_pipeline::FramePool>& pool : session->levelPools) {
+    void* data = nullptr;
+    napi_value buffer = nullptr;
+    if (napi_create_buffer(env, pool->slabBytes(), &data, &buffer) != napi_ok) {
+      return false;
+    }
+    buffers->push_back(buffer);
+    outputs->push_back(static_cast<uint8_t*>(data));
+  }
+  return true;
+}
+
+struct FrameMeta {
+  int32_t width = 0;
+  int32_t height = 0;
+  int32_t stride = 0;
+  pixel_pipeline::FrameLayout layout;
+  pixel_pipeline::YuvRange yuvRange = pixel_pipeline::YuvRange::kLimited;
+  double timestampMs = 0.0;
+  double captureMs = 0.0;
+  double processMs = 0.0;
+  // Set only while setViewport narrows the capture.
+  CaptureRect viewport;
+  // changeDetection sessions only.
+  bool changeDetection = false;
+  bool unchanged = false;
+  std::vector<pixel_pipeline::DirtyRect> dirtyRects;
+  // outputs sessions only.
+  std::vector<OutputLevel> levels;
+};
+
+// Copied out of the session so async reads can marshal after the lock is gone.
+FrameMeta SnapshotFrameMeta(const CaptureSession* session, int32_t stride) {
+  FrameMeta meta;
+  meta.width = session->outputWidth;
+  meta.height = session->outputHeight;
+  meta.stride = stride;
+  meta.layout = session->pipeline.output;
+  meta.yuvRange = session->yuvRange;
+  meta.timestampMs = session->captureTimestampMs;
+  meta.captureMs = session->captureMs;
+  meta.processMs = session->processMs;
+  if (!IsWholeCapture(session->viewport, session->rect)) {
+    meta.viewport = session->viewport;
+  }
+  if (session->tiles) {
+    meta.changeDetection = true;
+    meta.unchanged = session->unchanged;
+    meta.dirtyRects = session->dirtyRects;
+  }
+  meta.levels = session->levels;
+  return meta;
+}
+
+// pixelFormat, plus `planes` ({ offset, stride, width, height } each, in
+// bytes from the start of the frame) and `yuvRange` for NV12/I420.
+void SetPixelFormat(napi_env env,
+                    napi_value result,
+                    const pixel_pipeline::FrameLayout& layout,
+                    pixel_pipeline::YuvRange yuvRange) {
+  SetNamed(env, result, "pixelFormat", MakeString(env, pixel_pipeline::PixelFormatName(layout.format)));
+  if (layout.format == pixel_pipeline::PixelFormat::kRgba8) {
+    return;
+  }
+  napi_value planes = nullptr;
+  assert(napi_create_array_with_length(env, layout.planeCount, &planes) == napi_ok);
+  for (int32_t i = 0; i < layout.planeCount; ++i) {
+    const pixel_pipeline::PlaneLayout& plane = layout.planes[i];
+    napi_value entry = MakeObject(env);
+    SetNamed(env, entry, "offset", MakeDouble(env, static_cast<double>(plane.offset)));
+    SetNamed(env, entry, "stride", MakeInt32(env, plane.stride));
+    SetNamed(env, entry, "width", MakeInt32(env, plane.width));
+    SetNamed(env, entry, "height", MakeInt32(env, plane.height));
+    assert(napi_set_element(env, planes, static_cast<uint32_t>(i), entry) == napi_ok);
+  }
+  SetNamed(env, result, "planes", planes);
+  SetNamed(env, result, "yuvRange", MakeString(env, pixel_pipeline::YuvRangeName(yuvRange)));
+}
+
+void SetFrameMeta(napi_env env, napi_value result, const FrameMeta& meta) {
+  SetNamed(env, result, "ok", MakeBool(env, true));
+  SetNamed(env, result, "width", MakeInt32(env, meta.width));
+  SetNamed(env, result, "height", MakeInt32(env, meta.height));
+  SetNamed(env, result, "stride", MakeInt32(env, meta.stride));
+  SetPixelFormat(env, result, meta.layout, meta.yuvRange);
+  SetNamed(env, result, "timestampMs", MakeDouble(env, meta.timestampMs));
+
+  napi_value stageMs = MakeObject(env);
+  SetNamed(env, stageMs, "capture", MakeDouble(env, meta.captureMs));
+  SetNamed(env, stageMs, "process", MakeDouble(env, meta.processMs));
+  SetNamed(env, result, "stageMs", stageMs);
+  if (meta.viewport.width > 0) {
+    napi_value viewport = MakeObject(env);
+    SetNamed(env, viewport, "x", MakeInt32(env, meta.viewport.x));
+    SetNamed(env, viewport, "y", MakeInt32(env, meta.viewport.y));
+    SetNamed(env, viewport, "width", MakeInt32(env, meta.viewport.width));
+    SetNamed(env, viewport, "height", MakeInt32(env, meta.viewport.height));
+    SetNamed(env, result, "viewport", viewport);
+  }
+
+  if (!meta.changeDetection) {
+    return;
+  }
+  // Output pixels that may differ from the previous frame; empty (and
+  // `unchanged`) when the frame is identical to it.
+  napi_value dirtyRects = nullptr;
+  assert(napi_create_array_with_length(env, meta.dirtyRects.size(), &dirtyRects) == napi_ok);
+  for (size_t i = 0; i < meta.dirtyRects.size(); ++i) {
+    const pixel_pipeline::DirtyRect& rect = meta.dirtyRects[i];
+    napi_value entry = MakeObject(env);
+    SetNamed(env, entry, "x", MakeInt32(env, rect.x));
+    SetNamed(env, entry, "y", MakeInt32(env, rect.y));
+    SetNamed(env, entry, "width", MakeInt32(env, rect.width));
+    SetNamed(env, entry, "height", MakeInt32(env, rect.height));
+    assert(napi_set_element(env, dirtyRects, static_cast<uint32_t>(i), entry) == napi_ok);
+  }
+  SetNamed(env, result, "dirtyRects", dirtyRects);
+  SetNamed(env, result, "unchanged", MakeBool(env, meta.unchanged));
+}
+
+// outputs sessions: `levels`, the main frame first and then every pyramid
+// level, as { width, height, stride, byteLength, bytes }. Level 0 shares the
+// top-level `bytes`.
+void SetOutputLevels(napi_env env,
+                     napi_value result,
+                     const FrameMeta& meta,
+                     napi_value bytes,
+                     const std::vector<napi_value>& levelBytes) {
+  if (meta.levels.empty()) {
+    return;
+  }
+  napi_value levels = nullptr;
+  assert(napi_create_array_with_length(env, meta.levels.size() + 1, &levels) == napi_ok);
+  napi_value top = MakeObject(env);
+  SetNamed(env, top, "width", MakeInt32(env, meta.width));
+  SetNamed(env, top, "height", MakeInt32(env, meta.height));
+  SetNamed(env, top, "stride", MakeInt32(env, meta.stride));
+  SetNamed(env, top, "byteLength", MakeDouble(env, static_cast<double>(meta.layout.byteLength)));
+  SetNamed(env, top, "bytes", bytes);
+  assert(napi_set_element(env, levels, 0, top) == napi_ok);
+  for (size_t i = 0; i < meta.levels.size(); ++i) {
+    const OutputLevel& level = meta.levels[i];
+    napi_value entry = MakeObject(env);
+    SetNamed(env, entry, "width", MakeInt32(env, level.width));
+    SetNamed(env, entry, "height", MakeInt32(env, level.height));
+    SetNamed(env, entry, "stride", MakeInt32(env, level.stride));
+    SetNamed(env,
+             entry,
+             "byteLength",
+             MakeDouble(env, static_cast<double>(level.stride) * static_cast<double>(level.height)));
+    SetNamed(env, entry, "bytes", levelBytes[i]);
+    assert(napi_set_element(env, levels, static_cast<uint32_t>(i + 1), entry) == napi_ok);
+  }
+  SetNamed(env, result, "levels", levels);
+}
+
+void SetFailure(napi_env env, napi_value result, const char* reason, const char* message) {
+  SetNamed(env, result, "ok", MakeBool(env, false));
+  SetNamed(env, result, "reason", MakeString(env, reason));
+  SetNamed(env, result, "message", MakeString(env, message));
+}
+
+// Writable backing store of a TypedArray/DataView/Buffer view or a plain
+// ArrayBuffer. SharedArrayBuffers arrive wrapped in a Uint8Array (index.js).
+bool GetWritableBytes(napi_env env, napi_value value, uint8_t** data, size_t* length) {
+  if (value == nullptr) {
+    return false;
+  }
+  bool is = false;
+  void* raw = nullptr;
+  if (napi_is_typedarray(env, value, &is) == napi_ok && is) {
+    napi_typedarray_type type;
+    size_t elements = 0;
+    napi_value arrayBuffer;
+    size_t byteOffset = 0;
+    if (napi_get_typedarray_info(env, value, &type, &elements, &raw, &arrayBuffer, &byteOffset) != napi_ok) {
+      return false;
+    }
+    size_t elementSize = 1;
+    switch (type) {
+      case napi_int16_array:
+      case napi_uint16_array:
+        elementSize = 2;
+        break;
+      case napi_int32_array:
+      case napi_uint32_array:
+      case napi_float32_array:
+        elementSize = 4;
+        break;
+      case napi_float64_array:
+      case napi_bigint64_array:
+      case napi_biguint64_array:
+        elementSize = 8;
+        break;
+      default:
+        break;
+    }
+    *length = elements * elementSize;
+  } else if (napi_is_dataview(env, value, &is) == napi_ok && is) {
+    napi_value arrayBuffer;
+    size_t byteOffset = 0;
+    if (napi_get_dataview_info(env, value, length, &raw, &arrayBuffer, &byteOffset) != napi_ok) {
+      return false;
+    }
+  } else if (napi_is_arraybuffer(env, value, &is) == napi_ok && is) {
+    if (napi_get_arraybuffer_info(env, value, &raw, length) != napi_ok) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  *data = static_cast<uint8_t*>(raw);
+  return raw != nullptr || *length == 0;
+}
+
+void SetProbeResponse(napi_env env, napi_value result, bool hdrActive) {
+  SetNamed(env, result, "supported", MakeBool(env, true));
+  SetNamed(env, result, "hdrActive", MakeBool(env, hdrActive));
+  SetNamed(env, result, "nativeBackend", MakeString(env, kBackendName));
+  SetNamed(env, result, "reason", MakeString(env, hdrActive ? "HDR_ACTIVE" : "SDR_OR_UNKNOWN"));
+}
+
+napi_value Probe(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+
+  if (IsCaptureAvailable()) {
+    napi_value payload = GetFirstArg(env, info);
+    const bool hdrLikely = ResolveHdrLikely(env, payload);
+    SetProbeResponse(env, result, hdrLikely);
+  } else {
+    SetNamed(env, result, "supported", MakeBool(env, false));
+    SetNamed(env, result, "hdrActive", MakeBool(env, false));
+    SetNamed(env, result, "nativeBackend", MakeString(env, "node-addon-stub"));
+    SetNamed(env, result, "reason", MakeString(env, "NOT_WINDOWS"));
+  }
+  SetNamed(env,
+           result,
+           "toneMapKernel",
+           MakeString(env, pixel_pipeline::ToneMapKernelName(pixel_pipeline::ActiveToneMapKernel())));
+
+  napi_value backends = nullptr;
+  assert(napi_create_array(env, &backends) == napi_ok);
+  uint32_t backendCount = 0;
+  for (CaptureBackend backend : {CaptureBackend::kDesktop, CaptureBackend::kSynthetic, CaptureBackend::kReplay}) {
+    if (backend == CaptureBackend::kDesktop && !IsDesktopCaptureAvailable()) {
+      continue;
+    }
+    assert(napi_set_element(env, backends, backendCount++, MakeString(env, CaptureBackendName(backend))) == napi_ok);
+  }
+  SetNamed(env, result, "backends", backends);
+  return result;
+}
+
+napi_value StartCapture(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  CaptureBackend backend = CaptureBackend::kDesktop;
+  if (!ResolveCaptureBackend(env, payload, &backend)) {
+    SetFailure(env, result, "INVALID_BACKEND", "backend must be desktop, synthetic or replay.");
+    return result;
+  }
+  if (backend == CaptureBackend::kDesktop && !IsDesktopCaptureAvailable()) {
+    SetFailure(env, result, "NOT_WINDOWS", "Windows-only backend.");
+    return result;
+  }
+
+  std::string error;
+  auto session = CreateSession(env, payload, backend, &error);
+  // The encoder is only started for an otherwise complete session.
+  if (session && !OpenEncoderPipe(env, payload, session.get(), &error)) {
+    session.reset();
+  }
+  if (!session) {
+    const bool frameTooLarge = error.rfind("FRAME_TOO_LARGE", 0) == 0;
+    SetNamed(env, result, "ok", MakeBool(env, false));
+    SetNamed(env, result, "reason", MakeString(env, frameTooLarge ? "FRAME_TOO_LARGE" : "START_FAILED"));
+    SetNamed(env, result, "message", MakeString(env, error.empty() ? "Failed to create capture session." : error));
+    return result;
+  }
+
+  int32_t startedId = 0;
+  {
+    std::lock_guard<std::mutex> lock(g_sessionsMutex);
+    startedId = g_nextSessionId++;
+    session->sessionId = startedId;
+    g_sessions[startedId] = std::move(session);
+    if (IsCoverageTestFlagEnabled("CURSORCINE_NATIVE_TEST_FORCE_SESSION_REGISTRATION_FAIL")) {
+      g_sessions.erase(startedId);
+    }
+  }
+
+  const std::shared_ptr<CaptureSession> started = FindSession(startedId);
+  if (!started) {
+    SetNamed(env, result, "ok", MakeBool(env, false));
+    SetNamed(env, result, "reason", MakeString(env, "START_FAILED"));
+    SetNamed(env, result, "message", MakeString(env, "Session registration failed."));
+    return result;
+  }
+
+  if (started->continuous) {
+    started->captureThread = std::thread(RunCaptureThread, started.get());
+  }
+  SetNamed(env, result, "ok", MakeBool(env, true));
+  SetNamed(env, result, "nativeSessionId", MakeInt32(env, started->sessionId));
+  SetNamed(env, result, "width", MakeInt32(env, started->outputWidth));
+  SetNamed(env, result, "height", MakeInt32(env, started->outputHeight));
+  SetNamed(env, result, "stride", MakeInt32(env, started->outputStride));
+  SetPixelFormat(env, result, started->pipeline.output, started->yuvRange);
+  SetNamed(env, result, "byteLength", MakeDouble(env, static_cast<double>(started->pipeline.output.byteLength)));
+  SetNamed(env, result, "colorSpace", MakeString(env, "Rec.709"));
+  SetNamed(env, result, "hdrActive", MakeBool(env, started->hdrLikely));
+  SetNamed(env, result, "nativeBackend", MakeString(env, kBackendName));
+  SetNamed(env, result, "source", MakeString(env, CaptureBackendName(started->backend)));
+  SetNamed(env, result, "sourceFormat", MakeString(env, pixel_pipeline::SourceFormatName(started->sourceFormat)));
+  if (started->replay) {
+    SetNamed(env, result, "replayFrames", MakeDouble(env, static_cast<double>(started->replay->frameCount())));
+  }
+  SetNamed(env, result, "scaler", MakeString(env, pixel_pipeline::ScalerModeName(started->scaler)));
+  SetNamed(env, result, "framePoolDepth", MakeInt32(env, started->framePool->depth()));
+  SetNamed(env, result, "threads", MakeInt32(env, started->threads));
+  SetNamed(env, result, "continuous", MakeBool(env, started->continuous));
+  if (started->continuous) {
+    SetNamed(env, result, "targetFps", MakeDouble(env, started->targetFps));
+    SetNamed(env,
+             result,
+             "dropPolicy",
+             MakeString(env, started->queue ? "queue-" + std::to_string(started->queue->depth()) : "latest-only"));
+  }
+  if (started->tiles) {
+    napi_value changeDetection = MakeObject(env);
+    SetNamed(env, changeDetection, "tileSize", MakeInt32(env, started->tiles->tileSize()));
+    SetNamed(env, changeDetection, "tiles", MakeInt32(env, started->tiles->tilesX() * started->tiles->tilesY()));
+    SetNamed(env, result, "changeDetection", changeDetection);
+  }
+  if (!started->levels.empty()) {
+    napi_value outputs = nullptr;
+    assert(napi_create_array_with_length(env, started->levels.size() + 1, &outputs) == napi_ok);
+    for (size_t i = 0; i <= started->levels.size(); ++i) {
+      const int32_t width = i == 0 ? started->outputWidth : started->levels[i - 1].width;
+      const int32_t height = i == 0 ? started->outputHeight : started->levels[i - 1].height;
+      const int32_t stride = i == 0 ? started->outputStride : started->levels[i - 1].stride;
+      napi_value entry = MakeObject(env);
+      SetNamed(env, entry, "width", MakeInt32(env, width));
+      SetNamed(env, entry, "height", MakeInt32(env, height));
+      SetNamed(env, entry, "stride", MakeInt32(env, stride));
+      SetNamed(env, entry, "byteLength", MakeDouble(env, static_cast<double>(stride) * static_cast<double>(height)));
+      assert(napi_set_element(env, outputs, static_cast<uint32_t>(i), entry) == napi_ok);
+    }
+    SetNamed(env, result, "outputs", outputs);
+  }
+  if (started->ring) {
+    napi_value sharedRing = MakeObject(env);
+    SetNamed(env, sharedRing, "name", MakeString(env, started->ring->name()));
+    SetNamed(env, sharedRing, "slots", MakeInt32(env, started->ring->slots()));
+    SetNamed(env, result, "sharedRing", sharedRing);
+  }
+  if (started->encoder) {
+    napi_value encoderPipe = MakeObject(env);
+    SetNamed(env, encoderPipe, "pixelFormat", MakeString(env, RawVideoPixelFormat(started->pipeline.output.format)));
+    SetNamed(env, encoderPipe, "frameBytes", MakeDouble(env, static_cast<double>(started->encoder->frameBytes())));
+    SetNamed(env, encoderPipe, "depth", MakeInt32(env, started->encoder->depth()));
+    SetNamed(env, encoderPipe, "pid", MakeDouble(env, static_cast<double>(started->encoder->processId())));
+    SetNamed(env, result, "encoderPipe", encoderPipe);
+  }
+
+  napi_value toneMap = MakeObject(env);
+  SetNamed(env, toneMap, "profile", MakeString(env, pixel_pipeline::ToneMapProfileName(started->toneMap.profile)));
+  SetNamed(env, toneMap, "rolloff", MakeDouble(env, started->toneMap.rolloff));
+  SetNamed(env, toneMap, "saturation", MakeDouble(env, started->toneMap.saturation));
+  SetNamed(env, toneMap, "masteringPeakNits", MakeDouble(env, started->toneMap.masteringPeakNits));
+  SetNamed(env, toneMap, "targetNits", MakeDouble(env, started->toneMap.targetNits));
+  SetNamed(env,
+           toneMap,
+           "arithmetic",
+           MakeString(env, pixel_pipeline::ToneMapArithmeticName(started->toneMap.arithmetic)));
+  const pixel_pipeline::ToneMapLut& lut = started->pipeline.toneMap;
+  SetNamed(env,
+           toneMap,
+           "kernel",
+           MakeString(env,
+                      lut.fixedPoint     ? "fixed"
+                      : lut.preferTables ? "lut"
+                                         : pixel_pipeline::ToneMapKernelName(pixel_pipeline::ActiveToneMapKernel())));
+  if (lut.fixedPoint) {
+    // Only a converted bgra8 pipeline can take the fixed path, so its
+    // hdrLikely is the session's.
+    const pixel_pipeline::ToneMapFixedError error =
+        pixel_pipeline::MeasureToneMapFixedError(started->hdrLikely, started->toneMap, 5);
+    napi_value fixedError = MakeObject(env);
+    SetNamed(env, fixedError, "max", MakeInt32(env, error.maxError));
+    SetNamed(env, fixedError, "mean", MakeDouble(env, error.meanError));
+    SetNamed(env, fixedError, "mismatchRate", MakeDouble(env, error.mismatchRate));
+    SetNamed(env, toneMap, "fixedError", fixedError);
+  }
+  SetNamed(env, result, "toneMap", toneMap);
+
+  return result;
+}
+
+napi_value ReadFrame(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  const int32_t nativeSessionId = GetNamedInt32(env, payload, "nativeSessionId", 0);
+  if (!IsSessionReachable(nativeSessionId)) {
+    SetFailure(env, result, "NOT_WINDOWS", "Frame path is Windows-only.");
+    return result;
+  }
+  if (nativeSessionId <= 0) {
+    SetNamed(env, result, "ok", MakeBool(env, false));
+    SetNamed(env, result, "reason", MakeString(env, "INVALID_SESSION"));
+    SetNamed(env, result, "message", MakeString(env, "Invalid native session id."));
+    return result;
+  }
+
+  const std::shared_ptr<CaptureSession> sessionRef = FindSession(nativeSessionId);
+  if (!sessionRef) {
+    SetNamed(env, result, "ok", MakeBool(env, false));
+    SetNamed(env, result, "reason", MakeString(env, "INVALID_SESSION"));
+    SetNamed(env, result, "message", MakeString(env, "Native session not found."));
+    return result;
+  }
+
+  CaptureSession* session = sessionRef.get();
+  if (session->continuous) {
+    SetFailure(env, result, "CONTINUOUS_SESSION", "Continuous sessions are read with readLatest.");
+    return result;
+  }
+  std::unique_ptr<pixel_pipeline::FrameLease> lease;
+  napi_value bytes = nullptr;
+  uint8_t* output = nullptr;
+  std::vector<std::unique_ptr<pixel_pipeline::FrameLease>> levelLeases;
+  std::vector<napi_value> levelBytes;
+  std::vector<uint8_t*> levelOutputs;
+  if (g_externalBuffersAllowed) {
+    lease = session->framePool->Acquire();
+    if (!lease || IsCoverageTestFlagEnabled("CURSORCINE_NATIVE_TEST_FORCE_POOL_EXHAUSTED") ||
+        !AcquireLevelLeases(session, &levelLeases, &levelOutputs)) {
+      SetNamed(env, result, "ok", MakeBool(env, false));
+      SetNamed(env, result, "reason", MakeString(env, "POOL_EXHAUSTED"));
+      SetNamed(env, result, "message", MakeString(env, "All pooled frame buffers are still referenced."));
+      SetNamed(env, result, "framePoolDepth", MakeInt32(env, session->framePool->depth()));
+      return result;
+    }
+    output = lease->data();
+  } else {
+    void* data = nullptr;
+    if (napi_create_buffer(env, session->framePool->slabBytes(), &data, &bytes) != napi_ok ||
+        !CreateLevelBuffers(env, session, &levelBytes, &levelOutputs)) {
+      SetNamed(env, result, "ok", MakeBool(env, false));
+      SetNamed(env, result, "reason", MakeString(env, "READ_FAILED"));
+      SetNamed(env, result, "message", MakeString(env, "Frame buffer allocation failed."));
+      return result;
+    }
+    output = static_cast<uint8_t*>(data);
+  }
+
+  std::lock_guard<std::mutex> captureLock(session->captureMutex);
+  if (!CaptureFrame(session, output, session->outputStride, levelOutputs.empty() ? nullptr : levelOutputs.data())) {
+    SetNamed(env, result, "ok", MakeBool(env, false));
+    SetNamed(env, result, "reason", MakeString(env, "READ_FAILED"));
+    SetNamed(env, result, "message", MakeString(env, "BitBlt failed."));
+    return result;
+  }
+  const auto marshalStart = std::chrono::steady_clock::now();
+  const char* bufferMode = "direct";
+  if (lease) {
+    bytes = WrapFrameLease(env, std::move(lease), &bufferMode);
+    for (std::unique_ptr<pixel_pipeline::FrameLease>& levelLease : levelLeases) {
+      const char* levelMode = nullptr;
+      levelBytes.push_back(WrapFrameLease(env, std::move(levelLease), &levelMode));
+    }
+  }
+
+  const FrameMeta meta = SnapshotFrameMeta(session, session->outputStride);
+  SetFrameMeta(env, result, meta);
+  SetNamed(env, result, "bytes", bytes);
+  SetOutputLevels(env, result, meta, bytes, levelBytes);
+  SetNamed(env, result, "bufferMode", MakeString(env, bufferMode));
+  session->stats.Record(pixel_pipeline::CaptureStage::kMarshal, ElapsedMs(marshalStart));
+  return result;
+}
+
+struct FrameTarget {
+  uint8_t* data = nullptr;
+  size_t length = 0;
+  double offset = 0.0;
+  int32_t stride = 0;
+  double requiredBytes = 0.0;
+};
+
+// Reads payload.target and checks it holds a `width` x `height` frame laid
+// out as `layout` (RGBA rows `outputStride` apart by default) at
+// payload.offset/payload.stride. NV12/I420 frames are always written packed,
+// so payload.stride is ignored for them. On failure fills `result` with
+// INVALID_TARGET.
+bool ResolveFrameTarget(napi_env env,
+                        napi_value payload,
+                        napi_value target,
+                        const pixel_pipeline::FrameLayout& layout,
+                        int32_t width,
+                        int32_t height,
+                        int32_t outputStride,
+                        napi_value result,
+                        FrameTarget* out) {
+  if (!GetWritableBytes(env, target, &out->data, &out->length)) {
+    SetFailure(env, result, "INVALID_TARGET", "target must be an ArrayBuffer, SharedArrayBuffer or typed array.");
+    return false;
+  }
+  const bool planar = layout.format != pixel_pipeline::PixelFormat::kRgba8;
+  out->offset = GetNamedNumber(env, payload, "offset", 0.0);
+  out->stride = planar ? outputStride : GetNamedInt32(env, payload, "stride", outputStride);
+  const int32_t rowBytes = planar ? outputStride : width * 4;
+  out->requiredBytes = planar ? out->offset + static_cast<double>(layout.byteLength)
+                              : out->offset + static_cast<double>(height - 1) * out->stride + rowBytes;
+  if (!std::isfinite(out->offset) || out->offset < 0 || std::floor(out->offset) != out->offset ||
+      out->stride < rowBytes || out->requiredBytes > static_cast<double>(out->length)) {
+    SetFailure(env, result, "INVALID_TARGET", "target is too small for the frame at this offset/stride.");
+    SetNamed(env, result, "requiredBytes", MakeDouble(env, out->requiredBytes));
+    SetNamed(env, result, "minStride", MakeInt32(env, rowBytes));
+    return false;
+  }
+  return true;
+}
+
+bool ResolveFrameTarget(napi_env env,
+                        napi_value payload,
+                        napi_value target,
+                        const CaptureSession* session,
+                        napi_value result,
+                        FrameTarget* out) {
+  return ResolveFrameTarget(env,
+                            payload,
+                            target,
+                            session->pipeline.output,
+                            session->outputWidth,
+                            session->outputHeight,
+                            session->outputStride,
+                            result,
+                            out);
+}
+
+// Same capture as ReadFrame, written straight into `target` at `offset` with
+// rows `stride` bytes apart. Returns metadata only.
+napi_value ReadFrameInto(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  const int32_t nativeSessionId = GetNamedInt32(env, payload, "nativeSessionId", 0);
+  if (!IsSessionReachable(nativeSessionId)) {
+    SetFailure(env, result, "NOT_WINDOWS", "Frame path is Windows-only.");
+    return result;
+  }
+  if (nativeSessionId <= 0) {
+    SetNamed(env, result, "ok", MakeBool(env, false));
+    SetNamed(env, result, "reason", MakeString(env, "INVALID_SESSION"));
+    SetNamed(env, result, "message", MakeString(env, "Invalid native session id."));
+    return result;
+  }
+
+  napi_value target = nullptr;
+  GetNamedProperty(env, payload, "target", &target);
+
+  const std::shared_ptr<CaptureSession> sessionRef = FindSession(nativeSessionId);
+  if (!sessionRef) {
+    SetNamed(env, result, "ok", MakeBool(env, false));
+    SetNamed(env, result, "reason", MakeString(env, "INVALID_SESSION"));
+    SetNamed(env, result, "message", MakeString(env, "Native session not found."));
+    return result;
+  }
+
+  CaptureSession* session = sessionRef.get();
+  if (session->continuous) {
+    SetFailure(env, result, "CONTINUOUS_SESSION", "Continuous sessions are read with readLatest.");
+    return result;
+  }
+  FrameTarget frameTarget;
+  if (!ResolveFrameTarget(env, payload, target, session, result, &frameTarget)) {
+    return result;
+  }
+
+  std::lock_guard<std::mutex> captureLock(session->captureMutex);
+  if (!CaptureFrame(session, frameTarget.data + static_cast<size_t>(frameTarget.offset), frameTarget.stride)) {
+    SetNamed(env, result, "ok", MakeBool(env, false));
+    SetNamed(env, result, "reason", MakeString(env, "READ_FAILED"));
+    SetNamed(env, result, "message", MakeString(env, "BitBlt failed."));
+    return result;
+  }
+
+  const auto marshalStart = std::chrono::steady_clock::now();
+  SetFrameMeta(env, result, SnapshotFrameMeta(session, frameTarget.stride));
+  SetNamed(env, result, "offset", MakeDouble(env, frameTarget.offset));
+  SetNamed(env, result, "byteLength", MakeDouble(env, frameTarget.requiredBytes - frameTarget.offset));
+  session->stats.Record(pixel_pipeline::CaptureStage::kMarshal, ElapsedMs(marshalStart));
+  return result;
+}
+
+// One readFrameAsync call. Everything touched by ExecuteReadFrame is plain
+// data; napi values are created only in CompleteReadFrame.
+struct ReadFrameWork {
+  napi_env env = nullptr;
+  napi_async_work work = nullptr;
+  napi_deferred deferred = nullptr;
+  int32_t sessionId = 0;
+  // Caller target or (sandboxed runtimes) a V8 Buffer allocated up front,
+  // referenced so it outlives the work. Null when writing into a pool slab.
+  napi_ref outputRef = nullptr;
+  uint8_t* output = nullptr;
+  bool intoTarget = false;
+  int32_t stride = 0;
+  double offset = 0.0;
+  double byteLength = 0.0;
+  std::unique_ptr<pixel_pipeline::FrameLease> lease;
+  // outputs levels (not for targets): pool slabs, or referenced V8 Buffers
+  // alongside outputRef.
+  std::vector<std::unique_ptr<pixel_pipeline::FrameLease>> levelLeases;
+  std::vector<napi_ref> levelRefs;
+  std::vector<uint8_t*> levelOutputs;
+  const char* reason = nullptr;
+  const char* message = nullptr;
+  int32_t framePoolDepth = 0;
+  FrameMeta meta;
+};
+
+// Queued reads, so StopCapture can cancel the ones that have not started.
+// Only touched on the JS thread.
+std::unordered_set<ReadFrameWork*> g_pendingReads;
+
+void ExecuteReadFrame(napi_env /*env*/, void* data) {
+  auto* job = static_cast<ReadFrameWork*>(data);
+  const std::shared_ptr<CaptureSession> sessionRef = FindSession(job->sessionId);
+  if (!sessionRef) {
+    job->reason = "CANCELLED";
+    job->message = "Capture stopped before the frame was read.";
+    return;
+  }
+
+  CaptureSession* session = sessionRef.get();
+  uint8_t* output = job->output;
+  if (!output) {
+    job->lease = session->framePool->Acquire();
+    if (!job->lease || IsCoverageTestFlagEnabled("CURSORCINE_NATIVE_TEST_FORCE_POOL_EXHAUSTED") ||
+        !AcquireLevelLeases(session, &job->levelLeases, &job->levelOutputs)) {
+      job->lease.reset();
+      job->reason = "POOL_EXHAUSTED";
+      job->message = "All pooled frame buffers are still referenced.";
+      job->framePoolDepth = session->framePool->depth();
+      return;
+    }
+    output = job->lease->data();
+  }
+
+  std::lock_guard<std::mutex> captureLock(session->captureMutex);
+  if (!CaptureFrame(session, output, job->stride, job->levelOutputs.empty() ? nullptr : job->levelOutputs.data())) {
+    job->lease.reset();
+    job->levelLeases.clear();
+    job->reason = "READ_FAILED";
+    job->message = "BitBlt failed.";
+    return;
+  }
+  job->meta = SnapshotFrameMeta(session, job->stride);
+}
+
+void CompleteReadFrame(napi_env env, napi_status status, void* data) {
+  std::unique_ptr<ReadFrameWork> job(static_cast<ReadFrameWork*>(data));
+  g_pendingReads.erase(job.get());
+
+  napi_value result = MakeObject(env);
+  if (status == napi_cancelled) {
+    SetFailure(env, result, "CANCELLED", "Capture stopped before the frame was read.");
+  } else if (job->reason) {
+    SetFailure(env, result, job->reason, job->message);
+    if (job->framePoolDepth > 0) {
+      SetNamed(env, result, "framePoolDepth", MakeInt32(env, job->framePoolDepth));
+    }
+  } else {
+    const auto marshalStart = std::chrono::steady_clock::now();
+    SetFrameMeta(env, result, job->meta);
+    if (job->intoTarget) {
+      SetNamed(env, result, "offset", MakeDouble(env, job->offset));
+      SetNamed(env, result, "byteLength", MakeDouble(env, job->byteLength));
+    } else {
+      const char* bufferMode = "direct";
+      napi_value bytes = nullptr;
+      std::vector<napi_value> levelBytes;
+      if (job->lease) {
+        bytes = WrapFrameLease(env, std::move(job->lease), &bufferMode);
+        for (std::unique_ptr<pixel_pipeline::FrameLease>& levelLease : job->levelLeases) {
+          const char* levelMode = nullptr;
+          levelBytes.push_back(WrapFrameLease(env, std::move(levelLease), &levelMode));
+        }
+      } else {
+        assert(napi_get_reference_value(env, job->outputRef, &bytes) == napi_ok);
+        for (napi_ref levelRef : job->levelRefs) {
+          napi_value levelBuffer = nullptr;
+          assert(napi_get_reference_value(env, levelRef, &levelBuffer) == napi_ok);
+          levelBytes.push_back(levelBuffer);
+        }
+      }
+      SetNamed(env, result, "bytes", bytes);
+      SetNamed(env, result, "bufferMode", MakeString(env, bufferMode));
+      SetOutputLevels(env, result, job->meta, bytes, levelBytes);
+    }
+    // The session may have stopped while the work was queued.
+    if (const std::shared_ptr<CaptureSession> session = FindSession(job->sessionId)) {
+      session->stats.Record(pixel_pipeline::CaptureStage::kMarshal, ElapsedMs(marshalStart));
+    }
+  }
+
+  if (job->outputRef) {
+    napi_delete_reference(env, job->outputRef);
+  }
+  for (napi_ref levelRef : job->levelRefs) {
+    napi_delete_reference(env, levelRef);
+  }
+  napi_delete_async_work(env, job->work);
+  assert(napi_resolve_deferred(env, job->deferred, result) == napi_ok);
+}
+
+// Promise-returning readFrame/readFrameInto: capture and the pixel pipeline
+// run on the libuv thread pool, only marshalling happens on the JS thread.
+// With payload.target the frame lands in the caller's buffer (which must not
+// be detached or resized while the read is in flight). Always resolves;
+// failures use the same {ok:false, reason} shape as the sync calls.
+napi_value ReadFrameAsync(napi_env env, napi_callback_info info) {
+  napi_deferred deferred = nullptr;
+  napi_value promise = nullptr;
+  assert(napi_create_promise(env, &deferred, &promise) == napi_ok);
+
+  napi_value result = MakeObject(env);
+  auto resolveNow = [&]() {
+    assert(napi_resolve_deferred(env, deferred, result) == napi_ok);
+    return promise;
+  };
+  napi_value payload = GetFirstArg(env, info);
+  const int32_t nativeSessionId = GetNamedInt32(env, payload, "nativeSessionId", 0);
+  if (!IsSessionReachable(nativeSessionId)) {
+    SetFailure(env, result, "NOT_WINDOWS", "Frame path is Windows-only.");
+    return resolveNow();
+  }
+  if (nativeSessionId <= 0) {
+    SetFailure(env, result, "INVALID_SESSION", "Invalid native session id.");
+    return resolveNow();
+  }
+
+  auto job = std::make_unique<ReadFrameWork>();
+  job->env = env;
+  job->sessionId = nativeSessionId;
+  napi_value target = nullptr;
+  const bool hasTarget = GetNamedProperty(env, payload, "target", &target);
+  {
+    const std::shared_ptr<CaptureSession> session = FindSession(nativeSessionId);
+    if (!session) {
+      SetFailure(env, result, "INVALID_SESSION", "Native session not found.");
+      return resolveNow();
+    }
+    if (session->continuous) {
+      SetFailure(env, result, "CONTINUOUS_SESSION", "Continuous sessions are read with readLatest.");
+      return resolveNow();
+    }
+    job->stride = session->outputStride;
+    if (hasTarget) {
+      FrameTarget frameTarget;
+      if (!ResolveFrameTarget(env, payload, target, session.get(), result, &frameTarget)) {
+        return resolveNow();
+      }
+      job->intoTarget = true;
+      job->output = frameTarget.data + static_cast<size_t>(frameTarget.offset);
+      job->stride = frameTarget.stride;
+      job->offset = frameTarget.offset;
+      job->byteLength = frameTarget.requiredBytes - frameTarget.offset;
+    } else if (!g_externalBuffersAllowed) {
+      void* data = nullptr;
+      std::vector<napi_value> levelBuffers;
+      if (napi_create_buffer(env, session->framePool->slabBytes(), &data, &target) != napi_ok ||
+          !CreateLevelBuffers(env, session.get(), &levelBuffers, &job->levelOutputs)) {
+        SetFailure(env, result, "READ_FAILED", "Frame buffer allocation failed.");
+        return resolveNow();
+      }
+      job->output = static_cast<uint8_t*>(data);
+      for (napi_value levelBuffer : levelBuffers) {
+        napi_ref levelRef = nullptr;
+        assert(napi_create_reference(env, levelBuffer, 1, &levelRef) == napi_ok);
+        job->levelRefs.push_back(levelRef);
+      }
+    }
+  }
+  if (job->output) {
+    assert(napi_create_reference(env, target, 1, &job->outputRef) == napi_ok);
+  }
+
+  napi_value resourceName = MakeString(env, "cursorcine:readFrameAsync");
+  job->deferred = deferred;
+  assert(napi_create_async_work(
+             env, nullptr, resourceName, ExecuteReadFrame, CompleteReadFrame, job.get(), &job->work) == napi_ok);
+  assert(napi_queue_async_work(env, job->work) == napi_ok);
+  g_pendingReads.insert(job.release());
+  return promise;
+}
+
+bool AcquireFrame(pixel_pipeline::TripleBuffer* frames) {
+  return frames->AcquireLatest();
+}
+
+bool AcquireFrame(pixel_pipeline::FrameQueue* queue) {
+  return queue->AcquireNext();
+}
+
+// Copies the channel's next frame into a new Buffer or `target` and fills
+// the readLatest result. Caller holds the session's captureMutex.
+template <typename Channel>
+void DeliverContinuousFrame(napi_env env,
+                            napi_value result,
+                            CaptureSession* session,
+                            Channel* channel,
+                            const FrameTarget* target) {
+  if (!AcquireFrame(channel)) {
+    SetFailure(env, result, "NO_NEW_FRAME", "No frame completed since the last readLatest.");
+    SetNamed(env, result, "sequence", MakeDouble(env, static_cast<double>(channel->ReadMeta().sequence)));
+    SetNamed(env, result, "droppedFrames", MakeDouble(env, static_cast<double>(channel->Dropped())));
+    return;
+  }
+
+  const auto marshalStart = std::chrono::steady_clock::now();
+  const pixel_pipeline::TripleBufferMeta& frame = channel->ReadMeta();
+  const int32_t rowBytes = session->outputWidth * 4;
+  int32_t stride = session->outputStride;
+  if (target) {
+    stride = target->stride;
+    uint8_t* dst = target->data + static_cast<size_t>(target->offset);
+    if (stride == session->outputStride) {
+      std::memcpy(dst, channel->ReadSlot(), channel->slotBytes());
+    } else {
+      for (int32_t y = 0; y < session->outputHeight; ++y) {
+        std::memcpy(dst + static_cast<size_t>(y) * static_cast<size_t>(stride),
+                    channel->ReadSlot() + static_cast<size_t>(y) * static_cast<size_t>(session->outputStride),
+                    static_cast<size_t>(rowBytes));
+      }
+    }
+    SetNamed(env, result, "offset", MakeDouble(env, target->offset));
+    SetNamed(env, result, "byteLength", MakeDouble(env, target->requiredBytes - target->offset));
+  } else {
+    napi_value bytes = nullptr;
+    void* copied = nullptr;
+    assert(napi_create_buffer_copy(env, channel->slotBytes(), channel->ReadSlot(), &copied, &bytes) == napi_ok);
+    SetNamed(env, result, "bytes", bytes);
+    SetNamed(env, result, "bufferMode", MakeString(env, "copied"));
+  }
+
+  FrameMeta meta;
+  meta.width = session->outputWidth;
+  meta.height = session->outputHeight;
+  meta.stride = stride;
+  meta.layout = session->pipeline.output;
+  meta.yuvRange = session->yuvRange;
+  meta.timestampMs = frame.timestampMs;
+  meta.captureMs = frame.captureMs;
+  meta.processMs = frame.processMs;
+  meta.viewport = CaptureRect{frame.sourceX, frame.sourceY, frame.sourceWidth, frame.sourceHeight};
+  SetFrameMeta(env, result, meta);
+  SetNamed(env, result, "sequence", MakeDouble(env, static_cast<double>(frame.sequence)));
+  SetNamed(env, result, "droppedFrames", MakeDouble(env, static_cast<double>(channel->Dropped())));
+  session->stats.Record(pixel_pipeline::CaptureStage::kMarshal, ElapsedMs(marshalStart));
+}
+
+// Copies the newest ring frame after `*lastSequence` into a new Buffer or
+// `target` and fills a read result like DeliverContinuousFrame; frames skipped
+// since `*lastSequence` add to `*dropped`. `latencyMs` is how long the frame sat in the ring.
+// Returns false (NO_NEW_FRAME) when there is none, including when the writer
+// kept overwriting the slot faster than it could be copied.
+bool DeliverRingFrame(napi_env env,
+                      napi_value result,
+                      const pixel_pipeline::FrameRingReader* reader,
+                      const FrameTarget* target,
+                      uint64_t* lastSequence,
+                      uint64_t* dropped) {
+  const pixel_pipeline::FrameRingFormat& format = reader->format();
+  pixel_pipeline::FrameRingFrame frame;
+  bool copied = false;
+  int32_t stride = format.stride;
+  napi_value bytes = nullptr;
+  if (reader->Published() > *lastSequence) {
+    if (target) {
+      stride = target->stride;
+      copied = reader->CopyLatest(*lastSequence, target->data + static_cast<size_t>(target->offset), stride, &frame);
+    } else {
+      void* data = nullptr;
+      assert(napi_create_buffer(env, format.frameBytes, &data, &bytes) == napi_ok);
+      copied = reader->CopyLatest(*lastSequence, static_cast<uint8_t*>(data), stride, &frame);
+    }
+  }
+  if (!copied) {
+    SetFailure(env, result, "NO_NEW_FRAME", "No frame completed since the last read.");
+    SetNamed(env, result, "sequence", MakeDouble(env, static_cast<double>(*lastSequence)));
+    SetNamed(env, result, "droppedFrames", MakeDouble(env, static_cast<double>(*dropped)));
+    return false;
+  }
+  if (frame.sequence > *lastSequence + 1) {
+    *dropped += frame.sequence - *lastSequence - 1;
+  }
+  *lastSequence = frame.sequence;
+  if (target) {
+    SetNamed(env, result, "offset", MakeDouble(env, target->offset));
+    SetNamed(env, result, "byteLength", MakeDouble(env, target->requiredBytes - target->offset));
+  } else {
+    SetNamed(env, result, "bytes", bytes);
+    SetNamed(env, result, "bufferMode", MakeString(env, "copied"));
+  }
+
+  FrameMeta meta;
+  meta.width = format.width;
+  meta.height = format.height;
+  meta.stride = stride;
+  meta.layout = pixel_pipeline::ComputeFrameLayout(format.format, format.width, format.height);
+  meta.yuvRange = format.range;
+  meta.timestampMs = frame.timestampMs;
+  meta.captureMs = frame.captureMs;
+  meta.processMs = frame.processMs;
+  meta.viewport = CaptureRect{frame.sourceX, frame.sourceY, frame.sourceWidth, frame.sourceHeight};
+  SetFrameMeta(env, result, meta);
+  SetNamed(env, result, "sequence", MakeDouble(env, static_cast<double>(frame.sequence)));
+  SetNamed(env, result, "droppedFrames", MakeDouble(env, static_cast<double>(*dropped)));
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+  SetNamed(env, result, "latencyMs", MakeDouble(env, static_cast<double>(nowNs - frame.publishedNs) / 1e6));
+  return true;
+}
+
+// Continuous sessions only: copies the newest frame the capture thread has
+// completed (latest-only) or the oldest queued one (queue-N, with `queued`
+// left), without waiting. `sequence` counts frames produced since start;
+// `droppedFrames` counts those discarded before any readLatest saw them.
+// With payload.target the frame is written there like readFrameInto.
+napi_value ReadLatest(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  const int32_t nativeSessionId = GetNamedInt32(env, payload, "nativeSessionId", 0);
+  if (!IsSessionReachable(nativeSessionId)) {
+    SetFailure(env, result, "NOT_WINDOWS", "Frame path is Windows-only.");
+    return result;
+  }
+  if (nativeSessionId <= 0) {
+    SetFailure(env, result, "INVALID_SESSION", "Invalid native session id.");
+    return result;
+  }
+
+  napi_value target = nullptr;
+  const bool hasTarget = GetNamedProperty(env, payload, "target", &target);
+
+  const std::shared_ptr<CaptureSession> sessionRef = FindSession(nativeSessionId);
+  if (!sessionRef) {
+    SetFailure(env, result, "INVALID_SESSION", "Native session not found.");
+    return result;
+  }
+
+  CaptureSession* session = sessionRef.get();
+  if (!session->continuous) {
+    SetFailure(env, result, "NOT_CONTINUOUS", "Session was not started with continuous: true.");
+    return result;
+  }
+  FrameTarget frameTarget;
+  if (hasTarget && !ResolveFrameTarget(env, payload, target, session, result, &frameTarget)) {
+    return result;
+  }
+
+  // The capture thread is the only producer; captureMutex keeps readers to
+  // the single consumer the frame channels allow.
+  std::lock_guard<std::mutex> consumerLock(session->captureMutex);
+  session->latestReaderAttached.store(true, std::memory_order_release);
+  if (session->ring) {
+    const auto marshalStart = std::chrono::steady_clock::now();
+    if (DeliverRingFrame(env,
+                         result,
+                         session->ringReader.get(),
+                         hasTarget ? &frameTarget : nullptr,
+                         &session->ringReadSequence,
+                         &session->ringDropped)) {
+      session->stats.Record(pixel_pipeline::CaptureStage::kMarshal, ElapsedMs(marshalStart));
+    }
+  } else if (session->queue) {
+    DeliverContinuousFrame(env, result, session, session->queue.get(), hasTarget ? &frameTarget : nullptr);
+    SetNamed(env, result, "queued", MakeInt32(env, session->queue->Queued()));
+  } else {
+    DeliverContinuousFrame(env, result, session, session->frames.get(), hasTarget ? &frameTarget : nullptr);
+  }
+  SetNamed(env, result, "captureFailures",
+           MakeDouble(env, static_cast<double>(session->captureFailures.load(std::memory_order_relaxed))));
+  return result;
+}
+
+// setViewport({ nativeSessionId, x, y, width, height, margin }): capture only
+// this region of the session's bounds (capture pixels, origin at their
+// top-left) from the next frame on, still scaled to the session's output
+// size. The region is grown by `margin` (default 64) on each side, fitted to
+// the output aspect ratio and never upscaled (FitSourceRegion); without
+// width/height the whole capture comes back. Returns the region frames will
+// use; frames taken from it carry it as `viewport`.
+napi_value SetViewport(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  const int32_t nativeSessionId = GetNamedInt32(env, payload, "nativeSessionId", 0);
+  if (!IsSessionReachable(nativeSessionId)) {
+    SetFailure(env, result, "NOT_WINDOWS", "Frame path is Windows-only.");
+    return result;
+  }
+  const std::shared_ptr<CaptureSession> sessionRef = nativeSessionId > 0 ? FindSession(nativeSessionId) : nullptr;
+  if (!sessionRef) {
+    SetFailure(env, result, "INVALID_SESSION", "Native session not found.");
+    return result;
+  }
+  CaptureSession* session = sessionRef.get();
+  CaptureRect viewport;
+  viewport.x = GetNamedInt32(env, payload, "x", 0);
+  viewport.y = GetNamedInt32(env, payload, "y", 0);
+  viewport.width = GetNamedInt32(env, payload, "width", 0);
+  viewport.height = GetNamedInt32(env, payload, "height", 0);
+  pixel_pipeline::FitSourceRegion(session->rect.width,
+                                  session->rect.height,
+                                  session->outputWidth,
+                                  session->outputHeight,
+                                  GetNamedInt32(env, payload, "margin", kDefaultViewportMargin),
+                                  &viewport.x,
+                                  &viewport.y,
+                                  &viewport.width,
+                                  &viewport.height);
+  {
+    std::lock_guard<std::mutex> lock(session->viewportMutex);
+    session->pendingViewport = viewport;
+    session->viewportPending = true;
+  }
+
+  napi_value applied = MakeObject(env);
+  SetNamed(env, applied, "x", MakeInt32(env, viewport.x));
+  SetNamed(env, applied, "y", MakeInt32(env, viewport.y));
+  SetNamed(env, applied, "width", MakeInt32(env, viewport.width));
+  SetNamed(env, applied, "height", MakeInt32(env, viewport.height));
+  SetNamed(env, result, "ok", MakeBool(env, true));
+  SetNamed(env, result, "viewport", applied);
+  SetNamed(env, result, "captureWidth", MakeInt32(env, session->rect.width));
+  SetNamed(env, result, "captureHeight", MakeInt32(env, session->rect.height));
+  return result;
+}
+
+napi_value MakeHistogramSummary(napi_env env, const pixel_pipeline::Histogram::Summary& summary) {
+  napi_value out = MakeObject(env);
+  SetNamed(env, out, "count", MakeDouble(env, static_cast<double>(summary.count)));
+  SetNamed(env, out, "mean", MakeDouble(env, summary.meanMs));
+  SetNamed(env, out, "p50", MakeDouble(env, summary.p50Ms));
+  SetNamed(env, out, "p95", MakeDouble(env, summary.p95Ms));
+  SetNamed(env, out, "p99", MakeDouble(env, summary.p99Ms));
+  SetNamed(env, out, "max", MakeDouble(env, summary.maxMs));
+  SetNamed(env, out, "bucketMs", MakeDouble(env, summary.bucketMs));
+  napi_value counts = nullptr;
+  assert(napi_create_array_with_length(env, summary.counts.size(), &counts) == napi_ok);
+  for (size_t i = 0; i < summary.counts.size(); ++i) {
+    assert(napi_set_element(env, counts, static_cast<uint32_t>(i),
+                            MakeDouble(env, static_cast<double>(summary.counts[i]))) == napi_ok);
+  }
+  SetNamed(env, out, "counts", counts);
+  return out;
+}
+
+// Continuous sessions only: the capture thread's pacing so far. `intervalMs`
+// is the time between consecutive frame starts, `jitterMs` how late each
+// frame started against its deadline; both are histograms in milliseconds.
+napi_value GetPacingStats(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  const int32_t nativeSessionId = GetNamedInt32(env, payload, "nativeSessionId", 0);
+  if (!IsSessionReachable(nativeSessionId)) {
+    SetFailure(env, result, "NOT_WINDOWS", "Frame path is Windows-only.");
+    return result;
+  }
+  const std::shared_ptr<CaptureSession> sessionRef = nativeSessionId > 0 ? FindSession(nativeSessionId) : nullptr;
+  if (!sessionRef) {
+    SetFailure(env, result, "INVALID_SESSION", "Native session not found.");
+    return result;
+  }
+  const CaptureSession* session = sessionRef.get();
+  if (!session->continuous) {
+    SetFailure(env, result, "NOT_CONTINUOUS", "Session was not started with continuous: true.");
+    return result;
+  }
+
+  const pixel_pipeline::FramePacer* pacer = session->pacer.get();
+  SetNamed(env, result, "ok", MakeBool(env, true));
+  SetNamed(env, result, "targetFps", MakeDouble(env, pacer->fps()));
+  SetNamed(env, result, "frames", MakeDouble(env, static_cast<double>(pacer->Frames())));
+  SetNamed(env, result, "missedDeadlines", MakeDouble(env, static_cast<double>(pacer->MissedDeadlines())));
+  SetNamed(env, result, "published",
+           MakeDouble(env,
+                      static_cast<double>(session->ring    ? session->ringReader->Published()
+                                          : session->queue ? session->queue->Published()
+                                                           : session->frames->Published())));
+  SetNamed(env, result, "captureFailures",
+           MakeDouble(env, static_cast<double>(session->captureFailures.load(std::memory_order_relaxed))));
+  SetNamed(env, result, "intervalMs", MakeHistogramSummary(env, pacer->Intervals().Snapshot()));
+  SetNamed(env, result, "jitterMs", MakeHistogramSummary(env, pacer->Jitter().Snapshot()));
+  return result;
+}
+
+// The encoderPipe counters in getStats and stopCapture results.
+napi_value MakeEncoderPipeStats(napi_env env, const pixel_pipeline::FramePipeStats& stats) {
+  napi_value result = MakeObject(env);
+  SetNamed(env, result, "framesWritten", MakeDouble(env, static_cast<double>(stats.framesWritten)));
+  SetNamed(env, result, "bytesWritten", MakeDouble(env, static_cast<double>(stats.bytesWritten)));
+  SetNamed(env, result, "framesDropped", MakeDouble(env, static_cast<double>(stats.framesDropped)));
+  SetNamed(env, result, "writeCalls", MakeDouble(env, static_cast<double>(stats.writeCalls)));
+  SetNamed(env, result, "stallMs", MakeDouble(env, stats.stallMs));
+  SetNamed(env, result, "queued", MakeInt32(env, stats.queued));
+  SetNamed(env, result, "failed", MakeBool(env, stats.failed));
+  if (stats.failed) {
+    SetNamed(env, result, "error", MakeString(env, stats.error));
+  }
+  return result;
+}
+
+// Any session: where each frame's time went. `stages` holds one histogram per
+// stage (capture, cursor, decode, process, scale, tonemap, convert, marshal;
+// scale/tonemap/convert come from every `sampleInterval`th frame and sum
+// thread time across bands). `totalMs` adds up capture through process per
+// frame; frames over `budgetMs` are counted against their slowest stage in
+// `overBudgetByStage`. payload.reset clears everything after reading.
+napi_value GetStats(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  const int32_t nativeSessionId = GetNamedInt32(env, payload, "nativeSessionId", 0);
+  if (!IsSessionReachable(nativeSessionId)) {
+    SetFailure(env, result, "NOT_WINDOWS", "Frame path is Windows-only.");
+    return result;
+  }
+  const std::shared_ptr<CaptureSession> sessionRef = nativeSessionId > 0 ? FindSession(nativeSessionId) : nullptr;
+  if (!sessionRef) {
+    SetFailure(env, result, "INVALID_SESSION", "Native session not found.");
+    return result;
+  }
+  CaptureSession* session = sessionRef.get();
+  const pixel_pipeline::StageStats::Snapshot snapshot = session->stats.Snap();
+  if (GetNamedBool(env, payload, "reset", false)) {
+    session->stats.Reset();
+  }
+
+  napi_value stages = MakeObject(env);
+  napi_value overBudgetByStage = MakeObject(env);
+  for (int32_t i = 0; i < pixel_pipeline::kCaptureStageCount; ++i) {
+    const auto stage = static_cast<pixel_pipeline::CaptureStage>(i);
+    const char* name = pixel_pipeline::CaptureStageName(stage);
+    SetNamed(env, stages, name, MakeHistogramSummary(env, snapshot.stages[i]));
+    if (pixel_pipeline::IsFrameStage(stage)) {
+      SetNamed(env, overBudgetByStage, name, MakeDouble(env, static_cast<double>(snapshot.overBudgetByStage[i])));
+    }
+  }
+  SetNamed(env, result, "ok", MakeBool(env, true));
+  SetNamed(env, result, "frames", MakeDouble(env, static_cast<double>(snapshot.frames)));
+  SetNamed(env, result, "failures", MakeDouble(env, static_cast<double>(snapshot.failures)));
+  SetNamed(env, result, "budgetMs", MakeDouble(env, session->frameBudgetMs));
+  SetNamed(env, result, "overBudgetFrames", MakeDouble(env, static_cast<double>(snapshot.overBudgetFrames)));
+  SetNamed(env, result, "overBudgetByStage", overBudgetByStage);
+  SetNamed(env, result, "sampleInterval", MakeDouble(env, static_cast<double>(kStageSampleInterval)));
+  SetNamed(env, result, "stages", stages);
+  SetNamed(env, result, "totalMs", MakeHistogramSummary(env, snapshot.total));
+  if (session->encoder) {
+    SetNamed(env, result, "encoderPipe", MakeEncoderPipeStats(env, session->encoder->Stats()));
+  }
+  return result;
+}
+
+// encodeFrameDelta({ base, frame, maxBytes }): the frame_delta encoding of
+// `frame` against `base` (equal-length byte views) as a Buffer. No capture
+// session is involved, so it works on every platform; the frame server uses
+// it for the HTTP transport. DELTA_TOO_LARGE means the raw frame is smaller
+// than `maxBytes` (default: the frame size) allows and should be sent as is.
+napi_value EncodeFrameDelta(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  napi_value baseValue = nullptr;
+  napi_value frameValue = nullptr;
+  uint8_t* base = nullptr;
+  uint8_t* frame = nullptr;
+  size_t baseBytes = 0;
+  size_t frameBytes = 0;
+  if (!GetNamedProperty(env, payload, "base", &baseValue) || !GetNamedProperty(env, payload, "frame", &frameValue) ||
+      !GetWritableBytes(env, baseValue, &base, &baseBytes) || !GetWritableBytes(env, frameValue, &frame, &frameBytes)) {
+    SetFailure(env, result, "INVALID_ARGUMENT", "base and frame must be ArrayBuffers or views.");
+    return result;
+  }
+  if (baseBytes != frameBytes) {
+    SetFailure(env, result, "SIZE_MISMATCH", "base and frame differ in length.");
+    return result;
+  }
+  const double maxBytes = GetNamedNumber(env, payload, "maxBytes", static_cast<double>(frameBytes));
+  std::vector<uint8_t> encoded;
+  pixel_pipeline::FrameDeltaStats stats;
+  if (!pixel_pipeline::EncodeFrameDelta(
+          base, frame, frameBytes, static_cast<size_t>(std::max(0.0, maxBytes)), &encoded, &stats)) {
+    SetFailure(env, result, "DELTA_TOO_LARGE", "Delta would exceed maxBytes.");
+    return result;
+  }
+  napi_value bytes;
+  assert(napi_create_buffer_copy(env, encoded.size(), encoded.data(), nullptr, &bytes) == napi_ok);
+  SetNamed(env, result, "ok", MakeBool(env, true));
+  SetNamed(env, result, "bytes", bytes);
+  SetNamed(env, result, "encodedBytes", MakeDouble(env, static_cast<double>(stats.encodedBytes)));
+  SetNamed(env, result, "frameBytes", MakeDouble(env, static_cast<double>(frameBytes)));
+  SetNamed(env, result, "changedTiles", MakeDouble(env, static_cast<double>(stats.changedTiles)));
+  return result;
+}
+
+// decodeFrameDelta({ base, delta }): applies `delta` to `base` in place.
+napi_value DecodeFrameDelta(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  napi_value baseValue = nullptr;
+  napi_value deltaValue = nullptr;
+  uint8_t* base = nullptr;
+  uint8_t* delta = nullptr;
+  size_t baseBytes = 0;
+  size_t deltaBytes = 0;
+  if (!GetNamedProperty(env, payload, "base", &baseValue) || !GetNamedProperty(env, payload, "delta", &deltaValue) ||
+      !GetWritableBytes(env, baseValue, &base, &baseBytes) || !GetWritableBytes(env, deltaValue, &delta, &deltaBytes)) {
+    SetFailure(env, result, "INVALID_ARGUMENT", "base and delta must be ArrayBuffers or views.");
+    return result;
+  }
+  if (!pixel_pipeline::DecodeFrameDelta(delta, deltaBytes, base, baseBytes)) {
+    SetFailure(env, result, "INVALID_DELTA", "Delta does not apply to this base.");
+    return result;
+  }
+  SetNamed(env, result, "ok", MakeBool(env, true));
+  SetNamed(env, result, "frameBytes", MakeDouble(env, static_cast<double>(baseBytes)));
+  return result;
+}
+
+// A frame ring opened by name (openFrameRing), usually one another process's
+// session writes. `mutex` guards the read position.
+struct OpenRing {
+  std::unique_ptr<pixel_pipeline::FrameRingReader> reader;
+  std::mutex mutex;
+  uint64_t readSequence = 0;
+  uint64_t dropped = 0;
+};
+
+std::mutex g_ringsMutex;
+std::unordered_map<int32_t, std::shared_ptr<OpenRing>> g_rings;
+int32_t g_nextRingId = 1;
+
+std::shared_ptr<OpenRing> FindRing(int32_t ringId) {
+  std::lock_guard<std::mutex> lock(g_ringsMutex);
+  const auto it = g_rings.find(ringId);
+  return it == g_rings.end() ? nullptr : it->second;
+}
+
+// openFrameRing({ name }): attaches to the shared frame ring a session
+// started with sharedRing: { name } publishes. Like the delta helpers it needs
+// no capture backend, so a reader can run in any process on the machine.
+napi_value OpenFrameRing(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  std::string error;
+  auto ring = std::make_shared<OpenRing>();
+  ring->reader = pixel_pipeline::FrameRingReader::Open(GetNamedString(env, payload, "name"), &error);
+  if (!ring->reader) {
+    SetFailure(env, result, "RING_UNAVAILABLE", error.c_str());
+    return result;
+  }
+  // Frames published before the reader attached are not counted as dropped.
+  ring->readSequence = ring->reader->Published();
+  const pixel_pipeline::FrameRingFormat& format = ring->reader->format();
+  int32_t ringId = 0;
+  {
+    std::lock_guard<std::mutex> lock(g_ringsMutex);
+    ringId = g_nextRingId++;
+    g_rings[ringId] = ring;
+  }
+  SetNamed(env, result, "ok", MakeBool(env, true));
+  SetNamed(env, result, "ringId", MakeInt32(env, ringId));
+  SetNamed(env, result, "name", MakeString(env, ring->reader->name()));
+  SetNamed(env, result, "slots", MakeInt32(env, ring->reader->slots()));
+  SetNamed(env, result, "width", MakeInt32(env, format.width));
+  SetNamed(env, result, "height", MakeInt32(env, format.height));
+  SetNamed(env, result, "stride", MakeInt32(env, format.stride));
+  SetNamed(env, result, "byteLength", MakeDouble(env, static_cast<double>(format.frameBytes)));
+  SetPixelFormat(env,
+                 result,
+                 pixel_pipeline::ComputeFrameLayout(format.format, format.width, format.height),
+                 format.range);
+  return result;
+}
+
+// readFrameRing({ ringId, target?, offset?, stride? }): the newest frame
+// published since the previous read, shaped like a readLatest result plus
+// `latencyMs` (publish to copy). NO_NEW_FRAME when there is none yet.
+napi_value ReadFrameRing(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  const std::shared_ptr<OpenRing> ring = FindRing(GetNamedInt32(env, payload, "ringId", 0));
+  if (!ring) {
+    SetFailure(env, result, "INVALID_RING", "Frame ring not found.");
+    return result;
+  }
+  const pixel_pipeline::FrameRingFormat& format = ring->reader->format();
+  napi_value target;
+  FrameTarget frameTarget;
+  const bool hasTarget = GetNamedProperty(env, payload, "target", &target);
+  if (hasTarget &&
+      !ResolveFrameTarget(env,
+                          payload,
+                          target,
+                          pixel_pipeline::ComputeFrameLayout(format.format, format.width, format.height),
+                          format.width,
+                          format.height,
+                          format.stride,
+                          result,
+                          &frameTarget)) {
+    return result;
+  }
+  std::lock_guard<std::mutex> lock(ring->mutex);
+  DeliverRingFrame(env,
+                   result,
+                   ring->reader.get(),
+                   hasTarget ? &frameTarget : nullptr,
+                   &ring->readSequence,
+                   &ring->dropped);
+  return result;
+}
+
+napi_value CloseFrameRing(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  std::shared_ptr<OpenRing> closed;
+  {
+    std::lock_guard<std::mutex> lock(g_ringsMutex);
+    auto it = g_rings.find(GetNamedInt32(env, payload, "ringId", 0));
+    if (it != g_rings.end()) {
+      closed = std::move(it->second);
+      g_rings.erase(it);
+    }
+  }
+  SetNamed(env, result, "ok", MakeBool(env, closed != nullptr));
+  if (!closed) {
+    SetNamed(env, result, "reason", MakeString(env, "INVALID_RING"));
+    SetNamed(env, result, "message", MakeString(env, "Frame ring not found."));
+  }
+  return result;
+}
+
+napi_value StopCapture(napi_env env, napi_callback_info info) {
+  napi_value result = MakeObject(env);
+  napi_value payload = GetFirstArg(env, info);
+  const int32_t nativeSessionId = GetNamedInt32(env, payload, "nativeSessionId", 0);
+  if (!IsSessionReachable(nativeSessionId)) {
+    SetNamed(env, result, "ok", MakeBool(env, true));
+    SetNamed(env, result, "skipped", MakeBool(env, true));
+    return result;
+  }
+  if (nativeSessionId <= 0) {
+    SetNamed(env, result, "ok", MakeBool(env, false));
+    SetNamed(env, result, "reason", MakeString(env, "INVALID_SESSION"));
+    SetNamed(env, result, "message", MakeString(env, "Invalid native session id."));
+    return result;
+  }
+
+  // Reads still queued resolve as CANCELLED; one already running holds its
+  // own reference and finishes its frame first.
+  for (ReadFrameWork* job : g_pendingReads) {
+    if (job->env == env && job->sessionId == nativeSessionId) {
+      napi_cancel_async_work(env, job->work);
+    }
+  }
+
+  // The session (and its capture thread, which is joined on destruction) is
+  // torn down outside the registry lock.
+  std::shared_ptr<CaptureSession> stopped;
+  {
+    std::lock_guard<std::mutex> lock(g_sessionsMutex);
+    auto it = g_sessions.find(nativeSessionId);
+    if (it != g_sessions.end()) {
+      stopped = std::move(it->second);
+      g_sessions.erase(it);
+    }
+  }
+  const bool erased = stopped != nullptr;
+  if (erased && stopped->encoder) {
+    // Flushes the encoder and waits for it to exit (up to closeTimeoutMs) so
+    // its output is complete once stopCapture returns.
+    stopped->StopCaptureThread();
+    const pixel_pipeline::FramePipeExit exit = stopped->encoder->Close(stopped->encoderCloseTimeoutMs);
+    napi_value encoderPipe = MakeEncoderPipeStats(env, stopped->encoder->Stats());
+    SetNamed(env, encoderPipe, "exited", MakeBool(env, exit.exited));
+    SetNamed(env, encoderPipe, "exitCode", MakeInt32(env, exit.exitCode));
+    SetNamed(env, encoderPipe, "killed", MakeBool(env, exit.killed));
+    SetNamed(env, result, "encoderPipe", encoderPipe);
+  }
+  stopped.reset();
+  SetNamed(env, result, "ok", MakeBool(env, erased));
+  if (!erased) {
+    SetNamed(env, result, "reason", MakeString(env, "INVALID_SESSION"));
+    SetNamed(env, result, "message", MakeString(env, "Native session not found."));
+  }
+  return result;
+}
+
+napi_value Init(napi_env env, napi_value exports) {
+  napi_property_descriptor desc[] = {
+      {"probe", 0, Probe, 0, 0, 0, napi_default, 0},
+      {"startCapture", 0, StartCapture, 0, 0, 0, napi_default, 0},
+      {"readFrame", 0, ReadFrame, 0, 0, 0, napi_default, 0},
+      {"readFrameInto", 0, ReadFrameInto, 0, 0, 0, napi_default, 0},
+      {"readFrameAsync", 0, ReadFrameAsync, 0, 0, 0, napi_default, 0},
+      {"readLatest", 0, ReadLatest, 0, 0, 0, napi_default, 0},
+      {"setViewport", 0, SetViewport, 0, 0, 0, napi_default, 0},
+      {"getPacingStats", 0, GetPacingStats, 0, 0, 0, napi_default, 0},
+      {"getStats", 0, GetStats, 0, 0, 0, napi_default, 0},
+      {"encodeFrameDelta", 0, EncodeFrameDelta, 0, 0, 0, napi_default, 0},
+      {"decodeFrameDelta", 0, DecodeFrameDelta, 0, 0, 0, napi_default, 0},
+      {"openFrameRing", 0, OpenFrameRing, 0, 0, 0, napi_default, 0},
+      {"readFrameRing", 0, ReadFrameRing, 0, 0, 0, napi_default, 0},
+      {"closeFrameRing", 0, CloseFrameRing, 0, 0, 0, napi_default, 0},
+      {"stopCapture", 0, StopCapture, 0, 0, 0, napi_default, 0},
+  };
+
+  assert(napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc) == napi_ok);
+  return exports;
+}
+
+}  // namespace
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
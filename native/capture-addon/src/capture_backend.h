@@ -0,0 +1,12 @@
+#ifndef CURSORCINE_CAPTURE_ADDON_CAPTURE_BACKEND_H_
+#define CURSORCINE_CAPTURE_ADDON_CAPTURE_BACKEND_H_
+
+namespace capture_addon {
+
+// Reported as `nativeBackend` by probe() and startCapture. Each addon target
+// compiles capture_addon.cc with its own backend.cc defining it.
+extern const char kBackendName[];
+
+}  // namespace capture_addon
+
+#endif  // CURSORCINE_CAPTURE_ADDON_CAPTURE_BACKEND_H_
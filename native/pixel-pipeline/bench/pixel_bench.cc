@@ -0,0 +1,702 @@
+// Linux/Windows microbenchmark for the pixel-pipeline kernels.
+//
+//   node scripts/run-native-pixel-tests.js --bench [filter]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "cursor_sprite.h"
+#include "frame_delta.h"
+#include "frame_pipeline.h"
+#include "hdr_source.h"
+#include "scale.h"
+#include "synthetic_source.h"
+#include "tone_map.h"
+#include "thread_pool.h"
+#include "tile_change.h"
+#include "tone_map_fixed.h"
+#include "tone_map_lut.h"
+#include "yuv.h"
+
+namespace {
+
+struct Resolution {
+  const char* name;
+  int32_t width;
+  int32_t height;
+};
+
+const Resolution kResolutions[] = {
+    {"640x360", 640, 360},
+    {"1080p", 1920, 1080},
+    {"4K", 3840, 2160},
+};
+
+std::vector<uint8_t> MakeFrame(int32_t width, int32_t height) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+  uint32_t seed = 0x12345678u;
+  for (uint8_t& v : pixels) {
+    seed = seed * 1664525u + 1013904223u;
+    v = static_cast<uint8_t>(seed >> 24);
+  }
+  return pixels;
+}
+
+// Runs `fn` until ~200 ms have elapsed (at least 5 iterations) and returns the
+// best per-iteration time in milliseconds.
+template <typename Fn>
+double TimeBestMs(Fn&& fn) {
+  using Clock = std::chrono::steady_clock;
+  fn();
+  double best = 1e30;
+  const auto deadline = Clock::now() + std::chrono::milliseconds(200);
+  for (int i = 0; i < 5 || Clock::now() < deadline; ++i) {
+    const auto t0 = Clock::now();
+    fn();
+    const auto t1 = Clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+  }
+  return best;
+}
+
+void Report(const char* group, const char* variant, const Resolution& res, double ms, double baselineMs) {
+  const double pixels = static_cast<double>(res.width) * static_cast<double>(res.height);
+  const double nsPerPixel = ms * 1e6 / pixels;
+  const double gbPerSec = (pixels * 8.0) / (ms * 1e6);
+  std::printf("%-10s %-18s %-8s %8.3f ms  %6.3f ns/px  %6.2f GB/s  %7.1f fps  x%.2f\n",
+              group,
+              variant,
+              res.name,
+              ms,
+              nsPerPixel,
+              gbPerSec,
+              1000.0 / ms,
+              baselineMs / ms);
+}
+
+// Every available kernel (scalar reference, each supported SIMD kernel, LUT)
+// across a matrix of ToneMapConfig values and source HDR state.
+void BenchToneMap() {
+  struct Variant {
+    const char* name;
+    bool hdrLikely;
+    float rolloff;
+    float saturation;
+    pixel_pipeline::ToneMapProfile profile;
+  };
+  const pixel_pipeline::ToneMapProfile kRolloff = pixel_pipeline::ToneMapProfile::kRec709Rolloff;
+  // The profile curves only exist as tables; their speedup column is relative
+  // to `rolloff/lut`.
+  const Variant variants[] = {
+      {"sdr", false, 0.35f, 1.0f, kRolloff},
+      {"sdr+sat", false, 0.35f, 1.2f, kRolloff},
+      {"rolloff", true, 0.35f, 1.0f, kRolloff},
+      {"rolloff=1", true, 1.0f, 1.0f, kRolloff},
+      {"rolloff+sat", true, 0.35f, 1.2f, kRolloff},
+      {"pq", true, 0.0f, 1.0f, pixel_pipeline::ToneMapProfile::kBt2390Pq},
+      {"hlg", true, 0.0f, 1.0f, pixel_pipeline::ToneMapProfile::kHlg},
+      {"hable", true, 0.0f, 1.0f, pixel_pipeline::ToneMapProfile::kHable},
+      {"pq+sat", true, 0.0f, 1.2f, pixel_pipeline::ToneMapProfile::kBt2390Pq},
+  };
+  const pixel_pipeline::ToneMapKernel simdKernels[] = {
+      pixel_pipeline::ToneMapKernel::kSse41, pixel_pipeline::ToneMapKernel::kAvx2, pixel_pipeline::ToneMapKernel::kNeon};
+  for (const Resolution& res : kResolutions) {
+    const std::vector<uint8_t> src = MakeFrame(res.width, res.height);
+    std::vector<uint8_t> dst(src.size());
+    const size_t pixelCount = src.size() / 4;
+    double rolloffLutMs = 0.0;
+    for (const Variant& variant : variants) {
+      pixel_pipeline::ToneMapConfig cfg;
+      cfg.rolloff = variant.rolloff;
+      cfg.saturation = variant.saturation;
+      cfg.profile = variant.profile;
+      char name[32];
+      if (variant.profile != kRolloff) {
+        pixel_pipeline::ToneMapLut lut;
+        pixel_pipeline::BuildToneMapLut(variant.hdrLikely, cfg, &lut);
+        const double lutMs = TimeBestMs([&] {
+          pixel_pipeline::ApplyToneMapLut(src.data(), dst.data(), pixelCount, lut);
+        });
+        std::snprintf(name, sizeof(name), "%s/lut", variant.name);
+        Report("tonemap", name, res, lutMs, rolloffLutMs);
+        continue;
+      }
+      const pixel_pipeline::ToneMapParams params = pixel_pipeline::ResolveToneMapParams(variant.hdrLikely, cfg);
+      const double scalarMs = TimeBestMs([&] {
+        pixel_pipeline::ToneMapBgraToRgbaScalar(src.data(), dst.data(), pixelCount, params);
+      });
+      std::snprintf(name, sizeof(name), "%s/scalar", variant.name);
+      Report("tonemap", name, res, scalarMs, scalarMs);
+      for (pixel_pipeline::ToneMapKernel kernel : simdKernels) {
+        const pixel_pipeline::ToneMapFn fn = pixel_pipeline::GetToneMapKernel(kernel);
+        if (!fn) {
+          continue;
+        }
+        const double simdMs = TimeBestMs([&] { fn(src.data(), dst.data(), pixelCount, params); });
+        std::snprintf(name, sizeof(name), "%s/%s", variant.name, pixel_pipeline::ToneMapKernelName(kernel));
+        Report("tonemap", name, res, simdMs, scalarMs);
+      }
+      pixel_pipeline::ToneMapLut lut;
+      pixel_pipeline::BuildToneMapLut(variant.hdrLikely, cfg, &lut);
+      const double lutMs = TimeBestMs([&] {
+        pixel_pipeline::ApplyToneMapLut(src.data(), dst.data(), pixelCount, lut);
+      });
+      std::snprintf(name, sizeof(name), "%s/lut", variant.name);
+      Report("tonemap", name, res, lutMs, scalarMs);
+      if (std::strcmp(variant.name, "rolloff") == 0) {
+        rolloffLutMs = lutMs;
+      }
+    }
+  }
+}
+
+// Two-pass (scale/memcpy into a frame buffer, then tone-map it) vs. the fused
+// single-pass pipeline, from a 4K source to each output size.
+void BenchFused() {
+  const Resolution source = kResolutions[2];
+  const std::vector<uint8_t> src = MakeFrame(source.width, source.height);
+  pixel_pipeline::ToneMapConfig cfg;
+  cfg.rolloff = 0.35f;
+  for (const Resolution& out : kResolutions) {
+    pixel_pipeline::FramePipeline pipeline;
+    pixel_pipeline::BuildFramePipeline(
+        source.width, source.height, out.width, out.height, true, cfg, &pipeline);
+    std::vector<uint8_t> frame(static_cast<size_t>(out.width) * static_cast<size_t>(out.height) * 4);
+    const bool identity = pipeline.scale.IsIdentity();
+
+    const double scaleMs = TimeBestMs([&] {
+      if (identity) {
+        std::memcpy(frame.data(), src.data(), frame.size());
+      } else {
+        pixel_pipeline::ScaleBgraNearest(
+            src.data(), source.width, source.height, source.width * 4, &frame, out.width, out.height);
+      }
+    });
+    const double toneMapMs = TimeBestMs([&] {
+      pixel_pipeline::ApplyPreparedToneMap(frame.data(), frame.data(), frame.size() / 4, pipeline.toneMap);
+    });
+    const double fusedMs = TimeBestMs([&] {
+      pixel_pipeline::ProcessFrame(src.data(), source.width * 4, frame.data(), out.width * 4, pipeline);
+    });
+    const double twoPassMs = scaleMs + toneMapMs;
+    Report("fused", identity ? "two-pass/memcpy" : "two-pass/scale", out, scaleMs, twoPassMs);
+    Report("fused", "two-pass/tonemap", out, toneMapMs, twoPassMs);
+    Report("fused", "two-pass/total", out, twoPassMs, twoPassMs);
+    Report("fused", "single-pass", out, fusedMs, twoPassMs);
+  }
+}
+
+// Scaler modes from a 4K source to each smaller output size, scale + tone map
+// fused, against the legacy point sampler. Scalar rows force the portable
+// filter kernels for comparison.
+void BenchScale() {
+  const Resolution source = kResolutions[2];
+  const std::vector<uint8_t> src = MakeFrame(source.width, source.height);
+  const pixel_pipeline::ScalerMode modes[] = {
+      pixel_pipeline::ScalerMode::kNearest, pixel_pipeline::ScalerMode::kBox, pixel_pipeline::ScalerMode::kBilinear};
+  for (const Resolution& out : kResolutions) {
+    if (out.width == source.width && out.height == source.height) {
+      continue;
+    }
+    std::vector<uint8_t> frame(static_cast<size_t>(out.width) * static_cast<size_t>(out.height) * 4);
+    const double legacyMs = TimeBestMs([&] {
+      pixel_pipeline::ScaleBgraNearest(
+          src.data(), source.width, source.height, source.width * 4, &frame, out.width, out.height);
+    });
+    Report("scale", "legacy-nearest", out, legacyMs, legacyMs);
+    for (pixel_pipeline::ScalerMode mode : modes) {
+      pixel_pipeline::FramePipeline pipeline;
+      pixel_pipeline::BuildFramePipeline(source.width,
+                                         source.height,
+                                         out.width,
+                                         out.height,
+                                         false,
+                                         pixel_pipeline::ToneMapConfig(),
+                                         &pipeline,
+                                         mode);
+      const double ms = TimeBestMs([&] {
+        pixel_pipeline::ProcessFrame(src.data(), source.width * 4, frame.data(), out.width * 4, pipeline);
+      });
+      Report("scale", pixel_pipeline::ScalerModeName(mode), out, ms, legacyMs);
+    }
+    pixel_pipeline::ScalePlan plan;
+    pixel_pipeline::BuildScalePlan(
+        source.width, source.height, out.width, out.height, &plan, pixel_pipeline::ScalerMode::kBox);
+    std::vector<int16_t> scratch(pixel_pipeline::FilterScratchSize(plan));
+    std::vector<const uint8_t*> rows(static_cast<size_t>(plan.vertical.weightStride));
+    const double scalarMs = TimeBestMs([&] {
+      for (int32_t y = 0; y < out.height; ++y) {
+        const int32_t first = plan.vertical.start[static_cast<size_t>(y)];
+        for (int32_t k = 0; k < plan.vertical.weightStride; ++k) {
+          const int32_t sy = first + std::min(k, plan.vertical.taps - 1);
+          rows[static_cast<size_t>(k)] = src.data() + static_cast<size_t>(sy) * static_cast<size_t>(source.width) * 4;
+        }
+        pixel_pipeline::FilterVerticalScalar(rows.data(),
+                                             &plan.vertical.weights[static_cast<size_t>(y) * plan.vertical.weightStride],
+                                             plan.vertical.weightStride,
+                                             static_cast<size_t>(source.width) * 4,
+                                             scratch.data());
+        pixel_pipeline::FilterHorizontalScalar(
+            scratch.data(), plan.horizontal, out.width, frame.data() + static_cast<size_t>(y) * out.width * 4);
+      }
+    });
+    Report("scale", "box/scalar", out, scalarMs, legacyMs);
+  }
+}
+
+// Banded ProcessFrameParallel on a private pool at 1/2/4/8 threads, from a 4K
+// source: full-size HDR tone map and a box downscale to 1080p.
+void BenchThreads() {
+  const Resolution source = kResolutions[2];
+  const std::vector<uint8_t> src = MakeFrame(source.width, source.height);
+  struct Case {
+    const char* name;
+    const Resolution& out;
+    pixel_pipeline::ScalerMode mode;
+    bool hdrLikely;
+  };
+  const Case cases[] = {
+      {"hdr", kResolutions[2], pixel_pipeline::ScalerMode::kNearest, true},
+      {"box", kResolutions[1], pixel_pipeline::ScalerMode::kBox, false},
+  };
+  const int32_t threadCounts[] = {1, 2, 4, 8};
+  pixel_pipeline::ThreadPool pool;
+  pool.EnsureWorkers(7);
+  pixel_pipeline::ToneMapConfig cfg;
+  cfg.rolloff = 0.35f;
+  cfg.saturation = 1.2f;
+  for (const Case& c : cases) {
+    pixel_pipeline::FramePipeline pipeline;
+    pixel_pipeline::BuildFramePipeline(
+        source.width, source.height, c.out.width, c.out.height, c.hdrLikely, cfg, &pipeline, c.mode);
+    std::vector<uint8_t> frame(static_cast<size_t>(c.out.width) * static_cast<size_t>(c.out.height) * 4);
+    double baselineMs = 0.0;
+    for (int32_t threads : threadCounts) {
+      const double ms = TimeBestMs([&] {
+        pixel_pipeline::ProcessFrameParallel(
+            src.data(), source.width * 4, frame.data(), c.out.width * 4, pipeline, &pool, threads);
+      });
+      if (threads == 1) {
+        baselineMs = ms;
+      }
+      char name[32];
+      std::snprintf(name, sizeof(name), "%s/threads=%d", c.name, static_cast<int>(threads));
+      Report("threads", name, c.out, ms, baselineMs);
+    }
+  }
+}
+
+// Whole-frame RGBA8 vs. fused NV12/I420 output (same tone map), then the
+// RGBA -> 4:2:0 conversion on its own per kernel.
+void BenchYuv() {
+  pixel_pipeline::ToneMapConfig cfg;
+  cfg.rolloff = 0.35f;
+  for (const Resolution& res : {kResolutions[0], kResolutions[1]}) {
+    const std::vector<uint8_t> src = MakeFrame(res.width, res.height);
+    double rgbaMs = 0.0;
+    for (pixel_pipeline::PixelFormat format :
+         {pixel_pipeline::PixelFormat::kRgba8, pixel_pipeline::PixelFormat::kNv12, pixel_pipeline::PixelFormat::kI420}) {
+      pixel_pipeline::FramePipeline pipeline;
+      pixel_pipeline::BuildFramePipeline(res.width, res.height, res.width, res.height, true, cfg, &pipeline,
+                                         pixel_pipeline::ScalerMode::kNearest, format);
+      std::vector<uint8_t> frame(pipeline.output.byteLength);
+      const double ms = TimeBestMs([&] {
+        pixel_pipeline::ProcessFrame(src.data(), res.width * 4, frame.data(), res.width * 4, pipeline);
+      });
+      if (format == pixel_pipeline::PixelFormat::kRgba8) {
+        rgbaMs = ms;
+      }
+      Report("yuv", pixel_pipeline::PixelFormatName(format), res, ms, rgbaMs);
+    }
+
+    const pixel_pipeline::YuvCoefficients coeffs =
+        pixel_pipeline::ResolveYuvCoefficients(pixel_pipeline::YuvRange::kLimited);
+    const pixel_pipeline::FrameLayout layout =
+        pixel_pipeline::ComputeFrameLayout(pixel_pipeline::PixelFormat::kNv12, res.width, res.height);
+    std::vector<uint8_t> nv12(layout.byteLength);
+    struct Kernel {
+      const char* name;
+      pixel_pipeline::RgbaToYuvRowsFn fn;
+    };
+    std::vector<Kernel> kernels = {{"convert/scalar", pixel_pipeline::RgbaToYuvRowsScalar}};
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+    if (pixel_pipeline::GetCpuFeatures().sse41) {
+      kernels.push_back({"convert/sse41", pixel_pipeline::RgbaToYuvRowsSse41});
+    }
+#endif
+    double scalarMs = 0.0;
+    for (const Kernel& kernel : kernels) {
+      const double ms = TimeBestMs([&] {
+        const size_t rowBytes = static_cast<size_t>(res.width) * 4;
+        for (int32_t y = 0; y < res.height; y += 2) {
+          uint8_t* uv = nv12.data() + layout.planes[1].offset + static_cast<size_t>(y / 2) * layout.planes[1].stride;
+          kernel.fn(src.data() + y * rowBytes,
+                    src.data() + (y + 1) * rowBytes,
+                    res.width,
+                    nv12.data() + static_cast<size_t>(y) * res.width,
+                    nv12.data() + static_cast<size_t>(y + 1) * res.width,
+                    uv,
+                    uv + 1,
+                    2,
+                    coeffs);
+        }
+      });
+      if (scalarMs == 0.0) {
+        scalarMs = ms;
+      }
+      Report("yuv", kernel.name, res, ms, scalarMs);
+    }
+  }
+}
+
+struct Bench {
+  const char* name;
+  void (*fn)();
+};
+
+// High-bit-depth decode to BGRA8 per kernel, against the 8-bit tone map on
+// the same frame size (the work the decode replaces).
+void BenchHdr() {
+  pixel_pipeline::ToneMapConfig cfg;
+  cfg.rolloff = 0.35f;
+  cfg.saturation = 1.2f;
+  const pixel_pipeline::ToneMapParams params = pixel_pipeline::ResolveToneMapParams(true, cfg);
+  for (const Resolution& res : {kResolutions[0], kResolutions[1]}) {
+    const size_t pixels = static_cast<size_t>(res.width) * static_cast<size_t>(res.height);
+    const std::vector<uint8_t> bgra = MakeFrame(res.width, res.height);
+    std::vector<uint8_t> dst(pixels * 4);
+    const double baselineMs = TimeBestMs([&] {
+      pixel_pipeline::ToneMapBgraToRgbaScalar(bgra.data(), dst.data(), pixels, params);
+    });
+    Report("hdr", "bgra8/scalar", res, baselineMs, baselineMs);
+    for (pixel_pipeline::SourceFormat format :
+         {pixel_pipeline::SourceFormat::kRgba16f, pixel_pipeline::SourceFormat::kRgb10a2}) {
+      const int32_t stride = res.width * pixel_pipeline::SourceBytesPerPixel(format);
+      std::vector<uint8_t> src(static_cast<size_t>(stride) * static_cast<size_t>(res.height));
+      pixel_pipeline::RenderSyntheticHdrFrame(format, src.data(), res.width, res.height, stride, 0, 8.0f);
+      for (pixel_pipeline::ToneMapKernel kernel : {pixel_pipeline::ToneMapKernel::kScalar,
+                                                   pixel_pipeline::ToneMapKernel::kAvx2}) {
+        const pixel_pipeline::HdrDecodeFn fn = pixel_pipeline::GetHdrDecodeKernel(format, kernel);
+        if (!fn) {
+          continue;
+        }
+        const double ms = TimeBestMs([&] { fn(src.data(), dst.data(), pixels, params); });
+        char variant[32];
+        std::snprintf(variant, sizeof(variant), "%s/%s", pixel_pipeline::SourceFormatName(format),
+                      pixel_pipeline::ToneMapKernelName(kernel));
+        Report("hdr", variant, res, ms, baselineMs);
+      }
+    }
+  }
+}
+
+// Blending a 64x64 cursor per kernel, and what the overlay adds to a fused
+// frame (the sprite is drawn at output size, after scaling).
+void BenchCursor() {
+  pixel_pipeline::CursorSprite sprite;
+  const std::vector<uint8_t> pixels = MakeFrame(64, 64);
+  pixel_pipeline::BuildColorCursorSprite(pixels.data(), 64, 64, 64 * 4, nullptr, 0, 0, 0, &sprite);
+  const Resolution spriteSize = {"64x64", 64, 64};
+  std::vector<uint8_t> dst = MakeFrame(64, 64);
+  struct Kernel {
+    const char* name;
+    pixel_pipeline::CursorBlendFn fn;
+  };
+  std::vector<Kernel> kernels = {{"blend/scalar", pixel_pipeline::BlendCursorScalar}};
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  if (pixel_pipeline::GetCpuFeatures().sse41) {
+    kernels.push_back({"blend/sse41", pixel_pipeline::BlendCursorSse41});
+  }
+#endif
+  double scalarMs = 0.0;
+  for (const Kernel& kernel : kernels) {
+    const double ms = TimeBestMs([&] { kernel.fn(sprite.pixels.data(), dst.data(), 64 * 64); });
+    if (scalarMs == 0.0) {
+      scalarMs = ms;
+    }
+    Report("cursor", kernel.name, spriteSize, ms, scalarMs);
+  }
+
+  const Resolution source = kResolutions[2];
+  const std::vector<uint8_t> src = MakeFrame(source.width, source.height);
+  pixel_pipeline::ToneMapConfig cfg;
+  cfg.rolloff = 0.35f;
+  const Resolution& out = kResolutions[1];
+  pixel_pipeline::FramePipeline pipeline;
+  pixel_pipeline::BuildFramePipeline(source.width, source.height, out.width, out.height, true, cfg, &pipeline);
+  std::vector<uint8_t> frame(pipeline.output.byteLength);
+  const pixel_pipeline::CursorOverlay overlay =
+      pixel_pipeline::PlaceCursorOverlay(&sprite, source.width / 2, source.height / 2, 0.5, 0.5);
+  double plainMs = 0.0;
+  for (const pixel_pipeline::CursorOverlay* cursor : {static_cast<const pixel_pipeline::CursorOverlay*>(nullptr),
+                                                      &overlay}) {
+    const double ms = TimeBestMs([&] {
+      pixel_pipeline::ProcessFrame(src.data(), source.width * 4, frame.data(), out.width * 4, pipeline, cursor);
+    });
+    if (!cursor) {
+      plainMs = ms;
+    }
+    Report("cursor", cursor ? "fused+cursor" : "fused", out, ms, plainMs);
+  }
+}
+
+// Delta encode/decode of an RGBA frame where only a cursor-sized 64x64
+// region moved, against copying the raw frame, plus the bytes on the wire.
+void BenchDelta() {
+  for (const Resolution& res : kResolutions) {
+    const size_t bytes = static_cast<size_t>(res.width) * static_cast<size_t>(res.height) * 4;
+    const std::vector<uint8_t> base = MakeFrame(res.width, res.height);
+    std::vector<uint8_t> frame = base;
+    for (int32_t y = 100; y < 164; ++y) {
+      uint8_t* row = frame.data() + (static_cast<size_t>(y) * res.width + 200) * 4;
+      for (int32_t i = 0; i < 64 * 4; ++i) {
+        row[i] = static_cast<uint8_t>(~row[i]);
+      }
+    }
+    std::vector<uint8_t> copy(bytes);
+    const double copyMs = TimeBestMs([&] { std::memcpy(copy.data(), frame.data(), bytes); });
+    Report("delta", "raw/memcpy", res, copyMs, copyMs);
+
+    std::vector<uint8_t> delta;
+    pixel_pipeline::FrameDeltaStats stats;
+    const double staticMs =
+        TimeBestMs([&] { pixel_pipeline::EncodeFrameDelta(base.data(), base.data(), bytes, bytes, &delta); });
+    Report("delta", "encode/static", res, staticMs, copyMs);
+    const double encodeMs = TimeBestMs(
+        [&] { pixel_pipeline::EncodeFrameDelta(base.data(), frame.data(), bytes, bytes, &delta, &stats); });
+    Report("delta", "encode/cursor", res, encodeMs, copyMs);
+    const double decodeMs = TimeBestMs([&] {
+      std::memcpy(copy.data(), base.data(), bytes);
+      pixel_pipeline::DecodeFrameDelta(delta.data(), delta.size(), copy.data(), bytes);
+    });
+    Report("delta", "base+decode", res, decodeMs, copyMs);
+    std::printf("%-10s %-18s %-8s %zu of %zu bytes (1/%.0f)\n",
+                "delta",
+                "wire/cursor",
+                res.name,
+                stats.encodedBytes,
+                bytes,
+                static_cast<double>(bytes) / static_cast<double>(stats.encodedBytes));
+  }
+}
+
+// Change detection at 1:1 output: hashing every tile, then the full
+// pipeline against reprocessing only a cursor-sized change (plus the copy out
+// of the persistent frame a session still pays).
+void BenchTiles() {
+  pixel_pipeline::ToneMapConfig cfg;
+  cfg.rolloff = 0.35f;
+  for (const Resolution& res : kResolutions) {
+    const int32_t stride = res.width * 4;
+    const size_t bytes = static_cast<size_t>(stride) * static_cast<size_t>(res.height);
+    std::vector<uint8_t> src = MakeFrame(res.width, res.height);
+    pixel_pipeline::FramePipeline pipeline;
+    pixel_pipeline::BuildFramePipeline(res.width, res.height, res.width, res.height, true, cfg, &pipeline);
+    std::vector<uint8_t> frame(bytes);
+    std::vector<uint8_t> copy(bytes);
+    const double fullMs = TimeBestMs(
+        [&] { pixel_pipeline::ProcessFrame(src.data(), stride, frame.data(), stride, pipeline); });
+    Report("tiles", "full-frame", res, fullMs, fullMs);
+
+    const pixel_pipeline::TileHashRowFn kernels[] = {
+        pixel_pipeline::HashTileRowScalar,
+        pixel_pipeline::ActiveTileHashKernel(),
+    };
+    const int32_t tileSize = pixel_pipeline::kDefaultChangeTileSize;
+    const int32_t tiles = (res.width + tileSize - 1) / tileSize;
+    std::vector<uint32_t> lanes(static_cast<size_t>(tiles) * pixel_pipeline::kTileHashLanes + 4);
+    uint32_t* aligned = lanes.data() + (16 - reinterpret_cast<uintptr_t>(lanes.data()) % 16) % 16 / 4;
+    for (int k = 0; k < 2; ++k) {
+      if (k == 1 && kernels[1] == kernels[0]) {
+        break;
+      }
+      const double hashMs = TimeBestMs([&] {
+        for (int32_t y = 0; y < res.height; ++y) {
+          if (y % tileSize == 0) {
+            for (int32_t t = 0; t < tiles; ++t) {
+              pixel_pipeline::InitTileHashLanes(aligned + t * pixel_pipeline::kTileHashLanes);
+            }
+          }
+          kernels[k](src.data() + static_cast<size_t>(y) * stride, res.width * 4, tileSize * 4, aligned);
+        }
+      });
+      Report("tiles", k == 0 ? "hash/scalar" : "hash/simd", res, hashMs, fullMs);
+    }
+
+    pixel_pipeline::TileChangeTracker tracker(res.width, res.height);
+    tracker.Update(src.data(), stride);
+    std::vector<pixel_pipeline::DirtyRect> rects;
+    uint8_t tick = 0;
+    // A 64x64 patch changes every frame; "changed" stops at the persistent
+    // output, "changed+copy" also copies it out like a pooled readFrame.
+    auto processChanged = [&] {
+      for (int32_t y = 100; y < 164; ++y) {
+        std::memset(src.data() + (static_cast<size_t>(y) * res.width + 200) * 4, ++tick, 64 * 4);
+      }
+      tracker.Update(src.data(), stride);
+      tracker.ChangedRects(&rects);
+      for (pixel_pipeline::DirtyRect& rect : rects) {
+        rect = pixel_pipeline::MapSourceRectToOutput(pipeline, rect);
+      }
+      pixel_pipeline::NormalizeOutputRects(pipeline, &rects);
+      pixel_pipeline::ProcessFrameRects(src.data(), stride, frame.data(), stride, pipeline, rects, nullptr, 1);
+    };
+    Report("tiles", "changed", res, TimeBestMs(processChanged), fullMs);
+    const double partialMs = TimeBestMs([&] {
+      processChanged();
+      std::memcpy(copy.data(), frame.data(), bytes);
+    });
+    Report("tiles", "changed+copy", res, partialMs, fullMs);
+  }
+}
+
+void BenchPyramid() {
+  pixel_pipeline::ToneMapConfig cfg;
+  cfg.rolloff = 0.35f;
+  for (const Resolution& res : kResolutions) {
+    const int32_t stride = res.width * 4;
+    const int32_t halfW = res.width / 2;
+    const int32_t halfH = res.height / 2;
+    const std::vector<uint8_t> src = MakeFrame(res.width, res.height);
+    std::vector<uint8_t> level0(static_cast<size_t>(stride) * static_cast<size_t>(res.height));
+    pixel_pipeline::FramePipeline full;
+    pixel_pipeline::BuildFramePipeline(res.width, res.height, res.width, res.height, true, cfg, &full);
+    pixel_pipeline::ProcessFrame(src.data(), stride, level0.data(), stride, full);
+    // The second level either way: another scale + tone-map pass over the
+    // capture, or a 2x reduction of the finished first level.
+    pixel_pipeline::FramePipeline half;
+    pixel_pipeline::BuildFramePipeline(
+        res.width, res.height, halfW, halfH, true, cfg, &half, pixel_pipeline::ScalerMode::kBox);
+    std::vector<uint8_t> level1(static_cast<size_t>(halfW) * static_cast<size_t>(halfH) * 4);
+    const double passMs =
+        TimeBestMs([&] { pixel_pipeline::ProcessFrame(src.data(), stride, level1.data(), halfW * 4, half); });
+    Report("pyramid", "second-pass", res, passMs, passMs);
+
+    const pixel_pipeline::ReduceHalfRowFn kernels[] = {
+        pixel_pipeline::ReduceHalfRowScalar,
+        pixel_pipeline::ActiveReduceHalfKernel(),
+    };
+    for (int k = 0; k < 2; ++k) {
+      if (k == 1 && kernels[1] == kernels[0]) {
+        break;
+      }
+      const double reduceMs = TimeBestMs([&] {
+        for (int32_t y = 0; y < halfH; ++y) {
+          const uint8_t* row0 = level0.data() + static_cast<size_t>(2 * y) * stride;
+          kernels[k](row0, row0 + stride, halfW, level1.data() + static_cast<size_t>(y) * halfW * 4);
+        }
+      });
+      Report("pyramid", k == 0 ? "reduce/scalar" : "reduce/simd", res, reduceMs, passMs);
+    }
+  }
+}
+
+// The saturation mix in float (scalar and the active SIMD kernel), through
+// the Q16 tables, and in the 16-bit fixed-point kernels, relative to the
+// float scalar reference; each variant first prints the fixed-point error
+// over all 2^24 colors.
+void BenchFixed() {
+  struct Variant {
+    const char* name;
+    bool hdrLikely;
+    float rolloff;
+    float saturation;
+  };
+  const Variant variants[] = {
+      {"sdr+sat", false, 0.35f, 1.2f},
+      {"rolloff+sat", true, 0.35f, 1.2f},
+      {"rolloff=1+sat=2", true, 1.0f, 2.0f},
+  };
+  for (const Variant& variant : variants) {
+    pixel_pipeline::ToneMapConfig cfg;
+    cfg.rolloff = variant.rolloff;
+    cfg.saturation = variant.saturation;
+    cfg.arithmetic = pixel_pipeline::ToneMapArithmetic::kFixed;
+    const pixel_pipeline::ToneMapFixedError error =
+        pixel_pipeline::MeasureToneMapFixedError(variant.hdrLikely, cfg, 1);
+    std::printf("%-10s %-18s error vs float: max %d LSB, mean %.5f, %.3f%% of values differ\n",
+                "fixed",
+                variant.name,
+                error.maxError,
+                error.meanError,
+                error.mismatchRate * 100.0);
+  }
+  for (const Resolution& res : kResolutions) {
+    const std::vector<uint8_t> src = MakeFrame(res.width, res.height);
+    std::vector<uint8_t> dst(src.size());
+    const size_t pixelCount = src.size() / 4;
+    for (const Variant& variant : variants) {
+      pixel_pipeline::ToneMapConfig cfg;
+      cfg.rolloff = variant.rolloff;
+      cfg.saturation = variant.saturation;
+      const pixel_pipeline::ToneMapParams params = pixel_pipeline::ResolveToneMapParams(variant.hdrLikely, cfg);
+      pixel_pipeline::ToneMapLut lut;
+      pixel_pipeline::BuildToneMapLut(variant.hdrLikely, cfg, &lut);
+      pixel_pipeline::ToneMapFixed fixed;
+      pixel_pipeline::BuildToneMapFixed(variant.hdrLikely, cfg, &fixed);
+      const pixel_pipeline::ToneMapFn simd = pixel_pipeline::GetToneMapKernel(pixel_pipeline::ActiveToneMapKernel());
+      char name[32];
+      const double scalarMs = TimeBestMs([&] {
+        pixel_pipeline::ToneMapBgraToRgbaScalar(src.data(), dst.data(), pixelCount, params);
+      });
+      std::snprintf(name, sizeof(name), "%s/float", variant.name);
+      Report("fixed", name, res, scalarMs, scalarMs);
+      const double simdMs = TimeBestMs([&] { simd(src.data(), dst.data(), pixelCount, params); });
+      std::snprintf(name,
+                    sizeof(name),
+                    "%s/%s",
+                    variant.name,
+                    pixel_pipeline::ToneMapKernelName(pixel_pipeline::ActiveToneMapKernel()));
+      Report("fixed", name, res, simdMs, scalarMs);
+      const double lutMs = TimeBestMs([&] {
+        pixel_pipeline::ApplyToneMapLut(src.data(), dst.data(), pixelCount, lut);
+      });
+      std::snprintf(name, sizeof(name), "%s/lut", variant.name);
+      Report("fixed", name, res, lutMs, scalarMs);
+      const double fixedScalarMs = TimeBestMs([&] {
+        pixel_pipeline::ToneMapFixedScalar(src.data(), dst.data(), pixelCount, fixed);
+      });
+      std::snprintf(name, sizeof(name), "%s/q15", variant.name);
+      Report("fixed", name, res, fixedScalarMs, scalarMs);
+      const pixel_pipeline::ToneMapFixedFn fixedKernel = pixel_pipeline::ActiveToneMapFixedKernel();
+      if (fixedKernel != pixel_pipeline::ToneMapFixedScalar) {
+        const double fixedSimdMs = TimeBestMs([&] { fixedKernel(src.data(), dst.data(), pixelCount, fixed); });
+        std::snprintf(name, sizeof(name), "%s/q15-simd", variant.name);
+        Report("fixed", name, res, fixedSimdMs, scalarMs);
+      }
+    }
+  }
+}
+
+const Bench kBenches[] = {
+    {"tonemap", BenchToneMap},
+    {"fused", BenchFused},
+    {"scale", BenchScale},
+    {"threads", BenchThreads},
+    {"yuv", BenchYuv},
+    {"hdr", BenchHdr},
+    {"cursor", BenchCursor},
+    {"delta", BenchDelta},
+    {"tiles", BenchTiles},
+    {"pyramid", BenchPyramid},
+    {"fixed", BenchFixed},
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  std::printf("%-10s %-18s %-8s %11s  %12s  %11s  %11s  %s\n",
+              "group", "variant", "size", "time", "cost", "bandwidth", "rate", "speedup");
+  for (const Bench& bench : kBenches) {
+    if (filter && std::strstr(bench.name, filter) == nullptr) {
+      continue;
+    }
+    bench.fn();
+  }
+  return 0;
+}
@@ -0,0 +1,53 @@
+{
+  "includes": ["pixel_pipeline.gypi"],
+  "targets": [
+    {
+      "target_name": "pixel_pipeline_tests",
+      "type": "executable",
+      "dependencies": ["pixel_pipeline"],
+      "cflags_cc": ["-std=c++17"],
+      "msvs_settings": {
+        "VCCLCompilerTool": {
+          "AdditionalOptions": ["/std:c++17"]
+        }
+      },
+      "sources": [
+        "../../tests/native/pixel-pipeline/cursor_sprite_test.cc",
+        "../../tests/native/pixel-pipeline/frame_delta_test.cc",
+        "../../tests/native/pixel-pipeline/frame_pacer_test.cc",
+        "../../tests/native/pixel-pipeline/frame_pipe_test.cc",
+        "../../tests/native/pixel-pipeline/frame_pipeline_test.cc",
+        "../../tests/native/pixel-pipeline/frame_pool_test.cc",
+        "../../tests/native/pixel-pipeline/frame_queue_test.cc",
+        "../../tests/native/pixel-pipeline/frame_ring_test.cc",
+        "../../tests/native/pixel-pipeline/hdr_source_test.cc",
+        "../../tests/native/pixel-pipeline/histogram_test.cc",
+        "../../tests/native/pixel-pipeline/replay_source_test.cc",
+        "../../tests/native/pixel-pipeline/scale_test.cc",
+        "../../tests/native/pixel-pipeline/stage_stats_test.cc",
+        "../../tests/native/pixel-pipeline/synthetic_source_test.cc",
+        "../../tests/native/pixel-pipeline/test_main.cc",
+        "../../tests/native/pixel-pipeline/thread_pool_test.cc",
+        "../../tests/native/pixel-pipeline/tile_change_test.cc",
+        "../../tests/native/pixel-pipeline/tone_curves_test.cc",
+        "../../tests/native/pixel-pipeline/tone_map_fixed_test.cc",
+        "../../tests/native/pixel-pipeline/tone_map_lut_test.cc",
+        "../../tests/native/pixel-pipeline/tone_map_test.cc",
+        "../../tests/native/pixel-pipeline/triple_buffer_test.cc",
+        "../../tests/native/pixel-pipeline/yuv_test.cc"
+      ]
+    },
+    {
+      "target_name": "pixel_pipeline_bench",
+      "type": "executable",
+      "dependencies": ["pixel_pipeline"],
+      "cflags_cc": ["-std=c++17"],
+      "msvs_settings": {
+        "VCCLCompilerTool": {
+          "AdditionalOptions": ["/std:c++17"]
+        }
+      },
+      "sources": ["bench/pixel_bench.cc"]
+    }
+  ]
+}
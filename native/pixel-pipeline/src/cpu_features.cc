@@ -0,0 +1,53 @@
+#include "cpu_features.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86) && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace pixel_pipeline {
+
+namespace {
+
+CpuFeatures DetectCpuFeatures() {
+  CpuFeatures features;
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4] = {0, 0, 0, 0};
+  __cpuid(info, 0);
+  const int maxLeaf = info[0];
+  __cpuid(info, 1);
+  features.sse41 = (info[2] & (1 << 19)) != 0;
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  const bool f16c = (info[2] & (1 << 29)) != 0;
+  bool osAvxState = false;
+  if (osxsave && avx) {
+    osAvxState = (_xgetbv(0) & 0x6) == 0x6;
+  }
+  features.f16c = f16c && osAvxState;
+  if (maxLeaf >= 7 && osAvxState) {
+    __cpuidex(info, 7, 0);
+    features.avx2 = (info[1] & (1 << 5)) != 0;
+  }
+#else
+  __builtin_cpu_init();
+  features.sse41 = __builtin_cpu_supports("sse4.1") != 0;
+  features.avx2 = __builtin_cpu_supports("avx2") != 0;
+  features.f16c = __builtin_cpu_supports("f16c") != 0;
+#endif
+#endif
+#if defined(PIXEL_PIPELINE_ARCH_ARM64)
+  features.neon = true;
+#endif
+  return features;
+}
+
+}  // namespace
+
+const CpuFeatures& GetCpuFeatures() {
+  static const CpuFeatures features = DetectCpuFeatures();
+  return features;
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,35 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_CPU_FEATURES_H_
+#define CURSORCINE_PIXEL_PIPELINE_CPU_FEATURES_H_
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PIXEL_PIPELINE_ARCH_X86 1
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define PIXEL_PIPELINE_ARCH_ARM64 1
+#endif
+
+// GCC/Clang need per-function target attributes to emit SSE4.1/AVX2 code
+// without raising the baseline ISA of the whole translation unit. MSVC accepts
+// the intrinsics unconditionally.
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXEL_PIPELINE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PIXEL_PIPELINE_TARGET(isa)
+#endif
+
+namespace pixel_pipeline {
+
+struct CpuFeatures {
+  bool sse41 = false;
+  bool avx2 = false;
+  bool f16c = false;
+  bool neon = false;
+};
+
+// Detected once per process (CPUID on x86, compile-time on ARM64).
+const CpuFeatures& GetCpuFeatures();
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_CPU_FEATURES_H_
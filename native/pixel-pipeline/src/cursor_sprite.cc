@@ -0,0 +1,303 @@
+#include "cursor_sprite.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "tone_map.h"
+
+namespace pixel_pipeline {
+
+namespace {
+
+// round(x / 255) for x in [0, 255 * 255], exact.
+inline uint32_t Div255(uint32_t x) {
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+inline bool MaskBit(const uint8_t* mask, int32_t stride, int32_t x, int32_t y) {
+  return (mask[static_cast<size_t>(y) * static_cast<size_t>(stride) + static_cast<size_t>(x / 8)] >>
+          (7 - (x % 8))) & 1;
+}
+
+inline void SetPixel(CursorSprite* sprite, int32_t x, int32_t y, uint8_t b, uint8_t g, uint8_t r, uint8_t a) {
+  uint8_t* p = sprite->pixels.data() + (static_cast<size_t>(y) * static_cast<size_t>(sprite->width) + x) * 4;
+  p[0] = b;
+  p[1] = g;
+  p[2] = r;
+  p[3] = a;
+}
+
+bool ResetSprite(int32_t width, int32_t height, int32_t hotspotX, int32_t hotspotY, CursorSprite* sprite) {
+  if (!sprite || width <= 0 || height <= 0) {
+    return false;
+  }
+  sprite->width = width;
+  sprite->height = height;
+  sprite->hotspotX = hotspotX;
+  sprite->hotspotY = hotspotY;
+  sprite->pixels.assign(static_cast<size_t>(width) * static_cast<size_t>(height) * 4, 0);
+  return true;
+}
+
+// Source coverage of each output index along one axis: output `i` averages
+// source [i / scale, (i + 1) / scale), weighted by overlap.
+struct AxisWeights {
+  std::vector<int32_t> first;
+  std::vector<int32_t> count;
+  std::vector<double> weights;  // `count[i]` entries per index, summing to 1
+  std::vector<size_t> offset;
+};
+
+AxisWeights BuildAxisWeights(int32_t srcSize, int32_t dstSize) {
+  AxisWeights axis;
+  const double step = static_cast<double>(srcSize) / dstSize;
+  for (int32_t i = 0; i < dstSize; ++i) {
+    const double begin = i * step;
+    const double end = std::min(static_cast<double>(srcSize), (i + 1) * step);
+    const int32_t first = static_cast<int32_t>(std::floor(begin));
+    const int32_t last = std::min(srcSize - 1, static_cast<int32_t>(std::ceil(end)) - 1);
+    axis.first.push_back(first);
+    axis.count.push_back(last - first + 1);
+    axis.offset.push_back(axis.weights.size());
+    for (int32_t s = first; s <= last; ++s) {
+      const double overlap = std::min(end, s + 1.0) - std::max(begin, static_cast<double>(s));
+      axis.weights.push_back(overlap / (end - begin));
+    }
+  }
+  return axis;
+}
+
+}  // namespace
+
+bool BuildColorCursorSprite(const uint8_t* bgra,
+                            int32_t width,
+                            int32_t height,
+                            int32_t stride,
+                            const uint8_t* andMask,
+                            int32_t maskStride,
+                            int32_t hotspotX,
+                            int32_t hotspotY,
+                            CursorSprite* sprite) {
+  if (!bgra || stride < width * 4 || !ResetSprite(width, height, hotspotX, hotspotY, sprite)) {
+    return false;
+  }
+  bool hasAlpha = false;
+  for (int32_t y = 0; y < height && !hasAlpha; ++y) {
+    const uint8_t* row = bgra + static_cast<size_t>(y) * static_cast<size_t>(stride);
+    for (int32_t x = 0; x < width; ++x) {
+      if (row[x * 4 + 3] != 0) {
+        hasAlpha = true;
+        break;
+      }
+    }
+  }
+  for (int32_t y = 0; y < height; ++y) {
+    const uint8_t* row = bgra + static_cast<size_t>(y) * static_cast<size_t>(stride);
+    for (int32_t x = 0; x < width; ++x) {
+      const uint8_t* p = row + x * 4;
+      uint32_t alpha = 255;
+      if (hasAlpha) {
+        alpha = p[3];
+      } else if (andMask && MaskBit(andMask, maskStride, x, y)) {
+        alpha = 0;
+      }
+      SetPixel(sprite,
+               x,
+               y,
+               static_cast<uint8_t>(Div255(p[0] * alpha)),
+               static_cast<uint8_t>(Div255(p[1] * alpha)),
+               static_cast<uint8_t>(Div255(p[2] * alpha)),
+               static_cast<uint8_t>(alpha));
+    }
+  }
+  return true;
+}
+
+bool BuildMonochromeCursorSprite(const uint8_t* andMask,
+                                 const uint8_t* xorMask,
+                                 int32_t width,
+                                 int32_t height,
+                                 int32_t maskStride,
+                                 int32_t hotspotX,
+                                 int32_t hotspotY,
+                                 CursorSprite* sprite) {
+  if (!andMask || !xorMask || maskStride * 8 < width ||
+      !ResetSprite(width, height, hotspotX, hotspotY, sprite)) {
+    return false;
+  }
+  std::vector<uint8_t> inverted(static_cast<size_t>(width) * static_cast<size_t>(height), 0);
+  for (int32_t y = 0; y < height; ++y) {
+    for (int32_t x = 0; x < width; ++x) {
+      const bool transparent = MaskBit(andMask, maskStride, x, y);
+      const bool set = MaskBit(xorMask, maskStride, x, y);
+      if (!transparent) {
+        const uint8_t v = set ? 255 : 0;
+        SetPixel(sprite, x, y, v, v, v, 255);
+      } else if (set) {
+        SetPixel(sprite, x, y, 0, 0, 0, 255);
+        inverted[static_cast<size_t>(y) * width + x] = 1;
+      }
+    }
+  }
+  // White outline on the transparent neighbours of inverting pixels.
+  for (int32_t y = 0; y < height; ++y) {
+    for (int32_t x = 0; x < width; ++x) {
+      if (sprite->pixels[(static_cast<size_t>(y) * width + x) * 4 + 3] != 0) {
+        continue;
+      }
+      bool touches = false;
+      for (int32_t ny = std::max(0, y - 1); ny <= std::min(height - 1, y + 1) && !touches; ++ny) {
+        for (int32_t nx = std::max(0, x - 1); nx <= std::min(width - 1, x + 1); ++nx) {
+          if (inverted[static_cast<size_t>(ny) * width + nx]) {
+            touches = true;
+            break;
+          }
+        }
+      }
+      if (touches) {
+        SetPixel(sprite, x, y, 255, 255, 255, 255);
+      }
+    }
+  }
+  return true;
+}
+
+void ScaleCursorSprite(const CursorSprite& src, double scaleX, double scaleY, CursorSprite* dst) {
+  if (!dst || src.width <= 0 || src.height <= 0) {
+    return;
+  }
+  const int32_t width = std::max(1, static_cast<int32_t>(std::lround(src.width * scaleX)));
+  const int32_t height = std::max(1, static_cast<int32_t>(std::lround(src.height * scaleY)));
+  ResetSprite(width,
+              height,
+              static_cast<int32_t>(std::lround(src.hotspotX * scaleX)),
+              static_cast<int32_t>(std::lround(src.hotspotY * scaleY)),
+              dst);
+  // Premultiplied pixels average without dark fringes around transparency.
+  const AxisWeights columns = BuildAxisWeights(src.width, width);
+  const AxisWeights rows = BuildAxisWeights(src.height, height);
+  for (int32_t y = 0; y < height; ++y) {
+    for (int32_t x = 0; x < width; ++x) {
+      double sum[4] = {};
+      for (int32_t j = 0; j < rows.count[y]; ++j) {
+        const double wy = rows.weights[rows.offset[y] + j];
+        const uint8_t* row = src.pixels.data() + static_cast<size_t>(rows.first[y] + j) * src.width * 4;
+        for (int32_t i = 0; i < columns.count[x]; ++i) {
+          const double w = wy * columns.weights[columns.offset[x] + i];
+          const uint8_t* p = row + static_cast<size_t>(columns.first[x] + i) * 4;
+          for (int c = 0; c < 4; ++c) {
+            sum[c] += w * p[c];
+          }
+        }
+      }
+      uint8_t out[4];
+      for (int c = 0; c < 4; ++c) {
+        out[c] = static_cast<uint8_t>(std::min(255L, std::lround(sum[c])));
+      }
+      // Rounding must not leave a colour above its alpha.
+      for (int c = 0; c < 3; ++c) {
+        out[c] = std::min(out[c], out[3]);
+      }
+      SetPixel(dst, x, y, out[0], out[1], out[2], out[3]);
+    }
+  }
+}
+
+CursorSpriteCache::CursorSpriteCache(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {}
+
+const CursorSprite* CursorSpriteCache::Find(uint64_t key) {
+  for (Entry& entry : entries_) {
+    if (entry.key == key) {
+      entry.lastUse = ++clock_;
+      ++hits_;
+      return entry.sprite.get();
+    }
+  }
+  ++misses_;
+  return nullptr;
+}
+
+const CursorSprite* CursorSpriteCache::Insert(uint64_t key, CursorSprite sprite) {
+  Entry* slot = nullptr;
+  for (Entry& entry : entries_) {
+    if (entry.key == key) {
+      slot = &entry;
+      break;
+    }
+  }
+  if (!slot && entries_.size() < capacity_) {
+    entries_.emplace_back();
+    slot = &entries_.back();
+  }
+  if (!slot) {
+    slot = &*std::min_element(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+      return a.lastUse < b.lastUse;
+    });
+  }
+  slot->key = key;
+  slot->lastUse = ++clock_;
+  slot->sprite = std::make_unique<CursorSprite>(std::move(sprite));
+  return slot->sprite.get();
+}
+
+void CursorSpriteCache::Clear() {
+  entries_.clear();
+}
+
+CursorOverlay PlaceCursorOverlay(const CursorSprite* sprite, int32_t srcX, int32_t srcY, double scaleX, double scaleY) {
+  CursorOverlay overlay;
+  if (!sprite) {
+    return overlay;
+  }
+  overlay.sprite = sprite;
+  overlay.x = static_cast<int32_t>(std::lround(srcX * scaleX)) - sprite->hotspotX;
+  overlay.y = static_cast<int32_t>(std::lround(srcY * scaleY)) - sprite->hotspotY;
+  return overlay;
+}
+
+void BlendCursorScalar(const uint8_t* sprite, uint8_t* rgba, int32_t pixels) {
+  for (int32_t i = 0; i < pixels; ++i) {
+    const uint8_t* s = sprite + static_cast<size_t>(i) * 4;
+    uint8_t* d = rgba + static_cast<size_t>(i) * 4;
+    const uint32_t inv = 255u - s[3];
+    d[0] = static_cast<uint8_t>(std::min(255u, s[2] + Div255(d[0] * inv)));
+    d[1] = static_cast<uint8_t>(std::min(255u, s[1] + Div255(d[1] * inv)));
+    d[2] = static_cast<uint8_t>(std::min(255u, s[0] + Div255(d[2] * inv)));
+    d[3] = 255;
+  }
+}
+
+CursorBlendFn ActiveCursorBlendKernel() {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  const ToneMapKernel active = ActiveToneMapKernel();
+  if (active == ToneMapKernel::kAvx2 || active == ToneMapKernel::kSse41) {
+    return BlendCursorSse41;
+  }
+#endif
+  return BlendCursorScalar;
+}
+
+void BlendCursorRow(const CursorOverlay& overlay, int32_t y, int32_t width, uint8_t* rgbaRow) {
+  BlendCursorSpan(overlay, y, 0, width, rgbaRow);
+}
+
+void BlendCursorSpan(const CursorOverlay& overlay, int32_t y, int32_t spanBegin, int32_t spanEnd, uint8_t* rgbaRow) {
+  const CursorSprite* sprite = overlay.sprite;
+  if (!sprite || y < overlay.y || y >= overlay.y + sprite->height) {
+    return;
+  }
+  const int32_t x0 = std::max(spanBegin, overlay.x);
+  const int32_t x1 = std::min(spanEnd, overlay.x + sprite->width);
+  if (x0 >= x1) {
+    return;
+  }
+  static const CursorBlendFn kernel = ActiveCursorBlendKernel();
+  const size_t spriteOffset =
+      (static_cast<size_t>(y - overlay.y) * static_cast<size_t>(sprite->width) + static_cast<size_t>(x0 - overlay.x)) *
+      4;
+  kernel(sprite->pixels.data() + spriteOffset, rgbaRow + static_cast<size_t>(x0) * 4, x1 - x0);
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,121 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_CURSOR_SPRITE_H_
+#define CURSORCINE_PIXEL_PIPELINE_CURSOR_SPRITE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cpu_features.h"
+
+namespace pixel_pipeline {
+
+// A cursor image in premultiplied BGRA, with the hotspot in sprite pixels.
+struct CursorSprite {
+  int32_t width = 0;
+  int32_t height = 0;
+  int32_t hotspotX = 0;
+  int32_t hotspotY = 0;
+  std::vector<uint8_t> pixels;
+};
+
+// Colour cursor from top-down 32-bit BGRA. When every alpha byte is zero
+// (old-style cursors) opacity comes from `andMask` instead: 1 bpp, MSB first,
+// rows `maskStride` bytes apart, set bits transparent. A null mask then makes
+// the sprite opaque. Straight alpha is premultiplied here.
+bool BuildColorCursorSprite(const uint8_t* bgra,
+                            int32_t width,
+                            int32_t height,
+                            int32_t stride,
+                            const uint8_t* andMask,
+                            int32_t maskStride,
+                            int32_t hotspotX,
+                            int32_t hotspotY,
+                            CursorSprite* sprite);
+
+// Monochrome cursor from its AND and XOR masks (1 bpp, MSB first). Pixels
+// that would invert the screen cannot be expressed with alpha; they become
+// black with a white outline, so they stay visible on any background.
+bool BuildMonochromeCursorSprite(const uint8_t* andMask,
+                                 const uint8_t* xorMask,
+                                 int32_t width,
+                                 int32_t height,
+                                 int32_t maskStride,
+                                 int32_t hotspotX,
+                                 int32_t hotspotY,
+                                 CursorSprite* sprite);
+
+// Area-averaged resample to the output scale (at least 1x1); the hotspot
+// scales with it.
+void ScaleCursorSprite(const CursorSprite& src, double scaleX, double scaleY, CursorSprite* dst);
+
+// Sprites for the cursor handles a session has seen, already at output
+// scale, so a frame whose cursor shape is cached makes no GDI calls beyond
+// GetCursorInfo. Least recently used entries are evicted past `capacity`.
+// Not thread-safe; returned pointers stay valid until that entry is evicted
+// or the cache cleared.
+class CursorSpriteCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 16;
+
+  explicit CursorSpriteCache(size_t capacity = kDefaultCapacity);
+
+  // Null when `key` is not cached.
+  const CursorSprite* Find(uint64_t key);
+  const CursorSprite* Insert(uint64_t key, CursorSprite sprite);
+  void Clear();
+
+  size_t size() const { return entries_.size(); }
+  uint64_t hits() const { return hits_; }
+  uint64_t misses() const { return misses_; }
+
+ private:
+  struct Entry {
+    uint64_t key = 0;
+    uint64_t lastUse = 0;
+    std::unique_ptr<CursorSprite> sprite;
+  };
+
+  size_t capacity_;
+  uint64_t clock_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  std::vector<Entry> entries_;
+};
+
+// Where a frame's cursor lands in the output: the sprite's top-left corner
+// in output pixels, possibly partly or fully off the frame.
+struct CursorOverlay {
+  const CursorSprite* sprite = nullptr;
+  int32_t x = 0;
+  int32_t y = 0;
+};
+
+// Overlay for a cursor whose hotspot is at (`srcX`, `srcY`) in capture
+// pixels, with `sprite` already scaled by (`scaleX`, `scaleY`).
+CursorOverlay PlaceCursorOverlay(const CursorSprite* sprite, int32_t srcX, int32_t srcY, double scaleX, double scaleY);
+
+// Source-over blend of `pixels` premultiplied BGRA sprite pixels onto RGBA
+// output pixels (whose alpha stays 255).
+using CursorBlendFn = void (*)(const uint8_t* sprite, uint8_t* rgba, int32_t pixels);
+
+// Exact integer reference; SIMD kernels match it bit for bit.
+void BlendCursorScalar(const uint8_t* sprite, uint8_t* rgba, int32_t pixels);
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+void BlendCursorSse41(const uint8_t* sprite, uint8_t* rgba, int32_t pixels);
+#endif
+
+// Follows the tone-map ISA choice like the scaler and YUV kernels.
+CursorBlendFn ActiveCursorBlendKernel();
+
+// Blends the part of `overlay` that covers output row `y` (RGBA, `width`
+// pixels) into `rgbaRow`; rows the cursor misses are left alone.
+void BlendCursorRow(const CursorOverlay& overlay, int32_t y, int32_t width, uint8_t* rgbaRow);
+
+// Same, limited to columns [x0, x1) of the row; `rgbaRow` is still the start
+// of the row.
+void BlendCursorSpan(const CursorOverlay& overlay, int32_t y, int32_t x0, int32_t x1, uint8_t* rgbaRow);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_CURSOR_SPRITE_H_
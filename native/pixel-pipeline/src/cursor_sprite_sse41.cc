@@ -0,0 +1,43 @@
+#include "cursor_sprite.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+
+#include <immintrin.h>
+
+namespace pixel_pipeline {
+
+namespace {
+
+// round(x / 255) per 16-bit lane for x in [0, 255 * 255], as in the scalar
+// reference; every intermediate fits an unsigned 16-bit lane.
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i Div255Epu16(__m128i x) {
+  x = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+}  // namespace
+
+PIXEL_PIPELINE_TARGET("sse4.1")
+void BlendCursorSse41(const uint8_t* sprite, uint8_t* rgba, int32_t pixels) {
+  const __m128i toRgba = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+  const __m128i alphas = _mm_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+  const __m128i opaque = _mm_set1_epi32(static_cast<int32_t>(0xFF000000u));
+  const __m128i ones = _mm_set1_epi8(-1);
+  int32_t i = 0;
+  for (; i + 4 <= pixels; i += 4) {
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sprite + i * 4));
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 4));
+    const __m128i inv = _mm_xor_si128(_mm_shuffle_epi8(s, alphas), ones);
+    const __m128i lo = Div255Epu16(_mm_mullo_epi16(_mm_cvtepu8_epi16(d), _mm_cvtepu8_epi16(inv)));
+    const __m128i hi = Div255Epu16(
+        _mm_mullo_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(d, 8)), _mm_cvtepu8_epi16(_mm_srli_si128(inv, 8))));
+    const __m128i out = _mm_adds_epu8(_mm_shuffle_epi8(s, toRgba), _mm_packus_epi16(lo, hi));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_or_si128(out, opaque));
+  }
+  BlendCursorScalar(sprite + i * 4, rgba + i * 4, pixels - i);
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_X86
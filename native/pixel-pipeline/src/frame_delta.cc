@@ -0,0 +1,143 @@
+#include "frame_delta.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pixel_pipeline {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'C', 'D', 'F', '1'};
+
+void PutU32(uint8_t* p, uint32_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+  p[2] = static_cast<uint8_t>(v >> 16);
+  p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+uint32_t GetU32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void PutVarint(std::vector<uint8_t>* out, size_t v) {
+  while (v >= 0x80) {
+    out->push_back(static_cast<uint8_t>(v | 0x80));
+    v >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(v));
+}
+
+bool GetVarint(const uint8_t** cursor, const uint8_t* end, size_t* v) {
+  size_t value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (*cursor >= end) {
+      return false;
+    }
+    const uint8_t byte = *(*cursor)++;
+    value |= static_cast<size_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      *v = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool EncodeFrameDelta(const uint8_t* base,
+                      const uint8_t* frame,
+                      size_t bytes,
+                      size_t maxEncodedBytes,
+                      std::vector<uint8_t>* out,
+                      FrameDeltaStats* stats) {
+  if (!base || !frame || !out || bytes > UINT32_MAX || maxEncodedBytes < kFrameDeltaHeaderBytes) {
+    return false;
+  }
+  out->assign(kFrameDeltaHeaderBytes, 0);
+  uint32_t changedTiles = 0;
+  size_t literalBytes = 0;
+  size_t written = 0;  // end of the last token's literal
+  size_t runBegin = 0;
+  size_t runEnd = 0;
+
+  auto flush = [&]() {
+    if (runEnd == runBegin) {
+      return true;
+    }
+    PutVarint(out, runBegin - written);
+    PutVarint(out, runEnd - runBegin);
+    out->insert(out->end(), frame + runBegin, frame + runEnd);
+    literalBytes += runEnd - runBegin;
+    written = runEnd;
+    runBegin = runEnd;
+    return out->size() <= maxEncodedBytes;
+  };
+
+  for (size_t tile = 0; tile < bytes; tile += kFrameDeltaTileBytes) {
+    const size_t tileEnd = std::min(bytes, tile + kFrameDeltaTileBytes);
+    if (std::memcmp(base + tile, frame + tile, tileEnd - tile) == 0) {
+      continue;
+    }
+    ++changedTiles;
+    for (size_t chunk = tile; chunk < tileEnd; chunk += kFrameDeltaChunkBytes) {
+      const size_t chunkEnd = std::min(tileEnd, chunk + kFrameDeltaChunkBytes);
+      if (std::memcmp(base + chunk, frame + chunk, chunkEnd - chunk) == 0) {
+        continue;
+      }
+      // A skip of one chunk costs less as a new token than as literal bytes.
+      if (runEnd != chunk) {
+        if (!flush()) {
+          return false;
+        }
+        runBegin = chunk;
+      }
+      runEnd = chunkEnd;
+    }
+  }
+  if (!flush()) {
+    return false;
+  }
+
+  uint8_t* header = out->data();
+  std::memcpy(header, kMagic, sizeof(kMagic));
+  PutU32(header + 4, static_cast<uint32_t>(bytes));
+  PutU32(header + 8, changedTiles);
+  PutU32(header + 12, static_cast<uint32_t>(literalBytes));
+  if (stats) {
+    stats->changedTiles = changedTiles;
+    stats->literalBytes = static_cast<uint32_t>(literalBytes);
+    stats->encodedBytes = out->size();
+  }
+  return true;
+}
+
+bool DecodeFrameDelta(const uint8_t* delta, size_t deltaBytes, uint8_t* frame, size_t bytes) {
+  if (!delta || !frame || deltaBytes < kFrameDeltaHeaderBytes || std::memcmp(delta, kMagic, sizeof(kMagic)) != 0 ||
+      GetU32(delta + 4) != bytes) {
+    return false;
+  }
+  const size_t literalBytes = GetU32(delta + 12);
+  const uint8_t* cursor = delta + kFrameDeltaHeaderBytes;
+  const uint8_t* end = delta + deltaBytes;
+  size_t position = 0;
+  size_t copied = 0;
+  while (cursor < end) {
+    size_t skip = 0;
+    size_t length = 0;
+    if (!GetVarint(&cursor, end, &skip) || !GetVarint(&cursor, end, &length) || skip > bytes - position ||
+        length > bytes - position - skip || length > static_cast<size_t>(end - cursor)) {
+      return false;
+    }
+    position += skip;
+    std::memcpy(frame + position, cursor, length);
+    position += length;
+    cursor += length;
+    copied += length;
+  }
+  return copied == literalBytes;
+}
+
+}  // namespace pixel_pipeline
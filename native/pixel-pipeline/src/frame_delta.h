@@ -0,0 +1,50 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_FRAME_DELTA_H_
+#define CURSORCINE_PIXEL_PIPELINE_FRAME_DELTA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pixel_pipeline {
+
+// Compact encoding of a frame against the previous one the receiver holds,
+// for transports that copy whole frames (the HTTP frame endpoint). Layout:
+//
+//   "CDF1" | u32 frameBytes | u32 changedTiles | u32 literalBytes  (LE)
+//   then tokens of varint skip, varint length, `length` literal bytes
+//
+// Each token leaves `skip` bytes as they were in the base and overwrites the
+// next `length` with the literal; bytes after the last token are unchanged.
+// Literals carry the new bytes rather than an XOR against the base, so
+// decoding is a copy per run.
+constexpr size_t kFrameDeltaHeaderBytes = 16;
+
+// Unchanged tiles are skipped with one memcmp each; changed tiles are
+// narrowed to the 8-byte chunks that actually differ.
+constexpr size_t kFrameDeltaTileBytes = 64;
+constexpr size_t kFrameDeltaChunkBytes = 8;
+
+struct FrameDeltaStats {
+  uint32_t changedTiles = 0;
+  uint32_t literalBytes = 0;
+  size_t encodedBytes = 0;
+};
+
+// Encodes `frame` against `base` (both `bytes` long) into `out`. Returns false
+// once the encoding would exceed `maxEncodedBytes`, when the raw frame is the
+// better thing to send; `out` is unspecified then.
+bool EncodeFrameDelta(const uint8_t* base,
+                      const uint8_t* frame,
+                      size_t bytes,
+                      size_t maxEncodedBytes,
+                      std::vector<uint8_t>* out,
+                      FrameDeltaStats* stats = nullptr);
+
+// Applies `delta` to `frame`, which holds the base on entry. Every length and
+// offset is checked, so a truncated or foreign payload returns false; `frame`
+// may be partly updated then.
+bool DecodeFrameDelta(const uint8_t* delta, size_t deltaBytes, uint8_t* frame, size_t bytes);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_FRAME_DELTA_H_
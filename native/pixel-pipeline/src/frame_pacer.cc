@@ -0,0 +1,56 @@
+#include "frame_pacer.h"
+
+#include <thread>
+
+namespace pixel_pipeline {
+
+namespace {
+
+// 0.25 ms buckets up to 100 ms cover 10..240 fps intervals; 0.05 ms buckets
+// up to 10 ms for lateness.
+constexpr double kIntervalBucketMs = 0.25;
+constexpr int32_t kIntervalBuckets = 400;
+constexpr double kJitterBucketMs = 0.05;
+constexpr int32_t kJitterBuckets = 200;
+
+double ToMs(FramePacer::Clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+}  // namespace
+
+FramePacer::FramePacer(double fps, Clock::time_point start)
+    : fps_(fps),
+      interval_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))),
+      deadline_(start),
+      intervals_(kIntervalBucketMs, kIntervalBuckets),
+      jitter_(kJitterBucketMs, kJitterBuckets) {}
+
+FramePacer::Clock::time_point FramePacer::CoarseWakeTime() const {
+  const auto margin = std::chrono::duration<double, std::milli>(kSpinMarginMs);
+  return deadline_ - std::chrono::duration_cast<Clock::duration>(margin);
+}
+
+void FramePacer::SpinToDeadline() const {
+  while (Clock::now() < deadline_) {
+    std::this_thread::yield();
+  }
+}
+
+void FramePacer::BeginFrame(Clock::time_point now) {
+  if (frames_.load(std::memory_order_relaxed) > 0) {
+    intervals_.Record(ToMs(now - lastStart_));
+  }
+  jitter_.Record(now > deadline_ ? ToMs(now - deadline_) : 0.0);
+  lastStart_ = now;
+  frames_.fetch_add(1, std::memory_order_relaxed);
+
+  deadline_ += interval_;
+  if (deadline_ <= now) {
+    const auto behind = (now - deadline_) / interval_ + 1;
+    missed_.fetch_add(static_cast<uint64_t>(behind), std::memory_order_relaxed);
+    deadline_ += interval_ * behind;
+  }
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,57 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_FRAME_PACER_H_
+#define CURSORCINE_PIXEL_PIPELINE_FRAME_PACER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "histogram.h"
+
+namespace pixel_pipeline {
+
+// Deadline schedule for one capture thread on the monotonic clock. Frame n
+// is due at start + n * interval, so timing error never accumulates. The
+// thread blocks until CoarseWakeTime() (interruptibly, e.g. on a condition
+// variable), then SpinToDeadline() covers the last stretch that OS sleeps
+// cannot hit reliably. BeginFrame() records the frame-to-frame interval and
+// the lateness against the deadline ("jitter").
+class FramePacer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // How long before a deadline the blocking wait ends and spinning starts.
+  // Covers Windows' 1 ms timer resolution (timeBeginPeriod(1)) with margin.
+  static constexpr double kSpinMarginMs = 1.5;
+
+  explicit FramePacer(double fps, Clock::time_point start = Clock::now());
+
+  Clock::time_point Deadline() const { return deadline_; }
+  Clock::time_point CoarseWakeTime() const;
+  void SpinToDeadline() const;
+
+  // Call when frame work starts at `now`. Advances the deadline past `now`;
+  // deadlines already missed are skipped rather than captured in a burst,
+  // and counted in MissedDeadlines().
+  void BeginFrame(Clock::time_point now);
+
+  double fps() const { return fps_; }
+  uint64_t Frames() const { return frames_.load(std::memory_order_relaxed); }
+  uint64_t MissedDeadlines() const { return missed_.load(std::memory_order_relaxed); }
+  const Histogram& Intervals() const { return intervals_; }
+  const Histogram& Jitter() const { return jitter_; }
+
+ private:
+  const double fps_;
+  const Clock::duration interval_;
+  Clock::time_point deadline_;
+  Clock::time_point lastStart_;
+  // Written by the pacing thread only; read from anywhere.
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<uint64_t> missed_{0};
+  Histogram intervals_;
+  Histogram jitter_;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_FRAME_PACER_H_
@@ -0,0 +1,530 @@
+#include "frame_pipe.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <climits>
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace pixel_pipeline {
+
+namespace {
+
+void SetError(std::string* error, const std::string& message) {
+  if (error) {
+    *error = message;
+  }
+}
+
+double MsSince(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+#if defined(_WIN32)
+
+std::wstring Widen(const std::string& text) {
+  if (text.empty()) {
+    return std::wstring();
+  }
+  const int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+  std::wstring wide(static_cast<size_t>(length), L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), &wide[0], length);
+  return wide;
+}
+
+// One argument quoted the way the MSVC runtime's command-line parser splits
+// it back: backslashes are literal unless they precede a quote.
+void AppendQuotedArgument(const std::wstring& arg, std::wstring* commandLine) {
+  if (!commandLine->empty()) {
+    commandLine->push_back(L' ');
+  }
+  if (!arg.empty() && arg.find_first_of(L" \t\n\v\"") == std::wstring::npos) {
+    commandLine->append(arg);
+    return;
+  }
+  commandLine->push_back(L'"');
+  size_t backslashes = 0;
+  for (wchar_t c : arg) {
+    if (c == L'\\') {
+      ++backslashes;
+      continue;
+    }
+    commandLine->append(c == L'"' ? backslashes * 2 + 1 : backslashes, L'\\');
+    backslashes = 0;
+    commandLine->push_back(c);
+  }
+  commandLine->append(backslashes * 2, L'\\');
+  commandLine->push_back(L'"');
+}
+
+bool SpawnProcess(const FramePipeOptions& options,
+                  intptr_t* output,
+                  void** process,
+                  int64_t* processId,
+                  std::string* error) {
+  SECURITY_ATTRIBUTES inherit;
+  std::memset(&inherit, 0, sizeof(inherit));
+  inherit.nLength = sizeof(inherit);
+  inherit.bInheritHandle = TRUE;
+  HANDLE readPipe = nullptr;
+  HANDLE writePipe = nullptr;
+  // A pipe buffer of up to one frame lets the reader run a frame behind
+  // without stalling the writer mid-frame.
+  const DWORD pipeBytes = static_cast<DWORD>(std::min<size_t>(options.frameBytes, 1u << 24));
+  if (!CreatePipe(&readPipe, &writePipe, &inherit, pipeBytes)) {
+    SetError(error, "CreatePipe failed (" + std::to_string(GetLastError()) + ")");
+    return false;
+  }
+  SetHandleInformation(writePipe, HANDLE_FLAG_INHERIT, 0);
+  const std::wstring logPath = options.logPath.empty() ? L"NUL" : Widen(options.logPath);
+  HANDLE log = CreateFileW(logPath.c_str(),
+                           FILE_APPEND_DATA,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           &inherit,
+                           OPEN_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL,
+                           nullptr);
+
+  std::wstring commandLine;
+  for (const std::string& arg : options.command) {
+    AppendQuotedArgument(Widen(arg), &commandLine);
+  }
+  STARTUPINFOW startup;
+  std::memset(&startup, 0, sizeof(startup));
+  startup.cb = sizeof(startup);
+  startup.dwFlags = STARTF_USESTDHANDLES;
+  startup.hStdInput = readPipe;
+  startup.hStdOutput = log;
+  startup.hStdError = log;
+  PROCESS_INFORMATION info;
+  std::memset(&info, 0, sizeof(info));
+  const BOOL started = CreateProcessW(
+      nullptr, &commandLine[0], nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &startup, &info);
+  const DWORD startError = GetLastError();
+  CloseHandle(readPipe);
+  if (log != INVALID_HANDLE_VALUE) {
+    CloseHandle(log);
+  }
+  if (!started) {
+    CloseHandle(writePipe);
+    SetError(error, "cannot start " + options.command[0] + " (" + std::to_string(startError) + ")");
+    return false;
+  }
+  CloseHandle(info.hThread);
+  *output = reinterpret_cast<intptr_t>(writePipe);
+  *process = info.hProcess;
+  *processId = static_cast<int64_t>(info.dwProcessId);
+  return true;
+}
+
+bool OpenPath(const std::string& path, intptr_t* output, std::string* error) {
+  const bool namedPipe = path.rfind("\\\\.\\pipe\\", 0) == 0;
+  HANDLE file = CreateFileW(Widen(path).c_str(),
+                            GENERIC_WRITE,
+                            0,
+                            nullptr,
+                            namedPipe ? OPEN_EXISTING : CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    SetError(error, "cannot open " + path + " (" + std::to_string(GetLastError()) + ")");
+    return false;
+  }
+  *output = reinterpret_cast<intptr_t>(file);
+  return true;
+}
+
+#else
+
+bool SpawnProcess(const FramePipeOptions& options,
+                  intptr_t* output,
+                  void** /*process*/,
+                  int64_t* processId,
+                  std::string* error) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    SetError(error, std::string("pipe failed: ") + std::strerror(errno));
+    return false;
+  }
+  // Neither end may leak into other children; the spawned one gets the read
+  // end as its stdin through dup2, which clears the flag.
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#if defined(F_SETNOSIGPIPE)
+  fcntl(fds[1], F_SETNOSIGPIPE, 1);
+#endif
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, fds[0], STDIN_FILENO);
+  const std::string logPath = options.logPath.empty() ? "/dev/null" : options.logPath;
+  posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+  // Node ignores SIGPIPE and blocked/ignored signals survive exec; the
+  // encoder gets the defaults.
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+  sigset_t defaults;
+  sigemptyset(&defaults);
+  sigaddset(&defaults, SIGPIPE);
+  posix_spawnattr_setsigdefault(&attributes, &defaults);
+  sigset_t unblocked;
+  sigemptyset(&unblocked);
+  posix_spawnattr_setsigmask(&attributes, &unblocked);
+  posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+
+  std::vector<char*> argv;
+  for (const std::string& arg : options.command) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+  pid_t pid = 0;
+  const int spawned = posix_spawnp(&pid, argv[0], &actions, &attributes, argv.data(), environ);
+  posix_spawnattr_destroy(&attributes);
+  posix_spawn_file_actions_destroy(&actions);
+  close(fds[0]);
+  if (spawned != 0) {
+    close(fds[1]);
+    SetError(error, "cannot start " + options.command[0] + ": " + std::strerror(spawned));
+    return false;
+  }
+  *output = fds[1];
+  *processId = pid;
+  return true;
+}
+
+bool OpenPath(const std::string& path, intptr_t* output, std::string* error) {
+  // Non-blocking so a FIFO without a reader fails (ENXIO) instead of
+  // blocking the caller; writes block again afterwards.
+  const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_NONBLOCK | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    SetError(error,
+             "cannot open " + path + ": " + (errno == ENXIO ? std::string("no reader") : std::strerror(errno)));
+    return false;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+#if defined(F_SETNOSIGPIPE)
+  fcntl(fd, F_SETNOSIGPIPE, 1);
+#endif
+  *output = fd;
+  return true;
+}
+
+#endif
+
+}  // namespace
+
+FramePipe::FramePipe(std::shared_ptr<FramePool> pool, bool dropWhenFull)
+    : pool_(std::move(pool)), dropWhenFull_(dropWhenFull) {}
+
+std::unique_ptr<FramePipe> FramePipe::Open(const FramePipeOptions& options, std::string* error) {
+  if (options.frameBytes == 0 || (options.command.empty() && options.path.empty())) {
+    SetError(error, "frame pipe needs a frame size and a command or path");
+    return nullptr;
+  }
+  const int32_t depth = std::min(kFramePipeMaxDepth, std::max(kFramePipeMinDepth, options.depth));
+  std::unique_ptr<FramePipe> pipe(new FramePipe(FramePool::Create(options.frameBytes, depth), options.dropWhenFull));
+  const bool opened = options.command.empty()
+                          ? OpenPath(options.path, &pipe->output_, error)
+                          : SpawnProcess(options, &pipe->output_, &pipe->process_, &pipe->processId_, error);
+  if (!opened) {
+    return nullptr;
+  }
+  pipe->writer_ = std::thread(&FramePipe::RunWriter, pipe.get());
+  return pipe;
+}
+
+FramePipe::~FramePipe() {
+  Close();
+}
+
+std::unique_ptr<FrameLease> FramePipe::AcquireFrame() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  bool stalled = false;
+  std::chrono::steady_clock::time_point stallStart;
+  for (;;) {
+    if (closing_ || stats_.failed) {
+      return nullptr;
+    }
+    std::unique_ptr<FrameLease> frame = pool_->Acquire();
+    if (frame) {
+      if (stalled) {
+        stats_.stallMs += MsSince(stallStart);
+      }
+      return frame;
+    }
+    if (dropWhenFull_) {
+      ++stats_.framesDropped;
+      return nullptr;
+    }
+    if (!stalled) {
+      stalled = true;
+      stallStart = std::chrono::steady_clock::now();
+    }
+    // The writer returns slabs to the pool before it takes the lock to
+    // notify, so a slab freed after the Acquire above still wakes us.
+    frameFreed_.wait(lock);
+  }
+}
+
+void FramePipe::Submit(std::unique_ptr<FrameLease> frame) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closing_ || !frame) {
+      return;
+    }
+    queue_.push_back(std::move(frame));
+  }
+  writerWake_.notify_one();
+}
+
+void FramePipe::RunWriter() {
+#if !defined(_WIN32)
+  // A reader that exits turns writes into EPIPE instead of killing the
+  // process; the SIGPIPE stays pending on this thread and is consumed below.
+  sigset_t pipeSignal;
+  sigemptyset(&pipeSignal);
+  sigaddset(&pipeSignal, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipeSignal, nullptr);
+#endif
+  std::vector<std::unique_ptr<FrameLease>> batch;
+  for (;;) {
+    bool failed = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      writerWake_.wait(lock, [this] { return closing_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        writerDone_ = true;
+        frameFreed_.notify_all();
+        return;
+      }
+      while (!queue_.empty()) {
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+      failed = stats_.failed;
+    }
+    uint64_t writeCalls = 0;
+    std::string error;
+    const bool written = !failed && WriteFrames(batch, &writeCalls, &error);
+#if defined(__linux__)
+    if (!written) {
+      const timespec noWait = {0, 0};
+      sigtimedwait(&pipeSignal, nullptr, &noWait);
+    }
+#endif
+    const uint64_t frames = batch.size();
+    batch.clear();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.writeCalls += writeCalls;
+      if (written) {
+        stats_.framesWritten += frames;
+        stats_.bytesWritten += frames * pool_->slabBytes();
+      } else {
+        stats_.framesDropped += frames;
+        if (!stats_.failed) {
+          stats_.failed = true;
+          stats_.error = error;
+        }
+      }
+    }
+    frameFreed_.notify_all();
+  }
+}
+
+#if defined(_WIN32)
+
+// Anonymous pipes have no gather write (WriteFileGather needs an unbuffered
+// file), so each frame is its own WriteFile loop.
+bool FramePipe::WriteFrames(const std::vector<std::unique_ptr<FrameLease>>& frames,
+                            uint64_t* writeCalls,
+                            std::string* error) {
+  HANDLE output = reinterpret_cast<HANDLE>(output_);
+  for (const std::unique_ptr<FrameLease>& frame : frames) {
+    const uint8_t* data = frame->data();
+    size_t remaining = frame->size();
+    while (remaining > 0) {
+      DWORD written = 0;
+      const DWORD chunk = static_cast<DWORD>(std::min<size_t>(remaining, 1u << 30));
+      ++*writeCalls;
+      if (!WriteFile(output, data, chunk, &written, nullptr)) {
+        SetError(error, "WriteFile failed (" + std::to_string(GetLastError()) + ")");
+        return false;
+      }
+      data += written;
+      remaining -= written;
+    }
+  }
+  return true;
+}
+
+void FramePipe::KillProcess() {
+  if (process_) {
+    TerminateProcess(static_cast<HANDLE>(process_), 1);
+  }
+}
+
+FramePipeExit FramePipe::WaitProcess(int32_t timeoutMs) {
+  FramePipeExit result;
+  HANDLE process = static_cast<HANDLE>(process_);
+  if (WaitForSingleObject(process, static_cast<DWORD>(std::max(0, timeoutMs))) == WAIT_TIMEOUT) {
+    TerminateProcess(process, 1);
+    WaitForSingleObject(process, INFINITE);
+    result.killed = true;
+  }
+  DWORD code = 0;
+  if (!result.killed && GetExitCodeProcess(process, &code)) {
+    result.exited = true;
+    result.exitCode = static_cast<int32_t>(code);
+  }
+  CloseHandle(process);
+  process_ = nullptr;
+  return result;
+}
+
+void FramePipe::CloseOutput() {
+  if (output_ != -1) {
+    CloseHandle(reinterpret_cast<HANDLE>(output_));
+    output_ = -1;
+  }
+}
+
+#else
+
+bool FramePipe::WriteFrames(const std::vector<std::unique_ptr<FrameLease>>& frames,
+                            uint64_t* writeCalls,
+                            std::string* error) {
+  std::vector<iovec> iov(frames.size());
+  for (size_t i = 0; i < frames.size(); ++i) {
+    iov[i].iov_base = frames[i]->data();
+    iov[i].iov_len = frames[i]->size();
+  }
+  size_t next = 0;
+  while (next < iov.size()) {
+    const int count = static_cast<int>(std::min<size_t>(iov.size() - next, IOV_MAX));
+    ++*writeCalls;
+    ssize_t written = writev(static_cast<int>(output_), &iov[next], count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      SetError(error, std::string("write failed: ") + std::strerror(errno));
+      return false;
+    }
+    // Partial writes resume mid-frame.
+    while (written > 0) {
+      const size_t step = std::min(static_cast<size_t>(written), iov[next].iov_len);
+      iov[next].iov_base = static_cast<uint8_t*>(iov[next].iov_base) + step;
+      iov[next].iov_len -= step;
+      written -= static_cast<ssize_t>(step);
+      if (iov[next].iov_len == 0) {
+        ++next;
+      }
+    }
+  }
+  return true;
+}
+
+void FramePipe::KillProcess() {
+  if (processId_ > 0) {
+    kill(static_cast<pid_t>(processId_), SIGKILL);
+  }
+}
+
+FramePipeExit FramePipe::WaitProcess(int32_t timeoutMs) {
+  FramePipeExit result;
+  const pid_t pid = static_cast<pid_t>(processId_);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(0, timeoutMs));
+  int status = 0;
+  for (;;) {
+    const pid_t reaped = waitpid(pid, &status, WNOHANG);
+    if (reaped == pid) {
+      break;
+    }
+    if (reaped < 0 && errno != EINTR) {
+      return result;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      kill(pid, SIGKILL);
+      while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+      }
+      result.killed = true;
+      return result;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  result.exited = true;
+  result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+  return result;
+}
+
+void FramePipe::CloseOutput() {
+  if (output_ != -1) {
+    close(static_cast<int>(output_));
+    output_ = -1;
+  }
+}
+
+#endif
+
+FramePipeExit FramePipe::Close(int32_t timeoutMs) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (closed_) {
+    return exit_;
+  }
+  closed_ = true;
+  closing_ = true;
+  writerWake_.notify_all();
+  frameFreed_.notify_all();
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(0, timeoutMs));
+  const bool drained = !writer_.joinable() || frameFreed_.wait_until(lock, deadline, [this] { return writerDone_; });
+  lock.unlock();
+  if (!drained) {
+    KillProcess();
+  }
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  CloseOutput();
+  FramePipeExit result;
+  if (processId_ != 0) {
+    const int64_t remainingMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    result = WaitProcess(drained ? static_cast<int32_t>(std::max<int64_t>(0, remainingMs)) : 0);
+    if (!drained) {
+      // Reaped after the kill above; its status is the kill, not an exit.
+      result = FramePipeExit();
+      result.killed = true;
+    }
+  } else {
+    result.exited = true;
+    result.exitCode = 0;
+  }
+  lock.lock();
+  exit_ = result;
+  return result;
+}
+
+FramePipeStats FramePipe::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FramePipeStats stats = stats_;
+  stats.queued = static_cast<int32_t>(queue_.size());
+  return stats;
+}
+
+}  // namespace pixel_pipeline
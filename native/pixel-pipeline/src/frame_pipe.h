@@ -0,0 +1,130 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_FRAME_PIPE_H_
+#define CURSORCINE_PIXEL_PIPELINE_FRAME_PIPE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame_pool.h"
+
+namespace pixel_pipeline {
+
+constexpr int32_t kFramePipeDefaultDepth = 4;
+constexpr int32_t kFramePipeMinDepth = 2;
+constexpr int32_t kFramePipeMaxDepth = 16;
+constexpr int32_t kFramePipeDefaultCloseTimeoutMs = 10000;
+
+struct FramePipeOptions {
+  // Spawns command[0] (looked up on PATH) with the rest as its arguments and
+  // writes to its stdin. When empty, `path` is opened for writing instead: a
+  // FIFO or file on POSIX, a named pipe (\\.\pipe\name) or file on Windows.
+  std::vector<std::string> command;
+  std::string path;
+  // The spawned process's stdout and stderr are appended here; discarded
+  // when empty.
+  std::string logPath;
+  size_t frameBytes = 0;
+  // Frames rendered or queued at once (clamped to kFramePipeMinDepth..
+  // kFramePipeMaxDepth).
+  int32_t depth = kFramePipeDefaultDepth;
+  // With every frame still queued, AcquireFrame waits for the writer
+  // (backpressure on the producer) unless `dropWhenFull`, which skips the
+  // frame instead.
+  bool dropWhenFull = false;
+};
+
+struct FramePipeStats {
+  uint64_t framesWritten = 0;
+  uint64_t bytesWritten = 0;
+  uint64_t framesDropped = 0;
+  // Vectored write calls; fewer than framesWritten when the writer batched
+  // queued frames.
+  uint64_t writeCalls = 0;
+  // Time AcquireFrame spent waiting for a free frame.
+  double stallMs = 0.0;
+  int32_t queued = 0;
+  bool failed = false;
+  std::string error;
+};
+
+struct FramePipeExit {
+  // A spawned process that finished within the close timeout; attached
+  // pipes always report exited with code 0.
+  bool exited = false;
+  int32_t exitCode = -1;
+  // Killed after the close timeout.
+  bool killed = false;
+};
+
+// Streams equally sized raw frames (e.g. `ffmpeg -f rawvideo -i -`) into a
+// spawned process or an existing pipe. Frames are rendered straight into
+// FramePool slabs and handed to a writer thread, which drains everything
+// queued with one vectored write (writev; a WriteFile per frame on Windows)
+// and returns the slabs to the pool, so no frame is copied on the way out.
+// AcquireFrame/Submit come from one producer thread; Stats from any.
+class FramePipe {
+ public:
+  // nullptr (with `error` set) when the process cannot be started or the
+  // path opened, e.g. a FIFO nobody is reading yet.
+  static std::unique_ptr<FramePipe> Open(const FramePipeOptions& options, std::string* error);
+
+  ~FramePipe();
+  FramePipe(const FramePipe&) = delete;
+  FramePipe& operator=(const FramePipe&) = delete;
+
+  // A slab of frameBytes for the next frame. nullptr once the pipe failed or
+  // closed, or (dropWhenFull) while every slab is still queued; the frame
+  // counts as dropped then.
+  std::unique_ptr<FrameLease> AcquireFrame();
+  // Queues a frame from AcquireFrame for writing.
+  void Submit(std::unique_ptr<FrameLease> frame);
+
+  // Writes what is queued, closes the pipe (end of input for the reader) and
+  // waits up to `timeoutMs` for a spawned process to exit, killing it after
+  // that. A writer stuck behind a reader that stopped reading is unblocked
+  // by the kill; an attached pipe has no process to kill and waits for its
+  // reader. Later calls return the first result.
+  FramePipeExit Close(int32_t timeoutMs = kFramePipeDefaultCloseTimeoutMs);
+
+  FramePipeStats Stats() const;
+  size_t frameBytes() const { return pool_->slabBytes(); }
+  int32_t depth() const { return pool_->depth(); }
+  // Spawned process id, 0 when attached.
+  int64_t processId() const { return processId_; }
+
+ private:
+  FramePipe(std::shared_ptr<FramePool> pool, bool dropWhenFull);
+  void RunWriter();
+  bool WriteFrames(const std::vector<std::unique_ptr<FrameLease>>& frames, uint64_t* writeCalls, std::string* error);
+  void KillProcess();
+  FramePipeExit WaitProcess(int32_t timeoutMs);
+  void CloseOutput();
+
+  std::shared_ptr<FramePool> pool_;
+  const bool dropWhenFull_;
+  int64_t processId_ = 0;
+  // POSIX file descriptor, or a Windows HANDLE (and the process handle).
+  intptr_t output_ = -1;
+  void* process_ = nullptr;
+
+  mutable std::mutex mutex_;
+  std::condition_variable writerWake_;
+  std::condition_variable frameFreed_;
+  std::deque<std::unique_ptr<FrameLease>> queue_;
+  bool closing_ = false;
+  bool writerDone_ = false;
+  bool closed_ = false;
+  FramePipeExit exit_;
+  FramePipeStats stats_;
+  std::thread writer_;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_FRAME_PIPE_H_
@@ -0,0 +1,456 @@
+#include "frame_pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace pixel_pipeline {
+
+namespace {
+
+// Bands much shorter than this cost more in hand-off than they save.
+constexpr int32_t kMinBandRows = 8;
+// A few bands per thread so a thread that got descheduled does not hold up
+// the frame; idle threads take the remaining bands.
+constexpr int32_t kBandsPerThread = 4;
+
+using Clock = std::chrono::steady_clock;
+
+// A band's share of ProcessTimings, summed locally and flushed once so the
+// rows never touch the shared atomics.
+struct BandTimes {
+  int64_t scaleNs = 0;
+  int64_t toneMapNs = 0;
+  int64_t convertNs = 0;
+
+  void FlushTo(ProcessTimings* timings) const {
+    timings->scaleNs.fetch_add(scaleNs, std::memory_order_relaxed);
+    timings->toneMapNs.fetch_add(toneMapNs, std::memory_order_relaxed);
+    timings->convertNs.fetch_add(convertNs, std::memory_order_relaxed);
+  }
+};
+
+int64_t NsBetween(Clock::time_point begin, Clock::time_point end) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+}
+
+bool ScalesWholeRows(const ScalePlan& plan) {
+  return !plan.IsIdentity() && plan.mode != ScalerMode::kNearest;
+}
+
+// Columns [x0, x1) of output row `y`: sampled (or passed through at 1:1),
+// tone-mapped and swizzled to RGBA in `dstRow` (the start of the row), then
+// the cursor (if any) drawn over them. Box/bilinear rows are always whole.
+// With `times`, the first two steps are timed separately.
+void ProcessRowSpan(const uint8_t* src,
+                    int32_t srcStride,
+                    const FramePipeline& pipeline,
+                    int32_t y,
+                    int32_t x0,
+                    int32_t x1,
+                    std::vector<int16_t>* scratch,
+                    uint8_t* dstRow,
+                    const CursorOverlay* cursor,
+                    BandTimes* times) {
+  const ScalePlan& plan = pipeline.scale;
+  const size_t width = static_cast<size_t>(x1 - x0);
+  const size_t offset = static_cast<size_t>(x0) * 4;
+  const Clock::time_point start = times ? Clock::now() : Clock::time_point();
+  const uint8_t* toneMapSrc = dstRow + offset;
+  if (plan.IsIdentity()) {
+    toneMapSrc = src + static_cast<size_t>(y) * static_cast<size_t>(srcStride) + offset;
+  } else if (plan.mode != ScalerMode::kNearest) {
+    scratch->resize(FilterScratchSize(plan));
+    SampleRowFiltered(src, srcStride, plan, y, scratch->data(), dstRow);
+  } else {
+    SampleRowNearestRange(src, srcStride, plan, y, x0, x1, dstRow);
+  }
+  if (!times) {
+    ApplyPreparedToneMap(toneMapSrc, dstRow + offset, width, pipeline.toneMap);
+  } else {
+    const Clock::time_point sampled = Clock::now();
+    ApplyPreparedToneMap(toneMapSrc, dstRow + offset, width, pipeline.toneMap);
+    times->scaleNs += NsBetween(start, sampled);
+    times->toneMapNs += NsBetween(sampled, Clock::now());
+  }
+  if (cursor) {
+    BlendCursorSpan(*cursor, y, x0, x1, dstRow);
+  }
+}
+
+void ProcessRow(const uint8_t* src,
+                int32_t srcStride,
+                const FramePipeline& pipeline,
+                int32_t y,
+                std::vector<int16_t>* scratch,
+                uint8_t* dstRow,
+                const CursorOverlay* cursor,
+                BandTimes* times) {
+  ProcessRowSpan(src, srcStride, pipeline, y, 0, pipeline.scale.dstWidth, scratch, dstRow, cursor, times);
+}
+
+// Chroma rows [chromaBegin, chromaEnd) of a YUV frame, columns [x0, x1) with
+// x0 even; the whole frame when x0 = 0 and x1 = width.
+void ProcessYuvSpan(const uint8_t* src,
+                    int32_t srcStride,
+                    uint8_t* dst,
+                    const FramePipeline& pipeline,
+                    int32_t chromaBegin,
+                    int32_t chromaEnd,
+                    int32_t x0,
+                    int32_t x1,
+                    const CursorOverlay* cursor,
+                    BandTimes* times) {
+  const FrameLayout& layout = pipeline.output;
+  const int32_t width = pipeline.scale.dstWidth;
+  const int32_t height = pipeline.scale.dstHeight;
+  const size_t rowBytes = static_cast<size_t>(width) * 4;
+  thread_local std::vector<int16_t> scratch;
+  thread_local std::vector<uint8_t> rgba;
+  rgba.resize(rowBytes * 2);
+  const RgbaToYuvRowsFn convert = ActiveYuvKernel();
+  const PlaneLayout& luma = layout.planes[0];
+  const PlaneLayout& chroma = layout.planes[1];
+  const bool nv12 = layout.format == PixelFormat::kNv12;
+  const int32_t chromaStep = nv12 ? 2 : 1;
+  const size_t chromaOffset = static_cast<size_t>(x0 / 2) * static_cast<size_t>(chromaStep);
+  for (int32_t c = chromaBegin; c < chromaEnd; ++c) {
+    const int32_t y0 = c * 2;
+    // The last row of an odd-height frame pairs with itself.
+    const int32_t y1 = std::min(y0 + 1, height - 1);
+    ProcessRowSpan(src, srcStride, pipeline, y0, x0, x1, &scratch, rgba.data(), cursor, times);
+    if (y1 != y0) {
+      ProcessRowSpan(src, srcStride, pipeline, y1, x0, x1, &scratch, rgba.data() + rowBytes, cursor, times);
+    }
+    const Clock::time_point convertStart = times ? Clock::now() : Clock::time_point();
+    uint8_t* u = dst + chroma.offset + static_cast<size_t>(c) * static_cast<size_t>(chroma.stride) + chromaOffset;
+    uint8_t* v = nv12 ? u + 1
+                      : dst + layout.planes[2].offset +
+                            static_cast<size_t>(c) * static_cast<size_t>(layout.planes[2].stride) + chromaOffset;
+    convert(rgba.data() + static_cast<size_t>(x0) * 4,
+            rgba.data() + (y1 != y0 ? rowBytes : 0) + static_cast<size_t>(x0) * 4,
+            x1 - x0,
+            dst + luma.offset + static_cast<size_t>(y0) * static_cast<size_t>(luma.stride) + x0,
+            dst + luma.offset + static_cast<size_t>(y1) * static_cast<size_t>(luma.stride) + x0,
+            u,
+            v,
+            chromaStep,
+            pipeline.yuv);
+    if (times) {
+      times->convertNs += NsBetween(convertStart, Clock::now());
+    }
+  }
+}
+
+DirtyRect NormalizeOutputRect(const FramePipeline& pipeline, DirtyRect rect) {
+  const int32_t width = pipeline.scale.dstWidth;
+  const int32_t height = pipeline.scale.dstHeight;
+  int32_t x0 = std::max(0, rect.x);
+  int32_t y0 = std::max(0, rect.y);
+  int32_t x1 = std::min(width, rect.x + rect.width);
+  int32_t y1 = std::min(height, rect.y + rect.height);
+  if (x0 >= x1 || y0 >= y1) {
+    return DirtyRect();
+  }
+  if (ScalesWholeRows(pipeline.scale)) {
+    x0 = 0;
+    x1 = width;
+  }
+  if (pipeline.output.format != PixelFormat::kRgba8) {
+    x0 &= ~1;
+    y0 &= ~1;
+    x1 = std::min(width, (x1 + 1) & ~1);
+    y1 = std::min(height, (y1 + 1) & ~1);
+  }
+  DirtyRect out;
+  out.x = x0;
+  out.y = y0;
+  out.width = x1 - x0;
+  out.height = y1 - y0;
+  return out;
+}
+
+// [*first, *last) of the output indices whose source index (`sourceOf`,
+// non-decreasing) falls in [begin, end).
+template <typename SourceOf>
+void MapAxis(int32_t count, int32_t begin, int32_t end, SourceOf sourceOf, int32_t* first, int32_t* last) {
+  int32_t lo = 0;
+  int32_t hi = count;
+  while (lo < hi) {
+    const int32_t mid = lo + (hi - lo) / 2;
+    if (sourceOf(mid) < begin) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  *first = lo;
+  hi = count;
+  while (lo < hi) {
+    const int32_t mid = lo + (hi - lo) / 2;
+    if (sourceOf(mid) < end) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  *last = lo;
+}
+
+}  // namespace
+
+void BuildFramePipeline(int32_t srcW,
+                        int32_t srcH,
+                        int32_t dstW,
+                        int32_t dstH,
+                        bool hdrLikely,
+                        const ToneMapConfig& cfg,
+                        FramePipeline* pipeline,
+                        ScalerMode scaler,
+                        PixelFormat format,
+                        YuvRange range) {
+  if (!pipeline) {
+    return;
+  }
+  BuildScalePlan(srcW, srcH, dstW, dstH, &pipeline->scale, scaler);
+  BuildToneMapLut(hdrLikely, cfg, &pipeline->toneMap);
+  pipeline->output = ComputeFrameLayout(format, dstW, dstH);
+  pipeline->yuv = ResolveYuvCoefficients(range);
+}
+
+void ProcessFrameRows(const uint8_t* src,
+                      int32_t srcStride,
+                      uint8_t* dst,
+                      int32_t dstStride,
+                      const FramePipeline& pipeline,
+                      int32_t rowBegin,
+                      int32_t rowEnd,
+                      const CursorOverlay* cursor,
+                      ProcessTimings* timings) {
+  if (!src || !dst || pipeline.scale.dstWidth == 0) {
+    return;
+  }
+  thread_local std::vector<int16_t> scratch;
+  BandTimes times;
+  BandTimes* rowTimes = timings ? &times : nullptr;
+  for (int32_t y = rowBegin; y < rowEnd; ++y) {
+    ProcessRow(src,
+               srcStride,
+               pipeline,
+               y,
+               &scratch,
+               dst + static_cast<size_t>(y) * static_cast<size_t>(dstStride),
+               cursor,
+               rowTimes);
+  }
+  if (timings) {
+    times.FlushTo(timings);
+  }
+}
+
+void ProcessFrameYuvRows(const uint8_t* src,
+                         int32_t srcStride,
+                         uint8_t* dst,
+                         const FramePipeline& pipeline,
+                         int32_t chromaBegin,
+                         int32_t chromaEnd,
+                         const CursorOverlay* cursor,
+                         ProcessTimings* timings) {
+  const int32_t width = pipeline.scale.dstWidth;
+  if (!src || !dst || width == 0 || pipeline.output.format == PixelFormat::kRgba8) {
+    return;
+  }
+  BandTimes times;
+  ProcessYuvSpan(src, srcStride, dst, pipeline, chromaBegin, chromaEnd, 0, width, cursor, timings ? &times : nullptr);
+  if (timings) {
+    times.FlushTo(timings);
+  }
+}
+
+void ProcessFrame(const uint8_t* src,
+                  int32_t srcStride,
+                  uint8_t* dst,
+                  int32_t dstStride,
+                  const FramePipeline& pipeline,
+                  const CursorOverlay* cursor,
+                  ProcessTimings* timings) {
+  if (pipeline.output.format != PixelFormat::kRgba8) {
+    ProcessFrameYuvRows(src, srcStride, dst, pipeline, 0, (pipeline.scale.dstHeight + 1) / 2, cursor, timings);
+    return;
+  }
+  ProcessFrameRows(src, srcStride, dst, dstStride, pipeline, 0, pipeline.scale.dstHeight, cursor, timings);
+}
+
+void ProcessFrameParallel(const uint8_t* src,
+                          int32_t srcStride,
+                          uint8_t* dst,
+                          int32_t dstStride,
+                          const FramePipeline& pipeline,
+                          ThreadPool* pool,
+                          int32_t threads,
+                          const CursorOverlay* cursor,
+                          ProcessTimings* timings) {
+  const bool yuv = pipeline.output.format != PixelFormat::kRgba8;
+  const int32_t rows = yuv ? (pipeline.scale.dstHeight + 1) / 2 : pipeline.scale.dstHeight;
+  const int32_t bands = std::min(rows / kMinBandRows, std::max(1, threads) * kBandsPerThread);
+  if (!pool || threads <= 1 || bands <= 1) {
+    ProcessFrame(src, srcStride, dst, dstStride, pipeline, cursor, timings);
+    return;
+  }
+  pool->ParallelFor(bands, threads, [&](int32_t band) {
+    const int32_t rowBegin = static_cast<int32_t>(static_cast<int64_t>(rows) * band / bands);
+    const int32_t rowEnd = static_cast<int32_t>(static_cast<int64_t>(rows) * (band + 1) / bands);
+    if (yuv) {
+      ProcessFrameYuvRows(src, srcStride, dst, pipeline, rowBegin, rowEnd, cursor, timings);
+    } else {
+      ProcessFrameRows(src, srcStride, dst, dstStride, pipeline, rowBegin, rowEnd, cursor, timings);
+    }
+  });
+}
+
+DirtyRect MapSourceRectToOutput(const FramePipeline& pipeline, const DirtyRect& src) {
+  const ScalePlan& plan = pipeline.scale;
+  if (plan.IsIdentity()) {
+    return NormalizeOutputRect(pipeline, src);
+  }
+  DirtyRect out;
+  int32_t x1 = 0;
+  int32_t y1 = 0;
+  if (plan.mode == ScalerMode::kNearest) {
+    MapAxis(
+        plan.dstWidth, src.x, src.x + src.width, [&](int32_t x) { return plan.columnOffset[x] / 4; }, &out.x, &x1);
+    MapAxis(plan.dstHeight, src.y, src.y + src.height, [&](int32_t y) { return plan.rowIndex[y]; }, &out.y, &y1);
+  } else {
+    // Row y reads source rows [start, start + taps); both ends are
+    // non-decreasing in y, so the rows reaching into the rect are those from
+    // the first with start + taps > src.y up to the first with start past it.
+    const FilterAxis& axis = plan.vertical;
+    MapAxis(plan.dstHeight, src.y + 1, INT32_MAX, [&](int32_t y) { return axis.start[y] + axis.taps; }, &out.y, &y1);
+    int32_t ignored = 0;
+    MapAxis(plan.dstHeight, src.y + src.height, INT32_MAX, [&](int32_t y) { return axis.start[y]; }, &y1, &ignored);
+    out.x = 0;
+    x1 = plan.dstWidth;
+  }
+  out.width = x1 - out.x;
+  out.height = y1 - out.y;
+  return NormalizeOutputRect(pipeline, out);
+}
+
+DirtyRect CursorOutputRect(const FramePipeline& pipeline, const CursorOverlay& cursor) {
+  if (!cursor.sprite) {
+    return DirtyRect();
+  }
+  DirtyRect rect;
+  rect.x = cursor.x;
+  rect.y = cursor.y;
+  rect.width = cursor.sprite->width;
+  rect.height = cursor.sprite->height;
+  return NormalizeOutputRect(pipeline, rect);
+}
+
+void NormalizeOutputRects(const FramePipeline& pipeline, std::vector<DirtyRect>* rects) {
+  size_t kept = 0;
+  for (const DirtyRect& rect : *rects) {
+    const DirtyRect normalized = NormalizeOutputRect(pipeline, rect);
+    if (normalized.width > 0 && normalized.height > 0) {
+      (*rects)[kept++] = normalized;
+    }
+  }
+  rects->resize(kept);
+  CoalesceRects(rects);
+}
+
+void ProcessFrameRects(const uint8_t* src,
+                       int32_t srcStride,
+                       uint8_t* dst,
+                       int32_t dstStride,
+                       const FramePipeline& pipeline,
+                       const std::vector<DirtyRect>& rects,
+                       ThreadPool* pool,
+                       int32_t threads,
+                       const CursorOverlay* cursor,
+                       ProcessTimings* timings) {
+  if (!src || !dst || pipeline.scale.dstWidth == 0 || rects.empty()) {
+    return;
+  }
+  const bool yuv = pipeline.output.format != PixelFormat::kRgba8;
+  // Bands of kMinBandRows rows (row pairs for YUV) across all rects.
+  struct Band {
+    const DirtyRect* rect;
+    int32_t begin;
+    int32_t end;
+  };
+  std::vector<Band> bands;
+  for (const DirtyRect& rect : rects) {
+    const int32_t begin = yuv ? rect.y / 2 : rect.y;
+    const int32_t end = yuv ? (rect.y + rect.height + 1) / 2 : rect.y + rect.height;
+    for (int32_t row = begin; row < end; row += kMinBandRows) {
+      bands.push_back({&rect, row, std::min(end, row + kMinBandRows)});
+    }
+  }
+  auto run = [&](int32_t index) {
+    const Band& band = bands[static_cast<size_t>(index)];
+    const int32_t x0 = band.rect->x;
+    const int32_t x1 = band.rect->x + band.rect->width;
+    BandTimes times;
+    BandTimes* bandTimes = timings ? &times : nullptr;
+    if (yuv) {
+      ProcessYuvSpan(src, srcStride, dst, pipeline, band.begin, band.end, x0, x1, cursor, bandTimes);
+    } else {
+      thread_local std::vector<int16_t> scratch;
+      for (int32_t y = band.begin; y < band.end; ++y) {
+        ProcessRowSpan(src,
+                       srcStride,
+                       pipeline,
+                       y,
+                       x0,
+                       x1,
+                       &scratch,
+                       dst + static_cast<size_t>(y) * static_cast<size_t>(dstStride),
+                       cursor,
+                       bandTimes);
+      }
+    }
+    if (timings) {
+      times.FlushTo(timings);
+    }
+  };
+  const int32_t count = static_cast<int32_t>(bands.size());
+  if (!pool || threads <= 1 || count <= 1) {
+    for (int32_t i = 0; i < count; ++i) {
+      run(i);
+    }
+    return;
+  }
+  pool->ParallelFor(count, threads, run);
+}
+
+void ReduceRgbaHalf(const uint8_t* src,
+                    int32_t srcStride,
+                    int32_t srcW,
+                    int32_t srcH,
+                    uint8_t* dst,
+                    int32_t dstStride,
+                    ThreadPool* pool,
+                    int32_t threads) {
+  static const ReduceHalfRowFn reduceRow = ActiveReduceHalfKernel();
+  const int32_t dstW = srcW / 2;
+  const int32_t dstH = srcH / 2;
+  auto reduceRows = [&](int32_t rowBegin, int32_t rowEnd) {
+    for (int32_t y = rowBegin; y < rowEnd; ++y) {
+      const uint8_t* row0 = src + static_cast<size_t>(2 * y) * static_cast<size_t>(srcStride);
+      reduceRow(row0, row0 + srcStride, dstW, dst + static_cast<size_t>(y) * static_cast<size_t>(dstStride));
+    }
+  };
+  const int32_t bands = std::min(dstH / kMinBandRows, std::max(1, threads) * kBandsPerThread);
+  if (!pool || threads <= 1 || bands <= 1) {
+    reduceRows(0, dstH);
+    return;
+  }
+  pool->ParallelFor(bands, threads, [&](int32_t band) {
+    reduceRows(static_cast<int32_t>(static_cast<int64_t>(dstH) * band / bands),
+               static_cast<int32_t>(static_cast<int64_t>(dstH) * (band + 1) / bands));
+  });
+}
+
+}  // namespace pixel_pipeline
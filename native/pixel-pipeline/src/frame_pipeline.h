@@ -0,0 +1,142 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_FRAME_PIPELINE_H_
+#define CURSORCINE_PIXEL_PIPELINE_FRAME_PIPELINE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "cursor_sprite.h"
+#include "scale.h"
+#include "thread_pool.h"
+#include "tile_change.h"
+#include "tone_map_lut.h"
+#include "yuv.h"
+
+namespace pixel_pipeline {
+
+// Everything CaptureFrame needs to turn one captured BGRA surface into the
+// final output frame (RGBA8, or NV12/I420 laid out as `output`).
+struct FramePipeline {
+  ScalePlan scale;
+  ToneMapLut toneMap;
+  FrameLayout output;
+  YuvCoefficients yuv;
+};
+
+// Thread time spent in each part of the fused pass, summed over every band
+// (so with several threads it can exceed the frame's wall time). Collecting
+// it costs two or three clock reads per row; pass nullptr to skip.
+struct ProcessTimings {
+  std::atomic<int64_t> scaleNs{0};
+  std::atomic<int64_t> toneMapNs{0};
+  std::atomic<int64_t> convertNs{0};
+};
+
+void BuildFramePipeline(int32_t srcW,
+                        int32_t srcH,
+                        int32_t dstW,
+                        int32_t dstH,
+                        bool hdrLikely,
+                        const ToneMapConfig& cfg,
+                        FramePipeline* pipeline,
+                        ScalerMode scaler = ScalerMode::kNearest,
+                        PixelFormat format = PixelFormat::kRgba8,
+                        YuvRange range = YuvRange::kLimited);
+
+// Fused scale + tone-map + BGRA->RGBA swizzle for output rows
+// [rowBegin, rowEnd). Each sampled row is tone-mapped while it is still in
+// cache, so the frame makes one trip through memory instead of two and there
+// is no intermediate full-frame buffer. A non-null `cursor` is blended into
+// the rows it covers after tone mapping, at output resolution.
+void ProcessFrameRows(const uint8_t* src,
+                      int32_t srcStride,
+                      uint8_t* dst,
+                      int32_t dstStride,
+                      const FramePipeline& pipeline,
+                      int32_t rowBegin,
+                      int32_t rowEnd,
+                      const CursorOverlay* cursor = nullptr,
+                      ProcessTimings* timings = nullptr);
+
+// YUV output for chroma rows [chromaBegin, chromaEnd), i.e. luma rows
+// 2 * chromaBegin up to 2 * chromaEnd. Each pair of rows is scaled and
+// tone-mapped into a two-row RGBA scratch and converted while still in cache;
+// planes are written at the offsets and strides in `pipeline.output`.
+void ProcessFrameYuvRows(const uint8_t* src,
+                         int32_t srcStride,
+                         uint8_t* dst,
+                         const FramePipeline& pipeline,
+                         int32_t chromaBegin,
+                         int32_t chromaEnd,
+                         const CursorOverlay* cursor = nullptr,
+                         ProcessTimings* timings = nullptr);
+
+// Whole frame in `pipeline.output.format`; `dstStride` only applies to RGBA8.
+void ProcessFrame(const uint8_t* src,
+                  int32_t srcStride,
+                  uint8_t* dst,
+                  int32_t dstStride,
+                  const FramePipeline& pipeline,
+                  const CursorOverlay* cursor = nullptr,
+                  ProcessTimings* timings = nullptr);
+
+// ProcessFrame split into bands of output rows (row pairs for YUV) on `pool`, using up to
+// `threads` threads including the caller. Output is identical to
+// ProcessFrame; threads <= 1 (or a null pool) runs it inline.
+void ProcessFrameParallel(const uint8_t* src,
+                          int32_t srcStride,
+                          uint8_t* dst,
+                          int32_t dstStride,
+                          const FramePipeline& pipeline,
+                          ThreadPool* pool,
+                          int32_t threads,
+                          const CursorOverlay* cursor = nullptr,
+                          ProcessTimings* timings = nullptr);
+
+// Partial updates for frames whose source changed only in places (see
+// TileChangeTracker). An output rect is "normalized" when it is clipped to
+// the frame, spans whole rows if box/bilinear scaling reads the full source
+// row anyway, and has even edges for YUV, whose chroma covers 2x2 blocks.
+
+// Output pixels that sample source rect `src`: exact columns and rows for
+// 1:1 and nearest scaling, every row whose filter taps reach into it for
+// box/bilinear. Normalized; empty when no output pixel samples it.
+DirtyRect MapSourceRectToOutput(const FramePipeline& pipeline, const DirtyRect& src);
+
+// The output pixels `cursor` covers, normalized.
+DirtyRect CursorOutputRect(const FramePipeline& pipeline, const CursorOverlay& cursor);
+
+// Normalizes every rect, drops empty ones and merges overlaps, so the result
+// can go to ProcessFrameRects.
+void NormalizeOutputRects(const FramePipeline& pipeline, std::vector<DirtyRect>* rects);
+
+// ProcessFrame for normalized, non-overlapping output `rects` only; pixels
+// outside them keep their previous value. Each rect is identical to the
+// same area of a full ProcessFrame. Rows are split into bands on `pool` like
+// ProcessFrameParallel; `timings` covers the rect pixels only.
+void ProcessFrameRects(const uint8_t* src,
+                       int32_t srcStride,
+                       uint8_t* dst,
+                       int32_t dstStride,
+                       const FramePipeline& pipeline,
+                       const std::vector<DirtyRect>& rects,
+                       ThreadPool* pool,
+                       int32_t threads,
+                       const CursorOverlay* cursor = nullptr,
+                       ProcessTimings* timings = nullptr);
+
+// One frame pyramid step: `src` (RGBA8, `srcW` x `srcH`) reduced 2x into
+// `dst`, which is srcW / 2 x srcH / 2; a trailing odd column or row is
+// dropped. Bands of rows run on `pool` like ProcessFrameParallel.
+void ReduceRgbaHalf(const uint8_t* src,
+                    int32_t srcStride,
+                    int32_t srcW,
+                    int32_t srcH,
+                    uint8_t* dst,
+                    int32_t dstStride,
+                    ThreadPool* pool,
+                    int32_t threads);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_FRAME_PIPELINE_H_
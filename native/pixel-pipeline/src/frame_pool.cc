@@ -0,0 +1,62 @@
+#include "frame_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace pixel_pipeline {
+
+FrameLease::FrameLease(std::shared_ptr<FramePool> pool, std::unique_ptr<uint8_t[]> slab, size_t size)
+    : pool_(std::move(pool)), slab_(std::move(slab)), size_(size) {}
+
+FrameLease::~FrameLease() {
+  if (pool_ && slab_) {
+    pool_->Release(std::move(slab_));
+  }
+}
+
+std::shared_ptr<FramePool> FramePool::Create(size_t slabBytes, int32_t depth) {
+  return std::shared_ptr<FramePool>(new FramePool(slabBytes, std::max(1, depth)));
+}
+
+FramePool::FramePool(size_t slabBytes, int32_t depth) : slabBytes_(slabBytes), depth_(depth) {
+  free_.reserve(static_cast<size_t>(depth));
+}
+
+std::unique_ptr<FrameLease> FramePool::Acquire() {
+  std::unique_ptr<uint8_t[]> slab;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (outstanding_ >= depth_) {
+      exhausted_ += 1;
+      return nullptr;
+    }
+    outstanding_ += 1;
+    if (!free_.empty()) {
+      slab = std::move(free_.back());
+      free_.pop_back();
+    }
+  }
+  if (!slab) {
+    // Default-initialized: pages are only touched when the first frame lands.
+    slab.reset(new uint8_t[slabBytes_]);
+  }
+  return std::unique_ptr<FrameLease>(new FrameLease(shared_from_this(), std::move(slab), slabBytes_));
+}
+
+int32_t FramePool::Outstanding() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return outstanding_;
+}
+
+uint64_t FramePool::ExhaustedCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return exhausted_;
+}
+
+void FramePool::Release(std::unique_ptr<uint8_t[]> slab) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  outstanding_ = std::max(0, outstanding_ - 1);
+  free_.push_back(std::move(slab));
+}
+
+}  // namespace pixel_pipeline
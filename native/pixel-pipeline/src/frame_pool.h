@@ -0,0 +1,66 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_FRAME_POOL_H_
+#define CURSORCINE_PIXEL_PIPELINE_FRAME_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pixel_pipeline {
+
+class FramePool;
+
+// One leased slab. Destroying the lease hands the slab back to its pool, so
+// it can be owned by whatever holds the frame (e.g. an N-API external buffer
+// finalizer) and may outlive the capture session that created the pool.
+class FrameLease {
+ public:
+  ~FrameLease();
+  FrameLease(const FrameLease&) = delete;
+  FrameLease& operator=(const FrameLease&) = delete;
+
+  uint8_t* data() { return slab_.get(); }
+  size_t size() const { return size_; }
+
+ private:
+  friend class FramePool;
+  FrameLease(std::shared_ptr<FramePool> pool, std::unique_ptr<uint8_t[]> slab, size_t size);
+
+  std::shared_ptr<FramePool> pool_;
+  std::unique_ptr<uint8_t[]> slab_;
+  size_t size_ = 0;
+};
+
+// Fixed-depth pool of equally sized output frames. Slabs are allocated on
+// first use and recycled most-recently-released first, so steady-state capture
+// does no allocation and reuses cache-warm memory. Thread-safe.
+class FramePool : public std::enable_shared_from_this<FramePool> {
+ public:
+  static std::shared_ptr<FramePool> Create(size_t slabBytes, int32_t depth);
+
+  // nullptr once `depth` slabs are leased out; the caller should report
+  // backpressure and retry after consumers drop frames.
+  std::unique_ptr<FrameLease> Acquire();
+
+  size_t slabBytes() const { return slabBytes_; }
+  int32_t depth() const { return depth_; }
+  int32_t Outstanding() const;
+  uint64_t ExhaustedCount() const;
+
+ private:
+  friend class FrameLease;
+  FramePool(size_t slabBytes, int32_t depth);
+  void Release(std::unique_ptr<uint8_t[]> slab);
+
+  const size_t slabBytes_;
+  const int32_t depth_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<uint8_t[]>> free_;
+  int32_t outstanding_ = 0;
+  uint64_t exhausted_ = 0;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_FRAME_POOL_H_
@@ -0,0 +1,59 @@
+#include "frame_queue.h"
+
+#include <algorithm>
+
+namespace pixel_pipeline {
+
+FrameQueue::FrameQueue(size_t slotBytes, int32_t depth)
+    : slotBytes_(slotBytes),
+      depth_(std::max(1, depth)),
+      storage_(new uint8_t[slotBytes * static_cast<size_t>(depth_ + 2)]()),
+      meta_(static_cast<size_t>(depth_ + 2)) {
+  for (int32_t i = depth_ + 1; i >= 2; --i) {
+    free_.push_back(i);
+  }
+}
+
+void FrameQueue::Publish() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  published_ += 1;
+  meta_[static_cast<size_t>(writing_)].sequence = published_;
+  ready_.push_back(writing_);
+  if (free_.empty()) {
+    // Full: the oldest queued frame makes room for the next write.
+    writing_ = ready_.front();
+    ready_.pop_front();
+    dropped_ += 1;
+  } else {
+    writing_ = free_.back();
+    free_.pop_back();
+  }
+}
+
+uint64_t FrameQueue::Published() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return published_;
+}
+
+bool FrameQueue::AcquireNext() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ready_.empty()) {
+    return false;
+  }
+  free_.push_back(reading_);
+  reading_ = ready_.front();
+  ready_.pop_front();
+  return true;
+}
+
+int32_t FrameQueue::Queued() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<int32_t>(ready_.size());
+}
+
+uint64_t FrameQueue::Dropped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+}  // namespace pixel_pipeline
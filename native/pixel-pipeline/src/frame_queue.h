@@ -0,0 +1,63 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_FRAME_QUEUE_H_
+#define CURSORCINE_PIXEL_PIPELINE_FRAME_QUEUE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "triple_buffer.h"
+
+namespace pixel_pipeline {
+
+// Bounded FIFO of equally sized frames for the `queue-N` drop policy: the
+// consumer gets every frame in capture order as long as it keeps up within
+// `depth` frames. When the queue is full the oldest queued frame is dropped,
+// so the frames handed out are never more than `depth` frames stale. Same
+// producer/consumer surface as TripleBuffer, one producer and one consumer
+// thread; the lock is held only to move slot indices.
+class FrameQueue {
+ public:
+  FrameQueue(size_t slotBytes, int32_t depth);
+  FrameQueue(const FrameQueue&) = delete;
+  FrameQueue& operator=(const FrameQueue&) = delete;
+
+  size_t slotBytes() const { return slotBytes_; }
+  int32_t depth() const { return depth_; }
+
+  // Producer side. WriteSlot/WriteMeta stay valid until the next Publish().
+  uint8_t* WriteSlot() { return Slot(writing_); }
+  TripleBufferMeta* WriteMeta() { return &meta_[static_cast<size_t>(writing_)]; }
+  void Publish();
+  uint64_t Published() const;
+
+  // Consumer side. Returns false when the queue is empty; otherwise
+  // ReadSlot/ReadMeta hold the oldest queued frame until the next call.
+  bool AcquireNext();
+  const uint8_t* ReadSlot() const { return Slot(reading_); }
+  const TripleBufferMeta& ReadMeta() const { return meta_[static_cast<size_t>(reading_)]; }
+  int32_t Queued() const;
+  uint64_t Dropped() const;
+
+ private:
+  uint8_t* Slot(int32_t index) const { return storage_.get() + static_cast<size_t>(index) * slotBytes_; }
+
+  const size_t slotBytes_;
+  const int32_t depth_;
+  // depth + 2 slots: one being written, one being read, `depth` queued.
+  std::unique_ptr<uint8_t[]> storage_;
+  std::vector<TripleBufferMeta> meta_;
+  mutable std::mutex mutex_;
+  std::vector<int32_t> free_;
+  std::deque<int32_t> ready_;
+  int32_t writing_ = 0;  // producer only
+  int32_t reading_ = 1;  // consumer only
+  uint64_t published_ = 0;
+  uint64_t dropped_ = 0;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_FRAME_QUEUE_H_
@@ -0,0 +1,258 @@
+#include "frame_ring.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace pixel_pipeline {
+
+namespace {
+
+constexpr uint32_t kRingMagic = 0x31524643u;  // "CFR1"
+constexpr uint32_t kRingVersion = 2;
+constexpr size_t kPageBytes = 4096;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring atomics must work across processes");
+static_assert(std::atomic<double>::is_always_lock_free, "ring atomics must work across processes");
+static_assert(std::atomic<int32_t>::is_always_lock_free, "ring atomics must work across processes");
+
+// Slot metadata lives in the header page, one cache line per slot. The
+// fields are atomics (relaxed) only so that reading them while the writer
+// may be mid-update is well defined; the seqlock decides whether to trust
+// what was read.
+struct alignas(64) SlotHeader {
+  std::atomic<uint64_t> lock;
+  std::atomic<uint64_t> sequence;
+  std::atomic<double> timestampMs;
+  std::atomic<double> captureMs;
+  std::atomic<double> processMs;
+  std::atomic<int64_t> publishedNs;
+  std::atomic<int32_t> source[4];  // x, y, width, height
+};
+
+static_assert(sizeof(SlotHeader) == 64, "slot metadata must stay one cache line");
+
+struct alignas(64) RingHeader {
+  std::atomic<uint32_t> magic;  // stored last by the writer
+  uint32_t version;
+  uint32_t slotCount;
+  uint32_t pixelFormat;
+  int32_t width;
+  int32_t height;
+  int32_t stride;
+  uint32_t yuvRange;
+  uint64_t frameBytes;
+  uint64_t slotStride;
+  alignas(64) std::atomic<uint64_t> published;
+  SlotHeader slots[kFrameRingMaxSlots];
+};
+
+static_assert(sizeof(RingHeader) <= kPageBytes, "ring header must fit its page");
+
+size_t SlotStride(size_t frameBytes) {
+  return (frameBytes + kPageBytes - 1) / kPageBytes * kPageBytes;
+}
+
+RingHeader* Header(const SharedMemory& memory) {
+  return reinterpret_cast<RingHeader*>(memory.data());
+}
+
+uint8_t* SlotData(const SharedMemory& memory, size_t slotStride, int32_t slot) {
+  return memory.data() + kPageBytes + static_cast<size_t>(slot) * slotStride;
+}
+
+// The reader copies frames with these fields, and they may come from another
+// process: RGBA rows must fit the stride and the last row must end inside
+// the slot; YUV frames must be exactly ComputeFrameLayout's size.
+bool FormatFitsFrame(const FrameRingFormat& format) {
+  if (format.width <= 0 || format.height <= 0 || format.frameBytes == 0) {
+    return false;
+  }
+  const uint64_t rowBytes = static_cast<uint64_t>(format.width) * 4;
+  if (format.format == PixelFormat::kRgba8) {
+    return format.stride >= 0 && static_cast<uint64_t>(format.stride) >= rowBytes &&
+           static_cast<uint64_t>(format.height - 1) * static_cast<uint64_t>(format.stride) + rowBytes <=
+               static_cast<uint64_t>(format.frameBytes);
+  }
+  return format.frameBytes == ComputeFrameLayout(format.format, format.width, format.height).byteLength;
+}
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+std::unique_ptr<FrameRingWriter> FrameRingWriter::Create(const std::string& name,
+                                                         const FrameRingFormat& format,
+                                                         int32_t slots,
+                                                         std::string* error) {
+  if (!FormatFitsFrame(format) || slots < kFrameRingMinSlots || slots > kFrameRingMaxSlots) {
+    if (error) {
+      *error = "invalid frame ring format or slot count";
+    }
+    return nullptr;
+  }
+  std::unique_ptr<SharedMemory> memory =
+      SharedMemory::Create(name, kPageBytes + static_cast<size_t>(slots) * SlotStride(format.frameBytes), error);
+  if (!memory) {
+    return nullptr;
+  }
+  return std::unique_ptr<FrameRingWriter>(new FrameRingWriter(std::move(memory), format, slots));
+}
+
+FrameRingWriter::FrameRingWriter(std::unique_ptr<SharedMemory> memory, const FrameRingFormat& format, int32_t slots)
+    : memory_(std::move(memory)), format_(format), slots_(slots) {
+  RingHeader* header = new (memory_->data()) RingHeader();
+  header->version = kRingVersion;
+  header->slotCount = static_cast<uint32_t>(slots);
+  header->pixelFormat = static_cast<uint32_t>(format.format);
+  header->width = format.width;
+  header->height = format.height;
+  header->stride = format.stride;
+  header->yuvRange = static_cast<uint32_t>(format.range);
+  header->frameBytes = format.frameBytes;
+  header->slotStride = SlotStride(format.frameBytes);
+  // Slot 0 is open for writing from the start.
+  header->slots[0].lock.store(1, std::memory_order_relaxed);
+  header->magic.store(kRingMagic, std::memory_order_release);
+}
+
+uint8_t* FrameRingWriter::WriteSlot() const {
+  return SlotData(*memory_, SlotStride(format_.frameBytes), writing_);
+}
+
+void FrameRingWriter::Publish() {
+  RingHeader* header = Header(*memory_);
+  SlotHeader& slot = header->slots[writing_];
+  meta_.sequence = ++published_;
+  slot.sequence.store(meta_.sequence, std::memory_order_relaxed);
+  slot.timestampMs.store(meta_.timestampMs, std::memory_order_relaxed);
+  slot.captureMs.store(meta_.captureMs, std::memory_order_relaxed);
+  slot.processMs.store(meta_.processMs, std::memory_order_relaxed);
+  slot.publishedNs.store(NowNs(), std::memory_order_relaxed);
+  slot.source[0].store(meta_.sourceX, std::memory_order_relaxed);
+  slot.source[1].store(meta_.sourceY, std::memory_order_relaxed);
+  slot.source[2].store(meta_.sourceWidth, std::memory_order_relaxed);
+  slot.source[3].store(meta_.sourceHeight, std::memory_order_relaxed);
+  // Even again: the pixels and fields above are visible to a reader that
+  // sees this value.
+  slot.lock.store(slot.lock.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  header->published.store(published_, std::memory_order_release);
+
+  // Open the next slot before the pipeline starts writing into it.
+  writing_ = (writing_ + 1) % slots_;
+  SlotHeader& next = header->slots[writing_];
+  next.lock.store(next.lock.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+std::unique_ptr<FrameRingReader> FrameRingReader::Open(const std::string& name, std::string* error) {
+  std::unique_ptr<SharedMemory> memory = SharedMemory::Open(name, false, error);
+  if (!memory) {
+    return nullptr;
+  }
+  const RingHeader* header = memory->size() >= kPageBytes ? Header(*memory) : nullptr;
+  if (!header || header->magic.load(std::memory_order_acquire) != kRingMagic || header->version != kRingVersion ||
+      header->slotCount < static_cast<uint32_t>(kFrameRingMinSlots) ||
+      header->slotCount > static_cast<uint32_t>(kFrameRingMaxSlots) || header->pixelFormat > 2 ||
+      header->slotStride != SlotStride(header->frameBytes) ||
+      memory->size() < kPageBytes + header->slotCount * header->slotStride) {
+    if (error) {
+      *error = "not a frame ring: " + name;
+    }
+    return nullptr;
+  }
+  FrameRingFormat format;
+  format.width = header->width;
+  format.height = header->height;
+  format.stride = header->stride;
+  format.format = static_cast<PixelFormat>(header->pixelFormat);
+  format.range = header->yuvRange == 0 ? YuvRange::kLimited : YuvRange::kFull;
+  format.frameBytes = static_cast<size_t>(header->frameBytes);
+  if (!FormatFitsFrame(format)) {
+    if (error) {
+      *error = "frame ring has an invalid frame format: " + name;
+    }
+    return nullptr;
+  }
+  const int32_t slots = static_cast<int32_t>(header->slotCount);
+  return std::unique_ptr<FrameRingReader>(new FrameRingReader(std::move(memory), format, slots));
+}
+
+FrameRingReader::FrameRingReader(std::unique_ptr<SharedMemory> memory, const FrameRingFormat& format, int32_t slots)
+    : memory_(std::move(memory)), format_(format), slots_(slots) {}
+
+uint64_t FrameRingReader::Published() const {
+  return Header(*memory_)->published.load(std::memory_order_acquire);
+}
+
+bool FrameRingReader::PeekLatest(uint64_t afterSequence, FrameRingFrame* frame, const uint8_t** pixels) const {
+  const RingHeader* header = Header(*memory_);
+  const uint64_t published = header->published.load(std::memory_order_acquire);
+  if (published == 0 || published <= afterSequence) {
+    return false;
+  }
+  const int32_t slot = static_cast<int32_t>((published - 1) % static_cast<uint64_t>(slots_));
+  const SlotHeader& meta = header->slots[slot];
+  const uint64_t generation = meta.lock.load(std::memory_order_acquire);
+  if (generation & 1) {
+    return false;
+  }
+  frame->sequence = meta.sequence.load(std::memory_order_relaxed);
+  frame->timestampMs = meta.timestampMs.load(std::memory_order_relaxed);
+  frame->captureMs = meta.captureMs.load(std::memory_order_relaxed);
+  frame->processMs = meta.processMs.load(std::memory_order_relaxed);
+  frame->publishedNs = meta.publishedNs.load(std::memory_order_relaxed);
+  frame->sourceX = meta.source[0].load(std::memory_order_relaxed);
+  frame->sourceY = meta.source[1].load(std::memory_order_relaxed);
+  frame->sourceWidth = meta.source[2].load(std::memory_order_relaxed);
+  frame->sourceHeight = meta.source[3].load(std::memory_order_relaxed);
+  frame->slot = slot;
+  frame->generation = generation;
+  *pixels = SlotData(*memory_, static_cast<size_t>(header->slotStride), slot);
+  return IsCurrent(*frame) && frame->sequence > afterSequence;
+}
+
+bool FrameRingReader::IsCurrent(const FrameRingFrame& frame) const {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return Header(*memory_)->slots[frame.slot].lock.load(std::memory_order_relaxed) == frame.generation;
+}
+
+bool FrameRingReader::CopyLatest(uint64_t afterSequence,
+                                 uint8_t* dst,
+                                 int32_t dstStride,
+                                 FrameRingFrame* frame) const {
+  constexpr int kAttempts = 4;
+  const int32_t rowBytes = format_.width * 4;
+  for (int attempt = 0; attempt < kAttempts; ++attempt) {
+    const uint8_t* pixels = nullptr;
+    if (!PeekLatest(afterSequence, frame, &pixels)) {
+      continue;
+    }
+    if (format_.format != PixelFormat::kRgba8) {
+      std::memcpy(dst, pixels, format_.frameBytes);
+    } else if (dstStride == format_.stride) {
+      // The last row's padding may not fit in `dst`.
+      std::memcpy(dst,
+                  pixels,
+                  static_cast<size_t>(format_.height - 1) * static_cast<size_t>(format_.stride) +
+                      static_cast<size_t>(rowBytes));
+    } else {
+      for (int32_t y = 0; y < format_.height; ++y) {
+        std::memcpy(dst + static_cast<size_t>(y) * static_cast<size_t>(dstStride),
+                    pixels + static_cast<size_t>(y) * static_cast<size_t>(format_.stride),
+                    static_cast<size_t>(rowBytes));
+      }
+    }
+    if (IsCurrent(*frame)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,133 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_FRAME_RING_H_
+#define CURSORCINE_PIXEL_PIPELINE_FRAME_RING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "shared_memory.h"
+#include "triple_buffer.h"
+#include "yuv.h"
+
+namespace pixel_pipeline {
+
+// Shape of every frame in a ring. `stride` is the RGBA8 row pitch; YUV
+// frames are packed as ComputeFrameLayout lays them out, in `range`.
+struct FrameRingFormat {
+  int32_t width = 0;
+  int32_t height = 0;
+  int32_t stride = 0;
+  PixelFormat format = PixelFormat::kRgba8;
+  YuvRange range = YuvRange::kLimited;
+  size_t frameBytes = 0;
+};
+
+// One published frame as a reader saw it. `publishedNs` is steady_clock at
+// Publish(), which is system-wide (CLOCK_MONOTONIC / QPC), so a reader in
+// another process can subtract it from its own clock to get latency.
+struct FrameRingFrame {
+  uint64_t sequence = 0;  // 1-based, as assigned by the writer
+  double timestampMs = 0.0;
+  double captureMs = 0.0;
+  double processMs = 0.0;
+  int64_t publishedNs = 0;
+  // As in TripleBufferMeta.
+  int32_t sourceX = 0;
+  int32_t sourceY = 0;
+  int32_t sourceWidth = 0;
+  int32_t sourceHeight = 0;
+  int32_t slot = 0;
+  uint64_t generation = 0;  // the slot's seqlock value when read
+};
+
+constexpr int32_t kFrameRingMinSlots = 2;
+constexpr int32_t kFrameRingMaxSlots = 16;
+constexpr int32_t kFrameRingDefaultSlots = 4;
+
+// Single-producer ring of frame slots in named shared memory, so consumers
+// in other processes read frames where the capture pipeline wrote them.
+// Each slot is guarded by a seqlock: odd while the writer fills it, bumped
+// to the next even value when it is published. Readers never block the
+// writer; they check the slot's value before and after using a frame and
+// retry (or drop it) when it changed. The slot being written next is always
+// odd, so readers see at most `slots - 1` frames, and a frame stays intact
+// until the writer has published `slots - 1` more.
+//
+// Same producer surface as TripleBuffer (WriteSlot/WriteMeta/Publish), so the
+// continuous capture thread can render straight into shared memory.
+class FrameRingWriter {
+ public:
+  // nullptr (with `error` set) when the format is empty or its frames do not
+  // fit `frameBytes`, `slots` is outside [kFrameRingMinSlots,
+  // kFrameRingMaxSlots], or the region cannot be created.
+  static std::unique_ptr<FrameRingWriter> Create(const std::string& name,
+                                                 const FrameRingFormat& format,
+                                                 int32_t slots,
+                                                 std::string* error);
+
+  FrameRingWriter(const FrameRingWriter&) = delete;
+  FrameRingWriter& operator=(const FrameRingWriter&) = delete;
+
+  const std::string& name() const { return memory_->name(); }
+  int32_t slots() const { return slots_; }
+  size_t slotBytes() const { return format_.frameBytes; }
+  const FrameRingFormat& format() const { return format_; }
+
+  // WriteSlot/WriteMeta stay valid until the next Publish(). `sequence` in
+  // the meta is assigned by Publish().
+  uint8_t* WriteSlot() const;
+  TripleBufferMeta* WriteMeta() { return &meta_; }
+  void Publish();
+  uint64_t Published() const { return published_; }
+
+ private:
+  FrameRingWriter(std::unique_ptr<SharedMemory> memory, const FrameRingFormat& format, int32_t slots);
+
+  std::unique_ptr<SharedMemory> memory_;
+  FrameRingFormat format_;
+  int32_t slots_ = 0;
+  int32_t writing_ = 0;
+  uint64_t published_ = 0;
+  TripleBufferMeta meta_;
+};
+
+// Consumer side, in any process. Several readers may share a ring; none of
+// them affects the writer or each other.
+class FrameRingReader {
+ public:
+  // nullptr (with `error` set) when `name` does not exist, is not a ring, or
+  // its header describes frames that do not fit the slots.
+  static std::unique_ptr<FrameRingReader> Open(const std::string& name, std::string* error);
+
+  FrameRingReader(const FrameRingReader&) = delete;
+  FrameRingReader& operator=(const FrameRingReader&) = delete;
+
+  const std::string& name() const { return memory_->name(); }
+  int32_t slots() const { return slots_; }
+  const FrameRingFormat& format() const { return format_; }
+  uint64_t Published() const;
+
+  // Zero-copy read of the newest frame with a sequence above
+  // `afterSequence`; false when there is none yet (or the writer lapped the
+  // ring mid-read). `pixels` points into shared memory: call IsCurrent() once
+  // done with it to learn whether the writer reused the slot meanwhile.
+  bool PeekLatest(uint64_t afterSequence, FrameRingFrame* frame, const uint8_t** pixels) const;
+  bool IsCurrent(const FrameRingFrame& frame) const;
+
+  // PeekLatest plus a validated copy into `dst` (RGBA rows `dstStride` bytes
+  // apart; YUV frames need the ring's own layout), retrying torn copies a few
+  // times before giving up.
+  bool CopyLatest(uint64_t afterSequence, uint8_t* dst, int32_t dstStride, FrameRingFrame* frame) const;
+
+ private:
+  FrameRingReader(std::unique_ptr<SharedMemory> memory, const FrameRingFormat& format, int32_t slots);
+
+  std::unique_ptr<SharedMemory> memory_;
+  FrameRingFormat format_;
+  int32_t slots_ = 0;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_FRAME_RING_H_
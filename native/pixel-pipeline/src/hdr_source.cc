@@ -0,0 +1,211 @@
+#include "hdr_source.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace pixel_pipeline {
+
+namespace {
+
+constexpr int32_t kMinBandRows = 8;
+constexpr int32_t kBandsPerThread = 4;
+constexpr float kMaxHalf = 65504.0f;
+
+uint8_t ToByte(float value) {
+  const float v = std::min(1.0f, std::max(0.0f, value));
+  return static_cast<uint8_t>(v * 255.0f + 0.5f);
+}
+
+float SrgbEncode(float linear) {
+  return linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+}
+
+// Shared tail of both decoders: rolloff already applied, `r/g/b` are
+// display-encoded in [0, 1].
+void StoreBgra(float r, float g, float b, const ToneMapParams& params, uint8_t* dst) {
+  if (params.applySaturation) {
+    const float luma = 0.2126f * r + 0.7152f * g + 0.0722f * b;
+    r = luma + (r - luma) * params.saturation;
+    g = luma + (g - luma) * params.saturation;
+    b = luma + (b - luma) * params.saturation;
+  }
+  dst[0] = ToByte(b);
+  dst[1] = ToByte(g);
+  dst[2] = ToByte(r);
+  dst[3] = 255;
+}
+
+float LinearToDisplay(float linear, const ToneMapParams& params) {
+  // NaN and negatives go to 0; +Inf to the largest finite half so the
+  // rolloff below stays finite.
+  float v = linear > 0.0f ? std::min(linear, kMaxHalf) : 0.0f;
+  if (params.applyRolloff) {
+    v = v / (1.0f + params.rolloff * v);
+  }
+  return SrgbEncode(std::min(v, 1.0f));
+}
+
+}  // namespace
+
+const char* SourceFormatName(SourceFormat format) {
+  switch (format) {
+    case SourceFormat::kRgba16f:
+      return "rgba16f";
+    case SourceFormat::kRgb10a2:
+      return "rgb10a2";
+    case SourceFormat::kBgra8:
+    default:
+      return "bgra8";
+  }
+}
+
+bool ParseSourceFormat(const std::string& name, SourceFormat* out) {
+  const SourceFormat formats[] = {SourceFormat::kBgra8, SourceFormat::kRgba16f, SourceFormat::kRgb10a2};
+  for (SourceFormat format : formats) {
+    if (name == SourceFormatName(format)) {
+      if (out) {
+        *out = format;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+int32_t SourceBytesPerPixel(SourceFormat format) {
+  return format == SourceFormat::kRgba16f ? 8 : 4;
+}
+
+float HalfToFloat(uint16_t half) {
+  const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1Fu;
+  const uint32_t mantissa = half & 0x3FFu;
+  uint32_t bits = 0;
+  if (exponent == 0x1Fu) {
+    bits = sign | 0x7F800000u | (mantissa << 13);
+  } else if (exponent != 0) {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  } else if (mantissa != 0) {
+    // Subnormal: scale by 2^-24.
+    const float value = std::ldexp(static_cast<float>(mantissa), -24);
+    return sign ? -value : value;
+  } else {
+    bits = sign;
+  }
+  float value = 0.0f;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+uint16_t FloatToHalf(float value) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+  const uint32_t magnitude = bits & 0x7FFFFFFFu;
+  if (magnitude >= 0x7F800000u) {
+    return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+  }
+  if (magnitude >= 0x477FF000u) {
+    return static_cast<uint16_t>(sign | 0x7C00u);  // rounds past 65504
+  }
+  if (magnitude < 0x38800000u) {
+    // Subnormal or zero: round |value| * 2^24 to nearest even.
+    float absolute = 0.0f;
+    std::memcpy(&absolute, &magnitude, sizeof(absolute));
+    return static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(absolute * 16777216.0f)));
+  }
+  const uint32_t rebased = magnitude - (112u << 23);
+  const uint32_t rounded = rebased + 0xFFFu + ((rebased >> 13) & 1u);
+  return static_cast<uint16_t>(sign | (rounded >> 13));
+}
+
+void DecodeRgba16fScalar(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params) {
+  for (size_t p = 0; p < pixelCount; ++p) {
+    uint16_t rgba[4];
+    std::memcpy(rgba, src + p * 8, sizeof(rgba));
+    StoreBgra(LinearToDisplay(HalfToFloat(rgba[0]), params),
+              LinearToDisplay(HalfToFloat(rgba[1]), params),
+              LinearToDisplay(HalfToFloat(rgba[2]), params),
+              params,
+              dst + p * 4);
+  }
+}
+
+void DecodeRgb10a2Scalar(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params) {
+  for (size_t p = 0; p < pixelCount; ++p) {
+    uint32_t packed = 0;
+    std::memcpy(&packed, src + p * 4, sizeof(packed));
+    float rgb[3] = {
+        static_cast<float>(packed & 0x3FFu) / 1023.0f,
+        static_cast<float>((packed >> 10) & 0x3FFu) / 1023.0f,
+        static_cast<float>((packed >> 20) & 0x3FFu) / 1023.0f,
+    };
+    if (params.applyRolloff) {
+      for (float& c : rgb) {
+        c = c / (1.0f + params.rolloff * c);
+      }
+    }
+    StoreBgra(rgb[0], rgb[1], rgb[2], params, dst + p * 4);
+  }
+}
+
+HdrDecodeFn GetHdrDecodeKernel(SourceFormat format, ToneMapKernel kernel) {
+  if (format == SourceFormat::kBgra8 || GetToneMapKernel(kernel) == nullptr) {
+    return nullptr;
+  }
+  const bool fp16 = format == SourceFormat::kRgba16f;
+  switch (kernel) {
+    case ToneMapKernel::kScalar:
+      return fp16 ? DecodeRgba16fScalar : DecodeRgb10a2Scalar;
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+    case ToneMapKernel::kAvx2:
+      if (fp16 && !GetCpuFeatures().f16c) {
+        return nullptr;
+      }
+      return fp16 ? DecodeRgba16fAvx2 : DecodeRgb10a2Avx2;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+HdrDecodeFn ActiveHdrDecodeKernel(SourceFormat format) {
+  const HdrDecodeFn active = GetHdrDecodeKernel(format, ActiveToneMapKernel());
+  return active ? active : GetHdrDecodeKernel(format, ToneMapKernel::kScalar);
+}
+
+void DecodeHdrSurface(const uint8_t* src,
+                      int32_t srcStride,
+                      SourceFormat format,
+                      int32_t width,
+                      int32_t height,
+                      const ToneMapParams& params,
+                      uint8_t* dst,
+                      int32_t dstStride,
+                      ThreadPool* pool,
+                      int32_t threads) {
+  const HdrDecodeFn decode = ActiveHdrDecodeKernel(format);
+  if (!decode || !src || !dst || width <= 0 || height <= 0) {
+    return;
+  }
+  auto decodeRows = [&](int32_t rowBegin, int32_t rowEnd) {
+    for (int32_t y = rowBegin; y < rowEnd; ++y) {
+      decode(src + static_cast<size_t>(y) * static_cast<size_t>(srcStride),
+             dst + static_cast<size_t>(y) * static_cast<size_t>(dstStride),
+             static_cast<size_t>(width),
+             params);
+    }
+  };
+  const int32_t bands = std::min(height / kMinBandRows, std::max(1, threads) * kBandsPerThread);
+  if (!pool || threads <= 1 || bands <= 1) {
+    decodeRows(0, height);
+    return;
+  }
+  pool->ParallelFor(bands, threads, [&](int32_t band) {
+    decodeRows(static_cast<int32_t>(static_cast<int64_t>(height) * band / bands),
+               static_cast<int32_t>(static_cast<int64_t>(height) * (band + 1) / bands));
+  });
+}
+
+}  // namespace pixel_pipeline
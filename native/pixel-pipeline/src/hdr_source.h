@@ -0,0 +1,76 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_HDR_SOURCE_H_
+#define CURSORCINE_PIXEL_PIPELINE_HDR_SOURCE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "thread_pool.h"
+#include "tone_map.h"
+
+namespace pixel_pipeline {
+
+// Pixel layout of a captured surface.
+enum class SourceFormat {
+  // 8-bit BGRA (GDI DIB, DXGI_FORMAT_B8G8R8A8_UNORM).
+  kBgra8 = 0,
+  // scRGB: linear BT.709 primaries as FP16 RGBA, 1.0 = SDR white (80 nits);
+  // HDR highlights go above 1.0 (DXGI_FORMAT_R16G16B16A16_FLOAT).
+  kRgba16f,
+  // 10-bit gamma-encoded RGB packed R | G << 10 | B << 20 | A << 30
+  // (DXGI_FORMAT_R10G10B10A2_UNORM).
+  kRgb10a2,
+};
+
+const char* SourceFormatName(SourceFormat format);
+bool ParseSourceFormat(const std::string& name, SourceFormat* out);
+int32_t SourceBytesPerPixel(SourceFormat format);
+
+// IEEE 754 binary16 <-> float (round to nearest even), for tests and
+// synthetic sources; the kernels convert with F16C when they can.
+float HalfToFloat(uint16_t half);
+uint16_t FloatToHalf(float value);
+
+// Converts `pixelCount` high-bit-depth pixels at `src` to tone-mapped BGRA8
+// (alpha 255) at `dst`, so the rest of the pipeline only ever sees 8-bit
+// input and highlights are compressed before they are quantized.
+//
+// rgba16f: negative and NaN values clamp to 0; the rolloff (x / (1 + r * x))
+// runs in linear light, so highlights above 1.0 are compressed (at rolloff 1
+// nothing clips) before the result is sRGB encoded and saturated like the
+// 8-bit path.
+// rgb10a2: the 8-bit tone map curve applied to 10-bit code values.
+using HdrDecodeFn = void (*)(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+
+// Float references; SIMD kernels match them within +/-1 LSB.
+void DecodeRgba16fScalar(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+void DecodeRgb10a2Scalar(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+// AVX2 + F16C.
+void DecodeRgba16fAvx2(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+void DecodeRgb10a2Avx2(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+#endif
+
+// Returns nullptr for kBgra8, or when `kernel` is not compiled in or not
+// supported by the CPU for `format`.
+HdrDecodeFn GetHdrDecodeKernel(SourceFormat format, ToneMapKernel kernel);
+
+// Best supported kernel for `format`, following ActiveToneMapKernel().
+HdrDecodeFn ActiveHdrDecodeKernel(SourceFormat format);
+
+// Decodes a whole `width` x `height` surface into BGRA8 at `dst`, in row
+// bands on `pool` when threads > 1.
+void DecodeHdrSurface(const uint8_t* src,
+                      int32_t srcStride,
+                      SourceFormat format,
+                      int32_t width,
+                      int32_t height,
+                      const ToneMapParams& params,
+                      uint8_t* dst,
+                      int32_t dstStride,
+                      ThreadPool* pool = nullptr,
+                      int32_t threads = 1);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_HDR_SOURCE_H_
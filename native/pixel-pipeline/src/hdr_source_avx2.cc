@@ -0,0 +1,148 @@
+#include "hdr_source.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+
+#include <immintrin.h>
+
+#include <cmath>
+
+namespace pixel_pipeline {
+
+namespace {
+
+// sRGB encode sampled on a sqrt(linear) grid: the curve is close to linear
+// in that domain (slope <= 1.5 everywhere), so 4096 nearest-neighbour entries
+// stay far inside one 8-bit step even after a 2x saturation boost.
+constexpr int kEncodeTableSize = 4096;
+
+const float* SrgbEncodeTable() {
+  static const struct Table {
+    float values[kEncodeTableSize];
+    Table() {
+      for (int i = 0; i < kEncodeTableSize; ++i) {
+        const float s = static_cast<float>(i) / (kEncodeTableSize - 1);
+        const float linear = s * s;
+        values[i] = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+      }
+    }
+  } table;
+  return table.values;
+}
+
+struct Constants {
+  __m256 zero;
+  __m256 one;
+  __m256 scale;
+  __m256 half;
+  __m256 rolloff;
+  __m256 sat;
+  __m256 wr;
+  __m256 wg;
+  __m256 wb;
+};
+
+PIXEL_PIPELINE_TARGET("avx2")
+inline Constants MakeConstants(const ToneMapParams& params) {
+  Constants k;
+  k.zero = _mm256_setzero_ps();
+  k.one = _mm256_set1_ps(1.0f);
+  k.scale = _mm256_set1_ps(255.0f);
+  k.half = _mm256_set1_ps(0.5f);
+  k.rolloff = _mm256_set1_ps(params.rolloff);
+  k.sat = _mm256_set1_ps(params.saturation);
+  k.wr = _mm256_set1_ps(0.2126f);
+  k.wg = _mm256_set1_ps(0.7152f);
+  k.wb = _mm256_set1_ps(0.0722f);
+  return k;
+}
+
+PIXEL_PIPELINE_TARGET("avx2")
+inline __m256i ToByteLanes(__m256 value, const Constants& k) {
+  const __m256 clamped = _mm256_min_ps(k.one, _mm256_max_ps(value, k.zero));
+  return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clamped, k.scale), k.half));
+}
+
+// Saturation and quantization shared by both decoders; returns eight BGRA
+// pixels (alpha 255) in lane order.
+PIXEL_PIPELINE_TARGET("avx2")
+inline __m256i PackBgra(__m256 r, __m256 g, __m256 b, const ToneMapParams& params, const Constants& k) {
+  if (params.applySaturation) {
+    const __m256 luma = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(k.wr, r), _mm256_mul_ps(k.wg, g)),
+                                      _mm256_mul_ps(k.wb, b));
+    r = _mm256_add_ps(luma, _mm256_mul_ps(_mm256_sub_ps(r, luma), k.sat));
+    g = _mm256_add_ps(luma, _mm256_mul_ps(_mm256_sub_ps(g, luma), k.sat));
+    b = _mm256_add_ps(luma, _mm256_mul_ps(_mm256_sub_ps(b, luma), k.sat));
+  }
+  const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+  return _mm256_or_si256(_mm256_or_si256(ToByteLanes(b, k), _mm256_slli_epi32(ToByteLanes(g, k), 8)),
+                         _mm256_or_si256(_mm256_slli_epi32(ToByteLanes(r, k), 16), alpha));
+}
+
+PIXEL_PIPELINE_TARGET("avx2,f16c")
+inline __m256 LinearToDisplay(__m256 linear, const ToneMapParams& params, const Constants& k, const float* table) {
+  // maxps returns its second operand for NaN; +Inf clamps to the largest
+  // finite half like the scalar path.
+  __m256 v = _mm256_min_ps(_mm256_max_ps(linear, k.zero), _mm256_set1_ps(65504.0f));
+  if (params.applyRolloff) {
+    v = _mm256_div_ps(v, _mm256_add_ps(k.one, _mm256_mul_ps(k.rolloff, v)));
+  }
+  v = _mm256_min_ps(v, k.one);
+  const __m256 position = _mm256_mul_ps(_mm256_sqrt_ps(v), _mm256_set1_ps(static_cast<float>(kEncodeTableSize - 1)));
+  const __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(position, k.half));
+  return _mm256_i32gather_ps(table, index, 4);
+}
+
+}  // namespace
+
+PIXEL_PIPELINE_TARGET("avx2,f16c")
+void DecodeRgba16fAvx2(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params) {
+  const Constants k = MakeConstants(params);
+  const float* table = SrgbEncodeTable();
+  // Pixels come out of the transpose in lane order 0 2 4 6 1 3 5 7.
+  const __m256i restoreOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  size_t p = 0;
+  for (; p + 8 <= pixelCount; p += 8) {
+    const __m128i* in = reinterpret_cast<const __m128i*>(src + p * 8);
+    // Two RGBA pixels per vector: [R G B A | R G B A].
+    const __m256 p01 = _mm256_cvtph_ps(_mm_loadu_si128(in));
+    const __m256 p23 = _mm256_cvtph_ps(_mm_loadu_si128(in + 1));
+    const __m256 p45 = _mm256_cvtph_ps(_mm_loadu_si128(in + 2));
+    const __m256 p67 = _mm256_cvtph_ps(_mm_loadu_si128(in + 3));
+    const __m256 rg0 = _mm256_unpacklo_ps(p01, p23);
+    const __m256 ba0 = _mm256_unpackhi_ps(p01, p23);
+    const __m256 rg1 = _mm256_unpacklo_ps(p45, p67);
+    const __m256 ba1 = _mm256_unpackhi_ps(p45, p67);
+    const __m256 r = LinearToDisplay(_mm256_shuffle_ps(rg0, rg1, _MM_SHUFFLE(1, 0, 1, 0)), params, k, table);
+    const __m256 g = LinearToDisplay(_mm256_shuffle_ps(rg0, rg1, _MM_SHUFFLE(3, 2, 3, 2)), params, k, table);
+    const __m256 b = LinearToDisplay(_mm256_shuffle_ps(ba0, ba1, _MM_SHUFFLE(1, 0, 1, 0)), params, k, table);
+    const __m256i bgra = _mm256_permutevar8x32_epi32(PackBgra(r, g, b, params, k), restoreOrder);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + p * 4), bgra);
+  }
+  DecodeRgba16fScalar(src + p * 8, dst + p * 4, pixelCount - p, params);
+}
+
+PIXEL_PIPELINE_TARGET("avx2")
+void DecodeRgb10a2Avx2(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params) {
+  const Constants k = MakeConstants(params);
+  const __m256i mask = _mm256_set1_epi32(0x3FF);
+  const __m256 inv1023 = _mm256_set1_ps(1.0f / 1023.0f);
+  size_t p = 0;
+  for (; p + 8 <= pixelCount; p += 8) {
+    // One pixel per lane, so the channels are already planar.
+    const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + p * 4));
+    __m256 r = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(packed, mask)), inv1023);
+    __m256 g = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(packed, 10), mask)), inv1023);
+    __m256 b = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(packed, 20), mask)), inv1023);
+    if (params.applyRolloff) {
+      r = _mm256_div_ps(r, _mm256_add_ps(k.one, _mm256_mul_ps(k.rolloff, r)));
+      g = _mm256_div_ps(g, _mm256_add_ps(k.one, _mm256_mul_ps(k.rolloff, g)));
+      b = _mm256_div_ps(b, _mm256_add_ps(k.one, _mm256_mul_ps(k.rolloff, b)));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + p * 4), PackBgra(r, g, b, params, k));
+  }
+  DecodeRgb10a2Scalar(src + p * 4, dst + p * 4, pixelCount - p, params);
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_X86
@@ -0,0 +1,69 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace pixel_pipeline {
+
+Histogram::Histogram(double bucketMs, int32_t buckets)
+    : bucketMs_(bucketMs > 0.0 ? bucketMs : 1.0), counts_(static_cast<size_t>(std::max(1, buckets)), 0) {}
+
+void Histogram::Record(double ms) {
+  if (!std::isfinite(ms)) {
+    return;
+  }
+  ms = std::max(0.0, ms);
+  const double index = std::floor(ms / bucketMs_);
+  const size_t last = counts_.size() - 1;
+  const size_t bucket = index >= static_cast<double>(last) ? last : static_cast<size_t>(index);
+  std::lock_guard<std::mutex> lock(mutex_);
+  counts_[bucket] += 1;
+  count_ += 1;
+  sumMs_ += ms;
+  maxMs_ = std::max(maxMs_, ms);
+}
+
+void Histogram::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  sumMs_ = 0.0;
+  maxMs_ = 0.0;
+}
+
+double Histogram::PercentileLocked(double fraction) const {
+  const uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count_)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= std::max<uint64_t>(1, rank)) {
+      // The overflow bucket has no upper bound; the max is the best answer.
+      return i + 1 == counts_.size() ? maxMs_ : std::min(maxMs_, static_cast<double>(i + 1) * bucketMs_);
+    }
+  }
+  return maxMs_;
+}
+
+Histogram::Summary Histogram::Snapshot() const {
+  Summary summary;
+  summary.bucketMs = bucketMs_;
+  std::lock_guard<std::mutex> lock(mutex_);
+  summary.count = count_;
+  if (count_ == 0) {
+    return summary;
+  }
+  summary.meanMs = sumMs_ / static_cast<double>(count_);
+  summary.p50Ms = PercentileLocked(0.50);
+  summary.p95Ms = PercentileLocked(0.95);
+  summary.p99Ms = PercentileLocked(0.99);
+  summary.maxMs = maxMs_;
+  size_t used = counts_.size();
+  while (used > 0 && counts_[used - 1] == 0) {
+    --used;
+  }
+  summary.counts.assign(counts_.begin(), counts_.begin() + static_cast<std::ptrdiff_t>(used));
+  return summary;
+}
+
+}  // namespace pixel_pipeline
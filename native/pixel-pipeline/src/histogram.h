@@ -0,0 +1,47 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_HISTOGRAM_H_
+#define CURSORCINE_PIXEL_PIPELINE_HISTOGRAM_H_
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace pixel_pipeline {
+
+// Fixed-width buckets of millisecond samples: bucket i counts values in
+// [i * bucketMs, (i + 1) * bucketMs); the last bucket also takes everything
+// larger. Percentiles are bucket upper bounds, so they are exact to one
+// bucket. Record() and Snapshot() may run on different threads.
+class Histogram {
+ public:
+  struct Summary {
+    uint64_t count = 0;
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double bucketMs = 0.0;
+    // Trailing empty buckets are trimmed.
+    std::vector<uint64_t> counts;
+  };
+
+  Histogram(double bucketMs, int32_t buckets);
+
+  void Record(double ms);
+  void Reset();
+  Summary Snapshot() const;
+
+ private:
+  double PercentileLocked(double fraction) const;
+
+  const double bucketMs_;
+  mutable std::mutex mutex_;
+  std::vector<uint64_t> counts_;
+  uint64_t count_ = 0;
+  double sumMs_ = 0.0;
+  double maxMs_ = 0.0;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_HISTOGRAM_H_
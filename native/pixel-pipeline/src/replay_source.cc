@@ -0,0 +1,43 @@
+#include "replay_source.h"
+
+#include <utility>
+
+namespace pixel_pipeline {
+
+std::unique_ptr<ReplaySource> ReplaySource::Open(const std::string& path, size_t frameBytes, std::string* error) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    if (error) {
+      *error = "cannot open replay file: " + path;
+    }
+    return nullptr;
+  }
+  const std::streamoff size = file.tellg();
+  const uint64_t frameCount = (size > 0 && frameBytes > 0) ? static_cast<uint64_t>(size) / frameBytes : 0;
+  if (frameCount == 0) {
+    if (error) {
+      *error = "replay file holds less than one " + std::to_string(frameBytes) + "-byte frame: " + path;
+    }
+    return nullptr;
+  }
+  file.seekg(0);
+  return std::unique_ptr<ReplaySource>(new ReplaySource(std::move(file), frameBytes, frameCount));
+}
+
+ReplaySource::ReplaySource(std::ifstream file, size_t frameBytes, uint64_t frameCount)
+    : file_(std::move(file)), frameBytes_(frameBytes), frameCount_(frameCount) {}
+
+bool ReplaySource::ReadNext(uint8_t* dst) {
+  if (framesRead_ % frameCount_ == 0) {
+    file_.clear();
+    file_.seekg(0);
+  }
+  file_.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(frameBytes_));
+  if (file_.gcount() != static_cast<std::streamsize>(frameBytes_)) {
+    return false;
+  }
+  framesRead_ += 1;
+  return true;
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,43 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_REPLAY_SOURCE_H_
+#define CURSORCINE_PIXEL_PIPELINE_REPLAY_SOURCE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace pixel_pipeline {
+
+// Streams raw BGRA frames from a headerless file (`frameBytes` per frame, as
+// written by e.g. `ffmpeg -f rawvideo -pix_fmt bgra`), one read per frame,
+// looping back to the first frame after the last. A trailing partial frame
+// is ignored. Not thread-safe; each capture session owns its own source.
+class ReplaySource {
+ public:
+  // nullptr (with `error` set) when the file cannot be opened or holds less
+  // than one frame.
+  static std::unique_ptr<ReplaySource> Open(const std::string& path, size_t frameBytes, std::string* error);
+
+  ReplaySource(const ReplaySource&) = delete;
+  ReplaySource& operator=(const ReplaySource&) = delete;
+
+  // Copies the next frame into `dst` (frameBytes bytes). False on I/O error.
+  bool ReadNext(uint8_t* dst);
+
+  uint64_t frameCount() const { return frameCount_; }
+  // Frames read so far, including loops.
+  uint64_t framesRead() const { return framesRead_; }
+
+ private:
+  ReplaySource(std::ifstream file, size_t frameBytes, uint64_t frameCount);
+
+  std::ifstream file_;
+  size_t frameBytes_ = 0;
+  uint64_t frameCount_ = 0;
+  uint64_t framesRead_ = 0;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_REPLAY_SOURCE_H_
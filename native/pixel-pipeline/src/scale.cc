@@ -0,0 +1,402 @@
+#include "scale.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "tone_map.h"
+
+namespace pixel_pipeline {
+
+namespace {
+
+constexpr int32_t kWeightOne = 1 << kFilterWeightBits;
+constexpr int kVerticalShift = kFilterWeightBits - kFilterIntermediateBits;
+constexpr int kHorizontalShift = kFilterWeightBits + kFilterIntermediateBits;
+
+struct RawTaps {
+  int32_t first = 0;
+  std::vector<double> weights;
+};
+
+RawTaps ComputeBoxTaps(int32_t index, double ratio, int32_t srcLen) {
+  RawTaps taps;
+  const double s0 = index * ratio;
+  const double s1 = std::min(static_cast<double>(srcLen), (index + 1) * ratio);
+  int32_t i0 = static_cast<int32_t>(std::floor(s0));
+  int32_t i1 = static_cast<int32_t>(std::ceil(s1)) - 1;
+  i0 = std::min(srcLen - 1, std::max(0, i0));
+  i1 = std::min(srcLen - 1, std::max(i0, i1));
+  taps.first = i0;
+  for (int32_t i = i0; i <= i1; ++i) {
+    const double overlap = std::min(s1, i + 1.0) - std::max(s0, static_cast<double>(i));
+    taps.weights.push_back(std::max(0.0, overlap));
+  }
+  return taps;
+}
+
+RawTaps ComputeBilinearTaps(int32_t index, double ratio, int32_t srcLen) {
+  RawTaps taps;
+  const double center = (index + 0.5) * ratio - 0.5;
+  int32_t i0 = static_cast<int32_t>(std::floor(center));
+  double frac = center - i0;
+  if (i0 < 0) {
+    i0 = 0;
+    frac = 0.0;
+  }
+  if (i0 >= srcLen - 1) {
+    i0 = srcLen - 1;
+    frac = 0.0;
+  }
+  taps.first = i0;
+  taps.weights.push_back(1.0 - frac);
+  if (frac > 0.0) {
+    taps.weights.push_back(frac);
+  }
+  return taps;
+}
+
+// Quantizes to Q14 so every output's weights sum to exactly 1 << 14 (the
+// rounding remainder goes to the largest tap).
+void QuantizeTaps(const RawTaps& raw, int32_t srcLen, FilterAxis* axis, int32_t index) {
+  const int32_t start = std::max(0, std::min(raw.first, srcLen - axis->taps));
+  axis->start[static_cast<size_t>(index)] = start;
+  int16_t* out = &axis->weights[static_cast<size_t>(index) * static_cast<size_t>(axis->weightStride)];
+  double total = 0.0;
+  for (double w : raw.weights) {
+    total += w;
+  }
+  if (total <= 0.0) {
+    out[raw.first - start] = static_cast<int16_t>(kWeightOne);
+    return;
+  }
+  int32_t sum = 0;
+  int32_t largest = raw.first - start;
+  for (size_t j = 0; j < raw.weights.size(); ++j) {
+    const int32_t slot = raw.first - start + static_cast<int32_t>(j);
+    const int32_t q = static_cast<int32_t>(std::lround(raw.weights[j] / total * kWeightOne));
+    out[slot] = static_cast<int16_t>(q);
+    sum += q;
+    if (out[slot] > out[largest]) {
+      largest = slot;
+    }
+  }
+  out[largest] = static_cast<int16_t>(out[largest] + (kWeightOne - sum));
+}
+
+void BuildFilterAxis(int32_t srcLen, int32_t dstLen, ScalerMode mode, FilterAxis* axis) {
+  const double ratio = static_cast<double>(srcLen) / static_cast<double>(dstLen);
+  std::vector<RawTaps> raw;
+  raw.reserve(static_cast<size_t>(dstLen));
+  int32_t taps = 1;
+  for (int32_t i = 0; i < dstLen; ++i) {
+    raw.push_back(mode == ScalerMode::kBox ? ComputeBoxTaps(i, ratio, srcLen) : ComputeBilinearTaps(i, ratio, srcLen));
+    taps = std::max(taps, static_cast<int32_t>(raw.back().weights.size()));
+  }
+  axis->taps = std::min(taps, srcLen);
+  axis->weightStride = (axis->taps + 1) & ~1;
+  axis->start.assign(static_cast<size_t>(dstLen), 0);
+  axis->weights.assign(static_cast<size_t>(dstLen) * static_cast<size_t>(axis->weightStride), 0);
+  for (int32_t i = 0; i < dstLen; ++i) {
+    QuantizeTaps(raw[static_cast<size_t>(i)], srcLen, axis, i);
+  }
+}
+
+bool UseAvx2() {
+  return ActiveToneMapKernel() == ToneMapKernel::kAvx2;
+}
+
+bool UseSse41() {
+  return ActiveToneMapKernel() == ToneMapKernel::kAvx2 || ActiveToneMapKernel() == ToneMapKernel::kSse41;
+}
+
+// Scaler kernels follow the tone-map ISA choice, so CURSORCINE_PIXEL_KERNEL
+// forces both.
+FilterVerticalFn SelectVertical() {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  if (UseAvx2()) {
+    return FilterVerticalAvx2;
+  }
+  if (UseSse41()) {
+    return FilterVerticalSse41;
+  }
+#endif
+  return FilterVerticalScalar;
+}
+
+FilterHorizontalFn SelectHorizontal() {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  if (UseSse41()) {
+    return FilterHorizontalSse41;
+  }
+#endif
+  return FilterHorizontalScalar;
+}
+
+}  // namespace
+
+void ComputeOutputSize(int32_t srcW, int32_t srcH, int64_t maxOutputPixels, int32_t* outW, int32_t* outH) {
+  if (srcW <= 0 || srcH <= 0) {
+    *outW = 0;
+    *outH = 0;
+    return;
+  }
+  const int64_t srcPixels = static_cast<int64_t>(srcW) * static_cast<int64_t>(srcH);
+  if (srcPixels <= maxOutputPixels) {
+    *outW = srcW;
+    *outH = srcH;
+    return;
+  }
+
+  const double scale = std::sqrt(static_cast<double>(maxOutputPixels) / static_cast<double>(srcPixels));
+  int32_t w = static_cast<int32_t>(std::floor(srcW * scale));
+  int32_t h = static_cast<int32_t>(std::floor(srcH * scale));
+  *outW = std::max(1, w);
+  *outH = std::max(1, h);
+}
+
+bool ComputePyramidLevelSize(int32_t prevW, int32_t prevH, int64_t maxPixels, int32_t* outW, int32_t* outH) {
+  int32_t w = prevW / 2;
+  int32_t h = prevH / 2;
+  while (w > 0 && h > 0 && static_cast<int64_t>(w) * static_cast<int64_t>(h) > maxPixels) {
+    w /= 2;
+    h /= 2;
+  }
+  if (w <= 0 || h <= 0) {
+    return false;
+  }
+  *outW = w;
+  *outH = h;
+  return true;
+}
+
+void FitSourceRegion(int32_t srcW,
+                     int32_t srcH,
+                     int32_t outW,
+                     int32_t outH,
+                     int32_t margin,
+                     int32_t* x,
+                     int32_t* y,
+                     int32_t* width,
+                     int32_t* height) {
+  if (*width <= 0 || *height <= 0 || outW <= 0 || outH <= 0) {
+    *x = 0;
+    *y = 0;
+    *width = srcW;
+    *height = srcH;
+    return;
+  }
+  margin = std::max(0, margin);
+  // Twice the centre, so odd sizes stay exact.
+  const int64_t centreX2 = 2 * static_cast<int64_t>(*x) + *width;
+  const int64_t centreY2 = 2 * static_cast<int64_t>(*y) + *height;
+  int64_t w = static_cast<int64_t>(*width) + 2 * static_cast<int64_t>(margin);
+  int64_t h = static_cast<int64_t>(*height) + 2 * static_cast<int64_t>(margin);
+  if (w * outH < h * outW) {
+    w = (h * outW + outH - 1) / outH;
+  } else {
+    h = (w * outH + outW - 1) / outW;
+  }
+  if (w < outW) {
+    w = outW;
+    h = outH;
+  }
+  w = std::min<int64_t>(w, srcW);
+  h = std::min<int64_t>(h, srcH);
+  *x = static_cast<int32_t>(std::min<int64_t>(srcW - w, std::max<int64_t>(0, (centreX2 - w) / 2)));
+  *y = static_cast<int32_t>(std::min<int64_t>(srcH - h, std::max<int64_t>(0, (centreY2 - h) / 2)));
+  *width = static_cast<int32_t>(w);
+  *height = static_cast<int32_t>(h);
+}
+
+void ReduceHalfRowScalar(const uint8_t* row0, const uint8_t* row1, int32_t dstWidth, uint8_t* dstRow) {
+  for (int32_t x = 0; x < dstWidth; ++x) {
+    const uint8_t* a = row0 + static_cast<size_t>(x) * 8;
+    const uint8_t* b = row1 + static_cast<size_t>(x) * 8;
+    uint8_t* out = dstRow + static_cast<size_t>(x) * 4;
+    for (int c = 0; c < 4; ++c) {
+      out[c] = static_cast<uint8_t>((a[c] + a[c + 4] + b[c] + b[c + 4] + 2) >> 2);
+    }
+  }
+}
+
+ReduceHalfRowFn ActiveReduceHalfKernel() {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  if (UseSse41()) {
+    return ReduceHalfRowSse41;
+  }
+#endif
+  return ReduceHalfRowScalar;
+}
+
+const char* ScalerModeName(ScalerMode mode) {
+  switch (mode) {
+    case ScalerMode::kBox:
+      return "box";
+    case ScalerMode::kBilinear:
+      return "bilinear";
+    case ScalerMode::kNearest:
+    default:
+      return "nearest";
+  }
+}
+
+bool ParseScalerMode(const std::string& name, ScalerMode* out) {
+  const ScalerMode modes[] = {ScalerMode::kNearest, ScalerMode::kBox, ScalerMode::kBilinear};
+  for (ScalerMode mode : modes) {
+    if (name == ScalerModeName(mode)) {
+      if (out) {
+        *out = mode;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void BuildScalePlan(int32_t srcW, int32_t srcH, int32_t dstW, int32_t dstH, ScalePlan* plan, ScalerMode mode) {
+  if (!plan) {
+    return;
+  }
+  plan->mode = mode;
+  plan->srcWidth = srcW;
+  plan->srcHeight = srcH;
+  plan->dstWidth = dstW;
+  plan->dstHeight = dstH;
+  plan->rowIndex.assign(static_cast<size_t>(std::max(0, dstH)), 0);
+  plan->columnOffset.assign(static_cast<size_t>(std::max(0, dstW)), 0);
+  plan->horizontal = FilterAxis();
+  plan->vertical = FilterAxis();
+  if (srcW <= 0 || srcH <= 0 || dstW <= 0 || dstH <= 0) {
+    return;
+  }
+  // Same float expressions as ScaleBgraNearest so both paths pick identical
+  // source pixels.
+  const float xRatio = static_cast<float>(srcW) / static_cast<float>(dstW);
+  const float yRatio = static_cast<float>(srcH) / static_cast<float>(dstH);
+  for (int32_t y = 0; y < dstH; ++y) {
+    plan->rowIndex[static_cast<size_t>(y)] = std::min(srcH - 1, static_cast<int32_t>(y * yRatio));
+  }
+  for (int32_t x = 0; x < dstW; ++x) {
+    plan->columnOffset[static_cast<size_t>(x)] = std::min(srcW - 1, static_cast<int32_t>(x * xRatio)) * 4;
+  }
+  if (mode != ScalerMode::kNearest) {
+    BuildFilterAxis(srcW, dstW, mode, &plan->horizontal);
+    BuildFilterAxis(srcH, dstH, mode, &plan->vertical);
+  }
+}
+
+void SampleRowNearest(const uint8_t* src, int32_t srcStride, const ScalePlan& plan, int32_t y, uint8_t* dstRow) {
+  SampleRowNearestRange(src, srcStride, plan, y, 0, plan.dstWidth, dstRow);
+}
+
+void SampleRowNearestRange(const uint8_t* src,
+                           int32_t srcStride,
+                           const ScalePlan& plan,
+                           int32_t y,
+                           int32_t x0,
+                           int32_t x1,
+                           uint8_t* dstRow) {
+  const uint8_t* srcRow = src + static_cast<size_t>(plan.rowIndex[static_cast<size_t>(y)]) * static_cast<size_t>(srcStride);
+  const int32_t* offsets = plan.columnOffset.data();
+  for (int32_t x = x0; x < x1; ++x) {
+    uint32_t px;
+    std::memcpy(&px, srcRow + offsets[x], 4);
+    px |= 0xFF000000u;
+    std::memcpy(dstRow + static_cast<size_t>(x) * 4, &px, 4);
+  }
+}
+
+size_t FilterScratchSize(const ScalePlan& plan) {
+  // One spare pixel: paired horizontal taps may read start + weightStride - 1.
+  return (static_cast<size_t>(std::max(0, plan.srcWidth)) + 1) * 4;
+}
+
+void SampleRowFiltered(const uint8_t* src,
+                       int32_t srcStride,
+                       const ScalePlan& plan,
+                       int32_t y,
+                       int16_t* scratch,
+                       uint8_t* dstRow) {
+  static const FilterVerticalFn vertical = SelectVertical();
+  static const FilterHorizontalFn horizontal = SelectHorizontal();
+  const FilterAxis& axis = plan.vertical;
+  const int32_t first = axis.start[static_cast<size_t>(y)];
+  const int16_t* weights = &axis.weights[static_cast<size_t>(y) * static_cast<size_t>(axis.weightStride)];
+  thread_local std::vector<const uint8_t*> rows;
+  rows.resize(static_cast<size_t>(axis.weightStride));
+  for (int32_t k = 0; k < axis.weightStride; ++k) {
+    const int32_t sy = first + std::min(k, axis.taps - 1);
+    rows[static_cast<size_t>(k)] = src + static_cast<size_t>(sy) * static_cast<size_t>(srcStride);
+  }
+  const size_t rowBytes = static_cast<size_t>(plan.srcWidth) * 4;
+  vertical(rows.data(), weights, axis.weightStride, rowBytes, scratch);
+  std::memset(scratch + rowBytes, 0, 4 * sizeof(int16_t));
+  horizontal(scratch, plan.horizontal, plan.dstWidth, dstRow);
+}
+
+void FilterVerticalScalar(const uint8_t* const* rows,
+                          const int16_t* weights,
+                          int32_t weightStride,
+                          size_t bytes,
+                          int16_t* out) {
+  for (size_t i = 0; i < bytes; ++i) {
+    int32_t acc = 0;
+    for (int32_t k = 0; k < weightStride; ++k) {
+      acc += static_cast<int32_t>(rows[k][i]) * weights[k];
+    }
+    out[i] = static_cast<int16_t>((acc + (1 << (kVerticalShift - 1))) >> kVerticalShift);
+  }
+}
+
+void FilterHorizontalScalar(const int16_t* row, const FilterAxis& axis, int32_t dstW, uint8_t* dstRow) {
+  for (int32_t x = 0; x < dstW; ++x) {
+    const int16_t* px = row + static_cast<size_t>(axis.start[static_cast<size_t>(x)]) * 4;
+    const int16_t* weights = &axis.weights[static_cast<size_t>(x) * static_cast<size_t>(axis.weightStride)];
+    for (int32_t c = 0; c < 3; ++c) {
+      int32_t acc = 0;
+      for (int32_t k = 0; k < axis.weightStride; ++k) {
+        acc += static_cast<int32_t>(px[k * 4 + c]) * weights[k];
+      }
+      const int32_t v = (acc + (1 << (kHorizontalShift - 1))) >> kHorizontalShift;
+      dstRow[static_cast<size_t>(x) * 4 + c] = static_cast<uint8_t>(std::min(255, std::max(0, v)));
+    }
+    dstRow[static_cast<size_t>(x) * 4 + 3] = 255;
+  }
+}
+
+void ScaleBgraNearest(const uint8_t* src,
+                      int32_t srcW,
+                      int32_t srcH,
+                      int32_t srcStride,
+                      std::vector<uint8_t>* dst,
+                      int32_t dstW,
+                      int32_t dstH) {
+  if (!src || !dst || srcW <= 0 || srcH <= 0 || dstW <= 0 || dstH <= 0) {
+    return;
+  }
+  const size_t dstBytes = static_cast<size_t>(dstW) * static_cast<size_t>(dstH) * 4;
+  if (dst->size() != dstBytes) {
+    dst->resize(dstBytes);
+  }
+  uint8_t* out = dst->data();
+  const float xRatio = static_cast<float>(srcW) / static_cast<float>(dstW);
+  const float yRatio = static_cast<float>(srcH) / static_cast<float>(dstH);
+
+  for (int32_t y = 0; y < dstH; ++y) {
+    const int32_t sy = std::min(srcH - 1, static_cast<int32_t>(y * yRatio));
+    const uint8_t* srcRow = src + static_cast<size_t>(sy) * static_cast<size_t>(srcStride);
+    uint8_t* dstRow = out + static_cast<size_t>(y) * static_cast<size_t>(dstW) * 4;
+    for (int32_t x = 0; x < dstW; ++x) {
+      const int32_t sx = std::min(srcW - 1, static_cast<int32_t>(x * xRatio));
+      const uint8_t* sp = srcRow + static_cast<size_t>(sx) * 4;
+      uint8_t* dp = dstRow + static_cast<size_t>(x) * 4;
+      dp[0] = sp[0];
+      dp[1] = sp[1];
+      dp[2] = sp[2];
+      dp[3] = 255;
+    }
+  }
+}
+
+}  // namespace pixel_pipeline
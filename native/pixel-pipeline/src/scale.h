@@ -0,0 +1,166 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_SCALE_H_
+#define CURSORCINE_PIXEL_PIPELINE_SCALE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cpu_features.h"
+
+namespace pixel_pipeline {
+
+enum class ScalerMode {
+  kNearest = 0,
+  kBox,
+  kBilinear,
+};
+
+// Largest size with the source aspect ratio and at most `maxOutputPixels`
+// pixels (the source size when it already fits); 0x0 for an empty source.
+void ComputeOutputSize(int32_t srcW, int32_t srcH, int64_t maxOutputPixels, int32_t* outW, int32_t* outH);
+
+// Size of the next frame pyramid level below a `prevW` x `prevH` one: halved
+// at least once, and again until it has at most `maxPixels` pixels, so every
+// level is an exact 2^k reduction of the one above. False when halving
+// would reach zero width or height first.
+bool ComputePyramidLevelSize(int32_t prevW, int32_t prevH, int64_t maxPixels, int32_t* outW, int32_t* outH);
+
+// Source region to scale into a fixed `outW` x `outH` output for a requested
+// region of interest (`*x`, `*y`, `*width`, `*height`, updated in place):
+// grown by `margin` pixels on every side, widened around its centre to the
+// output aspect ratio and to at least the output size (so it is never
+// upscaled), then moved and clipped to lie inside the `srcW` x `srcH`
+// surface. An empty request selects the whole surface.
+void FitSourceRegion(int32_t srcW,
+                     int32_t srcH,
+                     int32_t outW,
+                     int32_t outH,
+                     int32_t margin,
+                     int32_t* x,
+                     int32_t* y,
+                     int32_t* width,
+                     int32_t* height);
+
+const char* ScalerModeName(ScalerMode mode);
+bool ParseScalerMode(const std::string& name, ScalerMode* out);
+
+// Filter weights are Q14 and sum to exactly 1 << 14 per output sample. The
+// vertical pass keeps 7 fractional bits so both passes fit signed 16-bit
+// lanes (pmaddwd).
+constexpr int kFilterWeightBits = 14;
+constexpr int kFilterIntermediateBits = 7;
+
+// Separable filter taps along one axis. Every output index reads `taps`
+// consecutive source samples starting at `start[i]`; `weights` holds
+// `weightStride` (taps rounded up to even, zero padded) entries per index.
+struct FilterAxis {
+  int32_t taps = 0;
+  int32_t weightStride = 0;
+  std::vector<int32_t> start;
+  std::vector<int16_t> weights;
+};
+
+// Source row / byte offsets (nearest) or filter taps (box, bilinear) for every
+// output row and column, computed once per session so the per-frame loop does
+// no float-to-int conversion.
+struct ScalePlan {
+  ScalerMode mode = ScalerMode::kNearest;
+  int32_t srcWidth = 0;
+  int32_t srcHeight = 0;
+  int32_t dstWidth = 0;
+  int32_t dstHeight = 0;
+  std::vector<int32_t> rowIndex;
+  std::vector<int32_t> columnOffset;
+  FilterAxis horizontal;
+  FilterAxis vertical;
+
+  bool IsIdentity() const { return srcWidth == dstWidth && srcHeight == dstHeight; }
+};
+
+void BuildScalePlan(int32_t srcW,
+                    int32_t srcH,
+                    int32_t dstW,
+                    int32_t dstH,
+                    ScalePlan* plan,
+                    ScalerMode mode = ScalerMode::kNearest);
+
+// Copies row `y` of the scaled image (BGRA, alpha forced to 255) into `dstRow`.
+void SampleRowNearest(const uint8_t* src, int32_t srcStride, const ScalePlan& plan, int32_t y, uint8_t* dstRow);
+
+// Columns [x0, x1) of that row only; `dstRow` is still the start of the row.
+void SampleRowNearestRange(const uint8_t* src,
+                           int32_t srcStride,
+                           const ScalePlan& plan,
+                           int32_t y,
+                           int32_t x0,
+                           int32_t x1,
+                           uint8_t* dstRow);
+
+// Box/bilinear row `y` into `dstRow` (BGRA, alpha forced to 255). `scratch`
+// must hold FilterScratchSize(plan) entries.
+void SampleRowFiltered(const uint8_t* src,
+                       int32_t srcStride,
+                       const ScalePlan& plan,
+                       int32_t y,
+                       int16_t* scratch,
+                       uint8_t* dstRow);
+
+size_t FilterScratchSize(const ScalePlan& plan);
+
+// Vertical pass: out[i] = round(sum_k rows[k][i] * weights[k]) in Q7.
+// `rows` holds `weightStride` pointers (odd tap counts repeat the last row with
+// a zero weight).
+using FilterVerticalFn = void (*)(const uint8_t* const* rows,
+                                  const int16_t* weights,
+                                  int32_t weightStride,
+                                  size_t bytes,
+                                  int16_t* out);
+// Horizontal pass over one Q7 row into BGRA bytes with alpha forced to 255.
+using FilterHorizontalFn = void (*)(const int16_t* row, const FilterAxis& axis, int32_t dstW, uint8_t* dstRow);
+
+void FilterVerticalScalar(const uint8_t* const* rows,
+                          const int16_t* weights,
+                          int32_t weightStride,
+                          size_t bytes,
+                          int16_t* out);
+void FilterHorizontalScalar(const int16_t* row, const FilterAxis& axis, int32_t dstW, uint8_t* dstRow);
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+void FilterVerticalSse41(const uint8_t* const* rows,
+                         const int16_t* weights,
+                         int32_t weightStride,
+                         size_t bytes,
+                         int16_t* out);
+void FilterVerticalAvx2(const uint8_t* const* rows,
+                        const int16_t* weights,
+                        int32_t weightStride,
+                        size_t bytes,
+                        int16_t* out);
+void FilterHorizontalSse41(const int16_t* row, const FilterAxis& axis, int32_t dstW, uint8_t* dstRow);
+#endif
+
+// 2x box reduction of one output row of a 4-byte-per-pixel image (pyramid
+// levels): output pixel i is the per-channel (sum + 2) >> 2 of pixels 2i and
+// 2i + 1 of `row0` and `row1`.
+using ReduceHalfRowFn = void (*)(const uint8_t* row0, const uint8_t* row1, int32_t dstWidth, uint8_t* dstRow);
+
+void ReduceHalfRowScalar(const uint8_t* row0, const uint8_t* row1, int32_t dstWidth, uint8_t* dstRow);
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+void ReduceHalfRowSse41(const uint8_t* row0, const uint8_t* row1, int32_t dstWidth, uint8_t* dstRow);
+#endif
+
+// Follows the tone-map ISA choice like the filter kernels.
+ReduceHalfRowFn ActiveReduceHalfKernel();
+
+// Reference point-sampling downscaler (BGRA in, BGRA out).
+void ScaleBgraNearest(const uint8_t* src,
+                      int32_t srcW,
+                      int32_t srcH,
+                      int32_t srcStride,
+                      std::vector<uint8_t>* dst,
+                      int32_t dstW,
+                      int32_t dstH);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_SCALE_H_
@@ -0,0 +1,48 @@
+#include "scale.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+
+#include <immintrin.h>
+
+#include <cstring>
+
+namespace pixel_pipeline {
+
+PIXEL_PIPELINE_TARGET("avx2")
+void FilterVerticalAvx2(const uint8_t* const* rows,
+                        const int16_t* weights,
+                        int32_t weightStride,
+                        size_t bytes,
+                        int16_t* out) {
+  constexpr int kShift = kFilterWeightBits - kFilterIntermediateBits;
+  const __m256i round = _mm256_set1_epi32(1 << (kShift - 1));
+  size_t i = 0;
+  for (; i + 16 <= bytes; i += 16) {
+    __m256i accLo = round;
+    __m256i accHi = round;
+    for (int32_t k = 0; k < weightStride; k += 2) {
+      int32_t pair;
+      std::memcpy(&pair, weights + k, sizeof(pair));
+      const __m256i w = _mm256_set1_epi32(pair);
+      const __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + i)));
+      const __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k + 1] + i)));
+      // Per 128-bit lane: lo holds bytes 0-3 | 8-11, hi holds 4-7 | 12-15,
+      // so the packs below lands back in source order without a permute.
+      accLo = _mm256_add_epi32(accLo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), w));
+      accHi = _mm256_add_epi32(accHi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), w));
+    }
+    const __m256i packed = _mm256_packs_epi32(_mm256_srai_epi32(accLo, kShift), _mm256_srai_epi32(accHi, kShift));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+  }
+  for (; i < bytes; ++i) {
+    int32_t acc = 1 << (kShift - 1);
+    for (int32_t k = 0; k < weightStride; ++k) {
+      acc += static_cast<int32_t>(rows[k][i]) * weights[k];
+    }
+    out[i] = static_cast<int16_t>(acc >> kShift);
+  }
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_X86
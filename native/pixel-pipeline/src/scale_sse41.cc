@@ -0,0 +1,145 @@
+#include "scale.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+
+#include <immintrin.h>
+
+#include <cstring>
+
+namespace pixel_pipeline {
+
+namespace {
+
+constexpr int kVerticalShift = kFilterWeightBits - kFilterIntermediateBits;
+constexpr int kHorizontalShift = kFilterWeightBits + kFilterIntermediateBits;
+
+// Two adjacent Q14 taps broadcast as one (w0, w1) lane pair for pmaddwd.
+inline int32_t LoadWeightPair(const int16_t* weights) {
+  int32_t pair;
+  std::memcpy(&pair, weights, sizeof(pair));
+  return pair;
+}
+
+}  // namespace
+
+PIXEL_PIPELINE_TARGET("sse4.1")
+void FilterVerticalSse41(const uint8_t* const* rows,
+                         const int16_t* weights,
+                         int32_t weightStride,
+                         size_t bytes,
+                         int16_t* out) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi32(1 << (kVerticalShift - 1));
+  size_t i = 0;
+  for (; i + 16 <= bytes; i += 16) {
+    __m128i acc0 = round;
+    __m128i acc1 = round;
+    __m128i acc2 = round;
+    __m128i acc3 = round;
+    for (int32_t k = 0; k < weightStride; k += 2) {
+      const __m128i w = _mm_set1_epi32(LoadWeightPair(weights + k));
+      const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + i));
+      const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k + 1] + i));
+      const __m128i aLo = _mm_unpacklo_epi8(a, zero);
+      const __m128i aHi = _mm_unpackhi_epi8(a, zero);
+      const __m128i bLo = _mm_unpacklo_epi8(b, zero);
+      const __m128i bHi = _mm_unpackhi_epi8(b, zero);
+      acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi16(aLo, bLo), w));
+      acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi16(aLo, bLo), w));
+      acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi16(aHi, bHi), w));
+      acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi16(aHi, bHi), w));
+    }
+    const __m128i lo = _mm_packs_epi32(_mm_srai_epi32(acc0, kVerticalShift), _mm_srai_epi32(acc1, kVerticalShift));
+    const __m128i hi = _mm_packs_epi32(_mm_srai_epi32(acc2, kVerticalShift), _mm_srai_epi32(acc3, kVerticalShift));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), hi);
+  }
+  for (; i < bytes; ++i) {
+    int32_t acc = 1 << (kVerticalShift - 1);
+    for (int32_t k = 0; k < weightStride; ++k) {
+      acc += static_cast<int32_t>(rows[k][i]) * weights[k];
+    }
+    out[i] = static_cast<int16_t>(acc >> kVerticalShift);
+  }
+}
+
+namespace {
+
+// One output pixel of the horizontal pass as four int32 channel sums.
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i HorizontalTap(const int16_t* row, const FilterAxis& axis, int32_t x, __m128i pairMask, __m128i round) {
+  const int32_t stride = axis.weightStride;
+  const int16_t* px = row + static_cast<size_t>(axis.start[static_cast<size_t>(x)]) * 4;
+  const int16_t* weights = &axis.weights[static_cast<size_t>(x) * static_cast<size_t>(stride)];
+  __m128i acc = round;
+  for (int32_t k = 0; k < stride; k += 2) {
+    const __m128i pair = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(px + k * 4)), pairMask);
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(pair, _mm_set1_epi32(LoadWeightPair(weights + k))));
+  }
+  return _mm_srai_epi32(acc, kHorizontalShift);
+}
+
+}  // namespace
+
+PIXEL_PIPELINE_TARGET("sse4.1")
+void FilterHorizontalSse41(const int16_t* row, const FilterAxis& axis, int32_t dstW, uint8_t* dstRow) {
+  // [B0 G0 R0 A0 B1 G1 R1 A1] -> [B0 B1 G0 G1 R0 R1 A0 A1]
+  const __m128i pairMask = _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+  const __m128i round = _mm_set1_epi32(1 << (kHorizontalShift - 1));
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+  int32_t x = 0;
+  for (; x + 4 <= dstW; x += 4) {
+    const __m128i v01 = _mm_packs_epi32(HorizontalTap(row, axis, x, pairMask, round),
+                                        HorizontalTap(row, axis, x + 1, pairMask, round));
+    const __m128i v23 = _mm_packs_epi32(HorizontalTap(row, axis, x + 2, pairMask, round),
+                                        HorizontalTap(row, axis, x + 3, pairMask, round));
+    const __m128i bytes = _mm_or_si128(_mm_packus_epi16(v01, v23), alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dstRow + static_cast<size_t>(x) * 4), bytes);
+  }
+  for (; x < dstW; ++x) {
+    const __m128i v = HorizontalTap(row, axis, x, pairMask, round);
+    const __m128i bytes = _mm_or_si128(_mm_packus_epi16(_mm_packs_epi32(v, v), v), alpha);
+    const int32_t value = _mm_cvtsi128_si32(bytes);
+    std::memcpy(dstRow + static_cast<size_t>(x) * 4, &value, 4);
+  }
+}
+
+namespace {
+
+// Two output pixels from four input pixels (16 bytes) of each row: each
+// channel of a pixel pair is shuffled next to its neighbour so one maddubs
+// against ones sums them horizontally in 16 bits.
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i ReducePairSums(__m128i top, __m128i bottom) {
+  const __m128i pairs = _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+  const __m128i ones = _mm_set1_epi8(1);
+  return _mm_add_epi16(_mm_maddubs_epi16(_mm_shuffle_epi8(top, pairs), ones),
+                       _mm_maddubs_epi16(_mm_shuffle_epi8(bottom, pairs), ones));
+}
+
+}  // namespace
+
+PIXEL_PIPELINE_TARGET("sse4.1")
+void ReduceHalfRowSse41(const uint8_t* row0, const uint8_t* row1, int32_t dstWidth, uint8_t* dstRow) {
+  const __m128i round = _mm_set1_epi16(2);
+  int32_t x = 0;
+  for (; x + 4 <= dstWidth; x += 4) {
+    const __m128i* top = reinterpret_cast<const __m128i*>(row0 + static_cast<size_t>(x) * 8);
+    const __m128i* bottom = reinterpret_cast<const __m128i*>(row1 + static_cast<size_t>(x) * 8);
+    const __m128i sums01 = ReducePairSums(_mm_loadu_si128(top), _mm_loadu_si128(bottom));
+    const __m128i sums23 = ReducePairSums(_mm_loadu_si128(top + 1), _mm_loadu_si128(bottom + 1));
+    const __m128i packed = _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(sums01, round), 2),
+                                            _mm_srli_epi16(_mm_add_epi16(sums23, round), 2));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dstRow + static_cast<size_t>(x) * 4), packed);
+  }
+  if (x < dstWidth) {
+    ReduceHalfRowScalar(row0 + static_cast<size_t>(x) * 8,
+                        row1 + static_cast<size_t>(x) * 8,
+                        dstWidth - x,
+                        dstRow + static_cast<size_t>(x) * 4);
+  }
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_X86
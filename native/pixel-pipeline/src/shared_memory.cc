@@ -0,0 +1,186 @@
+#include "shared_memory.h"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pixel_pipeline {
+
+namespace {
+
+void SetError(std::string* error, const std::string& message) {
+  if (error) {
+    *error = message;
+  }
+}
+
+#if defined(_WIN32)
+std::wstring MappingName(const std::string& name) {
+  // Validated names are ASCII.
+  return L"Local\\" + std::wstring(name.begin(), name.end());
+}
+#else
+std::string ShmName(const std::string& name) {
+  return "/" + name;
+}
+#endif
+
+}  // namespace
+
+bool SharedMemory::IsValidName(const std::string& name) {
+  if (name.empty() || name.size() > 64) {
+    return false;
+  }
+  for (char c : name) {
+    const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+SharedMemory::SharedMemory(std::string name, uint8_t* data, size_t size, void* handle, bool owner)
+    : name_(std::move(name)), data_(data), size_(size), handle_(handle), owner_(owner) {}
+
+#if defined(_WIN32)
+
+std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string& name, size_t bytes, std::string* error) {
+  if (!IsValidName(name) || bytes == 0) {
+    SetError(error, "invalid shared memory name or size: " + name);
+    return nullptr;
+  }
+  const uint64_t size = bytes;
+  HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE,
+                                      nullptr,
+                                      PAGE_READWRITE,
+                                      static_cast<DWORD>(size >> 32),
+                                      static_cast<DWORD>(size & 0xFFFFFFFFu),
+                                      MappingName(name).c_str());
+  if (!mapping) {
+    SetError(error, "CreateFileMapping failed for " + name + " (" + std::to_string(GetLastError()) + ")");
+    return nullptr;
+  }
+  if (GetLastError() == ERROR_ALREADY_EXISTS) {
+    CloseHandle(mapping);
+    SetError(error, "shared memory already exists: " + name);
+    return nullptr;
+  }
+  void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+  if (!view) {
+    CloseHandle(mapping);
+    SetError(error, "MapViewOfFile failed for " + name);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemory>(new SharedMemory(name, static_cast<uint8_t*>(view), bytes, mapping, true));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Open(const std::string& name, bool writable, std::string* error) {
+  if (!IsValidName(name)) {
+    SetError(error, "invalid shared memory name: " + name);
+    return nullptr;
+  }
+  const DWORD access = writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ;
+  HANDLE mapping = OpenFileMappingW(access, FALSE, MappingName(name).c_str());
+  if (!mapping) {
+    SetError(error, "shared memory not found: " + name);
+    return nullptr;
+  }
+  void* view = MapViewOfFile(mapping, access, 0, 0, 0);
+  MEMORY_BASIC_INFORMATION info;
+  if (!view || VirtualQuery(view, &info, sizeof(info)) == 0) {
+    if (view) {
+      UnmapViewOfFile(view);
+    }
+    CloseHandle(mapping);
+    SetError(error, "MapViewOfFile failed for " + name);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemory>(
+      new SharedMemory(name, static_cast<uint8_t*>(view), info.RegionSize, mapping, false));
+}
+
+SharedMemory::~SharedMemory() {
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (handle_) {
+    CloseHandle(static_cast<HANDLE>(handle_));
+  }
+}
+
+#else
+
+std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string& name, size_t bytes, std::string* error) {
+  if (!IsValidName(name) || bytes == 0) {
+    SetError(error, "invalid shared memory name or size: " + name);
+    return nullptr;
+  }
+  const int fd = shm_open(ShmName(name).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    SetError(error, std::string(errno == EEXIST ? "shared memory already exists: " : "shm_open failed: ") + name);
+    return nullptr;
+  }
+  void* view = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+    view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (view == MAP_FAILED) {
+    shm_unlink(ShmName(name).c_str());
+    SetError(error, "cannot size or map shared memory: " + name);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemory>(new SharedMemory(name, static_cast<uint8_t*>(view), bytes, nullptr, true));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Open(const std::string& name, bool writable, std::string* error) {
+  if (!IsValidName(name)) {
+    SetError(error, "invalid shared memory name: " + name);
+    return nullptr;
+  }
+  const int fd = shm_open(ShmName(name).c_str(), writable ? O_RDWR : O_RDONLY, 0);
+  if (fd < 0) {
+    SetError(error, "shared memory not found: " + name);
+    return nullptr;
+  }
+  struct stat info;
+  void* view = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    view = mmap(nullptr,
+                static_cast<size_t>(info.st_size),
+                writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                MAP_SHARED,
+                fd,
+                0);
+  }
+  close(fd);
+  if (view == MAP_FAILED) {
+    SetError(error, "cannot map shared memory: " + name);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemory>(
+      new SharedMemory(name, static_cast<uint8_t*>(view), static_cast<size_t>(info.st_size), nullptr, false));
+}
+
+SharedMemory::~SharedMemory() {
+  if (data_) {
+    munmap(data_, size_);
+  }
+  if (owner_) {
+    shm_unlink(ShmName(name_).c_str());
+  }
+}
+
+#endif
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,47 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_SHARED_MEMORY_H_
+#define CURSORCINE_PIXEL_PIPELINE_SHARED_MEMORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace pixel_pipeline {
+
+// A named memory region other processes can map: a pagefile-backed file
+// mapping (`Local\<name>`) on Windows, a POSIX shm object (`/<name>`)
+// elsewhere. Names are 1..64 characters of [A-Za-z0-9_-]. The creator owns
+// the name: on POSIX it is unlinked when the creator's mapping goes away
+// (processes that already opened it keep their mapping), and on Windows it
+// lives as long as any handle to it.
+class SharedMemory {
+ public:
+  // nullptr (with `error` set) for an invalid name, a name already in use, or
+  // a failed allocation. The region starts zeroed.
+  static std::unique_ptr<SharedMemory> Create(const std::string& name, size_t bytes, std::string* error);
+  // Maps an existing region, read-only unless `writable`.
+  static std::unique_ptr<SharedMemory> Open(const std::string& name, bool writable, std::string* error);
+
+  ~SharedMemory();
+  SharedMemory(const SharedMemory&) = delete;
+  SharedMemory& operator=(const SharedMemory&) = delete;
+
+  uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  const std::string& name() const { return name_; }
+
+  static bool IsValidName(const std::string& name);
+
+ private:
+  SharedMemory(std::string name, uint8_t* data, size_t size, void* handle, bool owner);
+
+  std::string name_;
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  void* handle_ = nullptr;  // Windows mapping handle
+  bool owner_ = false;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_SHARED_MEMORY_H_
@@ -0,0 +1,99 @@
+#include "stage_stats.h"
+
+namespace pixel_pipeline {
+
+const char* CaptureStageName(CaptureStage stage) {
+  switch (stage) {
+    case CaptureStage::kCursor:
+      return "cursor";
+    case CaptureStage::kDecode:
+      return "decode";
+    case CaptureStage::kProcess:
+      return "process";
+    case CaptureStage::kScale:
+      return "scale";
+    case CaptureStage::kToneMap:
+      return "tonemap";
+    case CaptureStage::kConvert:
+      return "convert";
+    case CaptureStage::kMarshal:
+      return "marshal";
+    case CaptureStage::kCapture:
+    default:
+      return "capture";
+  }
+}
+
+bool IsFrameStage(CaptureStage stage) {
+  return stage == CaptureStage::kCapture || stage == CaptureStage::kCursor || stage == CaptureStage::kDecode ||
+         stage == CaptureStage::kProcess;
+}
+
+StageStats::Frame::Frame() {
+  for (double& value : ms) {
+    value = -1.0;
+  }
+}
+
+StageStats::StageStats() : total_(kBucketMs, kBuckets) {
+  for (std::unique_ptr<Histogram>& stage : stages_) {
+    stage = std::make_unique<Histogram>(kBucketMs, kBuckets);
+  }
+}
+
+void StageStats::RecordFrame(const Frame& frame, double budgetMs) {
+  double totalMs = 0.0;
+  int32_t slowest = 0;
+  for (int32_t i = 0; i < kCaptureStageCount; ++i) {
+    if (frame.ms[i] < 0.0) {
+      continue;
+    }
+    stages_[i]->Record(frame.ms[i]);
+    if (IsFrameStage(static_cast<CaptureStage>(i))) {
+      totalMs += frame.ms[i];
+      if (frame.ms[i] > frame.ms[slowest]) {
+        slowest = i;
+      }
+    }
+  }
+  total_.Record(totalMs);
+  frames_.fetch_add(1, std::memory_order_relaxed);
+  if (budgetMs > 0.0 && totalMs > budgetMs) {
+    overBudget_.fetch_add(1, std::memory_order_relaxed);
+    overBudgetByStage_[slowest].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void StageStats::RecordFailure() {
+  failures_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StageStats::Record(CaptureStage stage, double ms) {
+  stages_[static_cast<int32_t>(stage)]->Record(ms);
+}
+
+void StageStats::Reset() {
+  for (int32_t i = 0; i < kCaptureStageCount; ++i) {
+    stages_[i]->Reset();
+    overBudgetByStage_[i].store(0, std::memory_order_relaxed);
+  }
+  total_.Reset();
+  frames_.store(0, std::memory_order_relaxed);
+  failures_.store(0, std::memory_order_relaxed);
+  overBudget_.store(0, std::memory_order_relaxed);
+}
+
+StageStats::Snapshot StageStats::Snap() const {
+  Snapshot snapshot;
+  snapshot.frames = frames_.load(std::memory_order_relaxed);
+  snapshot.failures = failures_.load(std::memory_order_relaxed);
+  snapshot.overBudgetFrames = overBudget_.load(std::memory_order_relaxed);
+  for (int32_t i = 0; i < kCaptureStageCount; ++i) {
+    snapshot.overBudgetByStage[i] = overBudgetByStage_[i].load(std::memory_order_relaxed);
+    snapshot.stages[i] = stages_[i]->Snapshot();
+  }
+  snapshot.total = total_.Snapshot();
+  return snapshot;
+}
+
+}  // namespace pixel_pipeline
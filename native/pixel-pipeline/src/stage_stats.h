@@ -0,0 +1,82 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_STAGE_STATS_H_
+#define CURSORCINE_PIXEL_PIPELINE_STAGE_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "histogram.h"
+
+namespace pixel_pipeline {
+
+// Where a captured frame's time goes. kCapture, kCursor, kDecode and
+// kProcess run back to back inside one capture and make up its total;
+// kScale, kToneMap and kConvert split kProcess on sampled frames (the
+// fused pass interleaves them per row); kMarshal is handing the frame to JS,
+// recorded by the read that delivers it.
+enum class CaptureStage {
+  kCapture = 0,
+  kCursor,
+  kDecode,
+  kProcess,
+  kScale,
+  kToneMap,
+  kConvert,
+  kMarshal,
+};
+
+constexpr int32_t kCaptureStageCount = 8;
+
+const char* CaptureStageName(CaptureStage stage);
+
+// True for the stages that add up to a capture's total.
+bool IsFrameStage(CaptureStage stage);
+
+// Per-session stage histograms and counters. Record* may run on the capture
+// thread while Snapshot() runs on the JS thread.
+class StageStats {
+ public:
+  // One capture's stage durations in ms; negative means the stage did not
+  // run for this frame and is not recorded.
+  struct Frame {
+    double ms[kCaptureStageCount];
+    Frame();
+    void Set(CaptureStage stage, double value) { ms[static_cast<int32_t>(stage)] = value; }
+  };
+
+  struct Snapshot {
+    uint64_t frames = 0;
+    uint64_t failures = 0;
+    // Frames whose total exceeded the budget, and which frame stage was the
+    // largest in each of them.
+    uint64_t overBudgetFrames = 0;
+    uint64_t overBudgetByStage[kCaptureStageCount] = {};
+    Histogram::Summary stages[kCaptureStageCount];
+    Histogram::Summary total;
+  };
+
+  StageStats();
+
+  void RecordFrame(const Frame& frame, double budgetMs);
+  void RecordFailure();
+  void Record(CaptureStage stage, double ms);
+  void Reset();
+  Snapshot Snap() const;
+
+ private:
+  // 50 us buckets up to 50 ms; slower samples land in the last bucket (the
+  // max stays exact).
+  static constexpr double kBucketMs = 0.05;
+  static constexpr int32_t kBuckets = 1000;
+
+  std::unique_ptr<Histogram> stages_[kCaptureStageCount];
+  Histogram total_;
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<uint64_t> failures_{0};
+  std::atomic<uint64_t> overBudget_{0};
+  std::atomic<uint64_t> overBudgetByStage_[kCaptureStageCount] = {};
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_STAGE_STATS_H_
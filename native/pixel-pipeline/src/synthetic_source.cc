@@ -0,0 +1,151 @@
+#include "synthetic_source.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace pixel_pipeline {
+
+namespace {
+
+constexpr int32_t kGlyphWidth = 8;
+constexpr int32_t kLineHeight = 16;
+constexpr int32_t kScrollPixelsPerFrame = 2;
+constexpr int32_t kCursorSize = 16;
+
+uint32_t Hash(uint32_t v) {
+  v ^= v >> 16;
+  v *= 0x7FEB352Du;
+  v ^= v >> 15;
+  v *= 0x846CA68Bu;
+  v ^= v >> 16;
+  return v;
+}
+
+// Lines stop at a hashed length, so the text block has a ragged right edge.
+int32_t LineLength(int32_t line) {
+  return static_cast<int32_t>(24u + Hash(static_cast<uint32_t>(line) * 2654435761u) % 72u);
+}
+
+// One bit of a 5x7 glyph row taken from the cell hash; ~1 in 6 cells is a
+// space. `gx` is 0..4, `gy` 0..6.
+bool GlyphBit(uint32_t cell, int32_t gx, int32_t gy) {
+  if (cell % 6u == 0u) {
+    return false;
+  }
+  const int32_t bit = gy * 5 + gx;
+  return ((cell >> (bit % 32)) ^ (cell >> 27)) & 1u;
+}
+
+// Arrow head: right triangle with a vertical left edge and a black outline.
+// 0 = outside, 1 = outline, 2 = fill.
+int32_t CursorPixel(int32_t cx, int32_t cy) {
+  if (cy < 0 || cy >= kCursorSize || cx < 0 || cx > cy) {
+    return 0;
+  }
+  return (cx == 0 || cx == cy || cy == kCursorSize - 1) ? 1 : 2;
+}
+
+}  // namespace
+
+void SyntheticCursorPosition(int32_t width, int32_t height, uint32_t frame, int32_t* x, int32_t* y) {
+  const double t = static_cast<double>(frame) / 60.0;
+  const double rangeX = std::max(0, width - kCursorSize);
+  const double rangeY = std::max(0, height - kCursorSize);
+  *x = static_cast<int32_t>(std::lround(rangeX * (0.5 + 0.5 * std::sin(t * 1.3))));
+  *y = static_cast<int32_t>(std::lround(rangeY * (0.5 + 0.5 * std::sin(t * 0.9 + 1.0))));
+}
+
+void RenderSyntheticFrame(uint8_t* bgra, int32_t width, int32_t height, int32_t stride, uint32_t frame) {
+  // Text occupies the middle half of the width; the rest is gradient only.
+  const int32_t textLeft = width / 4;
+  const int32_t textRight = width - width / 4;
+  const int32_t scroll = static_cast<int32_t>(frame % 65536u) * kScrollPixelsPerFrame;
+  int32_t cursorX = 0;
+  int32_t cursorY = 0;
+  SyntheticCursorPosition(width, height, frame, &cursorX, &cursorY);
+
+  for (int32_t y = 0; y < height; ++y) {
+    uint8_t* row = bgra + static_cast<size_t>(y) * static_cast<size_t>(stride);
+    const uint8_t green = static_cast<uint8_t>((y * 255) / std::max(1, height - 1));
+    for (int32_t x = 0; x < width; ++x) {
+      uint8_t* px = row + static_cast<size_t>(x) * 4;
+      px[0] = static_cast<uint8_t>((x * 255) / std::max(1, width - 1) + frame);
+      px[1] = green;
+      px[2] = static_cast<uint8_t>(((x + y) >> 2) + frame * 3u);
+      px[3] = 0;
+    }
+
+    // Glyph rows 2..8 of each 16-row line hold the 5x7 glyph, columns 1..5 of
+    // each 8-pixel cell.
+    const int32_t textY = y + scroll;
+    const int32_t line = textY / kLineHeight;
+    const int32_t gy = textY % kLineHeight - 2;
+    if (gy >= 0 && gy < 7) {
+      const int32_t columns = std::min(LineLength(line), (textRight - textLeft) / kGlyphWidth - 1);
+      for (int32_t column = 1; column <= columns; ++column) {
+        const uint32_t cell = Hash(static_cast<uint32_t>(line) * 131u + static_cast<uint32_t>(column));
+        uint8_t* cellPx = row + static_cast<size_t>(textLeft + column * kGlyphWidth + 1) * 4;
+        for (int32_t gx = 0; gx < 5; ++gx) {
+          if (GlyphBit(cell, gx, gy)) {
+            cellPx[gx * 4] = cellPx[gx * 4 + 1] = cellPx[gx * 4 + 2] = 250;
+          }
+        }
+      }
+    }
+
+    const int32_t cy = y - cursorY;
+    if (cy >= 0 && cy < kCursorSize) {
+      for (int32_t cx = 0; cx <= cy && cursorX + cx < width; ++cx) {
+        uint8_t* px = row + static_cast<size_t>(cursorX + cx) * 4;
+        const uint8_t v = CursorPixel(cx, cy) == 1 ? 0 : 255;
+        px[0] = px[1] = px[2] = v;
+      }
+    }
+  }
+}
+
+void RenderSyntheticHdrFrame(SourceFormat format,
+                             uint8_t* dst,
+                             int32_t width,
+                             int32_t height,
+                             int32_t stride,
+                             uint32_t frame,
+                             float peak) {
+  if (!dst || width <= 0 || height <= 0 || format == SourceFormat::kBgra8) {
+    return;
+  }
+  constexpr int32_t kBands = 4;
+  const float channelMask[kBands][3] = {{1, 1, 1}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+  const size_t rowBytes = static_cast<size_t>(width) * static_cast<size_t>(SourceBytesPerPixel(format));
+  std::vector<uint8_t> row(rowBytes);
+  const int32_t shift = static_cast<int32_t>((frame * kScrollPixelsPerFrame) % static_cast<uint32_t>(width));
+  // Every row of a band is the same, so each band row is built once and copied.
+  for (int32_t band = 0; band < kBands; ++band) {
+    for (int32_t x = 0; x < width; ++x) {
+      const float t = static_cast<float>((x + shift) % width) / static_cast<float>(std::max(1, width - 1));
+      const float* mask = channelMask[band];
+      if (format == SourceFormat::kRgba16f) {
+        const uint16_t rgba[4] = {FloatToHalf(t * peak * mask[0]),
+                                  FloatToHalf(t * peak * mask[1]),
+                                  FloatToHalf(t * peak * mask[2]),
+                                  FloatToHalf(1.0f)};
+        std::memcpy(row.data() + static_cast<size_t>(x) * 8, rgba, sizeof(rgba));
+      } else {
+        const uint32_t code = static_cast<uint32_t>(std::min(1.0f, t * peak) * 1023.0f + 0.5f);
+        const uint32_t packed = (code * static_cast<uint32_t>(mask[0])) |
+                                ((code * static_cast<uint32_t>(mask[1])) << 10) |
+                                ((code * static_cast<uint32_t>(mask[2])) << 20) | (3u << 30);
+        std::memcpy(row.data() + static_cast<size_t>(x) * 4, &packed, sizeof(packed));
+      }
+    }
+    const int32_t rowBegin = height * band / kBands;
+    const int32_t rowEnd = height * (band + 1) / kBands;
+    for (int32_t y = rowBegin; y < rowEnd; ++y) {
+      std::memcpy(dst + static_cast<size_t>(y) * static_cast<size_t>(stride), row.data(), rowBytes);
+    }
+  }
+}
+
+}  // namespace pixel_pipeline
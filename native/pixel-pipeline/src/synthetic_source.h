@@ -0,0 +1,35 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_SYNTHETIC_SOURCE_H_
+#define CURSORCINE_PIXEL_PIPELINE_SYNTHETIC_SOURCE_H_
+
+#include <cstdint>
+
+#include "hdr_source.h"
+
+namespace pixel_pipeline {
+
+// Deterministic stand-in for a desktop capture: a drifting gradient, lines of
+// glyph-like blocks scrolling upwards and an arrow cursor on a Lissajous path.
+// Frame `frame` is always the same image for a given size, so runs are
+// reproducible and two sessions agree frame for frame. Writes BGRA with the
+// alpha byte left 0, like a GDI DIB.
+void RenderSyntheticFrame(uint8_t* bgra, int32_t width, int32_t height, int32_t stride, uint32_t frame);
+
+// High-bit-depth test pattern in `format` (rgba16f or rgb10a2): four bands
+// (white, red, green, blue) from top to bottom, each ramping left to right
+// from 0 up to `peak` in scRGB units (1.0 = SDR white) and scrolling
+// `kScrollPixelsPerFrame` per frame. rgb10a2 carries the ramp as sRGB code
+// values and clips at 1.0.
+void RenderSyntheticHdrFrame(SourceFormat format,
+                             uint8_t* dst,
+                             int32_t width,
+                             int32_t height,
+                             int32_t stride,
+                             uint32_t frame,
+                             float peak);
+
+// Top-left of the synthetic cursor in frame `frame`.
+void SyntheticCursorPosition(int32_t width, int32_t height, uint32_t frame, int32_t* x, int32_t* y);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_SYNTHETIC_SOURCE_H_
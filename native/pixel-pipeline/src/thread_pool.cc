@@ -0,0 +1,129 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace pixel_pipeline {
+
+struct ThreadPool::Job {
+  const std::function<void(int32_t)>* fn = nullptr;
+  int32_t tasks = 0;
+  std::atomic<int32_t> next{0};
+  int32_t helperSlots = 0;              // guarded by ThreadPool::mutex_
+  std::atomic<int32_t> activeHelpers{0};  // joined under mutex_, left under doneMutex
+  std::mutex doneMutex;
+  std::condition_variable doneCv;
+  int32_t doneCount = 0;  // guarded by doneMutex
+};
+
+ThreadPool* ThreadPool::Shared() {
+  static ThreadPool* pool = new ThreadPool();
+  return pool;
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::EnsureWorkers(int32_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const int32_t target = std::min(kMaxWorkers, count);
+  while (static_cast<int32_t>(workers_.size()) < target) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+int32_t ThreadPool::WorkerCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<int32_t>(workers_.size());
+}
+
+void ThreadPool::ParallelFor(int32_t tasks, int32_t maxThreads, const std::function<void(int32_t)>& fn) {
+  if (tasks <= 0) {
+    return;
+  }
+  Job job;
+  job.fn = &fn;
+  job.tasks = tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job.helperSlots = std::min({maxThreads - 1, tasks - 1, static_cast<int32_t>(workers_.size())});
+    if (job.helperSlots > 0) {
+      queue_.push_back(&job);
+    }
+  }
+  if (job.helperSlots > 0) {
+    wake_.notify_all();
+  }
+
+  RunTasks(&job);
+
+  {
+    // After this no new helper can join; the ones that did are waited for.
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.erase(std::remove(queue_.begin(), queue_.end(), &job), queue_.end());
+  }
+  std::unique_lock<std::mutex> lock(job.doneMutex);
+  job.doneCv.wait(lock, [&job] { return job.doneCount == job.tasks && job.activeHelpers.load() == 0; });
+}
+
+void ThreadPool::RunTasks(Job* job) {
+  for (;;) {
+    const int32_t task = job->next.fetch_add(1, std::memory_order_relaxed);
+    if (task >= job->tasks) {
+      return;
+    }
+    (*job->fn)(task);
+    std::lock_guard<std::mutex> lock(job->doneMutex);
+    if (++job->doneCount == job->tasks) {
+      job->doneCv.notify_one();
+    }
+  }
+}
+
+bool ThreadPool::HasOpenJobLocked() const {
+  for (const Job* job : queue_) {
+    if (job->helperSlots > 0 && job->next.load(std::memory_order_relaxed) < job->tasks) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop() {
+  for (;;) {
+    Job* job = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this] { return stopping_ || HasOpenJobLocked(); });
+      if (stopping_) {
+        return;
+      }
+      for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+        Job* candidate = *it;
+        if (candidate->helperSlots > 0 && candidate->next.load(std::memory_order_relaxed) < candidate->tasks) {
+          job = candidate;
+          job->helperSlots -= 1;
+          job->activeHelpers.fetch_add(1);
+          if (job->helperSlots == 0) {
+            queue_.erase(it);
+          }
+          break;
+        }
+      }
+    }
+    RunTasks(job);
+    std::lock_guard<std::mutex> lock(job->doneMutex);
+    job->activeHelpers.fetch_sub(1);
+    job->doneCv.notify_one();
+  }
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,57 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_THREAD_POOL_H_
+#define CURSORCINE_PIXEL_PIPELINE_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pixel_pipeline {
+
+// Persistent worker threads for splitting one frame across cores. Workers are
+// created on demand (EnsureWorkers) and then live as long as the pool, so
+// per-frame parallelism costs a wake-up, not a thread spawn. Any number of
+// threads (e.g. several capture sessions) may call ParallelFor concurrently.
+class ThreadPool {
+ public:
+  static constexpr int32_t kMaxWorkers = 15;
+
+  // Process-wide pool shared by every capture session. Intentionally never
+  // destroyed: joining threads from static destructors can deadlock when an
+  // addon DLL unloads.
+  static ThreadPool* Shared();
+
+  ThreadPool() = default;
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Grows the pool to at least `count` workers (capped at kMaxWorkers).
+  void EnsureWorkers(int32_t count);
+  int32_t WorkerCount() const;
+
+  // Runs fn(0) .. fn(tasks - 1) and returns when all have finished. The
+  // calling thread works too, helped by up to maxThreads - 1 pool workers;
+  // tasks are claimed one at a time, so faster threads take more of them.
+  void ParallelFor(int32_t tasks, int32_t maxThreads, const std::function<void(int32_t)>& fn);
+
+ private:
+  struct Job;
+
+  void WorkerLoop();
+  static void RunTasks(Job* job);
+  bool HasOpenJobLocked() const;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::vector<std::thread> workers_;
+  std::deque<Job*> queue_;
+  bool stopping_ = false;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_THREAD_POOL_H_
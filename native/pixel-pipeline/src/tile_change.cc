@@ -0,0 +1,183 @@
+#include "tile_change.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "tone_map.h"
+
+namespace pixel_pipeline {
+
+void InitTileHashLanes(uint32_t* lanes) {
+  for (int32_t i = 0; i < kTileHashLanes; ++i) {
+    lanes[i] = 0x243F6A88u + static_cast<uint32_t>(i) * kTileHashPrime;
+  }
+}
+
+uint64_t FinishTileHash(const uint32_t* lanes) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (int32_t i = 0; i < kTileHashLanes; ++i) {
+    hash = (hash ^ lanes[i]) * 0x100000001B3ull;
+  }
+  return hash ^ (hash >> 29);
+}
+
+void HashTileRowScalar(const uint8_t* row, int32_t rowBytes, int32_t tileBytes, uint32_t* lanes) {
+  for (int32_t begin = 0; begin < rowBytes; begin += tileBytes, lanes += kTileHashLanes) {
+    const int32_t end = std::min(rowBytes, begin + tileBytes);
+    for (int32_t i = begin; i < end; i += 4) {
+      uint32_t word;
+      std::memcpy(&word, row + i, 4);
+      uint32_t& lane = lanes[((i - begin) / 4) % kTileHashLanes];
+      lane = (lane ^ word) * kTileHashPrime;
+      lane ^= lane >> kTileHashShift;
+    }
+  }
+}
+
+uint64_t HashTile(TileHashRowFn kernel, const uint8_t* src, int32_t stride, int32_t rowBytes, int32_t rows) {
+  alignas(16) uint32_t lanes[kTileHashLanes];
+  InitTileHashLanes(lanes);
+  for (int32_t y = 0; y < rows; ++y) {
+    kernel(src + static_cast<size_t>(y) * static_cast<size_t>(stride), rowBytes, rowBytes, lanes);
+  }
+  return FinishTileHash(lanes);
+}
+
+TileHashRowFn ActiveTileHashKernel() {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  const ToneMapKernel active = ActiveToneMapKernel();
+  if (active == ToneMapKernel::kAvx2 || active == ToneMapKernel::kSse41) {
+    return HashTileRowSse41;
+  }
+#endif
+  return HashTileRowScalar;
+}
+
+TileChangeTracker::TileChangeTracker(int32_t width, int32_t height, int32_t tileSize)
+    : width_(std::max(0, width)),
+      height_(std::max(0, height)),
+      tileSize_(std::min(kMaxChangeTileSize, std::max(kMinChangeTileSize, tileSize))),
+      tilesX_((width_ + tileSize_ - 1) / tileSize_),
+      tilesY_((height_ + tileSize_ - 1) / tileSize_),
+      hashes_(static_cast<size_t>(tilesX_) * static_cast<size_t>(tilesY_), 0),
+      changed_(hashes_.size(), 1) {}
+
+int32_t TileChangeTracker::Update(const uint8_t* src, int32_t stride, ThreadPool* pool, int32_t threads) {
+  if (!src || hashes_.empty()) {
+    changedTiles_ = 0;
+    return 0;
+  }
+  static const TileHashRowFn hashRow = ActiveTileHashKernel();
+  const bool primed = primed_;
+  // One task per tile row, reading it row by row; each task writes only its
+  // own hashes and flags.
+  auto hashTileRow = [&](int32_t ty) {
+    thread_local std::vector<uint32_t> laneStorage;
+    laneStorage.resize(static_cast<size_t>(tilesX_) * kTileHashLanes + 4);
+    // 16-byte aligned for the SIMD kernels.
+    uint32_t* lanes = laneStorage.data();
+    while (reinterpret_cast<uintptr_t>(lanes) % 16 != 0) {
+      ++lanes;
+    }
+    for (int32_t tx = 0; tx < tilesX_; ++tx) {
+      InitTileHashLanes(lanes + static_cast<size_t>(tx) * kTileHashLanes);
+    }
+    const int32_t y0 = ty * tileSize_;
+    const int32_t y1 = std::min(height_, y0 + tileSize_);
+    for (int32_t y = y0; y < y1; ++y) {
+      hashRow(src + static_cast<size_t>(y) * static_cast<size_t>(stride), width_ * 4, tileSize_ * 4, lanes);
+    }
+    for (int32_t tx = 0; tx < tilesX_; ++tx) {
+      const uint64_t value = FinishTileHash(lanes + static_cast<size_t>(tx) * kTileHashLanes);
+      const size_t index = static_cast<size_t>(ty) * static_cast<size_t>(tilesX_) + static_cast<size_t>(tx);
+      changed_[index] = !primed || hashes_[index] != value;
+      hashes_[index] = value;
+    }
+  };
+  if (pool && threads > 1 && tilesY_ > 1) {
+    pool->ParallelFor(tilesY_, threads, hashTileRow);
+  } else {
+    for (int32_t ty = 0; ty < tilesY_; ++ty) {
+      hashTileRow(ty);
+    }
+  }
+  primed_ = true;
+  changedTiles_ = static_cast<int32_t>(std::count(changed_.begin(), changed_.end(), 1));
+  return changedTiles_;
+}
+
+void TileChangeTracker::ChangedRects(std::vector<DirtyRect>* rects) const {
+  rects->clear();
+  // Rects still open from the previous tile row, by tile column range.
+  struct Open {
+    int32_t begin;
+    int32_t end;
+    size_t rect;
+  };
+  std::vector<Open> open;
+  std::vector<Open> next;
+  for (int32_t ty = 0; ty < tilesY_; ++ty) {
+    next.clear();
+    const int32_t y = ty * tileSize_;
+    const int32_t rows = std::min(tileSize_, height_ - y);
+    int32_t tx = 0;
+    while (tx < tilesX_) {
+      if (!Changed(tx, ty)) {
+        ++tx;
+        continue;
+      }
+      const int32_t begin = tx;
+      while (tx < tilesX_ && Changed(tx, ty)) {
+        ++tx;
+      }
+      const auto same = std::find_if(
+          open.begin(), open.end(), [&](const Open& run) { return run.begin == begin && run.end == tx; });
+      if (same != open.end()) {
+        (*rects)[same->rect].height += rows;
+        next.push_back(*same);
+      } else {
+        DirtyRect rect;
+        rect.x = begin * tileSize_;
+        rect.y = y;
+        rect.width = std::min(width_, tx * tileSize_) - rect.x;
+        rect.height = rows;
+        next.push_back({begin, tx, rects->size()});
+        rects->push_back(rect);
+      }
+    }
+    open.swap(next);
+  }
+}
+
+void CoalesceRects(std::vector<DirtyRect>* rects, bool touching) {
+  const int32_t reach = touching ? 1 : 0;
+  auto overlaps = [reach](const DirtyRect& a, const DirtyRect& b) {
+    return a.x < b.x + b.width + reach && b.x < a.x + a.width + reach && a.y < b.y + b.height + reach &&
+           b.y < a.y + a.height + reach;
+  };
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (size_t i = 0; i < rects->size() && !merged; ++i) {
+      for (size_t j = i + 1; j < rects->size(); ++j) {
+        DirtyRect& a = (*rects)[i];
+        const DirtyRect& b = (*rects)[j];
+        if (!overlaps(a, b)) {
+          continue;
+        }
+        const int32_t x1 = std::max(a.x + a.width, b.x + b.width);
+        const int32_t y1 = std::max(a.y + a.height, b.y + b.height);
+        a.x = std::min(a.x, b.x);
+        a.y = std::min(a.y, b.y);
+        a.width = x1 - a.x;
+        a.height = y1 - a.y;
+        (*rects)[j] = rects->back();
+        rects->pop_back();
+        merged = true;
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace pixel_pipeline
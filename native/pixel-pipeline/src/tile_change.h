@@ -0,0 +1,104 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_TILE_CHANGE_H_
+#define CURSORCINE_PIXEL_PIPELINE_TILE_CHANGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cpu_features.h"
+#include "thread_pool.h"
+
+namespace pixel_pipeline {
+
+constexpr int32_t kDefaultChangeTileSize = 64;
+constexpr int32_t kMinChangeTileSize = 16;
+constexpr int32_t kMaxChangeTileSize = 256;
+
+// A pixel rectangle, [x, x + width) x [y, y + height).
+struct DirtyRect {
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t width = 0;
+  int32_t height = 0;
+};
+
+// Tiles are hashed as their rows stream past, so a frame is read once in
+// memory order. Each tile row is split into 32-bit words feeding
+// kTileHashLanes interleaved lanes (word i -> lane i % kTileHashLanes). A lane
+// steps as
+//   lane = (lane ^ word) * kTileHashPrime; lane ^= lane >> kTileHashShift
+// which is invertible, so one changed word always changes the tile's hash.
+constexpr int32_t kTileHashLanes = 16;
+constexpr uint32_t kTileHashPrime = 0x9E3779B1u;
+constexpr int kTileHashShift = 15;
+
+// Lane seeds and the final fold to 64 bits, shared by every kernel.
+void InitTileHashLanes(uint32_t* lanes);
+uint64_t FinishTileHash(const uint32_t* lanes);
+
+// Feeds one surface row of `rowBytes` bytes to consecutive tiles
+// `tileBytes` wide (the last one may be narrower); tile t's lanes are
+// lanes[t * kTileHashLanes, (t + 1) * kTileHashLanes). Both byte counts must
+// be multiples of 4, and `lanes` 16-byte aligned.
+using TileHashRowFn = void (*)(const uint8_t* row, int32_t rowBytes, int32_t tileBytes, uint32_t* lanes);
+
+// Portable reference; SIMD kernels match it bit for bit.
+void HashTileRowScalar(const uint8_t* row, int32_t rowBytes, int32_t tileBytes, uint32_t* lanes);
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+void HashTileRowSse41(const uint8_t* row, int32_t rowBytes, int32_t tileBytes, uint32_t* lanes);
+#endif
+
+// The hash of one tile, `rows` rows of `rowBytes` bytes `stride` apart.
+uint64_t HashTile(TileHashRowFn kernel, const uint8_t* src, int32_t stride, int32_t rowBytes, int32_t rows);
+
+// Follows the tone-map ISA choice like the other kernels.
+TileHashRowFn ActiveTileHashKernel();
+
+// Per-tile hashes of a 4-byte-per-pixel surface, compared frame to frame so
+// the pipeline can reprocess only what changed. Not thread-safe.
+class TileChangeTracker {
+ public:
+  // `tileSize` is clamped to [kMinChangeTileSize, kMaxChangeTileSize].
+  TileChangeTracker(int32_t width, int32_t height, int32_t tileSize = kDefaultChangeTileSize);
+
+  // Hashes every tile of `src` and marks those that differ from the previous
+  // Update; everything counts as changed on the first call and after
+  // Reset(). Returns the number of changed tiles.
+  int32_t Update(const uint8_t* src, int32_t stride, ThreadPool* pool = nullptr, int32_t threads = 1);
+  void Reset() { primed_ = false; }
+
+  bool Changed(int32_t tileX, int32_t tileY) const {
+    return changed_[static_cast<size_t>(tileY) * static_cast<size_t>(tilesX_) + static_cast<size_t>(tileX)] != 0;
+  }
+
+  // Changed tiles as rectangles in surface pixels: runs of changed tiles
+  // along each tile row, merged downwards while the next row has the same
+  // run. The rectangles do not overlap.
+  void ChangedRects(std::vector<DirtyRect>* rects) const;
+
+  int32_t width() const { return width_; }
+  int32_t height() const { return height_; }
+  int32_t tileSize() const { return tileSize_; }
+  int32_t tilesX() const { return tilesX_; }
+  int32_t tilesY() const { return tilesY_; }
+  int32_t changedTiles() const { return changedTiles_; }
+
+ private:
+  int32_t width_;
+  int32_t height_;
+  int32_t tileSize_;
+  int32_t tilesX_;
+  int32_t tilesY_;
+  int32_t changedTiles_ = 0;
+  bool primed_ = false;
+  std::vector<uint64_t> hashes_;
+  std::vector<uint8_t> changed_;
+};
+
+// Merges rectangles that overlap (or touch, with `touching`) into their
+// bounding boxes until none do. Order is not preserved.
+void CoalesceRects(std::vector<DirtyRect>* rects, bool touching = false);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_TILE_CHANGE_H_
@@ -0,0 +1,61 @@
+#include "tile_change.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+
+#include <immintrin.h>
+
+#include <cstring>
+
+namespace pixel_pipeline {
+
+namespace {
+
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i Step(__m128i lane, __m128i word) {
+  lane = _mm_mullo_epi32(_mm_xor_si128(lane, word), _mm_set1_epi32(static_cast<int32_t>(kTileHashPrime)));
+  return _mm_xor_si128(lane, _mm_srli_epi32(lane, kTileHashShift));
+}
+
+}  // namespace
+
+// A tile's 16 lanes live in four registers while its segment of the row is
+// hashed, so one 64-byte chunk is four independent multiply chains. Segment
+// tails shorter than a chunk use the scalar step on the stored lanes.
+PIXEL_PIPELINE_TARGET("sse4.1")
+void HashTileRowSse41(const uint8_t* row, int32_t rowBytes, int32_t tileBytes, uint32_t* lanes) {
+  const int32_t chunkBytes = kTileHashLanes * 4;
+  for (int32_t begin = 0; begin < rowBytes; begin += tileBytes, lanes += kTileHashLanes) {
+    const int32_t bytes = rowBytes - begin < tileBytes ? rowBytes - begin : tileBytes;
+    const int32_t chunked = bytes - bytes % chunkBytes;
+    const uint8_t* segment = row + begin;
+    __m128i* state = reinterpret_cast<__m128i*>(lanes);
+    if (chunked > 0) {
+      __m128i l0 = _mm_load_si128(state);
+      __m128i l1 = _mm_load_si128(state + 1);
+      __m128i l2 = _mm_load_si128(state + 2);
+      __m128i l3 = _mm_load_si128(state + 3);
+      for (int32_t i = 0; i < chunked; i += chunkBytes) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(segment + i);
+        l0 = Step(l0, _mm_loadu_si128(p));
+        l1 = Step(l1, _mm_loadu_si128(p + 1));
+        l2 = Step(l2, _mm_loadu_si128(p + 2));
+        l3 = Step(l3, _mm_loadu_si128(p + 3));
+      }
+      _mm_store_si128(state, l0);
+      _mm_store_si128(state + 1, l1);
+      _mm_store_si128(state + 2, l2);
+      _mm_store_si128(state + 3, l3);
+    }
+    for (int32_t i = chunked; i < bytes; i += 4) {
+      uint32_t word;
+      std::memcpy(&word, segment + i, 4);
+      uint32_t& lane = lanes[(i - chunked) / 4];
+      lane = (lane ^ word) * kTileHashPrime;
+      lane ^= lane >> kTileHashShift;
+    }
+  }
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_X86
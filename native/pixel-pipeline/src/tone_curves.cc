@@ -0,0 +1,137 @@
+#include "tone_curves.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pixel_pipeline {
+
+namespace {
+
+// ST 2084 constants.
+constexpr double kPqM1 = 2610.0 / 16384.0;
+constexpr double kPqM2 = 2523.0 / 4096.0 * 128.0;
+constexpr double kPqC1 = 3424.0 / 4096.0;
+constexpr double kPqC2 = 2413.0 / 4096.0 * 32.0;
+constexpr double kPqC3 = 2392.0 / 4096.0 * 32.0;
+constexpr double kPqMaxNits = 10000.0;
+
+// ARIB STD-B67 constants.
+constexpr double kHlgA = 0.17883277;
+constexpr double kHlgB = 1.0 - 4.0 * kHlgA;
+const double kHlgC = 0.5 - kHlgA * std::log(4.0 * kHlgA);
+
+constexpr double kMinMasteringNits = 100.0;
+constexpr double kMinTargetNits = 48.0;
+
+double Clamp01(double v) {
+  return std::min(1.0, std::max(0.0, v));
+}
+
+// Display-referred nits after the EETF, relative to the target peak and
+// sRGB encoded.
+double EncodeForTarget(double nits, double sourcePeakPq, double targetPeakPq, double targetNits) {
+  const double mapped = Bt2390Eetf(PqInverseEotf(nits), sourcePeakPq, targetPeakPq);
+  return SrgbEncode(Clamp01(PqEotf(mapped) / targetNits));
+}
+
+}  // namespace
+
+double PqEotf(double signal) {
+  const double p = std::pow(Clamp01(signal), 1.0 / kPqM2);
+  const double linear = std::pow(std::max(p - kPqC1, 0.0) / (kPqC2 - kPqC3 * p), 1.0 / kPqM1);
+  return linear * kPqMaxNits;
+}
+
+double PqInverseEotf(double nits) {
+  const double y = std::pow(Clamp01(nits / kPqMaxNits), kPqM1);
+  return std::pow((kPqC1 + kPqC2 * y) / (1.0 + kPqC3 * y), kPqM2);
+}
+
+double HlgInverseOetf(double signal) {
+  const double e = Clamp01(signal);
+  return e <= 0.5 ? e * e / 3.0 : (std::exp((e - kHlgC) / kHlgA) + kHlgB) / 12.0;
+}
+
+double HlgSystemGamma(double peakNits) {
+  return 1.2 + 0.42 * std::log10(std::max(1.0, peakNits) / 1000.0);
+}
+
+double Bt2390Eetf(double signal, double sourcePeakPq, double targetPeakPq) {
+  if (targetPeakPq >= sourcePeakPq || sourcePeakPq <= 0.0) {
+    return signal;
+  }
+  // Black level is taken as 0, so the BT.2390 black lift drops out.
+  const double e1 = Clamp01(signal / sourcePeakPq);
+  const double maxLum = targetPeakPq / sourcePeakPq;
+  const double knee = 1.5 * maxLum - 0.5;
+  double e2 = e1;
+  if (e1 >= knee) {
+    const double t = (e1 - knee) / (1.0 - knee);
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+    e2 = (2.0 * t3 - 3.0 * t2 + 1.0) * knee + (t3 - 2.0 * t2 + t) * (1.0 - knee) + (-2.0 * t3 + 3.0 * t2) * maxLum;
+  }
+  return e2 * sourcePeakPq;
+}
+
+double HableCurve(double x) {
+  constexpr double a = 0.15;  // shoulder strength
+  constexpr double b = 0.50;  // linear strength
+  constexpr double c = 0.10;  // linear angle
+  constexpr double d = 0.20;  // toe strength
+  constexpr double e = 0.02;  // toe numerator
+  constexpr double f = 0.30;  // toe denominator
+  return (x * (a * x + c * b) + d * e) / (x * (a * x + b) + d * f) - e / f;
+}
+
+double SrgbEncode(double linear) {
+  const double v = Clamp01(linear);
+  return v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+}
+
+double SrgbDecode(double encoded) {
+  const double v = Clamp01(encoded);
+  return v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+}
+
+void BuildToneCurve(bool hdrLikely, const ToneMapConfig& cfg, double curve[256]) {
+  const double masteringNits =
+      std::min(kPqMaxNits, std::max(kMinMasteringNits, static_cast<double>(cfg.masteringPeakNits)));
+  const double targetNits = std::min(kPqMaxNits, std::max(kMinTargetNits, static_cast<double>(cfg.targetNits)));
+  const double sourcePeakPq = PqInverseEotf(masteringNits);
+  const double targetPeakPq = PqInverseEotf(targetNits);
+  const ToneMapProfile profile = hdrLikely ? cfg.profile : ToneMapProfile::kRec709Rolloff;
+  const ToneMapParams params = ResolveToneMapParams(hdrLikely, cfg);
+  const double hlgGamma = HlgSystemGamma(masteringNits);
+  const double hableWhite = std::max(1.0, masteringNits / targetNits);
+  const double hableScale = 1.0 / HableCurve(hableWhite);
+
+  for (int v = 0; v < 256; ++v) {
+    const double code = v / 255.0;
+    double out = code;
+    switch (profile) {
+      case ToneMapProfile::kBt2390Pq:
+        // Signal above the mastering peak holds no graded detail; clip it.
+        out = EncodeForTarget(std::min(PqEotf(code), masteringNits), sourcePeakPq, targetPeakPq, targetNits);
+        break;
+      case ToneMapProfile::kHlg:
+        // Per-channel OOTF (Y^(gamma - 1) * E collapses to E^gamma on
+        // neutrals), the form a 1D table can hold.
+        out = EncodeForTarget(masteringNits * std::pow(HlgInverseOetf(code), hlgGamma),
+                              sourcePeakPq, targetPeakPq, targetNits);
+        break;
+      case ToneMapProfile::kHable:
+        out = SrgbEncode(HableCurve(SrgbDecode(code) * hableWhite) * hableScale);
+        break;
+      case ToneMapProfile::kRec709Rolloff:
+      default:
+        if (params.applyRolloff) {
+          out = code / (1.0 + params.rolloff * code);
+        }
+        break;
+    }
+    curve[v] = out;
+  }
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,41 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_TONE_CURVES_H_
+#define CURSORCINE_PIXEL_PIPELINE_TONE_CURVES_H_
+
+#include "tone_map.h"
+
+namespace pixel_pipeline {
+
+// Transfer functions behind the ToneMapProfile curves. Signals are
+// normalized to [0, 1]; luminance is in nits.
+
+// SMPTE ST 2084: PQ signal -> absolute luminance (0..10000 nits) and back.
+double PqEotf(double signal);
+double PqInverseEotf(double nits);
+
+// ARIB STD-B67 (BT.2100 HLG): signal -> relative scene light in [0, 1].
+double HlgInverseOetf(double signal);
+// BT.2100 system gamma for an HLG display with `peakNits` nominal peak.
+double HlgSystemGamma(double peakNits);
+
+// BT.2390 EETF on PQ signals: maps [0, sourcePeak] onto [0, targetPeak] with a
+// Hermite knee starting at 1.5 * target - 0.5 (relative to the source peak).
+// Identity below the knee; returns `signal` unchanged when targetPeak is not
+// below sourcePeak.
+double Bt2390Eetf(double signal, double sourcePeakPq, double targetPeakPq);
+
+// Hable ("Uncharted 2") filmic curve, unnormalized.
+double HableCurve(double x);
+
+double SrgbEncode(double linear);
+double SrgbDecode(double encoded);
+
+// The profile's curve for every 8-bit input code, as display-encoded (sRGB)
+// values in [0, 1]: EOTF, EETF and OETF folded into one table, so applying
+// any profile costs a table read per channel. kRec709Rolloff returns the
+// rolloff shoulder when `hdrLikely`, the identity ramp otherwise; the other
+// profiles only depend on the nit levels in `cfg`.
+void BuildToneCurve(bool hdrLikely, const ToneMapConfig& cfg, double curve[256]);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_TONE_CURVES_H_
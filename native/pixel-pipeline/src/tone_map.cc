@@ -0,0 +1,210 @@
+#include "tone_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "tone_map_fixed.h"
+#include "tone_map_lut.h"
+
+namespace pixel_pipeline {
+
+namespace {
+
+uint8_t ToByte(float value) {
+  const float v = std::min(1.0f, std::max(0.0f, value));
+  return static_cast<uint8_t>(v * 255.0f + 0.5f);
+}
+
+bool IsKernelSupported(ToneMapKernel kernel) {
+  const CpuFeatures& cpu = GetCpuFeatures();
+  switch (kernel) {
+    case ToneMapKernel::kScalar:
+      return true;
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+    case ToneMapKernel::kSse41:
+      return cpu.sse41;
+    case ToneMapKernel::kAvx2:
+      return cpu.avx2;
+#endif
+#if defined(PIXEL_PIPELINE_ARCH_ARM64)
+    case ToneMapKernel::kNeon:
+      return cpu.neon;
+#endif
+    default:
+      return false;
+  }
+}
+
+ToneMapKernel SelectToneMapKernel() {
+  const char* forced = std::getenv("CURSORCINE_PIXEL_KERNEL");
+  if (forced && forced[0] != '\0') {
+    const ToneMapKernel candidates[] = {
+        ToneMapKernel::kScalar, ToneMapKernel::kSse41, ToneMapKernel::kAvx2, ToneMapKernel::kNeon};
+    for (ToneMapKernel candidate : candidates) {
+      if (std::strcmp(forced, ToneMapKernelName(candidate)) == 0 && IsKernelSupported(candidate)) {
+        return candidate;
+      }
+    }
+  }
+  if (IsKernelSupported(ToneMapKernel::kAvx2)) {
+    return ToneMapKernel::kAvx2;
+  }
+  if (IsKernelSupported(ToneMapKernel::kSse41)) {
+    return ToneMapKernel::kSse41;
+  }
+  if (IsKernelSupported(ToneMapKernel::kNeon)) {
+    return ToneMapKernel::kNeon;
+  }
+  return ToneMapKernel::kScalar;
+}
+
+}  // namespace
+
+const char* ToneMapProfileName(ToneMapProfile profile) {
+  switch (profile) {
+    case ToneMapProfile::kBt2390Pq:
+      return "bt2390-pq";
+    case ToneMapProfile::kHlg:
+      return "hlg";
+    case ToneMapProfile::kHable:
+      return "hable";
+    case ToneMapProfile::kRec709Rolloff:
+    default:
+      return "rec709-rolloff-v1";
+  }
+}
+
+bool ParseToneMapProfile(const std::string& name, ToneMapProfile* out) {
+  const ToneMapProfile profiles[] = {
+      ToneMapProfile::kRec709Rolloff, ToneMapProfile::kBt2390Pq, ToneMapProfile::kHlg, ToneMapProfile::kHable};
+  for (ToneMapProfile profile : profiles) {
+    if (name == ToneMapProfileName(profile)) {
+      if (out) {
+        *out = profile;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* ToneMapArithmeticName(ToneMapArithmetic arithmetic) {
+  return arithmetic == ToneMapArithmetic::kFixed ? "fixed" : "float";
+}
+
+bool ParseToneMapArithmetic(const std::string& name, ToneMapArithmetic* out) {
+  for (ToneMapArithmetic arithmetic : {ToneMapArithmetic::kFloat, ToneMapArithmetic::kFixed}) {
+    if (name == ToneMapArithmeticName(arithmetic)) {
+      if (out) {
+        *out = arithmetic;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+ToneMapParams ResolveToneMapParams(bool hdrLikely, const ToneMapConfig& cfg) {
+  ToneMapParams params;
+  params.rolloff = std::min(1.0f, std::max(0.0f, cfg.rolloff));
+  params.saturation = std::min(2.0f, std::max(0.0f, cfg.saturation));
+  params.applyRolloff = hdrLikely && params.rolloff > 0.0f;
+  params.applySaturation = std::fabs(params.saturation - 1.0f) > 0.001f;
+  return params;
+}
+
+void ToneMapBgraToRgbaScalar(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params) {
+  const float rolloff = params.rolloff;
+  const float sat = params.saturation;
+  for (size_t p = 0; p < pixelCount; ++p) {
+    const size_t i = p * 4;
+    float b = src[i] / 255.0f;
+    float g = src[i + 1] / 255.0f;
+    float r = src[i + 2] / 255.0f;
+
+    if (params.applyRolloff) {
+      // Deterministic shoulder compression for highlight rolloff.
+      r = r / (1.0f + rolloff * r);
+      g = g / (1.0f + rolloff * g);
+      b = b / (1.0f + rolloff * b);
+    }
+
+    if (params.applySaturation) {
+      const float luma = 0.2126f * r + 0.7152f * g + 0.0722f * b;
+      r = luma + (r - luma) * sat;
+      g = luma + (g - luma) * sat;
+      b = luma + (b - luma) * sat;
+    }
+
+    // Convert from BGRA source bytes to RGBA output bytes.
+    dst[i] = ToByte(r);
+    dst[i + 1] = ToByte(g);
+    dst[i + 2] = ToByte(b);
+    dst[i + 3] = 255;
+  }
+}
+
+ToneMapFn GetToneMapKernel(ToneMapKernel kernel) {
+  if (!IsKernelSupported(kernel)) {
+    return nullptr;
+  }
+  switch (kernel) {
+    case ToneMapKernel::kScalar:
+      return ToneMapBgraToRgbaScalar;
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+    case ToneMapKernel::kSse41:
+      return ToneMapBgraToRgbaSse41;
+    case ToneMapKernel::kAvx2:
+      return ToneMapBgraToRgbaAvx2;
+#endif
+#if defined(PIXEL_PIPELINE_ARCH_ARM64)
+    case ToneMapKernel::kNeon:
+      return ToneMapBgraToRgbaNeon;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+ToneMapKernel ActiveToneMapKernel() {
+  static const ToneMapKernel kernel = SelectToneMapKernel();
+  return kernel;
+}
+
+const char* ToneMapKernelName(ToneMapKernel kernel) {
+  switch (kernel) {
+    case ToneMapKernel::kSse41:
+      return "sse41";
+    case ToneMapKernel::kAvx2:
+      return "avx2";
+    case ToneMapKernel::kNeon:
+      return "neon";
+    case ToneMapKernel::kScalar:
+    default:
+      return "scalar";
+  }
+}
+
+void ApplyToneMap(const uint8_t* src, uint8_t* dst, size_t pixelCount, bool hdrLikely, const ToneMapConfig& cfg) {
+  if (!src || !dst || pixelCount == 0) {
+    return;
+  }
+  if (cfg.arithmetic == ToneMapArithmetic::kFixed) {
+    ToneMapFixed fixed;
+    BuildToneMapFixed(hdrLikely, cfg, &fixed);
+    ApplyToneMapFixed(src, dst, pixelCount, fixed);
+    return;
+  }
+  if (hdrLikely && cfg.profile != ToneMapProfile::kRec709Rolloff) {
+    ToneMapLut lut;
+    BuildToneMapLut(hdrLikely, cfg, &lut);
+    ApplyToneMapLut(src, dst, pixelCount, lut);
+    return;
+  }
+  static const ToneMapFn kernel = GetToneMapKernel(ActiveToneMapKernel());
+  kernel(src, dst, pixelCount, ResolveToneMapParams(hdrLikely, cfg));
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,103 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_TONE_MAP_H_
+#define CURSORCINE_PIXEL_PIPELINE_TONE_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "cpu_features.h"
+
+namespace pixel_pipeline {
+
+// How HDR-likely sources are mapped to SDR (see tone_curves.h). Every profile
+// is a per-channel curve over the 8-bit input, followed by the saturation mix.
+enum class ToneMapProfile {
+  // Reinhard-style shoulder on the display-encoded values (`rolloff`).
+  kRec709Rolloff = 0,
+  // Input is ST 2084 (PQ) signal; BT.2390 EETF from the mastering peak down
+  // to the target peak.
+  kBt2390Pq,
+  // Input is HLG signal; inverse OETF and OOTF for a display at the mastering
+  // peak, then the same EETF.
+  kHlg,
+  // Input is sRGB; Hable's filmic curve with the white point at
+  // masteringPeakNits / targetNits.
+  kHable,
+};
+
+const char* ToneMapProfileName(ToneMapProfile profile);
+bool ParseToneMapProfile(const std::string& name, ToneMapProfile* out);
+
+// How the saturation mix (and ApplyToneMap's rolloff) is computed.
+enum class ToneMapArithmetic {
+  // Float kernels, or the Q16 tables where those are faster.
+  kFloat = 0,
+  // Integer-only 16-bit-lane kernels, bit-exact on every platform and within
+  // 1 LSB of the float reference (tone_map_fixed.h).
+  kFixed,
+};
+
+const char* ToneMapArithmeticName(ToneMapArithmetic arithmetic);
+bool ParseToneMapArithmetic(const std::string& name, ToneMapArithmetic* out);
+
+struct ToneMapConfig {
+  float rolloff = 0.0f;
+  float saturation = 1.00f;
+  ToneMapProfile profile = ToneMapProfile::kRec709Rolloff;
+  // Brightest level the source was graded for, and the peak of the SDR
+  // output, in nits. Ignored by kRec709Rolloff.
+  float masteringPeakNits = 1000.0f;
+  float targetNits = 100.0f;
+  ToneMapArithmetic arithmetic = ToneMapArithmetic::kFloat;
+};
+
+// Per-frame constants derived from ToneMapConfig; resolved once so kernels
+// don't re-clamp or re-branch per pixel.
+struct ToneMapParams {
+  bool applyRolloff = false;
+  float rolloff = 0.0f;
+  bool applySaturation = false;
+  float saturation = 1.0f;
+};
+
+enum class ToneMapKernel {
+  kScalar = 0,
+  kSse41,
+  kAvx2,
+  kNeon,
+};
+
+// Converts `pixelCount` BGRA pixels at `src` to RGBA at `dst` with the
+// rec709-rolloff-v1 curve. `src` and `dst` may be the same buffer.
+using ToneMapFn = void (*)(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+
+ToneMapParams ResolveToneMapParams(bool hdrLikely, const ToneMapConfig& cfg);
+
+// Scalar float reference; every SIMD kernel must match it within +/-1 LSB.
+void ToneMapBgraToRgbaScalar(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+void ToneMapBgraToRgbaSse41(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+void ToneMapBgraToRgbaAvx2(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+#endif
+#if defined(PIXEL_PIPELINE_ARCH_ARM64)
+void ToneMapBgraToRgbaNeon(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params);
+#endif
+
+// Returns nullptr when `kernel` is not compiled in or not supported by the CPU.
+ToneMapFn GetToneMapKernel(ToneMapKernel kernel);
+
+// Best supported kernel, picked once per process. Setting
+// CURSORCINE_PIXEL_KERNEL=scalar|sse41|avx2|neon forces a specific kernel when
+// the CPU supports it.
+ToneMapKernel ActiveToneMapKernel();
+
+const char* ToneMapKernelName(ToneMapKernel kernel);
+
+// Profiles other than kRec709Rolloff go through a ToneMapLut, and
+// ToneMapArithmetic::kFixed through a ToneMapFixed, built per call; sessions
+// should build one up front instead.
+void ApplyToneMap(const uint8_t* src, uint8_t* dst, size_t pixelCount, bool hdrLikely, const ToneMapConfig& cfg);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_TONE_MAP_H_
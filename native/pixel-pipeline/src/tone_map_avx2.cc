@@ -0,0 +1,88 @@
+#include "tone_map.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+
+#include <immintrin.h>
+
+namespace pixel_pipeline {
+
+namespace {
+
+PIXEL_PIPELINE_TARGET("avx2")
+inline __m256i ToByteLanes(__m256 value, __m256 zero, __m256 one, __m256 scale, __m256 half) {
+  const __m256 clamped = _mm256_min_ps(one, _mm256_max_ps(value, zero));
+  return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clamped, scale), half));
+}
+
+}  // namespace
+
+PIXEL_PIPELINE_TARGET("avx2")
+void ToneMapBgraToRgbaAvx2(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params) {
+  size_t p = 0;
+  const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+  if (!params.applyRolloff && !params.applySaturation) {
+    // Identity curve: the float round trip is exact, so only swizzle.
+    const __m256i swizzle = _mm256_setr_epi8(2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1,
+                                             2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1);
+    for (; p + 8 <= pixelCount; p += 8) {
+      const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + p * 4));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + p * 4),
+                          _mm256_or_si256(_mm256_shuffle_epi8(px, swizzle), alpha));
+    }
+    ToneMapBgraToRgbaScalar(src + p * 4, dst + p * 4, pixelCount - p, params);
+    return;
+  }
+
+  // Per 128-bit lane: BGRA x4 -> [B0..B3 G0..G3 R0..R3 A0..A3]; the dword
+  // permute then gathers each channel of all 8 pixels into one 64-bit run.
+  const __m256i deinterleave = _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+                                                0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  const __m256i gather = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 scale = _mm256_set1_ps(255.0f);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 rolloff = _mm256_set1_ps(params.rolloff);
+  const __m256 sat = _mm256_set1_ps(params.saturation);
+  const __m256 wr = _mm256_set1_ps(0.2126f);
+  const __m256 wg = _mm256_set1_ps(0.7152f);
+  const __m256 wb = _mm256_set1_ps(0.0722f);
+
+  for (; p + 8 <= pixelCount; p += 8) {
+    const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + p * 4));
+    const __m256i planar = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(px, deinterleave), gather);
+    const __m128i bg = _mm256_castsi256_si128(planar);
+    const __m128i ra = _mm256_extracti128_si256(planar, 1);
+    __m256 b = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bg)), scale);
+    __m256 g = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bg, 8))), scale);
+    __m256 r = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(ra)), scale);
+
+    if (params.applyRolloff) {
+      r = _mm256_div_ps(r, _mm256_add_ps(one, _mm256_mul_ps(rolloff, r)));
+      g = _mm256_div_ps(g, _mm256_add_ps(one, _mm256_mul_ps(rolloff, g)));
+      b = _mm256_div_ps(b, _mm256_add_ps(one, _mm256_mul_ps(rolloff, b)));
+    }
+
+    if (params.applySaturation) {
+      const __m256 luma =
+          _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(wr, r), _mm256_mul_ps(wg, g)), _mm256_mul_ps(wb, b));
+      r = _mm256_add_ps(luma, _mm256_mul_ps(_mm256_sub_ps(r, luma), sat));
+      g = _mm256_add_ps(luma, _mm256_mul_ps(_mm256_sub_ps(g, luma), sat));
+      b = _mm256_add_ps(luma, _mm256_mul_ps(_mm256_sub_ps(b, luma), sat));
+    }
+
+    const __m256i r8 = ToByteLanes(r, zero, one, scale, half);
+    const __m256i g8 = ToByteLanes(g, zero, one, scale, half);
+    const __m256i b8 = ToByteLanes(b, zero, one, scale, half);
+    const __m256i rgba = _mm256_or_si256(_mm256_or_si256(r8, _mm256_slli_epi32(g8, 8)),
+                                         _mm256_or_si256(_mm256_slli_epi32(b8, 16), alpha));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + p * 4), rgba);
+  }
+
+  ToneMapBgraToRgbaScalar(src + p * 4, dst + p * 4, pixelCount - p, params);
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_X86
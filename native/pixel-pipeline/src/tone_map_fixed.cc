@@ -0,0 +1,180 @@
+#include "tone_map_fixed.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "tone_curves.h"
+
+namespace pixel_pipeline {
+
+namespace {
+
+// pmulhrsw / vqrdmulh: round(a * b / 2^15). The shift of a negative product
+// is arithmetic on every supported compiler (and guaranteed from C++20).
+inline int32_t MulQ15(int32_t a, int32_t b) {
+  return (a * b + (1 << 14)) >> 15;
+}
+
+// paddsw / vqadd.
+inline int32_t AddSaturate16(int32_t a, int32_t b) {
+  return std::min(32767, std::max(-32768, a + b));
+}
+
+inline uint8_t FixedToByte(int32_t value) {
+  const int32_t v = std::min(kToneMapFixedMax, std::max(0, value));
+  return static_cast<uint8_t>((v + (1 << (kToneMapFixedFractionBits - 1))) >> kToneMapFixedFractionBits);
+}
+
+uint8_t DoubleToByte(double value) {
+  return static_cast<uint8_t>(std::lround(std::min(1.0, std::max(0.0, value)) * 255.0));
+}
+
+}  // namespace
+
+void BuildToneMapFixed(bool hdrLikely, const ToneMapConfig& cfg, ToneMapFixed* fixed) {
+  if (!fixed) {
+    return;
+  }
+  const ToneMapParams params = ResolveToneMapParams(hdrLikely, cfg);
+  double curve[256];
+  BuildToneCurve(hdrLikely, cfg, curve);
+  // Without saturation the output is the curve itself: round it to the byte
+  // the float reference produces, so that case is exact rather than within 1.
+  uint8_t bytes[256];
+  const bool profileCurve = hdrLikely && cfg.profile != ToneMapProfile::kRec709Rolloff;
+  if (!params.applySaturation && !profileCurve) {
+    uint8_t ramp[256 * 4];
+    uint8_t mapped[256 * 4];
+    for (int v = 0; v < 256; ++v) {
+      ramp[v * 4] = ramp[v * 4 + 1] = ramp[v * 4 + 2] = static_cast<uint8_t>(v);
+      ramp[v * 4 + 3] = 255;
+    }
+    ToneMapBgraToRgbaScalar(ramp, mapped, 256, params);
+    for (int v = 0; v < 256; ++v) {
+      bytes[v] = mapped[v * 4];
+    }
+  }
+  fixed->identityCurve = true;
+  for (int v = 0; v < 256; ++v) {
+    const double c = std::min(1.0, std::max(0.0, curve[v]));
+    if (params.applySaturation) {
+      fixed->curve[v] = static_cast<int16_t>(std::llround(c * kToneMapFixedMax));
+    } else {
+      const uint8_t byte = profileCurve ? DoubleToByte(c) : bytes[v];
+      fixed->curve[v] = static_cast<int16_t>(byte << kToneMapFixedFractionBits);
+    }
+    fixed->identityCurve = fixed->identityCurve && fixed->curve[v] == (v << kToneMapFixedFractionBits);
+  }
+  fixed->applySaturation = params.applySaturation;
+  fixed->lumaR = static_cast<int16_t>(std::llround(0.2126 * 32768.0));
+  fixed->lumaB = static_cast<int16_t>(std::llround(0.0722 * 32768.0));
+  fixed->lumaG = static_cast<int16_t>(32768 - fixed->lumaR - fixed->lumaB);
+  const int64_t saturation = std::llround((static_cast<double>(params.saturation) - 1.0) * 32768.0);
+  fixed->saturation = static_cast<int16_t>(std::min<int64_t>(32767, std::max<int64_t>(-32768, saturation)));
+}
+
+void ToneMapFixedScalar(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapFixed& fixed) {
+  const int16_t* curve = fixed.curve;
+  for (size_t p = 0; p < pixelCount; ++p) {
+    const size_t i = p * 4;
+    int32_t b = curve[src[i]];
+    int32_t g = curve[src[i + 1]];
+    int32_t r = curve[src[i + 2]];
+
+    if (fixed.applySaturation) {
+      const int32_t luma = MulQ15(r, fixed.lumaR) + MulQ15(g, fixed.lumaG) + MulQ15(b, fixed.lumaB);
+      r = AddSaturate16(r, MulQ15(r - luma, fixed.saturation));
+      g = AddSaturate16(g, MulQ15(g - luma, fixed.saturation));
+      b = AddSaturate16(b, MulQ15(b - luma, fixed.saturation));
+    }
+
+    dst[i] = FixedToByte(r);
+    dst[i + 1] = FixedToByte(g);
+    dst[i + 2] = FixedToByte(b);
+    dst[i + 3] = 255;
+  }
+}
+
+ToneMapFixedFn ActiveToneMapFixedKernel() {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  const ToneMapKernel active = ActiveToneMapKernel();
+  if (active == ToneMapKernel::kAvx2 || active == ToneMapKernel::kSse41) {
+    return ToneMapFixedSse41;
+  }
+#endif
+  return ToneMapFixedScalar;
+}
+
+void ApplyToneMapFixed(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapFixed& fixed) {
+  if (!src || !dst || pixelCount == 0) {
+    return;
+  }
+  static const ToneMapFixedFn kernel = ActiveToneMapFixedKernel();
+  kernel(src, dst, pixelCount, fixed);
+}
+
+ToneMapFixedError MeasureToneMapFixedError(bool hdrLikely, const ToneMapConfig& cfg, int32_t step) {
+  ToneMapFixed fixed;
+  BuildToneMapFixed(hdrLikely, cfg, &fixed);
+  const ToneMapParams params = ResolveToneMapParams(hdrLikely, cfg);
+  const bool profileCurve = hdrLikely && cfg.profile != ToneMapProfile::kRec709Rolloff;
+  double curve[256];
+  BuildToneCurve(hdrLikely, cfg, curve);
+
+  std::vector<int32_t> codes;
+  for (int32_t v = 0; v < 255; v += std::min(255, std::max(1, step))) {
+    codes.push_back(v);
+  }
+  codes.push_back(255);
+  // One red code at a time: every green/blue pair of the grid.
+  const size_t sliceCount = codes.size() * codes.size();
+  std::vector<uint8_t> slice(sliceCount * 4);
+  std::vector<uint8_t> expected(slice.size());
+  std::vector<uint8_t> actual(slice.size());
+  ToneMapFixedError error;
+  int64_t total = 0;
+  int64_t mismatches = 0;
+  for (int32_t r : codes) {
+    size_t i = 0;
+    for (int32_t g : codes) {
+      for (int32_t b : codes) {
+        slice[i] = static_cast<uint8_t>(b);
+        slice[i + 1] = static_cast<uint8_t>(g);
+        slice[i + 2] = static_cast<uint8_t>(r);
+        slice[i + 3] = 255;
+        i += 4;
+      }
+    }
+    if (profileCurve) {
+      const double sat = params.applySaturation ? params.saturation : 1.0;
+      for (i = 0; i < slice.size(); i += 4) {
+        const double cb = curve[slice[i]];
+        const double cg = curve[slice[i + 1]];
+        const double cr = curve[slice[i + 2]];
+        const double luma = 0.2126 * cr + 0.7152 * cg + 0.0722 * cb;
+        expected[i] = DoubleToByte(luma + (cr - luma) * sat);
+        expected[i + 1] = DoubleToByte(luma + (cg - luma) * sat);
+        expected[i + 2] = DoubleToByte(luma + (cb - luma) * sat);
+      }
+    } else {
+      ToneMapBgraToRgbaScalar(slice.data(), expected.data(), sliceCount, params);
+    }
+    ApplyToneMapFixed(slice.data(), actual.data(), sliceCount, fixed);
+    for (i = 0; i < slice.size(); i += 4) {
+      for (size_t c = 0; c < 3; ++c) {
+        const int32_t diff = std::abs(static_cast<int32_t>(expected[i + c]) - static_cast<int32_t>(actual[i + c]));
+        error.maxError = std::max(error.maxError, diff);
+        total += diff;
+        mismatches += diff != 0;
+      }
+    }
+    error.samples += static_cast<int64_t>(sliceCount) * 3;
+  }
+  error.meanError = static_cast<double>(total) / static_cast<double>(error.samples);
+  error.mismatchRate = static_cast<double>(mismatches) / static_cast<double>(error.samples);
+  return error;
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,75 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_TONE_MAP_FIXED_H_
+#define CURSORCINE_PIXEL_PIPELINE_TONE_MAP_FIXED_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tone_map.h"
+
+namespace pixel_pipeline {
+
+// Channel values in the fixed-point path are bytes with 7 fractional bits,
+// so 255.0 is 32640 and every intermediate fits a signed 16-bit lane.
+constexpr int32_t kToneMapFixedFractionBits = 7;
+constexpr int32_t kToneMapFixedMax = 255 << kToneMapFixedFractionBits;
+
+// Integer-only tone map (ToneMapArithmetic::kFixed) for one ToneMapConfig.
+//
+// The profile curve, rolloff shoulder included, depends only on the 8-bit
+// input, so its multiply by the per-code reciprocal 1 / (1 + rolloff * x) is
+// folded into `curve` up front. Saturation then runs per pixel on 16-bit
+// lanes: Q15 luma weights, and (saturation - 1) in Q15, applied with
+// rounding Q15 multiplies (pmulhrsw, vqrdmulh) and a saturating add. Every
+// kernel does exactly the same integer steps, so for a given table the output
+// is bit-exact across kernels, compilers and platforms (the rolloff table
+// itself is plain IEEE arithmetic; the other profiles go through libm).
+// Against the float reference it is within 1 LSB (MeasureToneMapFixedError),
+// and exact when saturation is off.
+struct ToneMapFixed {
+  // Output of the curve for every input code, in the format above.
+  int16_t curve[256] = {};
+  // curve[v] == v << 7: the table reads are skipped.
+  bool identityCurve = true;
+  bool applySaturation = false;
+  // 0.2126, 0.7152 and 0.0722 in Q15, summing to 32768.
+  int16_t lumaR = 0;
+  int16_t lumaG = 0;
+  int16_t lumaB = 0;
+  // (saturation - 1) in Q15, clamped to the int16 range (2.0 -> 32767).
+  int16_t saturation = 0;
+};
+
+void BuildToneMapFixed(bool hdrLikely, const ToneMapConfig& cfg, ToneMapFixed* fixed);
+
+// Converts `pixelCount` BGRA pixels at `src` to RGBA at `dst`. `src` and
+// `dst` may be the same buffer.
+using ToneMapFixedFn = void (*)(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapFixed& fixed);
+
+void ToneMapFixedScalar(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapFixed& fixed);
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+void ToneMapFixedSse41(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapFixed& fixed);
+#endif
+
+// SSE4.1 when the active tone-map kernel is SSE4.1 or AVX2, scalar otherwise.
+ToneMapFixedFn ActiveToneMapFixedKernel();
+
+void ApplyToneMapFixed(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapFixed& fixed);
+
+struct ToneMapFixedError {
+  int32_t maxError = 0;
+  double meanError = 0.0;
+  // Share of channel values that differ from the reference at all.
+  double mismatchRate = 0.0;
+  int64_t samples = 0;
+};
+
+// Compares the fixed-point output with the float reference over an RGB grid
+// of every `step`-th code per channel (1 is all 2^24 colors; 255 and 0 are
+// always included). The reference is ToneMapBgraToRgbaScalar for the
+// rolloff profile and the double-precision curve plus saturation for the
+// others, which only exist as tables.
+ToneMapFixedError MeasureToneMapFixedError(bool hdrLikely, const ToneMapConfig& cfg, int32_t step);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_TONE_MAP_FIXED_H_
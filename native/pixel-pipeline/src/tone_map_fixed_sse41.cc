@@ -0,0 +1,86 @@
+#include "tone_map_fixed.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+
+#include <immintrin.h>
+
+namespace pixel_pipeline {
+
+namespace {
+
+// curve[] of one channel of eight BGRA pixels starting at `channel`.
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i Gather(const int16_t* curve, const uint8_t* channel) {
+  return _mm_setr_epi16(curve[channel[0]],
+                        curve[channel[4]],
+                        curve[channel[8]],
+                        curve[channel[12]],
+                        curve[channel[16]],
+                        curve[channel[20]],
+                        curve[channel[24]],
+                        curve[channel[28]]);
+}
+
+}  // namespace
+
+// Eight pixels per step, one channel per register in 16-bit lanes; the same
+// integer steps as ToneMapFixedScalar, which also finishes the tail.
+PIXEL_PIPELINE_TARGET("sse4.1")
+void ToneMapFixedSse41(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapFixed& fixed) {
+  // BGRA x4 -> planar [B0..B3 G0..G3 R0..R3 A0..A3].
+  const __m128i deinterleave = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i maxValue = _mm_set1_epi16(static_cast<int16_t>(kToneMapFixedMax));
+  const __m128i half = _mm_set1_epi16(static_cast<int16_t>(1 << (kToneMapFixedFractionBits - 1)));
+  const __m128i alpha = _mm_set1_epi16(static_cast<int16_t>(0xFF00));
+  const __m128i wr = _mm_set1_epi16(fixed.lumaR);
+  const __m128i wg = _mm_set1_epi16(fixed.lumaG);
+  const __m128i wb = _mm_set1_epi16(fixed.lumaB);
+  const __m128i sat = _mm_set1_epi16(fixed.saturation);
+  const int16_t* curve = fixed.curve;
+
+  size_t p = 0;
+  for (; p + 8 <= pixelCount; p += 8) {
+    const uint8_t* in = src + p * 4;
+    __m128i b;
+    __m128i g;
+    __m128i r;
+    if (fixed.identityCurve) {
+      const __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), deinterleave);
+      const __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)), deinterleave);
+      const __m128i bg = _mm_unpacklo_epi32(lo, hi);
+      const __m128i ra = _mm_unpackhi_epi32(lo, hi);
+      b = _mm_slli_epi16(_mm_cvtepu8_epi16(bg), kToneMapFixedFractionBits);
+      g = _mm_slli_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(bg, 8)), kToneMapFixedFractionBits);
+      r = _mm_slli_epi16(_mm_cvtepu8_epi16(ra), kToneMapFixedFractionBits);
+    } else {
+      // No 16-bit gather; the table reads are scalar, inserted lane by lane
+      // (a store and reload would stall on store forwarding).
+      b = Gather(curve, in);
+      g = Gather(curve, in + 1);
+      r = Gather(curve, in + 2);
+    }
+
+    if (fixed.applySaturation) {
+      const __m128i luma =
+          _mm_add_epi16(_mm_add_epi16(_mm_mulhrs_epi16(r, wr), _mm_mulhrs_epi16(g, wg)), _mm_mulhrs_epi16(b, wb));
+      r = _mm_adds_epi16(r, _mm_mulhrs_epi16(_mm_sub_epi16(r, luma), sat));
+      g = _mm_adds_epi16(g, _mm_mulhrs_epi16(_mm_sub_epi16(g, luma), sat));
+      b = _mm_adds_epi16(b, _mm_mulhrs_epi16(_mm_sub_epi16(b, luma), sat));
+    }
+
+    r = _mm_srli_epi16(_mm_add_epi16(_mm_min_epi16(_mm_max_epi16(r, zero), maxValue), half), kToneMapFixedFractionBits);
+    g = _mm_srli_epi16(_mm_add_epi16(_mm_min_epi16(_mm_max_epi16(g, zero), maxValue), half), kToneMapFixedFractionBits);
+    b = _mm_srli_epi16(_mm_add_epi16(_mm_min_epi16(_mm_max_epi16(b, zero), maxValue), half), kToneMapFixedFractionBits);
+    const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+    const __m128i ba = _mm_or_si128(b, alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + p * 4), _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + p * 4 + 16), _mm_unpackhi_epi16(rg, ba));
+  }
+
+  ToneMapFixedScalar(src + p * 4, dst + p * 4, pixelCount - p, fixed);
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_X86
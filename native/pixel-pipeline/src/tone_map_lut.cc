@@ -0,0 +1,125 @@
+#include "tone_map_lut.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "tone_curves.h"
+
+namespace pixel_pipeline {
+
+namespace {
+
+constexpr int32_t kOne = 1 << ToneMapLut::kFractionBits;
+constexpr int32_t kHalf = kOne >> 1;
+constexpr int32_t kMaxValue = 255 * kOne;
+
+int32_t ToFixed(double value) {
+  return static_cast<int32_t>(std::llround(value * 255.0 * kOne));
+}
+
+inline uint8_t MixChannel(int32_t scaled, int32_t luma) {
+  const int32_t v = std::min(kMaxValue, std::max(0, scaled + luma));
+  return static_cast<uint8_t>((v + kHalf) >> ToneMapLut::kFractionBits);
+}
+
+}  // namespace
+
+void BuildToneMapLut(bool hdrLikely, const ToneMapConfig& cfg, ToneMapLut* lut) {
+  if (!lut) {
+    return;
+  }
+  const ToneMapParams params = ResolveToneMapParams(hdrLikely, cfg);
+  // The SIMD float kernels only know the rolloff shoulder, so the other
+  // profiles always take the tables.
+  const bool profileCurve = hdrLikely && cfg.profile != ToneMapProfile::kRec709Rolloff;
+  lut->identity = !profileCurve && !params.applyRolloff && !params.applySaturation;
+  lut->separable = params.applySaturation;
+  lut->preferTables = profileCurve || !lut->separable || ActiveToneMapKernel() == ToneMapKernel::kScalar;
+  lut->params = params;
+  lut->fixedPoint = lut->separable && cfg.arithmetic == ToneMapArithmetic::kFixed;
+  if (lut->fixedPoint) {
+    BuildToneMapFixed(hdrLikely, cfg, &lut->fixed);
+  }
+
+  // Build the byte table with the scalar kernel itself so the no-saturation
+  // path is bit-exact with the float reference.
+  uint8_t ramp[256 * 4];
+  uint8_t mapped[256 * 4];
+  for (int v = 0; v < 256; ++v) {
+    ramp[v * 4] = static_cast<uint8_t>(v);
+    ramp[v * 4 + 1] = static_cast<uint8_t>(v);
+    ramp[v * 4 + 2] = static_cast<uint8_t>(v);
+    ramp[v * 4 + 3] = 255;
+  }
+  ToneMapParams rolloffOnly = params;
+  rolloffOnly.applySaturation = false;
+  ToneMapBgraToRgbaScalar(ramp, mapped, 256, rolloffOnly);
+
+  double curve[256];
+  BuildToneCurve(hdrLikely, cfg, curve);
+  const double sat = params.saturation;
+  const double inv = 1.0 - sat;
+  for (int v = 0; v < 256; ++v) {
+    const double c = curve[v];
+    lut->direct[v] = profileCurve ? static_cast<uint8_t>(std::lround(std::min(1.0, std::max(0.0, c)) * 255.0))
+                                  : mapped[v * 4];
+    lut->scaled[v] = ToFixed(sat * c);
+    lut->lumaR[v] = ToFixed(inv * 0.2126 * c);
+    lut->lumaG[v] = ToFixed(inv * 0.7152 * c);
+    lut->lumaB[v] = ToFixed(inv * 0.0722 * c);
+  }
+}
+
+void ApplyToneMapLut(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapLut& lut) {
+  if (!src || !dst || pixelCount == 0) {
+    return;
+  }
+  if (lut.identity) {
+    static const ToneMapFn swizzle = GetToneMapKernel(ActiveToneMapKernel());
+    swizzle(src, dst, pixelCount, ToneMapParams());
+    return;
+  }
+
+  if (!lut.separable) {
+    const uint8_t* table = lut.direct;
+    for (size_t i = 0; i < pixelCount * 4; i += 4) {
+      const uint8_t b = src[i];
+      const uint8_t g = src[i + 1];
+      const uint8_t r = src[i + 2];
+      dst[i] = table[r];
+      dst[i + 1] = table[g];
+      dst[i + 2] = table[b];
+      dst[i + 3] = 255;
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < pixelCount * 4; i += 4) {
+    const uint8_t b = src[i];
+    const uint8_t g = src[i + 1];
+    const uint8_t r = src[i + 2];
+    const int32_t luma = lut.lumaR[r] + lut.lumaG[g] + lut.lumaB[b];
+    dst[i] = MixChannel(lut.scaled[r], luma);
+    dst[i + 1] = MixChannel(lut.scaled[g], luma);
+    dst[i + 2] = MixChannel(lut.scaled[b], luma);
+    dst[i + 3] = 255;
+  }
+}
+
+void ApplyPreparedToneMap(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapLut& lut) {
+  if (!src || !dst || pixelCount == 0) {
+    return;
+  }
+  if (lut.fixedPoint) {
+    ApplyToneMapFixed(src, dst, pixelCount, lut.fixed);
+    return;
+  }
+  if (lut.preferTables) {
+    ApplyToneMapLut(src, dst, pixelCount, lut);
+    return;
+  }
+  static const ToneMapFn kernel = GetToneMapKernel(ActiveToneMapKernel());
+  kernel(src, dst, pixelCount, lut.params);
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,52 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_TONE_MAP_LUT_H_
+#define CURSORCINE_PIXEL_PIPELINE_TONE_MAP_LUT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tone_map.h"
+#include "tone_map_fixed.h"
+
+namespace pixel_pipeline {
+
+// Precomputed tone-map tables for one ToneMapConfig.
+//
+// Every profile curve only depends on the 8-bit channel value (see
+// BuildToneCurve), so without saturation it collapses to a single 256-entry
+// byte table. Saturation is a linear 3x3 mix of the mapped channels (c' = sat * c + (1 - sat) * luma),
+// so instead of a 3D table it is split into four 256-entry Q16 tables that are
+// summed per pixel with integer math.
+struct ToneMapLut {
+  static constexpr int kFractionBits = 16;
+
+  bool identity = true;
+  bool separable = false;
+  // False when the saturation mix would run slower through tables than through
+  // the active SIMD float kernel (four table reads per pixel vs. 8-wide math);
+  // callers then use ApplyToneMap with `params` instead.
+  bool preferTables = true;
+  // ToneMapArithmetic::kFixed with saturation: ApplyPreparedToneMap runs
+  // `fixed` instead of the tables or a float kernel. Without saturation the
+  // byte table is already integer-only and bit-exact, so it stays.
+  bool fixedPoint = false;
+  ToneMapFixed fixed;
+  ToneMapParams params;
+  uint8_t direct[256] = {};
+  int32_t scaled[256] = {};
+  int32_t lumaR[256] = {};
+  int32_t lumaG[256] = {};
+  int32_t lumaB[256] = {};
+};
+
+void BuildToneMapLut(bool hdrLikely, const ToneMapConfig& cfg, ToneMapLut* lut);
+
+// BGRA -> RGBA through `lut`; `src` and `dst` may be the same buffer.
+void ApplyToneMapLut(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapLut& lut);
+
+// The fixed-point kernel when `lut.fixedPoint`, the table path when
+// `lut.preferTables`, otherwise the active SIMD float kernel.
+void ApplyPreparedToneMap(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapLut& lut);
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_TONE_MAP_LUT_H_
@@ -0,0 +1,105 @@
+#include "tone_map.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_ARM64)
+
+#include <arm_neon.h>
+
+namespace pixel_pipeline {
+
+namespace {
+
+inline float32x4_t Rolloff(float32x4_t v, float32x4_t one, float32x4_t rolloff) {
+  return vdivq_f32(v, vaddq_f32(one, vmulq_f32(rolloff, v)));
+}
+
+inline uint32x4_t ToByteLanes(float32x4_t value, float32x4_t zero, float32x4_t one, float32x4_t scale, float32x4_t half) {
+  const float32x4_t clamped = vminq_f32(one, vmaxq_f32(value, zero));
+  return vcvtq_u32_f32(vaddq_f32(vmulq_f32(clamped, scale), half));
+}
+
+struct Channel8 {
+  float32x4_t lo;
+  float32x4_t hi;
+};
+
+inline Channel8 Widen(uint8x8_t v, float32x4_t scale) {
+  const uint16x8_t wide = vmovl_u8(v);
+  Channel8 out;
+  out.lo = vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide))), scale);
+  out.hi = vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(wide))), scale);
+  return out;
+}
+
+}  // namespace
+
+void ToneMapBgraToRgbaNeon(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params) {
+  size_t p = 0;
+  const uint8x8_t alpha = vdup_n_u8(255);
+
+  if (!params.applyRolloff && !params.applySaturation) {
+    // Identity curve: the float round trip is exact, so only swizzle.
+    for (; p + 8 <= pixelCount; p += 8) {
+      const uint8x8x4_t bgra = vld4_u8(src + p * 4);
+      uint8x8x4_t rgba;
+      rgba.val[0] = bgra.val[2];
+      rgba.val[1] = bgra.val[1];
+      rgba.val[2] = bgra.val[0];
+      rgba.val[3] = alpha;
+      vst4_u8(dst + p * 4, rgba);
+    }
+    ToneMapBgraToRgbaScalar(src + p * 4, dst + p * 4, pixelCount - p, params);
+    return;
+  }
+
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t scale = vdupq_n_f32(255.0f);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const float32x4_t rolloff = vdupq_n_f32(params.rolloff);
+  const float32x4_t sat = vdupq_n_f32(params.saturation);
+  const float32x4_t wr = vdupq_n_f32(0.2126f);
+  const float32x4_t wg = vdupq_n_f32(0.7152f);
+  const float32x4_t wb = vdupq_n_f32(0.0722f);
+
+  for (; p + 8 <= pixelCount; p += 8) {
+    const uint8x8x4_t bgra = vld4_u8(src + p * 4);
+    Channel8 b = Widen(bgra.val[0], scale);
+    Channel8 g = Widen(bgra.val[1], scale);
+    Channel8 r = Widen(bgra.val[2], scale);
+    float32x4_t* lanes[3][2] = {{&r.lo, &r.hi}, {&g.lo, &g.hi}, {&b.lo, &b.hi}};
+
+    if (params.applyRolloff) {
+      for (auto& channel : lanes) {
+        *channel[0] = Rolloff(*channel[0], one, rolloff);
+        *channel[1] = Rolloff(*channel[1], one, rolloff);
+      }
+    }
+
+    if (params.applySaturation) {
+      for (int side = 0; side < 2; ++side) {
+        float32x4_t& rv = *lanes[0][side];
+        float32x4_t& gv = *lanes[1][side];
+        float32x4_t& bv = *lanes[2][side];
+        const float32x4_t luma = vaddq_f32(vaddq_f32(vmulq_f32(wr, rv), vmulq_f32(wg, gv)), vmulq_f32(wb, bv));
+        rv = vaddq_f32(luma, vmulq_f32(vsubq_f32(rv, luma), sat));
+        gv = vaddq_f32(luma, vmulq_f32(vsubq_f32(gv, luma), sat));
+        bv = vaddq_f32(luma, vmulq_f32(vsubq_f32(bv, luma), sat));
+      }
+    }
+
+    uint8x8x4_t rgba;
+    for (int c = 0; c < 3; ++c) {
+      const uint16x4_t lo = vmovn_u32(ToByteLanes(*lanes[c][0], zero, one, scale, half));
+      const uint16x4_t hi = vmovn_u32(ToByteLanes(*lanes[c][1], zero, one, scale, half));
+      rgba.val[c] = vmovn_u16(vcombine_u16(lo, hi));
+    }
+    rgba.val[3] = alpha;
+    vst4_u8(dst + p * 4, rgba);
+  }
+
+  ToneMapBgraToRgbaScalar(src + p * 4, dst + p * 4, pixelCount - p, params);
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_ARM64
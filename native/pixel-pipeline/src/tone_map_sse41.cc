@@ -0,0 +1,84 @@
+#include "tone_map.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+
+#include <immintrin.h>
+
+namespace pixel_pipeline {
+
+namespace {
+
+// BGRA x4 -> planar [B0..B3 G0..G3 R0..R3 A0..A3].
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i DeinterleaveBgra(__m128i px) {
+  const __m128i mask = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  return _mm_shuffle_epi8(px, mask);
+}
+
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i ToByteLanes(__m128 value, __m128 zero, __m128 one, __m128 scale, __m128 half) {
+  const __m128 clamped = _mm_min_ps(one, _mm_max_ps(value, zero));
+  return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, scale), half));
+}
+
+}  // namespace
+
+PIXEL_PIPELINE_TARGET("sse4.1")
+void ToneMapBgraToRgbaSse41(const uint8_t* src, uint8_t* dst, size_t pixelCount, const ToneMapParams& params) {
+  size_t p = 0;
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+  if (!params.applyRolloff && !params.applySaturation) {
+    // Identity curve: the float round trip is exact, so only swizzle.
+    const __m128i swizzle = _mm_setr_epi8(2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1);
+    for (; p + 4 <= pixelCount; p += 4) {
+      const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + p * 4));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + p * 4), _mm_or_si128(_mm_shuffle_epi8(px, swizzle), alpha));
+    }
+    ToneMapBgraToRgbaScalar(src + p * 4, dst + p * 4, pixelCount - p, params);
+    return;
+  }
+
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(255.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 rolloff = _mm_set1_ps(params.rolloff);
+  const __m128 sat = _mm_set1_ps(params.saturation);
+  const __m128 wr = _mm_set1_ps(0.2126f);
+  const __m128 wg = _mm_set1_ps(0.7152f);
+  const __m128 wb = _mm_set1_ps(0.0722f);
+
+  for (; p + 4 <= pixelCount; p += 4) {
+    const __m128i planar = DeinterleaveBgra(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + p * 4)));
+    __m128 b = _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(planar)), scale);
+    __m128 g = _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(planar, 4))), scale);
+    __m128 r = _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(planar, 8))), scale);
+
+    if (params.applyRolloff) {
+      r = _mm_div_ps(r, _mm_add_ps(one, _mm_mul_ps(rolloff, r)));
+      g = _mm_div_ps(g, _mm_add_ps(one, _mm_mul_ps(rolloff, g)));
+      b = _mm_div_ps(b, _mm_add_ps(one, _mm_mul_ps(rolloff, b)));
+    }
+
+    if (params.applySaturation) {
+      const __m128 luma = _mm_add_ps(_mm_add_ps(_mm_mul_ps(wr, r), _mm_mul_ps(wg, g)), _mm_mul_ps(wb, b));
+      r = _mm_add_ps(luma, _mm_mul_ps(_mm_sub_ps(r, luma), sat));
+      g = _mm_add_ps(luma, _mm_mul_ps(_mm_sub_ps(g, luma), sat));
+      b = _mm_add_ps(luma, _mm_mul_ps(_mm_sub_ps(b, luma), sat));
+    }
+
+    const __m128i r8 = ToByteLanes(r, zero, one, scale, half);
+    const __m128i g8 = ToByteLanes(g, zero, one, scale, half);
+    const __m128i b8 = ToByteLanes(b, zero, one, scale, half);
+    const __m128i rgba =
+        _mm_or_si128(_mm_or_si128(r8, _mm_slli_epi32(g8, 8)), _mm_or_si128(_mm_slli_epi32(b8, 16), alpha));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + p * 4), rgba);
+  }
+
+  ToneMapBgraToRgbaScalar(src + p * 4, dst + p * 4, pixelCount - p, params);
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_X86
@@ -0,0 +1,32 @@
+#include "triple_buffer.h"
+
+namespace pixel_pipeline {
+
+TripleBuffer::TripleBuffer(size_t slotBytes)
+    : slotBytes_(slotBytes), storage_(new uint8_t[slotBytes * 3]()) {}
+
+void TripleBuffer::Publish() {
+  const uint64_t sequence = published_.load(std::memory_order_relaxed) + 1;
+  meta_[back_].sequence = sequence;
+  // Release makes the slot contents and meta visible to the consumer that
+  // acquires this index; the slot we get back is free for the next frame.
+  const uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+  back_ = previous & kIndexMask;
+  published_.store(sequence, std::memory_order_relaxed);
+}
+
+bool TripleBuffer::AcquireLatest() {
+  if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) {
+    return false;
+  }
+  const uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+  front_ = previous & kIndexMask;
+  const uint64_t sequence = meta_[front_].sequence;
+  if (sequence > consumedSequence_ + 1) {
+    dropped_ += sequence - consumedSequence_ - 1;
+  }
+  consumedSequence_ = sequence;
+  return true;
+}
+
+}  // namespace pixel_pipeline
@@ -0,0 +1,74 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_TRIPLE_BUFFER_H_
+#define CURSORCINE_PIXEL_PIPELINE_TRIPLE_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace pixel_pipeline {
+
+// Producer-filled fields travelling with each frame. `sequence` is assigned
+// by Publish() and starts at 1.
+struct TripleBufferMeta {
+  uint64_t sequence = 0;
+  double timestampMs = 0.0;
+  double captureMs = 0.0;
+  double processMs = 0.0;
+  // Capture-surface region the frame was scaled from (see FitSourceRegion);
+  // a zero sourceWidth means the whole surface.
+  int32_t sourceX = 0;
+  int32_t sourceY = 0;
+  int32_t sourceWidth = 0;
+  int32_t sourceHeight = 0;
+};
+
+// Lock-free single-producer/single-consumer triple buffer of equally sized
+// frames. The producer always has a private slot to render into and never
+// waits; the consumer always sees the newest published frame, and frames it
+// never picked up are counted as dropped. Exactly one producer thread and one
+// consumer thread may use it at a time.
+class TripleBuffer {
+ public:
+  explicit TripleBuffer(size_t slotBytes);
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  size_t slotBytes() const { return slotBytes_; }
+
+  // Producer side. WriteSlot/WriteMeta stay valid until the next Publish().
+  uint8_t* WriteSlot() { return Slot(back_); }
+  TripleBufferMeta* WriteMeta() { return &meta_[back_]; }
+  void Publish();
+  uint64_t Published() const { return published_.load(std::memory_order_relaxed); }
+
+  // Consumer side. Returns false when nothing was published since the last
+  // call; otherwise ReadSlot/ReadMeta hold the newest frame until the next
+  // successful call.
+  bool AcquireLatest();
+  const uint8_t* ReadSlot() const { return Slot(front_); }
+  const TripleBufferMeta& ReadMeta() const { return meta_[front_]; }
+  uint64_t Dropped() const { return dropped_; }
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x3;
+  static constexpr uint8_t kFresh = 0x4;
+
+  uint8_t* Slot(uint8_t index) const { return storage_.get() + static_cast<size_t>(index) * slotBytes_; }
+
+  const size_t slotBytes_;
+  std::unique_ptr<uint8_t[]> storage_;
+  TripleBufferMeta meta_[3];
+  // Index of the slot between producer and consumer, plus kFresh when it
+  // holds a frame the consumer has not taken yet.
+  std::atomic<uint8_t> middle_{1};
+  std::atomic<uint64_t> published_{0};
+  uint8_t back_ = 0;   // producer only
+  uint8_t front_ = 2;  // consumer only
+  uint64_t consumedSequence_ = 0;
+  uint64_t dropped_ = 0;
+};
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_TRIPLE_BUFFER_H_
@@ -0,0 +1,159 @@
+#include "yuv.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "tone_map.h"
+
+namespace pixel_pipeline {
+
+namespace {
+
+constexpr double kKr = 0.2126;
+constexpr double kKb = 0.0722;
+
+// Chroma is computed from the sum of a 2x2 block, so it carries two more
+// fractional bits than luma.
+constexpr int kLumaShift = YuvCoefficients::kFractionBits;
+constexpr int kChromaShift = YuvCoefficients::kFractionBits + 2;
+
+int16_t ToQ14(double value) {
+  return static_cast<int16_t>(std::lround(value * (1 << YuvCoefficients::kFractionBits)));
+}
+
+uint8_t ClampByte(int32_t value) {
+  return static_cast<uint8_t>(std::min(255, std::max(0, value)));
+}
+
+}  // namespace
+
+const char* PixelFormatName(PixelFormat format) {
+  switch (format) {
+    case PixelFormat::kNv12:
+      return "NV12";
+    case PixelFormat::kI420:
+      return "I420";
+    case PixelFormat::kRgba8:
+    default:
+      return "RGBA8";
+  }
+}
+
+bool ParsePixelFormat(const std::string& name, PixelFormat* out) {
+  const PixelFormat formats[] = {PixelFormat::kRgba8, PixelFormat::kNv12, PixelFormat::kI420};
+  for (PixelFormat format : formats) {
+    if (name == PixelFormatName(format)) {
+      if (out) {
+        *out = format;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* YuvRangeName(YuvRange range) {
+  return range == YuvRange::kFull ? "full" : "limited";
+}
+
+bool ParseYuvRange(const std::string& name, YuvRange* out) {
+  for (YuvRange range : {YuvRange::kLimited, YuvRange::kFull}) {
+    if (name == YuvRangeName(range)) {
+      if (out) {
+        *out = range;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+FrameLayout ComputeFrameLayout(PixelFormat format, int32_t width, int32_t height) {
+  FrameLayout layout;
+  layout.format = format;
+  if (width <= 0 || height <= 0) {
+    return layout;
+  }
+  const size_t lumaBytes = static_cast<size_t>(width) * static_cast<size_t>(height);
+  if (format == PixelFormat::kRgba8) {
+    layout.planeCount = 1;
+    layout.planes[0] = {0, width * 4, width, height};
+    layout.byteLength = lumaBytes * 4;
+    return layout;
+  }
+  const int32_t chromaW = (width + 1) / 2;
+  const int32_t chromaH = (height + 1) / 2;
+  const size_t chromaBytes = static_cast<size_t>(chromaW) * static_cast<size_t>(chromaH);
+  layout.planes[0] = {0, width, width, height};
+  if (format == PixelFormat::kNv12) {
+    layout.planeCount = 2;
+    layout.planes[1] = {lumaBytes, chromaW * 2, chromaW, chromaH};
+  } else {
+    layout.planeCount = 3;
+    layout.planes[1] = {lumaBytes, chromaW, chromaW, chromaH};
+    layout.planes[2] = {lumaBytes + chromaBytes, chromaW, chromaW, chromaH};
+  }
+  layout.byteLength = lumaBytes + chromaBytes * 2;
+  return layout;
+}
+
+YuvCoefficients ResolveYuvCoefficients(YuvRange range) {
+  const bool limited = range == YuvRange::kLimited;
+  const double lumaScale = limited ? 219.0 / 255.0 : 1.0;
+  const double chromaScale = limited ? 224.0 / 255.0 : 1.0;
+  YuvCoefficients coeffs;
+  coeffs.y[0] = ToQ14(kKr * lumaScale);
+  coeffs.y[2] = ToQ14(kKb * lumaScale);
+  coeffs.y[1] = static_cast<int16_t>(ToQ14(lumaScale) - coeffs.y[0] - coeffs.y[2]);
+  coeffs.u[0] = ToQ14(-kKr / (2.0 * (1.0 - kKb)) * chromaScale);
+  coeffs.u[2] = ToQ14(0.5 * chromaScale);
+  coeffs.u[1] = static_cast<int16_t>(-coeffs.u[0] - coeffs.u[2]);
+  coeffs.v[0] = ToQ14(0.5 * chromaScale);
+  coeffs.v[2] = ToQ14(-kKb / (2.0 * (1.0 - kKr)) * chromaScale);
+  coeffs.v[1] = static_cast<int16_t>(-coeffs.v[0] - coeffs.v[2]);
+  coeffs.yOffset = limited ? 16 : 0;
+  return coeffs;
+}
+
+void RgbaToYuvRowsScalar(const uint8_t* rgba0,
+                         const uint8_t* rgba1,
+                         int32_t width,
+                         uint8_t* y0,
+                         uint8_t* y1,
+                         uint8_t* u,
+                         uint8_t* v,
+                         int32_t chromaStep,
+                         const YuvCoefficients& coeffs) {
+  const int32_t lumaBias = (coeffs.yOffset << kLumaShift) + (1 << (kLumaShift - 1));
+  const int32_t chromaBias = (128 << kChromaShift) + (1 << (kChromaShift - 1));
+  for (int32_t x = 0; x < width; ++x) {
+    const uint8_t* p0 = rgba0 + static_cast<size_t>(x) * 4;
+    const uint8_t* p1 = rgba1 + static_cast<size_t>(x) * 4;
+    y0[x] = ClampByte((coeffs.y[0] * p0[0] + coeffs.y[1] * p0[1] + coeffs.y[2] * p0[2] + lumaBias) >> kLumaShift);
+    y1[x] = ClampByte((coeffs.y[0] * p1[0] + coeffs.y[1] * p1[1] + coeffs.y[2] * p1[2] + lumaBias) >> kLumaShift);
+  }
+  for (int32_t x = 0; x < width; x += 2) {
+    // An odd last column averages with itself.
+    const size_t a = static_cast<size_t>(x) * 4;
+    const size_t b = static_cast<size_t>(std::min(x + 1, width - 1)) * 4;
+    int32_t sum[3];
+    for (int c = 0; c < 3; ++c) {
+      sum[c] = rgba0[a + c] + rgba0[b + c] + rgba1[a + c] + rgba1[b + c];
+    }
+    const size_t out = static_cast<size_t>(x / 2) * static_cast<size_t>(chromaStep);
+    u[out] = ClampByte((coeffs.u[0] * sum[0] + coeffs.u[1] * sum[1] + coeffs.u[2] * sum[2] + chromaBias) >> kChromaShift);
+    v[out] = ClampByte((coeffs.v[0] * sum[0] + coeffs.v[1] * sum[1] + coeffs.v[2] * sum[2] + chromaBias) >> kChromaShift);
+  }
+}
+
+RgbaToYuvRowsFn ActiveYuvKernel() {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  const ToneMapKernel active = ActiveToneMapKernel();
+  if (active == ToneMapKernel::kAvx2 || active == ToneMapKernel::kSse41) {
+    return RgbaToYuvRowsSse41;
+  }
+#endif
+  return RgbaToYuvRowsScalar;
+}
+
+}  // namespace pixel_pipeline
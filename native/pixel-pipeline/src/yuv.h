@@ -0,0 +1,103 @@
+#ifndef CURSORCINE_PIXEL_PIPELINE_YUV_H_
+#define CURSORCINE_PIXEL_PIPELINE_YUV_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "cpu_features.h"
+
+namespace pixel_pipeline {
+
+enum class PixelFormat {
+  kRgba8 = 0,
+  // 4:2:0, Y plane then one interleaved UV plane.
+  kNv12,
+  // 4:2:0, Y, U and V planes.
+  kI420,
+};
+
+enum class YuvRange {
+  kLimited = 0,  // Y 16..235, UV 16..240
+  kFull,
+};
+
+const char* PixelFormatName(PixelFormat format);
+bool ParsePixelFormat(const std::string& name, PixelFormat* out);
+const char* YuvRangeName(YuvRange range);
+bool ParseYuvRange(const std::string& name, YuvRange* out);
+
+struct PlaneLayout {
+  size_t offset = 0;
+  int32_t stride = 0;  // bytes
+  int32_t width = 0;   // samples (a UV pair counts once)
+  int32_t height = 0;
+};
+
+// Where each plane of a tightly packed frame lives. Chroma planes round odd
+// luma sizes up.
+struct FrameLayout {
+  PixelFormat format = PixelFormat::kRgba8;
+  int32_t planeCount = 0;
+  PlaneLayout planes[3];
+  size_t byteLength = 0;
+};
+
+FrameLayout ComputeFrameLayout(PixelFormat format, int32_t width, int32_t height);
+
+// BT.709 RGB -> YCbCr weights in Q14. Luma weights sum to the range's full
+// luma scale and chroma weights sum to zero, so white and greys land exactly
+// on 235/255 and 128.
+struct YuvCoefficients {
+  static constexpr int kFractionBits = 14;
+
+  int16_t y[3] = {};  // R, G, B
+  int16_t u[3] = {};
+  int16_t v[3] = {};
+  int32_t yOffset = 0;
+};
+
+YuvCoefficients ResolveYuvCoefficients(YuvRange range);
+
+// Two RGBA rows (`rgba1` may equal `rgba0` for the last row of an odd-height
+// frame) to two luma rows and one row of 2x2-averaged chroma. Chroma samples
+// are written `chromaStep` bytes apart: 1 for I420 planes, 2 for NV12 with
+// `v` = `u` + 1.
+using RgbaToYuvRowsFn = void (*)(const uint8_t* rgba0,
+                                 const uint8_t* rgba1,
+                                 int32_t width,
+                                 uint8_t* y0,
+                                 uint8_t* y1,
+                                 uint8_t* u,
+                                 uint8_t* v,
+                                 int32_t chromaStep,
+                                 const YuvCoefficients& coeffs);
+
+// Integer reference; SIMD kernels match it exactly.
+void RgbaToYuvRowsScalar(const uint8_t* rgba0,
+                         const uint8_t* rgba1,
+                         int32_t width,
+                         uint8_t* y0,
+                         uint8_t* y1,
+                         uint8_t* u,
+                         uint8_t* v,
+                         int32_t chromaStep,
+                         const YuvCoefficients& coeffs);
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+void RgbaToYuvRowsSse41(const uint8_t* rgba0,
+                        const uint8_t* rgba1,
+                        int32_t width,
+                        uint8_t* y0,
+                        uint8_t* y1,
+                        uint8_t* u,
+                        uint8_t* v,
+                        int32_t chromaStep,
+                        const YuvCoefficients& coeffs);
+#endif
+
+// Follows the tone-map ISA choice like the scaler kernels.
+RgbaToYuvRowsFn ActiveYuvKernel();
+
+}  // namespace pixel_pipeline
+
+#endif  // CURSORCINE_PIXEL_PIPELINE_YUV_H_
@@ -0,0 +1,115 @@
+#include "yuv.h"
+
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+
+#include <immintrin.h>
+
+#include <cstring>
+
+namespace pixel_pipeline {
+
+namespace {
+
+constexpr int kLumaShift = YuvCoefficients::kFractionBits;
+constexpr int kChromaShift = YuvCoefficients::kFractionBits + 2;
+
+// (R, G, B, 0) weights for two RGBA pixels widened to 16-bit lanes, so one
+// pmaddwd yields [R*wr + G*wg, B*wb] per pixel.
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i PixelWeights(const int16_t* w) {
+  return _mm_setr_epi16(w[0], w[1], w[2], 0, w[0], w[1], w[2], 0);
+}
+
+// Eight RGBA pixels -> eight luma bytes (low half of the result).
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i LumaRow8(__m128i lo, __m128i hi, __m128i weights, __m128i bias) {
+  const __m128i p01 = _mm_madd_epi16(_mm_cvtepu8_epi16(lo), weights);
+  const __m128i p23 = _mm_madd_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(lo, 8)), weights);
+  const __m128i p45 = _mm_madd_epi16(_mm_cvtepu8_epi16(hi), weights);
+  const __m128i p67 = _mm_madd_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(hi, 8)), weights);
+  const __m128i y0123 = _mm_srai_epi32(_mm_add_epi32(_mm_hadd_epi32(p01, p23), bias), kLumaShift);
+  const __m128i y4567 = _mm_srai_epi32(_mm_add_epi32(_mm_hadd_epi32(p45, p67), bias), kLumaShift);
+  const __m128i y16 = _mm_packs_epi32(y0123, y4567);
+  return _mm_packus_epi16(y16, y16);
+}
+
+// Vertical sums of two pixels (16-bit RGBA lanes) -> 2x2 block sums of the
+// two chroma samples they cover.
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i BlockSums(__m128i pixels01, __m128i pixels23) {
+  return _mm_add_epi16(_mm_unpacklo_epi64(pixels01, pixels23), _mm_unpackhi_epi64(pixels01, pixels23));
+}
+
+PIXEL_PIPELINE_TARGET("sse4.1")
+inline __m128i Chroma4(__m128i blocks01, __m128i blocks23, __m128i weights, __m128i bias) {
+  const __m128i c = _mm_hadd_epi32(_mm_madd_epi16(blocks01, weights), _mm_madd_epi16(blocks23, weights));
+  return _mm_srai_epi32(_mm_add_epi32(c, bias), kChromaShift);
+}
+
+}  // namespace
+
+PIXEL_PIPELINE_TARGET("sse4.1")
+void RgbaToYuvRowsSse41(const uint8_t* rgba0,
+                        const uint8_t* rgba1,
+                        int32_t width,
+                        uint8_t* y0,
+                        uint8_t* y1,
+                        uint8_t* u,
+                        uint8_t* v,
+                        int32_t chromaStep,
+                        const YuvCoefficients& coeffs) {
+  const __m128i yWeights = PixelWeights(coeffs.y);
+  const __m128i uWeights = PixelWeights(coeffs.u);
+  const __m128i vWeights = PixelWeights(coeffs.v);
+  const __m128i lumaBias = _mm_set1_epi32((coeffs.yOffset << kLumaShift) + (1 << (kLumaShift - 1)));
+  const __m128i chromaBias = _mm_set1_epi32((128 << kChromaShift) + (1 << (kChromaShift - 1)));
+  // [u0 u1 u2 u3 v0 v1 v2 v3] -> [u0 v0 u1 v1 ...] for NV12.
+  const __m128i interleave = _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+
+  int32_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba0 + static_cast<size_t>(x) * 4));
+    const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba0 + static_cast<size_t>(x) * 4 + 16));
+    const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba1 + static_cast<size_t>(x) * 4));
+    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba1 + static_cast<size_t>(x) * 4 + 16));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(y0 + x), LumaRow8(a0, a1, yWeights, lumaBias));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(y1 + x), LumaRow8(b0, b1, yWeights, lumaBias));
+
+    const __m128i s01 = _mm_add_epi16(_mm_cvtepu8_epi16(a0), _mm_cvtepu8_epi16(b0));
+    const __m128i s23 = _mm_add_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(a0, 8)), _mm_cvtepu8_epi16(_mm_srli_si128(b0, 8)));
+    const __m128i s45 = _mm_add_epi16(_mm_cvtepu8_epi16(a1), _mm_cvtepu8_epi16(b1));
+    const __m128i s67 = _mm_add_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(a1, 8)), _mm_cvtepu8_epi16(_mm_srli_si128(b1, 8)));
+    const __m128i blocks01 = BlockSums(s01, s23);
+    const __m128i blocks23 = BlockSums(s45, s67);
+    const __m128i uv16 = _mm_packs_epi32(Chroma4(blocks01, blocks23, uWeights, chromaBias),
+                                         Chroma4(blocks01, blocks23, vWeights, chromaBias));
+    const __m128i uv8 = _mm_packus_epi16(uv16, uv16);
+    const size_t out = static_cast<size_t>(x / 2) * static_cast<size_t>(chromaStep);
+    if (chromaStep == 2) {
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(u + out), _mm_shuffle_epi8(uv8, interleave));
+    } else {
+      const int32_t u4 = _mm_cvtsi128_si32(uv8);
+      const int32_t v4 = _mm_extract_epi32(uv8, 1);
+      std::memcpy(u + out, &u4, sizeof(u4));
+      std::memcpy(v + out, &v4, sizeof(v4));
+    }
+  }
+
+  if (x < width) {
+    const size_t out = static_cast<size_t>(x / 2) * static_cast<size_t>(chromaStep);
+    RgbaToYuvRowsScalar(rgba0 + static_cast<size_t>(x) * 4,
+                        rgba1 + static_cast<size_t>(x) * 4,
+                        width - x,
+                        y0 + x,
+                        y1 + x,
+                        u + out,
+                        v + out,
+                        chromaStep,
+                        coeffs);
+  }
+}
+
+}  // namespace pixel_pipeline
+
+#endif  // PIXEL_PIPELINE_ARCH_X86
@@ -1,11 +1,21 @@
 {
+  "includes": ["../pixel-pipeline/pixel_pipeline.gypi"],
   "targets": [
     {
       "target_name": "windows_hdr_capture",
-      "sources": ["src/addon.cc"],
+      "sources": ["../capture-addon/src/capture_addon.cc", "src/backend.cc"],
+      "include_dirs": ["../capture-addon/src"],
+      "dependencies": ["pixel_pipeline"],
+      "cflags_cc": ["-std=c++17"],
       "conditions": [
         ["OS=='win'", {
-          "defines": ["NOMINMAX", "WIN32_LEAN_AND_MEAN"]
+          "defines": ["NOMINMAX", "WIN32_LEAN_AND_MEAN"],
+          "libraries": ["winmm.lib"],
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "AdditionalOptions": ["/std:c++17"]
+            }
+          }
         }]
       ]
     }
@@ -3,13 +3,28 @@ const path = require('path');
 let binding = null;
 let loadError = '';
 
-if (process.platform === 'win32') {
+// The addon builds everywhere. Desktop capture is Windows-only, but the
+// `synthetic` and `replay` backends run the same pipeline on any platform.
+// The test flag makes `synthetic` the default backend.
+const syntheticSource = process.env.CURSORCINE_NATIVE_TEST_SYNTHETIC_SOURCE === '1';
+const captureAvailable = process.platform === 'win32' || syntheticSource;
+const PORTABLE_BACKENDS = new Set(['synthetic', 'replay']);
+
+function loadBinding() {
+  if (binding || loadError) {
+    return binding;
+  }
   try {
     // eslint-disable-next-line global-require, import/no-dynamic-require
     binding = require(path.join(__dirname, 'build', 'Release', 'windows_hdr_capture.node'));
   } catch (error) {
     loadError = error && error.message ? error.message : 'load failed';
   }
+  return binding;
+}
+
+if (captureAvailable) {
+  loadBinding();
 }
 
 function unsupported(reason, message, extra = {}) {
@@ -24,7 +39,7 @@ function unsupported(reason, message, extra = {}) {
 }
 
 function probe(payload = {}) {
-  if (process.platform !== 'win32') {
+  if (!captureAvailable) {
     return unsupported('NOT_WINDOWS', 'Windows-only backend.');
   }
   if (!binding || typeof binding.probe !== 'function') {
@@ -36,14 +51,14 @@ function probe(payload = {}) {
 }
 
 function startCapture(payload = {}) {
-  if (process.platform !== 'win32') {
+  if (!captureAvailable && !PORTABLE_BACKENDS.has(payload && payload.backend)) {
     return {
       ok: false,
       reason: 'NOT_WINDOWS',
       message: 'Windows-only backend.'
     };
   }
-  if (!binding || typeof binding.startCapture !== 'function') {
+  if (!loadBinding() || typeof binding.startCapture !== 'function') {
     return {
       ok: false,
       reason: 'NATIVE_UNAVAILABLE',
@@ -64,6 +79,158 @@ function readFrame(payload = {}) {
   return binding.readFrame(payload);
 }
 
+// `target` may be a Buffer/typed array, ArrayBuffer or SharedArrayBuffer; Node-API
+// cannot read a SharedArrayBuffer directly, so it is wrapped in a Uint8Array.
+function readFrameInto(payload = {}) {
+  if (!binding || typeof binding.readFrameInto !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  const target = payload && payload.target;
+  if (typeof SharedArrayBuffer !== 'undefined' && target instanceof SharedArrayBuffer) {
+    return binding.readFrameInto({ ...payload, target: new Uint8Array(target) });
+  }
+  return binding.readFrameInto(payload);
+}
+
+// Promise form of readFrame/readFrameInto: capture and tone mapping run on the
+// libuv thread pool. Resolves (never rejects) with the same result shapes;
+// reads still queued when stopCapture runs resolve with reason CANCELLED.
+function readFrameAsync(payload = {}) {
+  if (!binding || typeof binding.readFrameAsync !== 'function') {
+    return Promise.resolve({
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    });
+  }
+  const target = payload && payload.target;
+  if (typeof SharedArrayBuffer !== 'undefined' && target instanceof SharedArrayBuffer) {
+    return binding.readFrameAsync({ ...payload, target: new Uint8Array(target) });
+  }
+  return binding.readFrameAsync(payload);
+}
+
+// Newest frame from a `continuous: true` session's native capture thread;
+// never waits (`NO_NEW_FRAME` when nothing completed since the last call).
+function readLatest(payload = {}) {
+  if (!binding || typeof binding.readLatest !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  const target = payload && payload.target;
+  if (typeof SharedArrayBuffer !== 'undefined' && target instanceof SharedArrayBuffer) {
+    return binding.readLatest({ ...payload, target: new Uint8Array(target) });
+  }
+  return binding.readLatest(payload);
+}
+
+// Pacing of a continuous session's capture thread: frame-interval and
+// deadline-jitter histograms plus missed-deadline counts.
+function getPacingStats(payload = {}) {
+  if (!binding || typeof binding.getPacingStats !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  return binding.getPacingStats(payload);
+}
+
+// Restricts capture to a display region (plus margin), scaled to the output size.
+function setViewport(payload = {}) {
+  if (!binding || typeof binding.setViewport !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  return binding.setViewport(payload);
+}
+
+// Per-stage timing histograms (capture, cursor, decode, process, scale,
+// tonemap, convert, marshal) and over-budget counts for any session.
+function getStats(payload = {}) {
+  if (!binding || typeof binding.getStats !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  return binding.getStats(payload);
+}
+
+// Frame deltas need no capture session, so they load the addon on any platform.
+function encodeFrameDelta(payload = {}) {
+  if (!loadBinding() || typeof binding.encodeFrameDelta !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  return binding.encodeFrameDelta(payload);
+}
+
+function decodeFrameDelta(payload = {}) {
+  if (!loadBinding() || typeof binding.decodeFrameDelta !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  return binding.decodeFrameDelta(payload);
+}
+
+// Shared frame rings (startCapture sharedRing) are opened by name and need no
+// capture session, so a reader can live in any process.
+function openFrameRing(payload = {}) {
+  if (!loadBinding() || typeof binding.openFrameRing !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  return binding.openFrameRing(payload);
+}
+
+function readFrameRing(payload = {}) {
+  if (!loadBinding() || typeof binding.readFrameRing !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  const target = payload && payload.target;
+  if (typeof SharedArrayBuffer !== 'undefined' && target instanceof SharedArrayBuffer) {
+    return binding.readFrameRing({ ...payload, target: new Uint8Array(target) });
+  }
+  return binding.readFrameRing(payload);
+}
+
+function closeFrameRing(payload = {}) {
+  if (!loadBinding() || typeof binding.closeFrameRing !== 'function') {
+    return {
+      ok: false,
+      reason: 'NATIVE_UNAVAILABLE',
+      message: loadError || 'Native addon not available.'
+    };
+  }
+  return binding.closeFrameRing(payload);
+}
+
 function stopCapture(payload = {}) {
   if (!binding || typeof binding.stopCapture !== 'function') {
     return {
@@ -78,5 +245,16 @@ module.exports = {
   probe,
   startCapture,
   readFrame,
+  readFrameInto,
+  readFrameAsync,
+  readLatest,
+  getPacingStats,
+  setViewport,
+  getStats,
+  encodeFrameDelta,
+  decodeFrameDelta,
+  openFrameRing,
+  readFrameRing,
+  closeFrameRing,
   stopCapture
 };
@@ -0,0 +1,7 @@
+#include "capture_backend.h"
+
+namespace capture_addon {
+
+const char kBackendName[] = "windows-gdi-capture";
+
+}  // namespace capture_addon
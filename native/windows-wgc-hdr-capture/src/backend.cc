@@ -0,0 +1,7 @@
+#include "capture_backend.h"
+
+namespace capture_addon {
+
+const char kBackendName[] = "windows-wgc-hdr-mvp";
+
+}  // namespace capture_addon
@@ -50,15 +50,21 @@ function cleanBuildDir(moduleDir) {
 }
 
 function patchPlatformToolset(moduleDir, vcxprojName) {
-  const vcxprojPath = path.join(moduleDir, "build", vcxprojName);
+  const buildDir = path.join(moduleDir, "build");
+  const vcxprojPath = path.join(buildDir, vcxprojName);
   if (!fs.existsSync(vcxprojPath)) {
     console.error("[build:native-hdr-win] vcxproj not found:", vcxprojPath);
     process.exit(1);
   }
-  const content = fs.readFileSync(vcxprojPath, "utf8");
-  const replaced = content.replace(/<PlatformToolset>[^<]+<\/PlatformToolset>/g, "<PlatformToolset>v143</PlatformToolset>");
-  if (replaced !== content) {
-    fs.writeFileSync(vcxprojPath, replaced, "utf8");
+  // Shared static libraries (pixel_pipeline) get their own project next to the addon's.
+  const projects = fs.readdirSync(buildDir).filter((name) => name.endsWith(".vcxproj"));
+  for (const name of projects) {
+    const projectPath = path.join(buildDir, name);
+    const content = fs.readFileSync(projectPath, "utf8");
+    const replaced = content.replace(/<PlatformToolset>[^<]+<\/PlatformToolset>/g, "<PlatformToolset>v143</PlatformToolset>");
+    if (replaced !== content) {
+      fs.writeFileSync(projectPath, replaced, "utf8");
+    }
   }
 }
 
@@ -66,8 +66,10 @@ function collectNativeCoverage() {
     '--quiet',
     '--export_type', 'cobertura:coverage-native\\native-windows-cobertura.xml',
     '--export_type', 'html:coverage-native\\html',
+    '--sources', 'native\\capture-addon\\src',
     '--sources', 'native\\windows-hdr-capture\\src',
     '--sources', 'native\\windows-wgc-hdr-capture\\src',
+    '--sources', 'native\\pixel-pipeline\\src',
     '--',
     'node',
     'tests/native/windows-native-coverage-smoke.js'
@@ -0,0 +1,53 @@
+#!/usr/bin/env node
+
+const fs = require("fs");
+const path = require("path");
+const { spawnSync } = require("child_process");
+
+const rootDir = path.join(__dirname, "..");
+const moduleDir = path.join("native", "pixel-pipeline");
+
+function resolveNodeGyp() {
+  const local = path.join(rootDir, "node_modules", "node-gyp", "bin", "node-gyp.js");
+  if (fs.existsSync(local)) {
+    return local;
+  }
+  // npm exposes its bundled node-gyp to lifecycle scripts.
+  return process.env.npm_config_node_gyp || local;
+}
+
+function run(name, command, args) {
+  process.stdout.write("[native-pixel] " + name + "...\n");
+  const result = spawnSync(command, args, {
+    cwd: rootDir,
+    stdio: "inherit",
+    env: process.env,
+  });
+  if (result.error) {
+    process.stderr.write("[native-pixel] " + name + " failed: " + result.error.message + "\n");
+    process.exit(1);
+  }
+  if (result.status !== 0) {
+    process.exit(result.status || 1);
+  }
+}
+
+function binaryPath(name) {
+  const suffix = process.platform === "win32" ? ".exe" : "";
+  return path.join(rootDir, moduleDir, "build", "Release", name + suffix);
+}
+
+const args = process.argv.slice(2);
+const benchMode = args[0] === "--bench";
+if (benchMode) {
+  args.shift();
+}
+
+if (String(process.env.CURSORCINE_NATIVE_SKIP_BUILD || "") !== "1") {
+  run("build", process.execPath, [resolveNodeGyp(), "rebuild", "--directory", moduleDir]);
+}
+if (benchMode) {
+  run("bench", binaryPath("pixel_pipeline_bench"), args);
+} else {
+  run("test", binaryPath("pixel_pipeline_tests"), args);
+}
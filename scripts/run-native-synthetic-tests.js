@@ -0,0 +1,51 @@
+#!/usr/bin/env node
+
+const fs = require("fs");
+const path = require("path");
+const { spawnSync } = require("child_process");
+
+const rootDir = path.join(__dirname, "..");
+const moduleDirs = [
+  path.join("native", "windows-hdr-capture"),
+  path.join("native", "windows-wgc-hdr-capture"),
+];
+
+function resolveNodeGyp() {
+  const local = path.join(rootDir, "node_modules", "node-gyp", "bin", "node-gyp.js");
+  if (fs.existsSync(local)) {
+    return local;
+  }
+  // npm exposes its bundled node-gyp to lifecycle scripts.
+  return process.env.npm_config_node_gyp || local;
+}
+
+function run(name, command, args, env = process.env) {
+  process.stdout.write("[native-synthetic] " + name + "...\n");
+  const result = spawnSync(command, args, {
+    cwd: rootDir,
+    stdio: "inherit",
+    env,
+  });
+  if (result.error) {
+    process.stderr.write("[native-synthetic] " + name + " failed: " + result.error.message + "\n");
+    process.exit(1);
+  }
+  if (result.status !== 0) {
+    process.exit(result.status || 1);
+  }
+}
+
+if (String(process.env.CURSORCINE_NATIVE_SKIP_BUILD || "") !== "1") {
+  for (const moduleDir of moduleDirs) {
+    run("build " + moduleDir, process.execPath, [resolveNodeGyp(), "rebuild", "--directory", moduleDir]);
+  }
+}
+const testEnv = {
+  ...process.env,
+  CURSORCINE_NATIVE_TEST_SYNTHETIC_SOURCE: "1",
+};
+run("test", process.execPath, [path.join("tests", "native", "synthetic-capture-smoke.js")], testEnv);
+// The stress test selects `backend: 'synthetic'` itself, without the test flag.
+const stressEnv = { ...process.env };
+delete stressEnv.CURSORCINE_NATIVE_TEST_SYNTHETIC_SOURCE;
+run("stress", process.execPath, [path.join("tests", "native", "synthetic-capture-stress.js")], stressEnv);
@@ -0,0 +1,94 @@
+// Decoder for the frame deltas the capture addon encodes (native/pixel-pipeline
+// src/frame_delta.h): a 16-byte header ("CDF1", then u32 LE frameBytes,
+// changedTiles, literalBytes) followed by (varint skip, varint length, literal)
+// tokens applied over the previous frame.
+const FRAME_DELTA_HEADER_BYTES = 16;
+const FRAME_DELTA_MAGIC = [0x43, 0x44, 0x46, 0x31];
+
+function readU32(bytes, offset) {
+  return (bytes[offset] | (bytes[offset + 1] << 8) | (bytes[offset + 2] << 16) | (bytes[offset + 3] << 24)) >>> 0;
+}
+
+function readFrameDeltaHeader(delta) {
+  if (!delta || delta.length < FRAME_DELTA_HEADER_BYTES) {
+    return null;
+  }
+  for (let i = 0; i < FRAME_DELTA_MAGIC.length; i += 1) {
+    if (delta[i] !== FRAME_DELTA_MAGIC[i]) {
+      return null;
+    }
+  }
+  return {
+    frameBytes: readU32(delta, 4),
+    changedTiles: readU32(delta, 8),
+    literalBytes: readU32(delta, 12)
+  };
+}
+
+// Applies `delta` to `frame` (the base, updated in place). Returns false for a
+// payload that does not fit this base; `frame` may be partly updated then.
+function decodeFrameDelta(delta, frame) {
+  const header = readFrameDeltaHeader(delta);
+  if (!header || !frame || header.frameBytes !== frame.length) {
+    return false;
+  }
+  let cursor = FRAME_DELTA_HEADER_BYTES;
+  let position = 0;
+  let copied = 0;
+  const readVarint = () => {
+    let value = 0;
+    for (let shift = 0; shift < 35; shift += 7) {
+      if (cursor >= delta.length) {
+        return -1;
+      }
+      const byte = delta[cursor];
+      cursor += 1;
+      value += (byte & 0x7f) * 2 ** shift;
+      if ((byte & 0x80) === 0) {
+        return value;
+      }
+    }
+    return -1;
+  };
+  while (cursor < delta.length) {
+    const skip = readVarint();
+    const length = readVarint();
+    if (skip < 0 || length < 0 || position + skip + length > frame.length || cursor + length > delta.length) {
+      return false;
+    }
+    position += skip;
+    frame.set(delta.subarray(cursor, cursor + length), position);
+    position += length;
+    cursor += length;
+    copied += length;
+  }
+  return copied === header.literalBytes;
+}
+
+// Keeps the frame the next delta builds on. applyDelta() updates it in place and
+// returns it, or returns null (and drops it) when the delta does not fit.
+function createFrameDeltaDecoder() {
+  let base = null;
+  return {
+    setBase(frame) {
+      base = frame || null;
+    },
+    applyDelta(delta) {
+      if (!base || !decodeFrameDelta(delta, base)) {
+        base = null;
+        return null;
+      }
+      return base;
+    },
+    reset() {
+      base = null;
+    }
+  };
+}
+
+module.exports = {
+  FRAME_DELTA_HEADER_BYTES,
+  readFrameDeltaHeader,
+  decodeFrameDelta,
+  createFrameDeltaDecoder
+};
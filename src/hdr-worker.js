@@ -10,6 +10,7 @@ const state = {
     width: 0,
     height: 0,
     stride: 0,
+    byteLength: 0,
     pixelFormat: "BGRA8",
   },
   latestFrameBytes: null,
@@ -24,10 +25,16 @@ const state = {
   pumpIntervalMs: 16,
   readTimeoutMs: 40,
   noFrameStreak: 0,
+  readIntoDisabled: false,
   reusableFrameBuffer: null,
   reusableFrameLength: 0,
   perf: {
     readMsAvg: 0,
+    nativeCaptureMsAvg: 0,
+    nativeProcessMsAvg: 0,
+    poolExhaustedCount: 0,
+    droppedFrames: 0,
+    bufferMode: "",
     copyMsAvg: 0,
     sabWriteMsAvg: 0,
     bytesPerFrameAvg: 0,
@@ -56,6 +63,12 @@ function encodePixelFormat(value) {
   if (fmt === "BGRA8") {
     return 2;
   }
+  if (fmt === "NV12") {
+    return 3;
+  }
+  if (fmt === "I420") {
+    return 4;
+  }
   return 1; // RGBA8 default
 }
 
@@ -167,6 +180,21 @@ function ensureSharedBuffers(frameByteLength) {
   }
 }
 
+// Native readFrameInto renders straight into the shared frame buffer, which
+// skips both the Buffer hand-off and the copy in writeFrameToSharedBuffer.
+function canReadFrameInto(bridge) {
+  if (!bridge || typeof bridge.readFrameInto !== "function" || state.readIntoDisabled) {
+    return false;
+  }
+  // NV12/I420 frames are larger than height * stride (the chroma planes
+  // follow the luma plane).
+  const required = Math.max(
+    state.lastFrameMeta.byteLength,
+    Math.max(1, state.lastFrameMeta.height) * Math.max(4, state.lastFrameMeta.stride)
+  );
+  return Boolean(state.sharedFrameBuffer && state.sharedFrameView && state.sharedFrameView.length >= required);
+}
+
 function writeFrameToSharedBuffer(result, bytes) {
   if (!bytes || !bytes.length) {
     return;
@@ -175,7 +203,12 @@ function writeFrameToSharedBuffer(result, bytes) {
   ensureSharedBuffers(bytes.length);
   const len = Math.min(bytes.length, state.sharedFrameView.length);
   state.sharedFrameView.set(bytes.subarray(0, len), 0);
+  publishSharedFrame(result, len);
+  const t1 = Number(process.hrtime.bigint()) / 1e6;
+  state.perf.sabWriteMsAvg = ewma(state.perf.sabWriteMsAvg, t1 - t0);
+}
 
+function publishSharedFrame(result, len) {
   const seq = state.frameSeq;
   const ts = Number(result && result.timestampMs ? result.timestampMs : Date.now());
   const tsLow = ts >>> 0;
@@ -194,8 +227,53 @@ function writeFrameToSharedBuffer(result, bytes) {
   );
   Atomics.store(state.sharedControlView, CONTROL_INDEX.FRAME_SEQ, seq);
   Atomics.store(state.sharedControlView, CONTROL_INDEX.STATUS, 1);
-  const t1 = Number(process.hrtime.bigint()) / 1e6;
-  state.perf.sabWriteMsAvg = ewma(state.perf.sabWriteMsAvg, t1 - t0);
+}
+
+// Native capture-thread pacing for continuous sessions (status requests only).
+function readNativePacing() {
+  const session = state.session;
+  const bridge = state.bridge;
+  if (!session || !session.continuous || !bridge || typeof bridge.getPacingStats !== "function") {
+    return null;
+  }
+  const stats = bridge.getPacingStats({ nativeSessionId: session.nativeSessionId });
+  if (!stats || !stats.ok) {
+    return null;
+  }
+  return {
+    targetFps: Number(stats.targetFps || 0),
+    missedDeadlines: Number(stats.missedDeadlines || 0),
+    intervalP50Ms: Number(stats.intervalMs.p50 || 0),
+    intervalP99Ms: Number(stats.intervalMs.p99 || 0),
+    jitterP95Ms: Number(stats.jitterMs.p95 || 0),
+    jitterMaxMs: Number(stats.jitterMs.max || 0),
+  };
+}
+
+// Native per-stage p95s and over-budget counts (status requests only).
+function readNativeStages() {
+  const session = state.session;
+  const bridge = state.bridge;
+  if (!session || !bridge || typeof bridge.getStats !== "function") {
+    return null;
+  }
+  const stats = bridge.getStats({ nativeSessionId: session.nativeSessionId });
+  if (!stats || !stats.ok) {
+    return null;
+  }
+  const p95Ms = {};
+  for (const [name, summary] of Object.entries(stats.stages || {})) {
+    p95Ms[name] = Number(summary.p95 || 0);
+  }
+  return {
+    frames: Number(stats.frames || 0),
+    failures: Number(stats.failures || 0),
+    budgetMs: Number(stats.budgetMs || 0),
+    overBudgetFrames: Number(stats.overBudgetFrames || 0),
+    overBudgetByStage: { ...(stats.overBudgetByStage || {}) },
+    totalP95Ms: Number(stats.totalMs.p95 || 0),
+    p95Ms,
+  };
 }
 
 async function stopCaptureInternal() {
@@ -238,25 +316,70 @@ async function pumpFrameLoop() {
   state.perf.lastPumpAt = loopStartMs;
 
   let gotFrame = false;
+  const session = state.session;
   try {
+    const readInto = canReadFrameInto(bridge);
+    const readAsync = typeof bridge.readFrameAsync === "function";
+    const targetBuffer = readInto ? state.sharedFrameBuffer : null;
+    const readPayload = {
+      nativeSessionId: Number(session.nativeSessionId || 0),
+      timeoutMs: Number(state.readTimeoutMs || 40),
+    };
+    if (readInto) {
+      readPayload.target = targetBuffer;
+      readPayload.offset = 0;
+    }
     const readStartMs = Number(process.hrtime.bigint()) / 1e6;
+    // Continuous sessions capture on a native thread and readLatest only
+    // copies out the newest frame; otherwise readFrameAsync keeps capture and
+    // tone mapping off this thread, so control messages are still served
+    // while a frame is being produced.
     const result = await Promise.resolve(
-      bridge.readFrame({
-        nativeSessionId: Number(state.session.nativeSessionId || 0),
-        timeoutMs: Number(state.readTimeoutMs || 40),
-      })
+      session.continuous
+        ? bridge.readLatest(readPayload)
+        : readAsync
+          ? bridge.readFrameAsync(readPayload)
+          : readInto
+            ? bridge.readFrameInto(readPayload)
+            : bridge.readFrame(readPayload)
     );
     const readEndMs = Number(process.hrtime.bigint()) / 1e6;
+    if (state.session !== session || (readInto && state.sharedFrameBuffer !== targetBuffer)) {
+      // Stopped, restarted or rebound while the read was in flight.
+      return;
+    }
     state.perf.readMsAvg = ewma(state.perf.readMsAvg, readEndMs - readStartMs);
+    if (result && result.ok && result.stageMs) {
+      state.perf.nativeCaptureMsAvg = ewma(state.perf.nativeCaptureMsAvg, Number(result.stageMs.capture || 0));
+      state.perf.nativeProcessMsAvg = ewma(state.perf.nativeProcessMsAvg, Number(result.stageMs.process || 0));
+    }
+    if (result && Number.isFinite(result.droppedFrames)) {
+      state.perf.droppedFrames = Number(result.droppedFrames);
+    }
+    if (result && !result.ok && result.reason === "POOL_EXHAUSTED") {
+      // Every pooled native frame is still referenced until GC runs their
+      // finalizers; the no-frame backoff below gives it time to catch up.
+      state.perf.poolExhaustedCount += 1;
+    }
+    if (result && !result.ok && result.reason === "INVALID_TARGET") {
+      state.readIntoDisabled = true;
+    }
     if (result && result.ok) {
-      const bytes = result.bytes;
+      state.perf.bufferMode = readInto ? "into" : String(result.bufferMode || "");
+      const bytes = readInto
+        ? state.sharedFrameView.subarray(0, Math.min(state.sharedFrameView.length, Number(result.byteLength || 0)))
+        : result.bytes;
       if (bytes && bytes.length) {
         gotFrame = true;
         state.noFrameStreak = 0;
-        const copyStartMs = Number(process.hrtime.bigint()) / 1e6;
-        state.latestFrameBytes = toStableBuffer(bytes);
-        const copyEndMs = Number(process.hrtime.bigint()) / 1e6;
-        state.perf.copyMsAvg = ewma(state.perf.copyMsAvg, copyEndMs - copyStartMs);
+        if (readInto) {
+          state.latestFrameBytes = bytes;
+        } else {
+          const copyStartMs = Number(process.hrtime.bigint()) / 1e6;
+          state.latestFrameBytes = toStableBuffer(bytes);
+          const copyEndMs = Number(process.hrtime.bigint()) / 1e6;
+          state.perf.copyMsAvg = ewma(state.perf.copyMsAvg, copyEndMs - copyStartMs);
+        }
         state.frameSeq += 1;
         const nowTs = Date.now();
         state.lastFrameAt = nowTs;
@@ -264,9 +387,15 @@ async function pumpFrameLoop() {
           width: Number(result.width || 0),
           height: Number(result.height || 0),
           stride: Number(result.stride || 0),
+          byteLength: Number(bytes.length || 0),
           pixelFormat: String(result.pixelFormat || "BGRA8"),
+          viewport: result.viewport || null,
         };
-        writeFrameToSharedBuffer(result, state.latestFrameBytes);
+        if (readInto) {
+          publishSharedFrame(result, bytes.length);
+        } else {
+          writeFrameToSharedBuffer(result, state.latestFrameBytes);
+        }
         const bytesLen = Number(state.latestFrameBytes.length || 0);
         state.perf.bytesPerFrameAvg = ewma(state.perf.bytesPerFrameAvg, bytesLen);
         if (state.perf.lastFrameAt > 0) {
@@ -283,9 +412,12 @@ async function pumpFrameLoop() {
   } catch (_error) {
     state.noFrameStreak += 1;
   } finally {
-    if (state.session) {
+    // A session replaced during the read already has its own pump loop.
+    if (state.session && state.session === session) {
       const baseInterval = Math.max(1, Number(state.pumpIntervalMs || 16));
-      const backoffMs = gotFrame ? 0 : Math.min(48, Math.max(0, state.noFrameStreak) * 2);
+      // Continuous sessions keep producing on their own; polling late only
+      // adds latency.
+      const backoffMs = gotFrame || session.continuous ? 0 : Math.min(48, Math.max(0, state.noFrameStreak) * 2);
       const nextDelay = baseInterval + backoffMs;
       state.pumpTimer = setTimeout(() => {
         pumpFrameLoop().catch(() => {});
@@ -307,12 +439,19 @@ async function handleRequest(requestId, command, payload) {
       readTimeoutMs: Number(state.readTimeoutMs || 0),
       perf: {
         readMsAvg: Number(state.perf.readMsAvg || 0),
+        nativeCaptureMsAvg: Number(state.perf.nativeCaptureMsAvg || 0),
+        nativeProcessMsAvg: Number(state.perf.nativeProcessMsAvg || 0),
+        poolExhaustedCount: Number(state.perf.poolExhaustedCount || 0),
+        droppedFrames: Number(state.perf.droppedFrames || 0),
+        bufferMode: String(state.perf.bufferMode || ""),
         copyMsAvg: Number(state.perf.copyMsAvg || 0),
         sabWriteMsAvg: Number(state.perf.sabWriteMsAvg || 0),
         bytesPerFrameAvg: Number(state.perf.bytesPerFrameAvg || 0),
         bytesPerSec: Number(state.perf.bytesPerSec || 0),
         pumpJitterMsAvg: Number(state.perf.pumpJitterMsAvg || 0),
         frameIntervalMsAvg: Number(state.perf.frameIntervalMsAvg || 0),
+        nativePacing: readNativePacing(),
+        nativeStages: readNativeStages(),
       },
       bridgeError: state.bridgeError || "",
     });
@@ -343,21 +482,28 @@ async function handleRequest(requestId, command, payload) {
     state.session = {
       nativeSessionId: Number(result.nativeSessionId || 0),
       routePreference,
+      continuous: Boolean(result.continuous) && typeof bridge.readLatest === "function",
     };
+    state.perf.droppedFrames = 0;
     const maxFps = Math.max(1, Math.min(120, Number(payload && payload.maxFps ? payload.maxFps : 60)));
     state.pumpIntervalMs = Math.max(1, Math.floor(1000 / maxFps));
     state.readTimeoutMs = Math.max(1, Math.min(120, state.pumpIntervalMs + 6));
     state.frameSeq = 0;
     state.lastFrameAt = 0;
     state.noFrameStreak = 0;
+    state.readIntoDisabled = false;
     state.latestFrameBytes = null;
     state.lastFrameMeta = {
       width: Number(result.width || 0),
       height: Number(result.height || 0),
       stride: Number(result.stride || 0),
+      byteLength: Number(result.byteLength || 0),
       pixelFormat: String(result.pixelFormat || "BGRA8"),
     };
-    const frameBytes = Math.max(1, state.lastFrameMeta.height) * Math.max(4, state.lastFrameMeta.stride);
+    const frameBytes = Math.max(
+      state.lastFrameMeta.byteLength,
+      Math.max(1, state.lastFrameMeta.height) * Math.max(4, state.lastFrameMeta.stride)
+    );
     ensureSharedBuffers(frameBytes);
     pumpFrameLoop().catch(() => {});
     response(requestId, true, {
@@ -378,6 +524,31 @@ async function handleRequest(requestId, command, payload) {
     return;
   }
 
+  if (command === "set-viewport") {
+    const bridge = state.bridge;
+    if (!state.session || !bridge || typeof bridge.setViewport !== "function") {
+      response(requestId, false, {
+        reason: state.session ? "NATIVE_UNAVAILABLE" : "NOT_CAPTURING",
+        message: state.session ? "setViewport is not supported by this bridge." : "No active capture session.",
+      });
+      return;
+    }
+    const result = bridge.setViewport({ ...(payload || {}), nativeSessionId: state.session.nativeSessionId });
+    if (!result || !result.ok) {
+      response(requestId, false, {
+        reason: String((result && result.reason) || "SET_VIEWPORT_FAILED"),
+        message: String((result && result.message) || "Failed to set the capture viewport."),
+      });
+      return;
+    }
+    response(requestId, true, {
+      viewport: result.viewport,
+      captureWidth: Number(result.captureWidth || 0),
+      captureHeight: Number(result.captureHeight || 0),
+    });
+    return;
+  }
+
   if (command === "bind-shared") {
     const sharedFrameBuffer = payload && payload.sharedFrameBuffer;
     const sharedControlBuffer = payload && payload.sharedControlBuffer;
@@ -393,6 +564,7 @@ async function handleRequest(requestId, command, payload) {
     state.sharedFrameView = new Uint8Array(sharedFrameBuffer);
     state.sharedControlView = new Int32Array(sharedControlBuffer);
     state.sharedControlView.fill(0);
+    state.readIntoDisabled = false;
     response(requestId, true, { bound: true });
     return;
   }
@@ -428,7 +600,11 @@ async function handleRequest(requestId, command, payload) {
       height: state.lastFrameMeta.height,
       stride: state.lastFrameMeta.stride,
       pixelFormat: state.lastFrameMeta.pixelFormat,
-      bytes: state.latestFrameBytes,
+      // readFrameInto frames are views of the live shared buffer; hand out a
+      // snapshot so the next frame cannot change it mid-message.
+      bytes: state.latestFrameBytes.buffer instanceof SharedArrayBuffer
+        ? Buffer.from(state.latestFrameBytes)
+        : state.latestFrameBytes,
     });
     return;
   }
@@ -65,6 +65,12 @@ function encodeHdrPixelFormat(value) {
   if (fmt === 'BGRA8') {
     return 2;
   }
+  if (fmt === 'NV12') {
+    return 3;
+  }
+  if (fmt === 'I420') {
+    return 4;
+  }
   return 1; // RGBA8 default
 }
 
@@ -180,6 +186,43 @@ function ewma(prev, sample, alpha = 0.2) {
   return p > 0 ? (p * (1 - alpha) + s * alpha) : s;
 }
 
+// The HTTP transport sends a frame as a delta against the one the client last
+// received when it asks for `encoding=delta` and that frame (`minSeq`) is the
+// base kept here; anything else gets the raw frame. One client per session.
+const HDR_FRAME_EXPOSED_HEADERS = [
+  'X-Hdr-Frame-Seq',
+  'X-Hdr-Width',
+  'X-Hdr-Height',
+  'X-Hdr-Stride',
+  'X-Hdr-Pixel-Format',
+  'X-Hdr-Timestamp-Ms',
+  'X-Hdr-Encoding',
+  'X-Hdr-Base-Seq'
+].join(', ');
+
+function encodeHdrFrameDelta(session, frame, baseSeq) {
+  const base = session.httpBaseBytes;
+  if (!(baseSeq > 0) || Number(session.httpBaseSeq || 0) !== baseSeq || !base || base.length !== frame.length) {
+    return null;
+  }
+  const codec = session.bridge && typeof session.bridge.encodeFrameDelta === 'function'
+    ? session.bridge
+    : loadWindowsHdrNativeBridge();
+  if (!codec || typeof codec.encodeFrameDelta !== 'function') {
+    return null;
+  }
+  // Past half the raw size a delta no longer pays for the decode.
+  const result = codec.encodeFrameDelta({ base, frame, maxBytes: Math.floor(frame.length / 2) });
+  return result && result.ok && Buffer.isBuffer(result.bytes) ? result.bytes : null;
+}
+
+// Each pump stores a new Buffer in latestFrameBytes and none is written after,
+// so the served frame can stay the delta base by reference.
+function rememberHdrHttpBase(session, frame, frameSeq) {
+  session.httpBaseBytes = frame;
+  session.httpBaseSeq = frameSeq;
+}
+
 function ensureHdrFrameServer() {
   if (hdrFrameServer && hdrFrameServerPort > 0) {
     return Promise.resolve({ ok: true, port: hdrFrameServerPort });
@@ -221,6 +264,19 @@ function ensureHdrFrameServer() {
         }
 
         const frame = session.latestFrameBytes;
+        let body = frame;
+        let encoding = 'raw';
+        if (url.searchParams.get('encoding') === 'delta') {
+          const delta = encodeHdrFrameDelta(session, frame, minSeq);
+          if (delta) {
+            body = delta;
+            encoding = 'delta';
+          }
+          rememberHdrHttpBase(session, frame, frameSeq);
+        }
+        if (session.perf) {
+          session.perf.httpBytesPerFrameAvg = ewma(session.perf.httpBytesPerFrameAvg, body.length);
+        }
         res.statusCode = 200;
         res.setHeader('Content-Type', 'application/octet-stream');
         res.setHeader('Cache-Control', 'no-store');
@@ -232,7 +288,12 @@ function ensureHdrFrameServer() {
         res.setHeader('X-Hdr-Stride', String(Number(session.latestStride || session.stride || 0)));
         res.setHeader('X-Hdr-Pixel-Format', String(session.latestPixelFormat || 'RGBA8'));
         res.setHeader('X-Hdr-Timestamp-Ms', String(Number(session.latestTimestampMs || 0)));
-        res.end(frame);
+        res.setHeader('X-Hdr-Encoding', encoding);
+        if (encoding === 'delta') {
+          res.setHeader('X-Hdr-Base-Seq', String(minSeq));
+        }
+        res.setHeader('Access-Control-Expose-Headers', HDR_FRAME_EXPOSED_HEADERS);
+        res.end(body);
       } catch (_error) {
         res.statusCode = 500;
         res.end('server-error');
@@ -2957,6 +3018,9 @@ app.whenReady().then(() => {
           maxFps: Number(payload && payload.maxFps ? payload.maxFps : 60),
           maxOutputPixels: Math.max(640 * 360, physicalW * physicalH),
           toneMap: payload && payload.toneMap ? payload.toneMap : {},
+          scaler: payload && payload.scaler ? String(payload.scaler) : 'nearest',
+          continuous: Boolean(payload && payload.continuous),
+          threads: payload && Number.isInteger(payload.threads) ? payload.threads : 1,
           routePreference: requestedRoute,
           displayHint
         };
@@ -2971,6 +3035,7 @@ app.whenReady().then(() => {
           maxFps: Number(payload && payload.maxFps ? payload.maxFps : 60),
           maxOutputPixels: Math.max(640 * 360, physicalW * physicalH),
           toneMap: payload && payload.toneMap ? payload.toneMap : {},
+          scaler: payload && payload.scaler ? String(payload.scaler) : 'nearest',
           routePreference: requestedRoute,
           displayHint
         }));
@@ -2996,6 +3061,7 @@ app.whenReady().then(() => {
             maxFps: Number(payload && payload.maxFps ? payload.maxFps : 60),
             maxOutputPixels: Math.max(640 * 360, physicalW * physicalH),
             toneMap: payload && payload.toneMap ? payload.toneMap : {},
+            scaler: payload && payload.scaler ? String(payload.scaler) : 'nearest',
             routePreference: 'legacy',
             displayHint
           }));
@@ -3064,12 +3130,15 @@ app.whenReady().then(() => {
         latestStride: stride,
         latestPixelFormat: String(startResult.pixelFormat || 'RGBA8'),
         latestFrameBytes: null,
+        httpBaseBytes: null,
+        httpBaseSeq: 0,
         pumpTimer: 0,
         perf: {
           readMsAvg: 0,
           copyMsAvg: 0,
           sabWriteMsAvg: 0,
           bytesPerFrameAvg: 0,
+          httpBytesPerFrameAvg: 0,
           bytesPerSec: 0,
           pumpJitterMsAvg: 0,
           frameIntervalMsAvg: 0,
@@ -3272,6 +3341,7 @@ app.whenReady().then(() => {
           copyMsAvg: Number(session.perf && session.perf.copyMsAvg ? session.perf.copyMsAvg : 0),
           sabWriteMsAvg: Number(session.perf && session.perf.sabWriteMsAvg ? session.perf.sabWriteMsAvg : 0),
           bytesPerFrameAvg: Number(session.perf && session.perf.bytesPerFrameAvg ? session.perf.bytesPerFrameAvg : 0),
+          httpBytesPerFrameAvg: Number(session.perf && session.perf.httpBytesPerFrameAvg ? session.perf.httpBytesPerFrameAvg : 0),
           bytesPerSec: Number(session.perf && session.perf.bytesPerSec ? session.perf.bytesPerSec : 0),
           pumpJitterMsAvg: Number(session.perf && session.perf.pumpJitterMsAvg ? session.perf.pumpJitterMsAvg : 0),
           frameIntervalMsAvg: Number(session.perf && session.perf.frameIntervalMsAvg ? session.perf.frameIntervalMsAvg : 0)
@@ -3337,6 +3407,7 @@ app.whenReady().then(() => {
             copyMsAvg: Number(sessionObj.perf && sessionObj.perf.copyMsAvg ? sessionObj.perf.copyMsAvg : 0),
             sabWriteMsAvg: Number(sessionObj.perf && sessionObj.perf.sabWriteMsAvg ? sessionObj.perf.sabWriteMsAvg : 0),
             bytesPerFrameAvg: Number(sessionObj.perf && sessionObj.perf.bytesPerFrameAvg ? sessionObj.perf.bytesPerFrameAvg : 0),
+            httpBytesPerFrameAvg: Number(sessionObj.perf && sessionObj.perf.httpBytesPerFrameAvg ? sessionObj.perf.httpBytesPerFrameAvg : 0),
             bytesPerSec: Number(sessionObj.perf && sessionObj.perf.bytesPerSec ? sessionObj.perf.bytesPerSec : 0),
             pumpJitterMsAvg: Number(sessionObj.perf && sessionObj.perf.pumpJitterMsAvg ? sessionObj.perf.pumpJitterMsAvg : 0),
             frameIntervalMsAvg: Number(sessionObj.perf && sessionObj.perf.frameIntervalMsAvg ? sessionObj.perf.frameIntervalMsAvg : 0)
@@ -3466,6 +3537,7 @@ app.whenReady().then(() => {
         displayId: displayHint.displayId,
         maxFps: Number(payload && payload.maxFps ? payload.maxFps : 60),
         toneMap: payload && payload.toneMap ? payload.toneMap : {},
+        scaler: payload && payload.scaler ? String(payload.scaler) : 'nearest',
         displayHint
       }));
 
@@ -3495,6 +3567,7 @@ app.whenReady().then(() => {
         pixelFormat: String(startResult.pixelFormat || 'RGBA8'),
         colorSpace: String(startResult.colorSpace || 'Rec.709'),
         toneMap: startResult.toneMap || {},
+        scaler: String(startResult.scaler || 'nearest'),
         hdrActive: Boolean(startResult.hdrActive),
         nativeBackend: String(startResult.nativeBackend || 'windows-hdr-capture')
       };
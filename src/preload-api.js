@@ -1,5 +1,6 @@
 const { createRecordingController } = require('./recording-controller');
 const { decideNextExportAction } = require('./core/export-strategy');
+const { createFrameDeltaDecoder } = require('./core/frame-delta');
 
 function createPreloadApi(ipcRenderer) {
   const uploadIpcApi = {
@@ -10,6 +11,7 @@ function createPreloadApi(ipcRenderer) {
   const recordingUploadController = createRecordingController({
     electronAPI: uploadIpcApi
   });
+  const frameDeltaDecoder = createFrameDeltaDecoder();
 
   return {
     getCursorPoint: (displayId) => ipcRenderer.invoke('cursor:get', displayId),
@@ -35,6 +37,9 @@ function createPreloadApi(ipcRenderer) {
     recordingUploadStats: () => recordingUploadController.getStats(),
     recordingUploadReset: () => recordingUploadController.reset(),
     decideExportAction: (payload) => decideNextExportAction(payload || {}),
+    setFrameDeltaBase: (frame) => frameDeltaDecoder.setBase(frame),
+    applyFrameDelta: (delta) => frameDeltaDecoder.applyDelta(delta),
+    resetFrameDelta: () => frameDeltaDecoder.reset(),
     pathToFileUrl: (payload) => ipcRenderer.invoke('path:to-file-url', payload),
     cleanupTempDir: (payload) => ipcRenderer.invoke('path:cleanup-temp-dir', payload),
     copyText: (payload) => ipcRenderer.invoke('app:copy-text', payload),
@@ -38,6 +38,70 @@ function decideNextExportAction(input = {}) {
   };
 }
 
+// Mirrors createFrameDeltaDecoder in src/core/frame-delta.js; the sandboxed
+// preload cannot require it. Keeps the base frame on this side of the bridge so
+// each delta crosses it once and only the decoded frame comes back.
+function readFrameDeltaU32(bytes, offset) {
+  return (bytes[offset] | (bytes[offset + 1] << 8) | (bytes[offset + 2] << 16) | (bytes[offset + 3] << 24)) >>> 0;
+}
+
+function decodeFrameDelta(delta, frame) {
+  if (!delta || !frame || delta.length < 16 || delta[0] !== 0x43 || delta[1] !== 0x44 || delta[2] !== 0x46 ||
+      delta[3] !== 0x31 || readFrameDeltaU32(delta, 4) !== frame.length) {
+    return false;
+  }
+  let cursor = 16;
+  let position = 0;
+  let copied = 0;
+  const readVarint = () => {
+    let value = 0;
+    for (let shift = 0; shift < 35; shift += 7) {
+      if (cursor >= delta.length) {
+        return -1;
+      }
+      const byte = delta[cursor];
+      cursor += 1;
+      value += (byte & 0x7f) * 2 ** shift;
+      if ((byte & 0x80) === 0) {
+        return value;
+      }
+    }
+    return -1;
+  };
+  while (cursor < delta.length) {
+    const skip = readVarint();
+    const length = readVarint();
+    if (skip < 0 || length < 0 || position + skip + length > frame.length || cursor + length > delta.length) {
+      return false;
+    }
+    position += skip;
+    frame.set(delta.subarray(cursor, cursor + length), position);
+    position += length;
+    cursor += length;
+    copied += length;
+  }
+  return copied === readFrameDeltaU32(delta, 12);
+}
+
+function createFrameDeltaDecoder() {
+  let base = null;
+  return {
+    setBase(frame) {
+      base = frame || null;
+    },
+    applyDelta(delta) {
+      if (!base || !decodeFrameDelta(delta, base)) {
+        base = null;
+        return null;
+      }
+      return base;
+    },
+    reset() {
+      base = null;
+    }
+  };
+}
+
 function createRecordingUploadController() {
   let session = null;
   let chain = Promise.resolve();
@@ -132,6 +196,7 @@ function createRecordingUploadController() {
 }
 
 const recordingUploadController = createRecordingUploadController();
+const frameDeltaDecoder = createFrameDeltaDecoder();
 
 contextBridge.exposeInMainWorld('electronAPI', {
   getCursorPoint: (displayId) => ipcRenderer.invoke('cursor:get', displayId),
@@ -157,6 +222,9 @@ contextBridge.exposeInMainWorld('electronAPI', {
   recordingUploadStats: () => recordingUploadController.getStats(),
   recordingUploadReset: () => recordingUploadController.reset(),
   decideExportAction: (payload) => decideNextExportAction(payload || {}),
+  setFrameDeltaBase: (frame) => frameDeltaDecoder.setBase(frame),
+  applyFrameDelta: (delta) => frameDeltaDecoder.applyDelta(delta),
+  resetFrameDelta: () => frameDeltaDecoder.reset(),
   pathToFileUrl: (payload) => ipcRenderer.invoke('path:to-file-url', payload),
   cleanupTempDir: (payload) => ipcRenderer.invoke('path:cleanup-temp-dir', payload),
   copyText: (payload) => ipcRenderer.invoke('app:copy-text', payload),
@@ -686,6 +686,12 @@ function decodeSharedPixelFormat(code) {
   if (n === 2) {
     return 'BGRA8';
   }
+  if (n === 3) {
+    return 'NV12';
+  }
+  if (n === 4) {
+    return 'I420';
+  }
   return 'RGBA8';
 }
 
@@ -2178,6 +2184,7 @@ async function stopNativeHdrCapture() {
   nativeHdrState.startupDeadlineMs = 0;
   nativeHdrState.frameEndpoint = '';
   nativeHdrState.lastHttpFrameSeq = 0;
+  electronAPI.resetFrameDelta();
   nativeHdrState.captureFps = 0;
   nativeHdrState.renderFps = 0;
   nativeHdrState.queueDepth = 0;
@@ -2318,7 +2325,7 @@ async function tryReadNativeFrameFromHttpEndpoint() {
   if (!endpoint) {
     return null;
   }
-  const url = endpoint + '?minSeq=' + String(Number(nativeHdrState.lastHttpFrameSeq || 0));
+  const url = endpoint + '?minSeq=' + String(Number(nativeHdrState.lastHttpFrameSeq || 0)) + '&encoding=delta';
   const response = await fetch(url, {
     method: 'GET',
     cache: 'no-store'
@@ -2345,7 +2352,23 @@ async function tryReadNativeFrameFromHttpEndpoint() {
   const height = Math.max(1, Number(response.headers.get('x-hdr-height') || nativeHdrState.height || 1));
   const stride = Math.max(width * 4, Number(response.headers.get('x-hdr-stride') || nativeHdrState.stride || width * 4));
   const pixelFormat = String(response.headers.get('x-hdr-pixel-format') || 'RGBA8');
-  const bytes = await response.arrayBuffer();
+  const encoding = String(response.headers.get('x-hdr-encoding') || 'raw');
+  const payload = new Uint8Array(await response.arrayBuffer());
+  // Deltas build on the last frame received, which the preload decoder keeps.
+  let frame = payload;
+  if (encoding === 'delta') {
+    const baseSeq = Number(response.headers.get('x-hdr-base-seq') || 0);
+    frame = baseSeq === Number(nativeHdrState.lastHttpFrameSeq || 0) ? electronAPI.applyFrameDelta(payload) : null;
+    if (!frame) {
+      // Asking from seq 0 gets a raw frame to start over from.
+      electronAPI.resetFrameDelta();
+      nativeHdrState.lastHttpFrameSeq = 0;
+      return null;
+    }
+  } else {
+    electronAPI.setFrameDeltaBase(payload);
+  }
+  const bytes = frame.buffer;
   nativeHdrState.lastHttpFrameSeq = frameSeq;
   return {
     ok: true,
@@ -2671,6 +2694,7 @@ async function tryStartNativeHdrCapture(sourceId, displayId, options = {}) {
   nativeHdrState.startupDeadlineMs = performance.now() + HDR_NATIVE_STARTUP_NO_FRAME_TIMEOUT_MS;
   nativeHdrState.frameEndpoint = String(start.frameEndpoint || '');
   nativeHdrState.lastHttpFrameSeq = 0;
+  electronAPI.resetFrameDelta();
   nativeHdrState.runtimeLegacyRetryAttempted = routePreference === 'legacy';
   hdrMappingState.runtimeBackend = String(start.nativeBackend || '');
   hdrMappingState.runtimeTransportMode = normalizeHdrTransportMode(
@@ -67,6 +67,18 @@ describe('preload api contract', () => {
     expect(decision.reuseOutputPath).toBe('/tmp/demo.webm');
   });
 
+  it('exposes the frame delta decoder', () => {
+    const api = createPreloadApi(createMockIpcRenderer());
+    // "CDF1", frameBytes 4, one tile, one literal byte; then skip 2, write [9].
+    const delta = new Uint8Array([0x43, 0x44, 0x46, 0x31, 4, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 2, 1, 9]);
+    expect(api.applyFrameDelta(delta)).toBe(null);
+
+    api.setFrameDeltaBase(new Uint8Array([1, 2, 3, 4]));
+    expect(Array.from(api.applyFrameDelta(delta))).toEqual([1, 2, 9, 4]);
+    api.resetFrameDelta();
+    expect(api.applyFrameDelta(delta)).toBe(null);
+  });
+
   it('resolves hdrSharedBindAsync on matching result event', async () => {
     const listeners = {};
     const ipcRenderer = {
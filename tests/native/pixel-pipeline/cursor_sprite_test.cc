@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "cursor_sprite.h"
+#include "frame_pipeline.h"
+#include "test_harness.h"
+
+namespace {
+
+using pixel_pipeline::CursorOverlay;
+using pixel_pipeline::CursorSprite;
+
+// Random premultiplied BGRA: every colour byte at or below its alpha.
+CursorSprite MakeSprite(int32_t width, int32_t height, uint32_t seed) {
+  CursorSprite sprite;
+  sprite.width = width;
+  sprite.height = height;
+  sprite.pixels.resize(static_cast<size_t>(width) * height * 4);
+  for (size_t i = 0; i < sprite.pixels.size(); i += 4) {
+    seed = seed * 1664525u + 1013904223u;
+    const uint8_t alpha = (seed >> 28) < 4 ? 0 : (seed >> 28) > 11 ? 255 : static_cast<uint8_t>(seed >> 24);
+    for (int c = 0; c < 3; ++c) {
+      seed = seed * 1664525u + 1013904223u;
+      sprite.pixels[i + c] = static_cast<uint8_t>(alpha == 0 ? 0 : (seed >> 24) % (alpha + 1));
+    }
+    sprite.pixels[i + 3] = alpha;
+  }
+  return sprite;
+}
+
+std::vector<uint8_t> MakeRgba(size_t pixels, uint32_t seed) {
+  std::vector<uint8_t> rgba(pixels * 4);
+  for (uint8_t& v : rgba) {
+    seed = seed * 1664525u + 1013904223u;
+    v = static_cast<uint8_t>(seed >> 24);
+  }
+  return rgba;
+}
+
+}  // namespace
+
+PIXEL_TEST(CursorBlendHitsReferenceLevels) {
+  // B, G, R, A premultiplied: opaque red, transparent, half-covered white.
+  const uint8_t sprite[12] = {0, 0, 255, 255, 0, 0, 0, 0, 128, 128, 128, 128};
+  uint8_t rgba[12] = {10, 20, 30, 0, 10, 20, 30, 0, 0, 0, 0, 0};
+  pixel_pipeline::BlendCursorScalar(sprite, rgba, 3);
+  const uint8_t expected[12] = {255, 0, 0, 255, 10, 20, 30, 255, 128, 128, 128, 255};
+  for (int i = 0; i < 12; ++i) {
+    EXPECT_EQ(rgba[i], expected[i]);
+  }
+}
+
+PIXEL_TEST(CursorBlendSimdMatchesScalarExactly) {
+  const pixel_pipeline::CursorBlendFn active = pixel_pipeline::ActiveCursorBlendKernel();
+  for (int32_t pixels : {1, 3, 4, 7, 32, 61}) {
+    const CursorSprite sprite = MakeSprite(pixels, 1, 0x1234u + pixels);
+    std::vector<uint8_t> scalar = MakeRgba(pixels, 0xBEEFu + pixels);
+    std::vector<uint8_t> simd = scalar;
+    pixel_pipeline::BlendCursorScalar(sprite.pixels.data(), scalar.data(), pixels);
+    active(sprite.pixels.data(), simd.data(), pixels);
+    EXPECT_TRUE(simd == scalar);
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+    if (pixel_pipeline::GetCpuFeatures().sse41) {
+      std::vector<uint8_t> sse = MakeRgba(pixels, 0xBEEFu + pixels);
+      pixel_pipeline::BlendCursorSse41(sprite.pixels.data(), sse.data(), pixels);
+      EXPECT_TRUE(sse == scalar);
+    }
+#endif
+  }
+}
+
+PIXEL_TEST(CursorSpritesFromColorBitmapsPremultiply) {
+  // Straight alpha: half-transparent white premultiplies to 128.
+  const uint8_t alphaCursor[8] = {255, 255, 255, 128, 40, 80, 120, 255};
+  CursorSprite sprite;
+  EXPECT_TRUE(pixel_pipeline::BuildColorCursorSprite(alphaCursor, 2, 1, 8, nullptr, 0, 1, 0, &sprite));
+  EXPECT_EQ(sprite.pixels[0], 128);
+  EXPECT_EQ(sprite.pixels[3], 128);
+  EXPECT_EQ(sprite.pixels[4], 40);
+  EXPECT_EQ(sprite.pixels[7], 255);
+  EXPECT_EQ(sprite.hotspotX, 1);
+
+  // No alpha at all: the AND mask (set bit = transparent) decides.
+  const uint8_t noAlpha[8] = {10, 20, 30, 0, 40, 50, 60, 0};
+  const uint8_t andMask[4] = {0x40, 0, 0, 0};
+  EXPECT_TRUE(pixel_pipeline::BuildColorCursorSprite(noAlpha, 2, 1, 8, andMask, 4, 0, 0, &sprite));
+  EXPECT_EQ(sprite.pixels[0], 10);
+  EXPECT_EQ(sprite.pixels[3], 255);
+  EXPECT_EQ(sprite.pixels[4], 0);
+  EXPECT_EQ(sprite.pixels[7], 0);
+  EXPECT_TRUE(!pixel_pipeline::BuildColorCursorSprite(noAlpha, 0, 1, 8, nullptr, 0, 0, 0, &sprite));
+}
+
+PIXEL_TEST(CursorSpritesFromMonochromeMasksOutlineInversion) {
+  // 4x3, MSB first. Row 0: black, white, transparent, transparent.
+  // Row 1: transparent, transparent, invert, transparent. Row 2: transparent.
+  const uint8_t andMask[3] = {0x30, 0xF0, 0xF0};
+  const uint8_t xorMask[3] = {0x40, 0x20, 0x00};
+  CursorSprite sprite;
+  EXPECT_TRUE(pixel_pipeline::BuildMonochromeCursorSprite(andMask, xorMask, 4, 3, 1, 0, 0, &sprite));
+  auto pixel = [&](int32_t x, int32_t y) { return sprite.pixels.data() + (y * 4 + x) * 4; };
+  EXPECT_EQ(pixel(0, 0)[0], 0);
+  EXPECT_EQ(pixel(0, 0)[3], 255);
+  EXPECT_EQ(pixel(1, 0)[0], 255);
+  EXPECT_EQ(pixel(1, 0)[3], 255);
+  // The inverting pixel turns black, its transparent neighbours white.
+  EXPECT_EQ(pixel(2, 1)[0], 0);
+  EXPECT_EQ(pixel(2, 1)[3], 255);
+  EXPECT_EQ(pixel(3, 0)[0], 255);
+  EXPECT_EQ(pixel(3, 2)[3], 255);
+  EXPECT_EQ(pixel(1, 2)[3], 255);
+  EXPECT_EQ(pixel(0, 2)[3], 0);
+}
+
+PIXEL_TEST(CursorSpriteScalesByAreaAndKeepsPremultiplication) {
+  CursorSprite src;
+  src.width = 32;
+  src.height = 32;
+  src.hotspotX = 10;
+  src.hotspotY = 7;
+  src.pixels.assign(32 * 32 * 4, 255);
+  // Transparent right half.
+  for (int32_t y = 0; y < 32; ++y) {
+    for (int32_t x = 16; x < 32; ++x) {
+      for (int c = 0; c < 4; ++c) {
+        src.pixels[(y * 32 + x) * 4 + c] = 0;
+      }
+    }
+  }
+  CursorSprite half;
+  pixel_pipeline::ScaleCursorSprite(src, 0.5, 0.5, &half);
+  EXPECT_EQ(half.width, 16);
+  EXPECT_EQ(half.height, 16);
+  EXPECT_EQ(half.hotspotX, 5);
+  EXPECT_EQ(half.hotspotY, 4);
+  EXPECT_EQ(half.pixels[(3 * 16 + 7) * 4 + 3], 255);
+  EXPECT_EQ(half.pixels[(3 * 16 + 8) * 4 + 3], 0);
+
+  // A scale that straddles the edge averages it to half coverage.
+  CursorSprite third;
+  pixel_pipeline::ScaleCursorSprite(src, 1.0 / 3.0, 1.0 / 3.0, &third);
+  EXPECT_EQ(third.width, 11);
+  const uint8_t* edge = third.pixels.data() + 5 * 4;
+  EXPECT_TRUE(edge[3] > 100 && edge[3] < 155);
+  for (size_t i = 0; i < third.pixels.size(); i += 4) {
+    EXPECT_TRUE(third.pixels[i] <= third.pixels[i + 3]);
+  }
+  // Never collapses to nothing.
+  CursorSprite tiny;
+  pixel_pipeline::ScaleCursorSprite(src, 0.001, 0.001, &tiny);
+  EXPECT_EQ(tiny.width, 1);
+  EXPECT_EQ(tiny.height, 1);
+}
+
+PIXEL_TEST(CursorSpriteCacheEvictsLeastRecentlyUsed) {
+  pixel_pipeline::CursorSpriteCache cache(2);
+  EXPECT_TRUE(cache.Find(1) == nullptr);
+  const CursorSprite* one = cache.Insert(1, MakeSprite(2, 2, 1));
+  cache.Insert(2, MakeSprite(3, 3, 2));
+  EXPECT_TRUE(cache.Find(1) == one);
+  cache.Insert(3, MakeSprite(4, 4, 3));
+  EXPECT_EQ(cache.size(), static_cast<size_t>(2));
+  EXPECT_TRUE(cache.Find(2) == nullptr);
+  EXPECT_TRUE(cache.Find(1) == one);
+  EXPECT_EQ(cache.Find(3)->width, 4);
+  EXPECT_EQ(cache.hits(), static_cast<uint64_t>(3));
+  EXPECT_EQ(cache.misses(), static_cast<uint64_t>(2));
+  cache.Clear();
+  EXPECT_TRUE(cache.Find(1) == nullptr);
+}
+
+PIXEL_TEST(CursorOverlayClipsAtFrameEdges) {
+  CursorSprite sprite = MakeSprite(8, 8, 7);
+  sprite.hotspotX = 2;
+  sprite.hotspotY = 3;
+  const CursorOverlay overlay = pixel_pipeline::PlaceCursorOverlay(&sprite, 2, 2, 0.5, 0.5);
+  EXPECT_EQ(overlay.x, -1);
+  EXPECT_EQ(overlay.y, -2);
+  for (int32_t y = 0; y < 8; ++y) {
+    std::vector<uint8_t> row = MakeRgba(6, 0x55u + y);
+    std::vector<uint8_t> expected = row;
+    if (y < 6) {
+      // Sprite columns 1..6 land on output columns 0..5.
+      pixel_pipeline::BlendCursorScalar(sprite.pixels.data() + ((y + 2) * 8 + 1) * 4, expected.data(), 6);
+    }
+    pixel_pipeline::BlendCursorRow(overlay, y, 6, row.data());
+    EXPECT_TRUE(row == expected);
+  }
+  const CursorOverlay offFrame = pixel_pipeline::PlaceCursorOverlay(&sprite, 40, 0, 1.0, 1.0);
+  std::vector<uint8_t> row = MakeRgba(6, 9);
+  const std::vector<uint8_t> untouched = row;
+  pixel_pipeline::BlendCursorRow(offFrame, 0, 6, row.data());
+  EXPECT_TRUE(row == untouched);
+}
+
+PIXEL_TEST(CursorOverlayIsDrawnByTheFusedPass) {
+  pixel_pipeline::ThreadPool pool;
+  pool.EnsureWorkers(3);
+  std::vector<uint8_t> src = MakeRgba(200 * 120, 0xC0FFEEu);
+  pixel_pipeline::ToneMapConfig cfg;
+  cfg.rolloff = 0.5f;
+  CursorSprite sprite = MakeSprite(12, 20, 11);
+  sprite.hotspotX = 1;
+  sprite.hotspotY = 1;
+  const CursorOverlay overlay = pixel_pipeline::PlaceCursorOverlay(&sprite, 190, 40, 0.5, 0.5);
+  for (pixel_pipeline::PixelFormat format : {pixel_pipeline::PixelFormat::kRgba8, pixel_pipeline::PixelFormat::kI420}) {
+    pixel_pipeline::FramePipeline pipeline;
+    pixel_pipeline::BuildFramePipeline(
+        200, 120, 100, 60, true, cfg, &pipeline, pixel_pipeline::ScalerMode::kBox, format);
+    std::vector<uint8_t> plain(pipeline.output.byteLength, 0);
+    pixel_pipeline::ProcessFrame(src.data(), 200 * 4, plain.data(), 100 * 4, pipeline);
+    std::vector<uint8_t> serial(plain.size(), 0);
+    pixel_pipeline::ProcessFrame(src.data(), 200 * 4, serial.data(), 100 * 4, pipeline, &overlay);
+    std::vector<uint8_t> parallel(plain.size(), 0);
+    pixel_pipeline::ProcessFrameParallel(src.data(), 200 * 4, parallel.data(), 100 * 4, pipeline, &pool, 4, &overlay);
+    EXPECT_TRUE(parallel == serial);
+    EXPECT_TRUE(serial != plain);
+    if (format == pixel_pipeline::PixelFormat::kRgba8) {
+      std::vector<uint8_t> expected = plain;
+      for (int32_t y = 0; y < 60; ++y) {
+        pixel_pipeline::BlendCursorRow(overlay, y, 100, expected.data() + y * 400);
+      }
+      EXPECT_TRUE(serial == expected);
+    } else {
+      // Luma rows outside the cursor are untouched.
+      EXPECT_TRUE(std::equal(plain.begin(), plain.begin() + 19 * 100, serial.begin()));
+    }
+  }
+}
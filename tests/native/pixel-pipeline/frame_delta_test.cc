@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <vector>
+
+#include "frame_delta.h"
+#include "test_harness.h"
+
+using pixel_pipeline::DecodeFrameDelta;
+using pixel_pipeline::EncodeFrameDelta;
+using pixel_pipeline::FrameDeltaStats;
+
+namespace {
+
+std::vector<uint8_t> MakeFrame(size_t bytes, uint32_t seed) {
+  std::vector<uint8_t> frame(bytes);
+  uint32_t state = seed;
+  for (uint8_t& b : frame) {
+    state = state * 1664525u + 1013904223u;
+    b = static_cast<uint8_t>(state >> 24);
+  }
+  return frame;
+}
+
+}  // namespace
+
+PIXEL_TEST(FrameDeltaRoundTripsSparseChanges) {
+  const size_t bytes = 640 * 360 * 4;
+  const std::vector<uint8_t> base = MakeFrame(bytes, 7);
+  std::vector<uint8_t> frame = base;
+  // A moved cursor and a blinking caret: a few small regions, one on the tail.
+  for (size_t i = 1000; i < 1300; ++i) {
+    frame[i] ^= 0x5A;
+  }
+  frame[400000] += 1;
+  frame[bytes - 1] += 1;
+
+  std::vector<uint8_t> delta;
+  FrameDeltaStats stats;
+  EXPECT_TRUE(EncodeFrameDelta(base.data(), frame.data(), bytes, bytes, &delta, &stats));
+  EXPECT_EQ(stats.encodedBytes, delta.size());
+  EXPECT_EQ(stats.changedTiles, static_cast<uint32_t>(8));
+  EXPECT_LE(delta.size(), static_cast<size_t>(400));
+
+  std::vector<uint8_t> decoded = base;
+  EXPECT_TRUE(DecodeFrameDelta(delta.data(), delta.size(), decoded.data(), bytes));
+  EXPECT_TRUE(decoded == frame);
+}
+
+PIXEL_TEST(FrameDeltaOfIdenticalFramesIsHeaderOnly) {
+  const std::vector<uint8_t> base = MakeFrame(4099, 3);
+  std::vector<uint8_t> delta;
+  EXPECT_TRUE(EncodeFrameDelta(base.data(), base.data(), base.size(), base.size(), &delta));
+  EXPECT_EQ(delta.size(), pixel_pipeline::kFrameDeltaHeaderBytes);
+  std::vector<uint8_t> decoded = base;
+  EXPECT_TRUE(DecodeFrameDelta(delta.data(), delta.size(), decoded.data(), decoded.size()));
+  EXPECT_TRUE(decoded == base);
+}
+
+PIXEL_TEST(FrameDeltaGivesUpPastTheSizeLimit) {
+  const size_t bytes = 64 * 1024;
+  const std::vector<uint8_t> base = MakeFrame(bytes, 1);
+  const std::vector<uint8_t> frame = MakeFrame(bytes, 2);
+  std::vector<uint8_t> delta;
+  EXPECT_TRUE(!EncodeFrameDelta(base.data(), frame.data(), bytes, bytes / 2, &delta));
+  // Unlimited, a full change still round-trips.
+  EXPECT_TRUE(EncodeFrameDelta(base.data(), frame.data(), bytes, bytes * 2, &delta));
+  std::vector<uint8_t> decoded = base;
+  EXPECT_TRUE(DecodeFrameDelta(delta.data(), delta.size(), decoded.data(), bytes));
+  EXPECT_TRUE(decoded == frame);
+}
+
+PIXEL_TEST(FrameDeltaDecodeRejectsMalformedInput) {
+  const size_t bytes = 8192;
+  const std::vector<uint8_t> base = MakeFrame(bytes, 11);
+  std::vector<uint8_t> frame = base;
+  frame[5000] += 1;
+  std::vector<uint8_t> delta;
+  EXPECT_TRUE(EncodeFrameDelta(base.data(), frame.data(), bytes, bytes, &delta));
+
+  std::vector<uint8_t> decoded = base;
+  // Wrong frame size, truncated literal, bad magic.
+  EXPECT_TRUE(!DecodeFrameDelta(delta.data(), delta.size(), decoded.data(), bytes - 4));
+  EXPECT_TRUE(!DecodeFrameDelta(delta.data(), delta.size() - 1, decoded.data(), bytes));
+  std::vector<uint8_t> foreign = delta;
+  foreign[0] = 'X';
+  EXPECT_TRUE(!DecodeFrameDelta(foreign.data(), foreign.size(), decoded.data(), bytes));
+  // A skip that runs off the end of the frame.
+  std::vector<uint8_t> overrun(delta.begin(), delta.begin() + pixel_pipeline::kFrameDeltaHeaderBytes);
+  overrun[12] = 1;
+  overrun.insert(overrun.end(), {0xFF, 0x7F, 0x01, 0x00});
+  EXPECT_TRUE(!DecodeFrameDelta(overrun.data(), overrun.size(), decoded.data(), bytes));
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "frame_pacer.h"
+#include "test_harness.h"
+
+namespace {
+
+using pixel_pipeline::FramePacer;
+using Clock = FramePacer::Clock;
+
+Clock::duration Ms(double ms) {
+  return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+}
+
+}  // namespace
+
+PIXEL_TEST(FramePacerDeadlinesDoNotDrift) {
+  const Clock::time_point start = Clock::now();
+  FramePacer pacer(50.0, start);
+  // Starting each frame 3 ms late must not push later deadlines back.
+  for (int i = 0; i < 10; ++i) {
+    pacer.BeginFrame(pacer.Deadline() + Ms(3.0));
+  }
+  EXPECT_TRUE(pacer.Deadline() == start + Ms(20.0) * 10);
+  EXPECT_EQ(pacer.Frames(), static_cast<uint64_t>(10));
+  EXPECT_EQ(pacer.MissedDeadlines(), static_cast<uint64_t>(0));
+  const pixel_pipeline::Histogram::Summary intervals = pacer.Intervals().Snapshot();
+  EXPECT_EQ(intervals.count, static_cast<uint64_t>(9));
+  EXPECT_TRUE(intervals.p50Ms >= 19.9 && intervals.p50Ms <= 20.25);
+  const pixel_pipeline::Histogram::Summary jitter = pacer.Jitter().Snapshot();
+  EXPECT_TRUE(jitter.p50Ms >= 2.99 && jitter.p50Ms <= 3.05);
+}
+
+PIXEL_TEST(FramePacerSkipsMissedDeadlinesInsteadOfBursting) {
+  const Clock::time_point start = Clock::now();
+  FramePacer pacer(100.0, start);
+  pacer.BeginFrame(start);
+  // Starting at 35 ms serves the 10 ms deadline 25 ms late and skips 20 and
+  // 30; the next deadline is 40.
+  pacer.BeginFrame(start + Ms(35.0));
+  EXPECT_EQ(pacer.MissedDeadlines(), static_cast<uint64_t>(2));
+  EXPECT_TRUE(pacer.Deadline() == start + Ms(10.0) * 4);
+}
+
+PIXEL_TEST(FramePacerSleepsToTheDeadline) {
+  FramePacer pacer(200.0);
+  pacer.BeginFrame(Clock::now());
+  for (int i = 0; i < 5; ++i) {
+    const Clock::time_point deadline = pacer.Deadline();
+    EXPECT_TRUE(pacer.CoarseWakeTime() < deadline);
+    std::this_thread::sleep_until(pacer.CoarseWakeTime());
+    pacer.SpinToDeadline();
+    const Clock::time_point now = Clock::now();
+    EXPECT_TRUE(now >= deadline);
+    pacer.BeginFrame(now);
+  }
+  EXPECT_EQ(pacer.Frames(), static_cast<uint64_t>(6));
+}
@@ -0,0 +1,201 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "frame_pipe.h"
+#include "test_harness.h"
+
+namespace {
+
+using pixel_pipeline::FrameLease;
+using pixel_pipeline::FramePipe;
+using pixel_pipeline::FramePipeExit;
+using pixel_pipeline::FramePipeOptions;
+using pixel_pipeline::FramePipeStats;
+
+std::string TempPath(const char* name) {
+#if defined(_WIN32)
+  const char* dir = std::getenv("TEMP");
+  const char* fallback = ".";
+#else
+  const char* dir = std::getenv("TMPDIR");
+  const char* fallback = "/tmp";
+#endif
+  return std::string(dir && *dir ? dir : fallback) + "/" + name;
+}
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Submits `frames` frames, every byte of frame i equal to i; returns how many
+// AcquireFrame handed out.
+int SubmitFrames(FramePipe* pipe, int frames) {
+  int submitted = 0;
+  for (int i = 0; i < frames; ++i) {
+    std::unique_ptr<FrameLease> frame = pipe->AcquireFrame();
+    if (!frame) {
+      continue;
+    }
+    std::memset(frame->data(), i, frame->size());
+    pipe->Submit(std::move(frame));
+    ++submitted;
+  }
+  return submitted;
+}
+
+bool HoldsFrames(const std::vector<uint8_t>& bytes, size_t frameBytes, int frames) {
+  if (bytes.size() != frameBytes * static_cast<size_t>(frames)) {
+    return false;
+  }
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    if (bytes[i] != static_cast<uint8_t>(i / frameBytes)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+PIXEL_TEST(FramePipeAttachWritesFramesInOrder) {
+  const std::string path = TempPath("pixel_pipeline_frame_pipe_attach.raw");
+  FramePipeOptions options;
+  options.path = path;
+  options.frameBytes = 4096;
+  options.depth = 3;
+  std::string error;
+  std::unique_ptr<FramePipe> pipe = FramePipe::Open(options, &error);
+  EXPECT_TRUE(pipe != nullptr);
+  if (!pipe) {
+    return;
+  }
+  EXPECT_EQ(pipe->depth(), 3);
+  EXPECT_EQ(SubmitFrames(pipe.get(), 40), 40);
+  const FramePipeExit exit = pipe->Close();
+  EXPECT_TRUE(exit.exited && exit.exitCode == 0);
+  const FramePipeStats stats = pipe->Stats();
+  EXPECT_EQ(stats.framesWritten, static_cast<uint64_t>(40));
+  EXPECT_EQ(stats.bytesWritten, static_cast<uint64_t>(40 * 4096));
+  EXPECT_EQ(stats.framesDropped, static_cast<uint64_t>(0));
+  EXPECT_LE(stats.writeCalls, static_cast<uint64_t>(40));
+  EXPECT_TRUE(!stats.failed);
+  EXPECT_TRUE(HoldsFrames(ReadFile(path), 4096, 40));
+  // Nothing is accepted after Close.
+  EXPECT_TRUE(pipe->AcquireFrame() == nullptr);
+  std::remove(path.c_str());
+}
+
+PIXEL_TEST(FramePipeRejectsMissingTargets) {
+  FramePipeOptions options;
+  options.frameBytes = 16;
+  std::string error;
+  EXPECT_TRUE(FramePipe::Open(options, &error) == nullptr);
+  options.command = {"cursorcine-no-such-encoder"};
+  error.clear();
+  EXPECT_TRUE(FramePipe::Open(options, &error) == nullptr);
+  EXPECT_TRUE(!error.empty());
+}
+
+#if !defined(_WIN32)
+
+PIXEL_TEST(FramePipeSpawnStreamsToStdin) {
+  const std::string path = TempPath("pixel_pipeline_frame_pipe_spawn.raw");
+  FramePipeOptions options;
+  options.command = {"sh", "-c", "cat > '" + path + "'"};
+  options.frameBytes = 100000;
+  std::string error;
+  std::unique_ptr<FramePipe> pipe = FramePipe::Open(options, &error);
+  EXPECT_TRUE(pipe != nullptr);
+  if (!pipe) {
+    return;
+  }
+  EXPECT_TRUE(pipe->processId() > 0);
+  EXPECT_EQ(SubmitFrames(pipe.get(), 30), 30);
+  const FramePipeExit exit = pipe->Close();
+  EXPECT_TRUE(exit.exited && !exit.killed);
+  EXPECT_EQ(exit.exitCode, 0);
+  EXPECT_EQ(pipe->Stats().framesWritten, static_cast<uint64_t>(30));
+  EXPECT_TRUE(HoldsFrames(ReadFile(path), 100000, 30));
+  std::remove(path.c_str());
+}
+
+PIXEL_TEST(FramePipeBackpressureBlocksOrDrops) {
+  // A reader that starts late, with frames far larger than the pipe buffer:
+  // blocking waits for it and keeps every frame, dropping does not wait.
+  for (bool drop : {false, true}) {
+    FramePipeOptions options;
+    options.command = {"sh", "-c", "sleep 0.2; cat > /dev/null"};
+    options.frameBytes = 1 << 20;
+    options.depth = 2;
+    options.dropWhenFull = drop;
+    std::string error;
+    std::unique_ptr<FramePipe> pipe = FramePipe::Open(options, &error);
+    EXPECT_TRUE(pipe != nullptr);
+    if (!pipe) {
+      continue;
+    }
+    const int submitted = SubmitFrames(pipe.get(), 12);
+    pipe->Close();
+    const FramePipeStats stats = pipe->Stats();
+    EXPECT_EQ(stats.framesWritten, static_cast<uint64_t>(submitted));
+    EXPECT_EQ(stats.framesWritten + stats.framesDropped, static_cast<uint64_t>(12));
+    if (drop) {
+      EXPECT_TRUE(stats.framesDropped > 0);
+    } else {
+      EXPECT_EQ(submitted, 12);
+      EXPECT_TRUE(stats.stallMs > 0.0);
+    }
+  }
+}
+
+PIXEL_TEST(FramePipeFailsWhenReaderExits) {
+  FramePipeOptions options;
+  options.command = {"sh", "-c", "exit 3"};
+  options.frameBytes = 1 << 20;
+  std::string error;
+  std::unique_ptr<FramePipe> pipe = FramePipe::Open(options, &error);
+  EXPECT_TRUE(pipe != nullptr);
+  if (!pipe) {
+    return;
+  }
+  // Writes hit EPIPE (not SIGPIPE) and the pipe stops handing out frames.
+  for (int i = 0; i < 200 && !pipe->Stats().failed; ++i) {
+    SubmitFrames(pipe.get(), 1);
+  }
+  EXPECT_TRUE(pipe->Stats().failed);
+  EXPECT_TRUE(pipe->AcquireFrame() == nullptr);
+  const FramePipeExit exit = pipe->Close();
+  EXPECT_TRUE(exit.exited);
+  EXPECT_EQ(exit.exitCode, 3);
+}
+
+PIXEL_TEST(FramePipeCloseKillsStalledReader) {
+  FramePipeOptions options;
+  options.command = {"sleep", "30"};
+  options.frameBytes = 1 << 20;
+  std::string error;
+  std::unique_ptr<FramePipe> pipe = FramePipe::Open(options, &error);
+  EXPECT_TRUE(pipe != nullptr);
+  if (!pipe) {
+    return;
+  }
+  SubmitFrames(pipe.get(), 1);
+  const FramePipeExit exit = pipe->Close(100);
+  EXPECT_TRUE(exit.killed && !exit.exited);
+}
+
+#else
+
+PIXEL_TEST(FramePipeSpawnStreamsToStdin) {
+  std::printf("[pixel-pipeline]      skip frame pipe spawn (needs sh)\n");
+}
+
+#endif
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "frame_pipeline.h"
+#include "scale.h"
+#include "test_harness.h"
+#include "tone_map_lut.h"
+
+namespace {
+
+using pixel_pipeline::FramePipeline;
+using pixel_pipeline::ToneMapConfig;
+
+std::vector<uint8_t> MakeSurface(int32_t width, int32_t height) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+  uint32_t seed = 0xC0FFEEu;
+  for (uint8_t& v : pixels) {
+    seed = seed * 1664525u + 1013904223u;
+    v = static_cast<uint8_t>(seed >> 24);
+  }
+  return pixels;
+}
+
+// The pre-fusion CaptureFrame: full-frame scale (or memcpy), then a second
+// full-frame tone-map pass.
+std::vector<uint8_t> TwoPassReference(const std::vector<uint8_t>& src,
+                                      int32_t srcW,
+                                      int32_t srcH,
+                                      int32_t dstW,
+                                      int32_t dstH,
+                                      const FramePipeline& pipeline) {
+  std::vector<uint8_t> frame;
+  if (srcW == dstW && srcH == dstH) {
+    frame = src;
+  } else {
+    pixel_pipeline::ScaleBgraNearest(src.data(), srcW, srcH, srcW * 4, &frame, dstW, dstH);
+  }
+  pixel_pipeline::ApplyPreparedToneMap(frame.data(), frame.data(), frame.size() / 4, pipeline.toneMap);
+  return frame;
+}
+
+void ExpectFusedMatchesTwoPass(int32_t srcW, int32_t srcH, int32_t dstW, int32_t dstH, float saturation) {
+  const std::vector<uint8_t> src = MakeSurface(srcW, srcH);
+  ToneMapConfig cfg;
+  cfg.rolloff = 0.4f;
+  cfg.saturation = saturation;
+  FramePipeline pipeline;
+  pixel_pipeline::BuildFramePipeline(srcW, srcH, dstW, dstH, true, cfg, &pipeline);
+
+  std::vector<uint8_t> fused(static_cast<size_t>(dstW) * static_cast<size_t>(dstH) * 4);
+  pixel_pipeline::ProcessFrame(src.data(), srcW * 4, fused.data(), dstW * 4, pipeline);
+  EXPECT_TRUE(fused == TwoPassReference(src, srcW, srcH, dstW, dstH, pipeline));
+}
+
+}  // namespace
+
+PIXEL_TEST(FramePipelineIdentityMatchesTwoPass) {
+  ExpectFusedMatchesTwoPass(97, 31, 97, 31, 1.0f);
+  ExpectFusedMatchesTwoPass(64, 16, 64, 16, 1.3f);
+}
+
+PIXEL_TEST(FramePipelineScaledMatchesTwoPass) {
+  ExpectFusedMatchesTwoPass(1920, 1080, 640, 360, 1.0f);
+  ExpectFusedMatchesTwoPass(333, 177, 101, 53, 0.7f);
+  ExpectFusedMatchesTwoPass(50, 40, 49, 39, 1.0f);
+}
+
+PIXEL_TEST(FramePipelineHonorsDestinationStride) {
+  const int32_t srcW = 120;
+  const int32_t srcH = 60;
+  const int32_t dstW = 40;
+  const int32_t dstH = 20;
+  const int32_t dstStride = dstW * 4 + 32;
+  const std::vector<uint8_t> src = MakeSurface(srcW, srcH);
+  FramePipeline pipeline;
+  pixel_pipeline::BuildFramePipeline(srcW, srcH, dstW, dstH, false, ToneMapConfig(), &pipeline);
+  std::vector<uint8_t> padded(static_cast<size_t>(dstStride) * dstH, 0xAB);
+  pixel_pipeline::ProcessFrame(src.data(), srcW * 4, padded.data(), dstStride, pipeline);
+  const std::vector<uint8_t> expected = TwoPassReference(src, srcW, srcH, dstW, dstH, pipeline);
+  for (int32_t y = 0; y < dstH; ++y) {
+    const uint8_t* row = padded.data() + static_cast<size_t>(y) * dstStride;
+    EXPECT_TRUE(std::memcmp(row, expected.data() + static_cast<size_t>(y) * dstW * 4, dstW * 4) == 0);
+    EXPECT_EQ(row[dstW * 4], 0xAB);
+  }
+}
+
+PIXEL_TEST(FramePipelineProcessesRowBands) {
+  const std::vector<uint8_t> src = MakeSurface(200, 100);
+  FramePipeline pipeline;
+  pixel_pipeline::BuildFramePipeline(200, 100, 90, 45, false, ToneMapConfig(), &pipeline);
+  std::vector<uint8_t> whole(90 * 45 * 4);
+  std::vector<uint8_t> banded(whole.size());
+  pixel_pipeline::ProcessFrame(src.data(), 200 * 4, whole.data(), 90 * 4, pipeline);
+  pixel_pipeline::ProcessFrameRows(src.data(), 200 * 4, banded.data(), 90 * 4, pipeline, 0, 17);
+  pixel_pipeline::ProcessFrameRows(src.data(), 200 * 4, banded.data(), 90 * 4, pipeline, 17, 45);
+  EXPECT_TRUE(whole == banded);
+}
+
+PIXEL_TEST(FramePipelineParallelMatchesSerial) {
+  pixel_pipeline::ThreadPool pool;
+  pool.EnsureWorkers(7);
+  const std::vector<uint8_t> src = MakeSurface(640, 360);
+  ToneMapConfig cfg;
+  cfg.rolloff = 0.35f;
+  cfg.saturation = 1.2f;
+  for (pixel_pipeline::ScalerMode mode : {pixel_pipeline::ScalerMode::kNearest, pixel_pipeline::ScalerMode::kBox}) {
+    for (int32_t dstH : {360, 203, 9}) {
+      const int32_t dstW = dstH == 360 ? 640 : dstH * 16 / 9;
+      FramePipeline pipeline;
+      pixel_pipeline::BuildFramePipeline(640, 360, dstW, dstH, true, cfg, &pipeline, mode);
+      std::vector<uint8_t> serial(static_cast<size_t>(dstW) * dstH * 4);
+      pixel_pipeline::ProcessFrame(src.data(), 640 * 4, serial.data(), dstW * 4, pipeline);
+      for (int32_t threads : {2, 3, 8}) {
+        std::vector<uint8_t> parallel(serial.size(), 0);
+        pixel_pipeline::ProcessFrameParallel(
+            src.data(), 640 * 4, parallel.data(), dstW * 4, pipeline, &pool, threads);
+        EXPECT_TRUE(parallel == serial);
+      }
+    }
+  }
+}
+
+PIXEL_TEST(FramePipelineYuvMatchesRgbaThenConvert) {
+  pixel_pipeline::ThreadPool pool;
+  pool.EnsureWorkers(3);
+  const std::vector<uint8_t> src = MakeSurface(333, 177);
+  ToneMapConfig cfg;
+  cfg.rolloff = 0.4f;
+  for (pixel_pipeline::PixelFormat format : {pixel_pipeline::PixelFormat::kNv12, pixel_pipeline::PixelFormat::kI420}) {
+    // Even and odd output sizes; odd ones pair the last row/column with itself.
+    for (int32_t dstW : {160, 101}) {
+      const int32_t dstH = dstW == 160 ? 90 : 53;
+      FramePipeline rgbaPipeline;
+      pixel_pipeline::BuildFramePipeline(333, 177, dstW, dstH, true, cfg, &rgbaPipeline);
+      std::vector<uint8_t> rgba(static_cast<size_t>(dstW) * dstH * 4);
+      pixel_pipeline::ProcessFrame(src.data(), 333 * 4, rgba.data(), dstW * 4, rgbaPipeline);
+
+      FramePipeline pipeline;
+      pixel_pipeline::BuildFramePipeline(333, 177, dstW, dstH, true, cfg, &pipeline,
+                                         pixel_pipeline::ScalerMode::kNearest, format,
+                                         pixel_pipeline::YuvRange::kFull);
+      const pixel_pipeline::FrameLayout& layout = pipeline.output;
+      std::vector<uint8_t> expected(layout.byteLength, 0);
+      const bool nv12 = format == pixel_pipeline::PixelFormat::kNv12;
+      for (int32_t y = 0; y < dstH; y += 2) {
+        const int32_t y1 = std::min(y + 1, dstH - 1);
+        uint8_t* u = expected.data() + layout.planes[1].offset + static_cast<size_t>(y / 2) * layout.planes[1].stride;
+        uint8_t* v = nv12 ? u + 1
+                          : expected.data() + layout.planes[2].offset +
+                                static_cast<size_t>(y / 2) * layout.planes[2].stride;
+        pixel_pipeline::RgbaToYuvRowsScalar(rgba.data() + static_cast<size_t>(y) * dstW * 4,
+                                            rgba.data() + static_cast<size_t>(y1) * dstW * 4,
+                                            dstW,
+                                            expected.data() + static_cast<size_t>(y) * dstW,
+                                            expected.data() + static_cast<size_t>(y1) * dstW,
+                                            u,
+                                            v,
+                                            nv12 ? 2 : 1,
+                                            pipeline.yuv);
+      }
+
+      std::vector<uint8_t> serial(layout.byteLength, 0);
+      pixel_pipeline::ProcessFrame(src.data(), 333 * 4, serial.data(), 0, pipeline);
+      EXPECT_TRUE(serial == expected);
+      std::vector<uint8_t> parallel(layout.byteLength, 0);
+      pixel_pipeline::ProcessFrameParallel(src.data(), 333 * 4, parallel.data(), 0, pipeline, &pool, 4);
+      EXPECT_TRUE(parallel == expected);
+    }
+  }
+}
+
+PIXEL_TEST(FramePipelineTimingsLeaveOutputUnchanged) {
+  pixel_pipeline::ThreadPool pool;
+  pool.EnsureWorkers(3);
+  const std::vector<uint8_t> src = MakeSurface(320, 180);
+  ToneMapConfig cfg;
+  cfg.rolloff = 0.5f;
+  for (pixel_pipeline::PixelFormat format : {pixel_pipeline::PixelFormat::kRgba8, pixel_pipeline::PixelFormat::kNv12}) {
+    FramePipeline pipeline;
+    pixel_pipeline::BuildFramePipeline(320, 180, 160, 90, true, cfg, &pipeline, pixel_pipeline::ScalerMode::kBox, format);
+    std::vector<uint8_t> plain(pipeline.output.byteLength, 0);
+    pixel_pipeline::ProcessFrameParallel(src.data(), 320 * 4, plain.data(), 160 * 4, pipeline, &pool, 4);
+    pixel_pipeline::ProcessTimings timings;
+    std::vector<uint8_t> timed(plain.size(), 0);
+    pixel_pipeline::ProcessFrameParallel(src.data(), 320 * 4, timed.data(), 160 * 4, pipeline, &pool, 4, nullptr, &timings);
+    EXPECT_TRUE(timed == plain);
+    EXPECT_TRUE(timings.scaleNs.load() > 0);
+    EXPECT_TRUE(timings.toneMapNs.load() > 0);
+    EXPECT_TRUE((timings.convertNs.load() > 0) == (format == pixel_pipeline::PixelFormat::kNv12));
+  }
+}
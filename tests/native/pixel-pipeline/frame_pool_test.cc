@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "frame_pool.h"
+#include "test_harness.h"
+
+namespace {
+
+using pixel_pipeline::FrameLease;
+using pixel_pipeline::FramePool;
+
+}  // namespace
+
+PIXEL_TEST(FramePoolEnforcesDepth) {
+  auto pool = FramePool::Create(64, 2);
+  std::unique_ptr<FrameLease> a = pool->Acquire();
+  std::unique_ptr<FrameLease> b = pool->Acquire();
+  EXPECT_TRUE(a && b);
+  EXPECT_EQ(a->size(), static_cast<size_t>(64));
+  EXPECT_EQ(pool->Outstanding(), 2);
+  EXPECT_TRUE(pool->Acquire() == nullptr);
+  EXPECT_EQ(pool->ExhaustedCount(), static_cast<uint64_t>(1));
+  a.reset();
+  EXPECT_EQ(pool->Outstanding(), 1);
+  EXPECT_TRUE(pool->Acquire() != nullptr);
+}
+
+PIXEL_TEST(FramePoolRecyclesMostRecentSlab) {
+  auto pool = FramePool::Create(4096, 3);
+  std::unique_ptr<FrameLease> first = pool->Acquire();
+  uint8_t* const slab = first->data();
+  first->data()[0] = 0x5A;
+  first.reset();
+  std::unique_ptr<FrameLease> again = pool->Acquire();
+  EXPECT_TRUE(again->data() == slab);
+  EXPECT_EQ(again->data()[0], 0x5A);
+}
+
+PIXEL_TEST(FramePoolLeaseOutlivesOwner) {
+  std::unique_ptr<FrameLease> lease;
+  {
+    auto pool = FramePool::Create(16, 1);
+    lease = pool->Acquire();
+  }
+  lease->data()[15] = 1;
+  lease.reset();
+}
+
+PIXEL_TEST(FramePoolReleasesFromOtherThreads) {
+  auto pool = FramePool::Create(256, 4);
+  for (int round = 0; round < 50; ++round) {
+    std::vector<std::unique_ptr<FrameLease>> leases;
+    while (std::unique_ptr<FrameLease> lease = pool->Acquire()) {
+      leases.push_back(std::move(lease));
+    }
+    EXPECT_EQ(static_cast<int32_t>(leases.size()), 4);
+    std::vector<std::thread> threads;
+    for (auto& lease : leases) {
+      threads.emplace_back([owned = std::move(lease)]() mutable { owned.reset(); });
+    }
+    for (std::thread& t : threads) {
+      t.join();
+    }
+    EXPECT_EQ(pool->Outstanding(), 0);
+  }
+}
@@ -0,0 +1,94 @@
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include "frame_queue.h"
+#include "test_harness.h"
+
+namespace {
+
+using pixel_pipeline::FrameQueue;
+
+void Produce(FrameQueue* queue, uint32_t value) {
+  uint8_t* slot = queue->WriteSlot();
+  std::memcpy(slot, &value, sizeof(value));
+  std::memset(slot + sizeof(value), static_cast<int>(value & 0xFF), queue->slotBytes() - sizeof(value));
+  queue->Publish();
+}
+
+uint32_t ReadValue(const FrameQueue& queue) {
+  uint32_t value = 0;
+  std::memcpy(&value, queue.ReadSlot(), sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+PIXEL_TEST(FrameQueueDeliversInOrder) {
+  FrameQueue queue(64, 3);
+  EXPECT_TRUE(!queue.AcquireNext());
+  Produce(&queue, 1);
+  Produce(&queue, 2);
+  EXPECT_EQ(queue.Queued(), 2);
+  EXPECT_TRUE(queue.AcquireNext());
+  EXPECT_EQ(ReadValue(queue), 1u);
+  EXPECT_EQ(queue.ReadMeta().sequence, static_cast<uint64_t>(1));
+  Produce(&queue, 3);
+  EXPECT_TRUE(queue.AcquireNext());
+  EXPECT_EQ(ReadValue(queue), 2u);
+  EXPECT_TRUE(queue.AcquireNext());
+  EXPECT_EQ(ReadValue(queue), 3u);
+  EXPECT_TRUE(!queue.AcquireNext());
+  EXPECT_EQ(queue.Dropped(), static_cast<uint64_t>(0));
+}
+
+PIXEL_TEST(FrameQueueDropsOldestWhenFull) {
+  FrameQueue queue(64, 2);
+  EXPECT_TRUE(queue.AcquireNext() == false);
+  Produce(&queue, 1);
+  EXPECT_TRUE(queue.AcquireNext());
+  // Consumer holds frame 1 while 2..5 arrive; only 4 and 5 fit.
+  for (uint32_t v = 2; v <= 5; ++v) {
+    Produce(&queue, v);
+  }
+  EXPECT_EQ(ReadValue(queue), 1u);
+  EXPECT_EQ(queue.Dropped(), static_cast<uint64_t>(2));
+  EXPECT_EQ(queue.Queued(), 2);
+  EXPECT_TRUE(queue.AcquireNext());
+  EXPECT_EQ(ReadValue(queue), 4u);
+  EXPECT_TRUE(queue.AcquireNext());
+  EXPECT_EQ(ReadValue(queue), 5u);
+  EXPECT_EQ(queue.Published(), static_cast<uint64_t>(5));
+}
+
+PIXEL_TEST(FrameQueueConcurrentFramesAreConsistentAndOrdered) {
+  FrameQueue queue(4096, 4);
+  constexpr uint32_t kFrames = 20000;
+  std::atomic<bool> done{false};
+  std::thread producer([&] {
+    for (uint32_t v = 1; v <= kFrames; ++v) {
+      Produce(&queue, v);
+    }
+    done.store(true);
+  });
+  uint32_t last = 0;
+  uint64_t torn = 0;
+  uint64_t outOfOrder = 0;
+  while (!done.load() || queue.Queued() > 0) {
+    if (!queue.AcquireNext()) {
+      continue;
+    }
+    const uint32_t value = ReadValue(queue);
+    const uint8_t* slot = queue.ReadSlot();
+    for (size_t i = sizeof(value); i < queue.slotBytes(); ++i) {
+      torn += slot[i] != static_cast<uint8_t>(value & 0xFF);
+    }
+    outOfOrder += value <= last;
+    last = value;
+  }
+  producer.join();
+  EXPECT_EQ(torn, static_cast<uint64_t>(0));
+  EXPECT_EQ(outOfOrder, static_cast<uint64_t>(0));
+  EXPECT_EQ(last, kFrames);
+}
@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "frame_ring.h"
+#include "test_harness.h"
+
+namespace {
+
+using pixel_pipeline::FrameRingFormat;
+using pixel_pipeline::FrameRingFrame;
+using pixel_pipeline::FrameRingReader;
+using pixel_pipeline::FrameRingWriter;
+
+std::string RingName(const char* tag) {
+#if defined(_WIN32)
+  return std::string("cursorcine-test-") + tag;
+#else
+  return std::string("cursorcine-test-") + tag + "-" + std::to_string(getpid());
+#endif
+}
+
+FrameRingFormat RgbaFormat(int32_t width, int32_t height) {
+  FrameRingFormat format;
+  format.width = width;
+  format.height = height;
+  format.stride = width * 4;
+  format.frameBytes = static_cast<size_t>(format.stride) * static_cast<size_t>(height);
+  return format;
+}
+
+void Produce(FrameRingWriter* writer, uint8_t value) {
+  std::memset(writer->WriteSlot(), value, writer->slotBytes());
+  writer->WriteMeta()->timestampMs = value * 10.0;
+  writer->WriteMeta()->sourceX = value;
+  writer->WriteMeta()->sourceWidth = value * 2;
+  writer->Publish();
+}
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool IsFilledWith(const std::vector<uint8_t>& frame, uint8_t value) {
+  return !frame.empty() && frame[0] == value && std::memcmp(frame.data(), frame.data() + 1, frame.size() - 1) == 0;
+}
+
+}  // namespace
+
+PIXEL_TEST(FrameRingRoundTripsFramesAndMetadata) {
+  std::string error;
+  auto writer = FrameRingWriter::Create(RingName("roundtrip"), RgbaFormat(64, 32), 3, &error);
+  EXPECT_TRUE(writer != nullptr);
+  auto reader = FrameRingReader::Open(writer->name(), &error);
+  EXPECT_TRUE(reader != nullptr);
+  if (!writer || !reader) {
+    return;
+  }
+  EXPECT_EQ(reader->slots(), 3);
+  EXPECT_EQ(reader->format().width, 64);
+  EXPECT_EQ(reader->format().frameBytes, static_cast<size_t>(64 * 32 * 4));
+
+  std::vector<uint8_t> frame(reader->format().frameBytes);
+  FrameRingFrame meta;
+  EXPECT_TRUE(!reader->CopyLatest(0, frame.data(), 64 * 4, &meta));
+  Produce(writer.get(), 7);
+  EXPECT_TRUE(reader->CopyLatest(0, frame.data(), 64 * 4, &meta));
+  EXPECT_EQ(meta.sequence, static_cast<uint64_t>(1));
+  EXPECT_TRUE(meta.timestampMs == 70.0);
+  EXPECT_TRUE(meta.sourceX == 7 && meta.sourceY == 0 && meta.sourceWidth == 14);
+  EXPECT_TRUE(IsFilledWith(frame, 7));
+  EXPECT_TRUE(!reader->CopyLatest(meta.sequence, frame.data(), 64 * 4, &meta));
+
+  // The newest frame wins; a padded destination gets row-by-row copies.
+  Produce(writer.get(), 8);
+  Produce(writer.get(), 9);
+  std::vector<uint8_t> padded(static_cast<size_t>(64 * 4 + 16) * 32, 0);
+  EXPECT_TRUE(reader->CopyLatest(1, padded.data(), 64 * 4 + 16, &meta));
+  EXPECT_EQ(meta.sequence, static_cast<uint64_t>(3));
+  EXPECT_EQ(padded[64 * 4 - 1], static_cast<uint8_t>(9));
+  EXPECT_EQ(padded[64 * 4], static_cast<uint8_t>(0));
+  EXPECT_EQ(reader->Published(), static_cast<uint64_t>(3));
+}
+
+PIXEL_TEST(FrameRingFrameStaysCurrentUntilTheWriterLaps) {
+  std::string error;
+  auto writer = FrameRingWriter::Create(RingName("lap"), RgbaFormat(16, 16), 3, &error);
+  auto reader = writer ? FrameRingReader::Open(writer->name(), &error) : nullptr;
+  EXPECT_TRUE(reader != nullptr);
+  if (!reader) {
+    return;
+  }
+  Produce(writer.get(), 1);
+  FrameRingFrame frame;
+  const uint8_t* pixels = nullptr;
+  EXPECT_TRUE(reader->PeekLatest(0, &frame, &pixels));
+  EXPECT_EQ(pixels[0], static_cast<uint8_t>(1));
+  // Three slots: one more frame leaves it alone, the next one reopens its slot.
+  Produce(writer.get(), 2);
+  EXPECT_TRUE(reader->IsCurrent(frame));
+  Produce(writer.get(), 3);
+  EXPECT_TRUE(!reader->IsCurrent(frame));
+}
+
+PIXEL_TEST(FrameRingRejectsBadNamesAndForeignRegions) {
+  std::string error;
+  EXPECT_TRUE(FrameRingWriter::Create("bad/name", RgbaFormat(16, 16), 3, &error) == nullptr);
+  EXPECT_TRUE(FrameRingWriter::Create(RingName("slots"), RgbaFormat(16, 16), 1, &error) == nullptr);
+  EXPECT_TRUE(FrameRingReader::Open(RingName("missing"), &error) == nullptr);
+  EXPECT_TRUE(!error.empty());
+
+  auto writer = FrameRingWriter::Create(RingName("dup"), RgbaFormat(16, 16), 2, &error);
+  EXPECT_TRUE(writer != nullptr);
+  EXPECT_TRUE(FrameRingWriter::Create(RingName("dup"), RgbaFormat(16, 16), 2, &error) == nullptr);
+
+  auto foreign = pixel_pipeline::SharedMemory::Create(RingName("foreign"), 8192, &error);
+  EXPECT_TRUE(foreign != nullptr);
+  EXPECT_TRUE(FrameRingReader::Open(RingName("foreign"), &error) == nullptr);
+}
+
+PIXEL_TEST(FrameRingRejectsForgedFrameFormats) {
+  std::string error;
+  FrameRingFormat uneven = RgbaFormat(16, 16);
+  uneven.stride = 32;
+  EXPECT_TRUE(FrameRingWriter::Create(RingName("uneven"), uneven, 2, &error) == nullptr);
+
+  // Another process could write any header with the right magic: rewrite
+  // width/height/stride (offsets 16/20/24) of a valid ring and check that the
+  // reader refuses anything CopyLatest would overrun.
+  auto writer = FrameRingWriter::Create(RingName("forged"), RgbaFormat(16, 16), 2, &error);
+  EXPECT_TRUE(writer != nullptr);
+  auto region = pixel_pipeline::SharedMemory::Open(RingName("forged"), true, &error);
+  EXPECT_TRUE(region != nullptr);
+  if (!writer || !region) {
+    return;
+  }
+  EXPECT_TRUE(FrameRingReader::Open(RingName("forged"), &error) != nullptr);
+  const int32_t forged[][3] = {{16, 16, 1 << 20}, {16, 1 << 20, 64}, {16, 16, 32}, {0, 16, 64}, {16, -1, 64}};
+  for (const auto& shape : forged) {
+    std::memcpy(region->data() + 16, shape, sizeof(shape));
+    error.clear();
+    EXPECT_TRUE(FrameRingReader::Open(RingName("forged"), &error) == nullptr);
+    EXPECT_TRUE(!error.empty());
+  }
+  const int32_t valid[3] = {16, 16, 64};
+  std::memcpy(region->data() + 16, valid, sizeof(valid));
+  EXPECT_TRUE(FrameRingReader::Open(RingName("forged"), &error) != nullptr);
+
+  // A YUV ring whose frame size does not match its layout.
+  const uint32_t nv12 = static_cast<uint32_t>(pixel_pipeline::PixelFormat::kNv12);
+  std::memcpy(region->data() + 12, &nv12, sizeof(nv12));
+  EXPECT_TRUE(FrameRingReader::Open(RingName("forged"), &error) == nullptr);
+}
+
+#if !defined(_WIN32)
+// The writer publishes 720p frames at up to 1 kHz from this process while a
+// forked reader maps the ring by name and copies out every frame it catches.
+// Each frame is one byte value throughout, so a torn copy that passed the
+// seqlock check would show up as mixed values.
+PIXEL_TEST(FrameRingTwoProcessLatencyAndThroughput) {
+  constexpr int32_t kFrames = 240;
+  struct Result {
+    int32_t frames = 0;
+    int32_t torn = 0;
+    uint64_t lastSequence = 0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+    double gbPerSec = 0.0;
+  };
+
+  std::string error;
+  auto writer = FrameRingWriter::Create(RingName("two-process"), RgbaFormat(1280, 720), 4, &error);
+  EXPECT_TRUE(writer != nullptr);
+  int fds[2];
+  if (!writer || pipe(fds) != 0) {
+    return;
+  }
+  const pid_t child = fork();
+  if (child == 0) {
+    close(fds[0]);
+    Result result;
+    auto reader = FrameRingReader::Open(writer->name(), &error);
+    if (reader) {
+      std::vector<uint8_t> frame(reader->format().frameBytes);
+      std::vector<double> latencies;
+      FrameRingFrame meta;
+      const int64_t start = NowNs();
+      const int64_t deadline = start + 10000000000LL;
+      while (result.lastSequence < static_cast<uint64_t>(kFrames) && NowNs() < deadline) {
+        if (!reader->CopyLatest(result.lastSequence, frame.data(), reader->format().stride, &meta)) {
+          continue;
+        }
+        latencies.push_back((NowNs() - meta.publishedNs) / 1000.0);
+        result.frames += 1;
+        result.lastSequence = meta.sequence;
+        if (!IsFilledWith(frame, static_cast<uint8_t>(meta.sequence))) {
+          result.torn += 1;
+        }
+      }
+      const double seconds = (NowNs() - start) / 1e9;
+      std::sort(latencies.begin(), latencies.end());
+      if (!latencies.empty()) {
+        result.p50Us = latencies[latencies.size() / 2];
+        result.p99Us = latencies[latencies.size() * 99 / 100];
+        result.maxUs = latencies.back();
+      }
+      result.gbPerSec = result.frames * static_cast<double>(frame.size()) / seconds / 1e9;
+    }
+    const ssize_t written = write(fds[1], &result, sizeof(result));
+    _exit(written == static_cast<ssize_t>(sizeof(result)) ? 0 : 1);
+  }
+  close(fds[1]);
+  EXPECT_TRUE(child > 0);
+  // Sleeping (not spinning) between frames leaves the reader a core even on
+  // single-CPU CI machines.
+  auto due = std::chrono::steady_clock::now();
+  for (int32_t i = 1; i <= kFrames; ++i) {
+    due += std::chrono::milliseconds(1);
+    Produce(writer.get(), static_cast<uint8_t>(i));
+    std::this_thread::sleep_until(due);
+  }
+  Result result;
+  const ssize_t got = read(fds[0], &result, sizeof(result));
+  close(fds[0]);
+  int status = 0;
+  waitpid(child, &status, 0);
+  EXPECT_EQ(got, static_cast<ssize_t>(sizeof(result)));
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  EXPECT_EQ(result.lastSequence, static_cast<uint64_t>(kFrames));
+  EXPECT_EQ(result.torn, 0);
+  EXPECT_LE(kFrames / 4, result.frames);
+  std::printf("[pixel-pipeline]      two-process ring: %d/%d 720p frames, latency p50 %.1f us p99 %.1f us max %.1f us, "
+              "%.2f GB/s copied\n",
+              result.frames,
+              kFrames,
+              result.p50Us,
+              result.p99Us,
+              result.maxUs,
+              result.gbPerSec);
+}
+#endif
@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "hdr_source.h"
+#include "synthetic_source.h"
+#include "test_harness.h"
+#include "tone_map.h"
+
+namespace {
+
+using pixel_pipeline::HdrDecodeFn;
+using pixel_pipeline::SourceFormat;
+using pixel_pipeline::ToneMapConfig;
+using pixel_pipeline::ToneMapKernel;
+using pixel_pipeline::ToneMapParams;
+
+float SrgbDecode(float encoded) {
+  return encoded <= 0.04045f ? encoded / 12.92f : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+}
+
+void PutHalfPixel(std::vector<uint8_t>* out, float r, float g, float b) {
+  const uint16_t rgba[4] = {pixel_pipeline::FloatToHalf(r),
+                            pixel_pipeline::FloatToHalf(g),
+                            pixel_pipeline::FloatToHalf(b),
+                            pixel_pipeline::FloatToHalf(1.0f)};
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(rgba);
+  out->insert(out->end(), bytes, bytes + sizeof(rgba));
+}
+
+void PutPacked10(std::vector<uint8_t>* out, uint32_t r, uint32_t g, uint32_t b) {
+  const uint32_t packed = r | (g << 10) | (b << 20) | (3u << 30);
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&packed);
+  out->insert(out->end(), bytes, bytes + sizeof(packed));
+}
+
+// Random scRGB values from deep negative to well past SDR white, plus
+// NaN/Inf; 1027 pixels so the SIMD tail runs.
+std::vector<uint8_t> MakeHalfFixture() {
+  std::vector<uint8_t> pixels;
+  const float specials[] = {0.0f, -0.0f, -1.0f, 1.0f, 65504.0f, std::numeric_limits<float>::infinity(),
+                            std::numeric_limits<float>::quiet_NaN(), 1e-7f};
+  for (float v : specials) {
+    PutHalfPixel(&pixels, v, 0.5f, v);
+  }
+  uint32_t seed = 0x2468ACE1u;
+  while (pixels.size() < 1027 * 8) {
+    float rgb[3];
+    for (float& c : rgb) {
+      seed = seed * 1664525u + 1013904223u;
+      c = static_cast<float>(seed >> 8) / 16777216.0f * 12.0f - 0.5f;
+    }
+    PutHalfPixel(&pixels, rgb[0], rgb[1], rgb[2]);
+  }
+  return pixels;
+}
+
+std::vector<uint8_t> MakePacked10Fixture() {
+  std::vector<uint8_t> pixels;
+  uint32_t seed = 0x13579BDFu;
+  while (pixels.size() < 1027 * 4) {
+    seed = seed * 1664525u + 1013904223u;
+    pixels.push_back(static_cast<uint8_t>(seed >> 24));
+  }
+  return pixels;
+}
+
+std::vector<ToneMapParams> ParamMatrix() {
+  std::vector<ToneMapParams> out;
+  for (float rolloff : {0.0f, 0.3f, 1.0f}) {
+    for (float saturation : {0.0f, 1.0f, 1.4f, 2.0f}) {
+      ToneMapConfig cfg;
+      cfg.rolloff = rolloff;
+      cfg.saturation = saturation;
+      out.push_back(pixel_pipeline::ResolveToneMapParams(true, cfg));
+    }
+  }
+  return out;
+}
+
+int MaxDelta(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+  int worst = 0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    worst = std::max(worst, std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+  }
+  return worst;
+}
+
+}  // namespace
+
+PIXEL_TEST(HdrSourceHalfConversionRoundTrips) {
+  EXPECT_EQ(pixel_pipeline::FloatToHalf(1.0f), 0x3C00);
+  EXPECT_EQ(pixel_pipeline::FloatToHalf(65504.0f), 0x7BFF);
+  EXPECT_EQ(pixel_pipeline::FloatToHalf(1e6f), 0x7C00);
+  EXPECT_EQ(pixel_pipeline::FloatToHalf(-2.0f), 0xC000);
+  EXPECT_EQ(pixel_pipeline::FloatToHalf(std::ldexp(1.0f, -24)), 0x0001);
+  // Halfway between 1.0 and the next half rounds to even.
+  EXPECT_EQ(pixel_pipeline::FloatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3C00);
+  int mismatches = 0;
+  for (uint32_t h = 0; h < 0x10000u; ++h) {
+    const bool nan = (h & 0x7C00u) == 0x7C00u && (h & 0x3FFu) != 0;
+    if (!nan && pixel_pipeline::FloatToHalf(pixel_pipeline::HalfToFloat(static_cast<uint16_t>(h))) != h) {
+      mismatches += 1;
+    }
+  }
+  EXPECT_EQ(mismatches, 0);
+}
+
+PIXEL_TEST(HdrSourceFp16MatchesEightBitPathInSdrRange) {
+  // Linear scRGB versions of every 8-bit level: without highlights the FP16
+  // path must reproduce what an 8-bit capture of the same desktop gives.
+  std::vector<uint8_t> halves;
+  std::vector<uint8_t> bgra;
+  for (int v = 0; v < 256; ++v) {
+    const int g = 255 - v;
+    const int b = (v * 7) % 256;
+    PutHalfPixel(&halves, SrgbDecode(v / 255.0f), SrgbDecode(g / 255.0f), SrgbDecode(b / 255.0f));
+    bgra.insert(bgra.end(), {static_cast<uint8_t>(b), static_cast<uint8_t>(g), static_cast<uint8_t>(v), 0});
+  }
+  for (float saturation : {1.0f, 1.3f}) {
+    ToneMapConfig cfg;
+    cfg.saturation = saturation;
+    const ToneMapParams params = pixel_pipeline::ResolveToneMapParams(false, cfg);
+    std::vector<uint8_t> decoded(bgra.size());
+    pixel_pipeline::DecodeRgba16fScalar(halves.data(), decoded.data(), 256, params);
+    std::vector<uint8_t> rgba(bgra.size());
+    pixel_pipeline::ToneMapBgraToRgbaScalar(bgra.data(), rgba.data(), 256, params);
+    int worst = 0;
+    for (size_t i = 0; i < rgba.size(); i += 4) {
+      worst = std::max(worst, std::abs(decoded[i] - rgba[i + 2]));
+      worst = std::max(worst, std::abs(decoded[i + 1] - rgba[i + 1]));
+      worst = std::max(worst, std::abs(decoded[i + 2] - rgba[i]));
+      EXPECT_EQ(decoded[i + 3], 255);
+    }
+    EXPECT_LE(worst, 1);
+  }
+}
+
+PIXEL_TEST(HdrSourceFp16RolloffKeepsHighlightDetail) {
+  const float levels[] = {0.25f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 64.0f};
+  std::vector<uint8_t> halves;
+  for (float level : levels) {
+    PutHalfPixel(&halves, level, level, level);
+  }
+  PutHalfPixel(&halves, -3.0f, std::numeric_limits<float>::quiet_NaN(), 0.0f);
+  const size_t count = halves.size() / 8;
+  std::vector<uint8_t> clipped(count * 4);
+  std::vector<uint8_t> rolled(count * 4);
+  pixel_pipeline::DecodeRgba16fScalar(
+      halves.data(), clipped.data(), count, pixel_pipeline::ResolveToneMapParams(true, ToneMapConfig()));
+  ToneMapConfig cfg;
+  cfg.rolloff = 1.0f;
+  pixel_pipeline::DecodeRgba16fScalar(
+      halves.data(), rolled.data(), count, pixel_pipeline::ResolveToneMapParams(true, cfg));
+  for (size_t i = 1; i + 1 < count; ++i) {
+    // Without rolloff everything from SDR white up clips; with it every
+    // highlight level stays distinct.
+    EXPECT_EQ(clipped[i * 4], 255);
+    EXPECT_TRUE(rolled[i * 4] > rolled[(i - 1) * 4]);
+    EXPECT_TRUE(rolled[i * 4] < 255);
+  }
+  // Negative and NaN clamp to black.
+  EXPECT_EQ(rolled[(count - 1) * 4 + 1], 0);
+  EXPECT_EQ(rolled[(count - 1) * 4 + 2], 0);
+}
+
+PIXEL_TEST(HdrSourceTenBitMatchesEightBitPath) {
+  std::vector<uint8_t> packed;
+  std::vector<uint8_t> bgra;
+  for (uint32_t v = 0; v < 256; ++v) {
+    const uint32_t g = 255 - v;
+    const uint32_t b = (v * 7) % 256;
+    // 8-bit levels map onto 10-bit codes exactly at v * 1023 / 255 only for
+    // a few values; rounding costs at most half a 10-bit step.
+    PutPacked10(&packed, (v * 1023 + 127) / 255, (g * 1023 + 127) / 255, (b * 1023 + 127) / 255);
+    bgra.insert(bgra.end(), {static_cast<uint8_t>(b), static_cast<uint8_t>(g), static_cast<uint8_t>(v), 0});
+  }
+  for (const ToneMapParams& params : ParamMatrix()) {
+    std::vector<uint8_t> decoded(bgra.size());
+    pixel_pipeline::DecodeRgb10a2Scalar(packed.data(), decoded.data(), 256, params);
+    std::vector<uint8_t> rgba(bgra.size());
+    pixel_pipeline::ToneMapBgraToRgbaScalar(bgra.data(), rgba.data(), 256, params);
+    int worst = 0;
+    for (size_t i = 0; i < rgba.size(); i += 4) {
+      worst = std::max(worst, std::abs(decoded[i] - rgba[i + 2]));
+      worst = std::max(worst, std::abs(decoded[i + 2] - rgba[i]));
+    }
+    EXPECT_LE(worst, 1);
+  }
+}
+
+PIXEL_TEST(HdrSourceSimdKernelsMatchScalarWithinOneLsb) {
+  struct Case {
+    SourceFormat format;
+    std::vector<uint8_t> src;
+    HdrDecodeFn reference;
+  };
+  const Case cases[] = {
+      {SourceFormat::kRgba16f, MakeHalfFixture(), pixel_pipeline::DecodeRgba16fScalar},
+      {SourceFormat::kRgb10a2, MakePacked10Fixture(), pixel_pipeline::DecodeRgb10a2Scalar},
+  };
+  for (const Case& c : cases) {
+    const HdrDecodeFn fn = pixel_pipeline::GetHdrDecodeKernel(c.format, ToneMapKernel::kAvx2);
+    if (!fn) {
+      std::printf("[pixel-pipeline]      skip %s avx2 (unsupported)\n", pixel_pipeline::SourceFormatName(c.format));
+      continue;
+    }
+    const size_t count = c.src.size() / static_cast<size_t>(pixel_pipeline::SourceBytesPerPixel(c.format));
+    for (const ToneMapParams& params : ParamMatrix()) {
+      std::vector<uint8_t> expected(count * 4);
+      std::vector<uint8_t> actual(count * 4);
+      c.reference(c.src.data(), expected.data(), count, params);
+      fn(c.src.data(), actual.data(), count, params);
+      EXPECT_LE(MaxDelta(expected, actual), 1);
+    }
+  }
+  EXPECT_TRUE(pixel_pipeline::GetHdrDecodeKernel(SourceFormat::kBgra8, ToneMapKernel::kScalar) == nullptr);
+  EXPECT_TRUE(pixel_pipeline::ActiveHdrDecodeKernel(SourceFormat::kRgba16f) != nullptr);
+}
+
+PIXEL_TEST(HdrSourceSurfaceDecodeHonorsStridesAndBands) {
+  const int32_t width = 37;
+  const int32_t height = 41;
+  const int32_t srcStride = width * 8 + 24;
+  const int32_t dstStride = width * 4 + 12;
+  std::vector<uint8_t> src(static_cast<size_t>(srcStride) * height);
+  for (int32_t y = 0; y < height; ++y) {
+    for (int32_t x = 0; x < width; ++x) {
+      const uint16_t rgba[4] = {pixel_pipeline::FloatToHalf(x * 0.1f),
+                                pixel_pipeline::FloatToHalf(y * 0.05f),
+                                pixel_pipeline::FloatToHalf(0.5f),
+                                pixel_pipeline::FloatToHalf(1.0f)};
+      std::memcpy(src.data() + static_cast<size_t>(y) * srcStride + static_cast<size_t>(x) * 8, rgba, sizeof(rgba));
+    }
+  }
+  ToneMapConfig cfg;
+  cfg.rolloff = 0.5f;
+  const ToneMapParams params = pixel_pipeline::ResolveToneMapParams(true, cfg);
+  std::vector<uint8_t> serial(static_cast<size_t>(dstStride) * height, 0xAB);
+  pixel_pipeline::DecodeHdrSurface(src.data(), srcStride, SourceFormat::kRgba16f, width, height, params,
+                                   serial.data(), dstStride);
+  pixel_pipeline::ThreadPool pool;
+  pool.EnsureWorkers(3);
+  std::vector<uint8_t> parallel(serial.size(), 0xAB);
+  pixel_pipeline::DecodeHdrSurface(src.data(), srcStride, SourceFormat::kRgba16f, width, height, params,
+                                   parallel.data(), dstStride, &pool, 4);
+  EXPECT_TRUE(parallel == serial);
+  const HdrDecodeFn active = pixel_pipeline::ActiveHdrDecodeKernel(SourceFormat::kRgba16f);
+  std::vector<uint8_t> row(static_cast<size_t>(width) * 4);
+  active(src.data() + static_cast<size_t>(height - 1) * srcStride, row.data(), width, params);
+  EXPECT_TRUE(std::memcmp(row.data(), serial.data() + static_cast<size_t>(height - 1) * dstStride, row.size()) == 0);
+  EXPECT_EQ(serial[static_cast<size_t>(width) * 4], 0xAB);
+}
+
+PIXEL_TEST(HdrSourceSyntheticRampsDecodeMonotonically) {
+  const int32_t width = 96;
+  const int32_t height = 8;
+  ToneMapConfig cfg;
+  cfg.rolloff = 1.0f;
+  const ToneMapParams params = pixel_pipeline::ResolveToneMapParams(true, cfg);
+  for (SourceFormat format : {SourceFormat::kRgba16f, SourceFormat::kRgb10a2}) {
+    const int32_t srcStride = width * pixel_pipeline::SourceBytesPerPixel(format);
+    std::vector<uint8_t> src(static_cast<size_t>(srcStride) * height);
+    pixel_pipeline::RenderSyntheticHdrFrame(format, src.data(), width, height, srcStride, 0, 8.0f);
+    std::vector<uint8_t> bgra(static_cast<size_t>(width) * height * 4);
+    pixel_pipeline::DecodeHdrSurface(src.data(), srcStride, format, width, height, params, bgra.data(), width * 4);
+    // Rows 0-1 white, 2-3 red, 4-5 green, 6-7 blue.
+    const uint8_t* white = bgra.data();
+    const uint8_t* red = bgra.data() + static_cast<size_t>(2) * width * 4;
+    const uint8_t* blue = bgra.data() + static_cast<size_t>(6) * width * 4;
+    EXPECT_EQ(white[0], 0);
+    for (int32_t x = 1; x < width; ++x) {
+      EXPECT_TRUE(white[x * 4] >= white[(x - 1) * 4]);
+      EXPECT_EQ(red[x * 4], 0);
+      EXPECT_EQ(blue[x * 4 + 2], 0);
+    }
+    EXPECT_TRUE(red[(width - 1) * 4 + 2] > 100);
+    if (format == SourceFormat::kRgba16f) {
+      // An 8x highlight survives the rolloff without clipping.
+      EXPECT_TRUE(white[(width - 1) * 4] < 255);
+      EXPECT_TRUE(white[(width - 1) * 4] > white[(width / 2) * 4]);
+    }
+  }
+  // The ramp scrolls.
+  std::vector<uint8_t> a(static_cast<size_t>(width) * 8 * height);
+  std::vector<uint8_t> b(a.size());
+  pixel_pipeline::RenderSyntheticHdrFrame(SourceFormat::kRgba16f, a.data(), width, height, width * 8, 0, 8.0f);
+  pixel_pipeline::RenderSyntheticHdrFrame(SourceFormat::kRgba16f, b.data(), width, height, width * 8, 1, 8.0f);
+  EXPECT_TRUE(a != b);
+}
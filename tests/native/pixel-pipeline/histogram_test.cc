@@ -0,0 +1,40 @@
+#include <cstdint>
+
+#include "histogram.h"
+#include "test_harness.h"
+
+using pixel_pipeline::Histogram;
+
+PIXEL_TEST(HistogramPercentilesResolveToBucketBounds) {
+  Histogram histogram(1.0, 10);
+  for (int i = 0; i < 90; ++i) {
+    histogram.Record(2.5);
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.Record(7.2);
+  }
+  const Histogram::Summary summary = histogram.Snapshot();
+  EXPECT_EQ(summary.count, static_cast<uint64_t>(100));
+  EXPECT_TRUE(summary.p50Ms == 3.0);
+  EXPECT_TRUE(summary.p95Ms == 7.2);
+  EXPECT_TRUE(summary.maxMs == 7.2);
+  EXPECT_TRUE(summary.meanMs > 2.96 && summary.meanMs < 2.98);
+  EXPECT_EQ(summary.counts.size(), static_cast<size_t>(8));
+  EXPECT_EQ(summary.counts[2], static_cast<uint64_t>(90));
+  EXPECT_EQ(summary.counts[7], static_cast<uint64_t>(10));
+}
+
+PIXEL_TEST(HistogramClampsOutliersAndResets) {
+  Histogram histogram(0.5, 4);
+  histogram.Record(-3.0);
+  histogram.Record(250.0);
+  Histogram::Summary summary = histogram.Snapshot();
+  EXPECT_EQ(summary.counts.size(), static_cast<size_t>(4));
+  EXPECT_EQ(summary.counts[0], static_cast<uint64_t>(1));
+  EXPECT_EQ(summary.counts[3], static_cast<uint64_t>(1));
+  EXPECT_TRUE(summary.p99Ms == 250.0);
+  histogram.Reset();
+  summary = histogram.Snapshot();
+  EXPECT_EQ(summary.count, static_cast<uint64_t>(0));
+  EXPECT_TRUE(summary.counts.empty());
+}
@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "replay_source.h"
+#include "test_harness.h"
+
+namespace {
+
+using pixel_pipeline::ReplaySource;
+
+std::string TempPath(const char* name) {
+#if defined(_WIN32)
+  const char* dir = std::getenv("TEMP");
+  const char* fallback = ".";
+#else
+  const char* dir = std::getenv("TMPDIR");
+  const char* fallback = "/tmp";
+#endif
+  return std::string(dir && *dir ? dir : fallback) + "/" + name;
+}
+
+// `frames` frames of `frameBytes` bytes, every byte of frame i equal to i,
+// plus `extra` trailing bytes.
+std::string WriteReplayFile(const char* name, size_t frameBytes, int frames, size_t extra) {
+  const std::string path = TempPath(name);
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  for (int i = 0; i < frames; ++i) {
+    const std::vector<char> frame(frameBytes, static_cast<char>(i));
+    out.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+  }
+  const std::vector<char> tail(extra, 'x');
+  out.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+  return path;
+}
+
+}  // namespace
+
+PIXEL_TEST(ReplaySourceLoopsOverWholeFrames) {
+  const std::string path = WriteReplayFile("pixel_pipeline_replay_loop.bgra", 64, 3, 10);
+  std::string error;
+  std::unique_ptr<ReplaySource> source = ReplaySource::Open(path, 64, &error);
+  EXPECT_TRUE(source != nullptr);
+  if (source) {
+    EXPECT_EQ(source->frameCount(), static_cast<uint64_t>(3));
+    std::vector<uint8_t> frame(64);
+    const int expected[] = {0, 1, 2, 0, 1, 2, 0};
+    for (int want : expected) {
+      EXPECT_TRUE(source->ReadNext(frame.data()));
+      EXPECT_EQ(frame.front(), want);
+      EXPECT_EQ(frame.back(), want);
+    }
+    EXPECT_EQ(source->framesRead(), static_cast<uint64_t>(7));
+  }
+  std::remove(path.c_str());
+}
+
+PIXEL_TEST(ReplaySourceRejectsMissingAndShortFiles) {
+  std::string error;
+  EXPECT_TRUE(ReplaySource::Open(TempPath("pixel_pipeline_replay_missing.bgra"), 64, &error) == nullptr);
+  EXPECT_TRUE(!error.empty());
+
+  const std::string path = WriteReplayFile("pixel_pipeline_replay_short.bgra", 64, 0, 63);
+  error.clear();
+  EXPECT_TRUE(ReplaySource::Open(path, 64, &error) == nullptr);
+  EXPECT_TRUE(error.find("less than one") != std::string::npos);
+  std::remove(path.c_str());
+}
@@ -0,0 +1,350 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "cpu_features.h"
+#include "frame_pipeline.h"
+#include "scale.h"
+#include "test_harness.h"
+
+namespace {
+
+using pixel_pipeline::FilterAxis;
+using pixel_pipeline::ScalePlan;
+using pixel_pipeline::ScalerMode;
+
+const ScalerMode kFilterModes[] = {ScalerMode::kBox, ScalerMode::kBilinear};
+
+// Dark 1px strokes and a 3px checker on a light background: the content where
+// point sampling drops detail and an area filter should not.
+std::vector<uint8_t> MakeTextSurface(int32_t width, int32_t height) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+  for (int32_t y = 0; y < height; ++y) {
+    for (int32_t x = 0; x < width; ++x) {
+      uint8_t* p = &pixels[(static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)) * 4];
+      const bool stroke = (x % 7 == 3) || (y % 11 == 5) || ((x + y) % 13 == 0);
+      const bool checker = ((x / 3) + (y / 3)) % 2 == 0;
+      p[0] = stroke ? 20 : (checker ? 235 : 200);
+      p[1] = stroke ? 30 : static_cast<uint8_t>(180 + (x * 31 + y * 17) % 60);
+      p[2] = stroke ? 40 : static_cast<uint8_t>((x * 255) / (width - 1));
+      p[3] = 0;
+    }
+  }
+  return pixels;
+}
+
+std::vector<uint8_t> Scale(const std::vector<uint8_t>& src,
+                           int32_t srcW,
+                           int32_t srcH,
+                           int32_t dstW,
+                           int32_t dstH,
+                           ScalerMode mode) {
+  ScalePlan plan;
+  pixel_pipeline::BuildScalePlan(srcW, srcH, dstW, dstH, &plan, mode);
+  std::vector<int16_t> scratch(pixel_pipeline::FilterScratchSize(plan));
+  std::vector<uint8_t> out(static_cast<size_t>(dstW) * static_cast<size_t>(dstH) * 4);
+  for (int32_t y = 0; y < dstH; ++y) {
+    uint8_t* row = &out[static_cast<size_t>(y) * static_cast<size_t>(dstW) * 4];
+    if (mode == ScalerMode::kNearest) {
+      pixel_pipeline::SampleRowNearest(src.data(), srcW * 4, plan, y, row);
+    } else {
+      pixel_pipeline::SampleRowFiltered(src.data(), srcW * 4, plan, y, scratch.data(), row);
+    }
+  }
+  return out;
+}
+
+uint32_t Fnv1a(const std::vector<uint8_t>& bytes) {
+  uint32_t hash = 2166136261u;
+  for (uint8_t b : bytes) {
+    hash = (hash ^ b) * 16777619u;
+  }
+  return hash;
+}
+
+void ExpectAxisWellFormed(const FilterAxis& axis, int32_t srcLen, int32_t dstLen) {
+  EXPECT_EQ(static_cast<int32_t>(axis.start.size()), dstLen);
+  EXPECT_EQ(axis.weightStride % 2, 0);
+  EXPECT_LE(axis.taps, axis.weightStride);
+  for (int32_t i = 0; i < dstLen; ++i) {
+    EXPECT_LE(axis.start[static_cast<size_t>(i)] + axis.taps, srcLen);
+    int32_t sum = 0;
+    for (int32_t k = 0; k < axis.weightStride; ++k) {
+      const int16_t w = axis.weights[static_cast<size_t>(i) * static_cast<size_t>(axis.weightStride) + static_cast<size_t>(k)];
+      EXPECT_TRUE(w >= 0);
+      if (k >= axis.taps) {
+        EXPECT_EQ(w, 0);
+      }
+      sum += w;
+    }
+    EXPECT_EQ(sum, 1 << pixel_pipeline::kFilterWeightBits);
+  }
+}
+
+}  // namespace
+
+PIXEL_TEST(ScalerModeNamesRoundTrip) {
+  for (ScalerMode mode : {ScalerMode::kNearest, ScalerMode::kBox, ScalerMode::kBilinear}) {
+    ScalerMode parsed = ScalerMode::kNearest;
+    EXPECT_TRUE(pixel_pipeline::ParseScalerMode(pixel_pipeline::ScalerModeName(mode), &parsed));
+    EXPECT_TRUE(parsed == mode);
+  }
+  EXPECT_TRUE(!pixel_pipeline::ParseScalerMode("lanczos", nullptr));
+}
+
+PIXEL_TEST(ScaleOutputSizeKeepsAspectWithinBudget) {
+  int32_t w = -1;
+  int32_t h = -1;
+  pixel_pipeline::ComputeOutputSize(1280, 720, 640 * 360, &w, &h);
+  EXPECT_EQ(w, 640);
+  EXPECT_EQ(h, 360);
+  pixel_pipeline::ComputeOutputSize(1920, 1080, 3840 * 2160, &w, &h);
+  EXPECT_EQ(w, 1920);
+  EXPECT_EQ(h, 1080);
+  pixel_pipeline::ComputeOutputSize(0, 1080, 640 * 360, &w, &h);
+  EXPECT_EQ(w, 0);
+  EXPECT_EQ(h, 0);
+  const int32_t sources[][2] = {{3840, 2160}, {2560, 1440}, {3440, 1440}, {1366, 768}, {333, 177}};
+  for (const auto& src : sources) {
+    pixel_pipeline::ComputeOutputSize(src[0], src[1], 640 * 360, &w, &h);
+    EXPECT_LE(static_cast<int64_t>(w) * h, 640 * 360);
+    EXPECT_LE(std::abs(w * src[1] - h * src[0]), src[0] + src[1]);
+  }
+}
+
+PIXEL_TEST(ScalePyramidLevelSizes) {
+  int32_t w = -1;
+  int32_t h = -1;
+  // One halving even when the level above already fits.
+  EXPECT_TRUE(pixel_pipeline::ComputePyramidLevelSize(1280, 720, 1280 * 720, &w, &h));
+  EXPECT_TRUE(w == 640 && h == 360);
+  EXPECT_TRUE(pixel_pipeline::ComputePyramidLevelSize(1280, 720, 200 * 100, &w, &h));
+  EXPECT_TRUE(w == 160 && h == 90);
+  EXPECT_TRUE(pixel_pipeline::ComputePyramidLevelSize(1281, 721, 640 * 360, &w, &h));
+  EXPECT_TRUE(w == 640 && h == 360);
+  EXPECT_TRUE(!pixel_pipeline::ComputePyramidLevelSize(5, 1, 1 << 20, &w, &h));
+  EXPECT_TRUE(!pixel_pipeline::ComputePyramidLevelSize(64, 64, 0, &w, &h));
+}
+
+PIXEL_TEST(ScaleFitSourceRegion) {
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t w = 0;
+  int32_t h = 0;
+  auto fit = [&](int32_t rx, int32_t ry, int32_t rw, int32_t rh, int32_t margin) {
+    x = rx;
+    y = ry;
+    w = rw;
+    h = rh;
+    pixel_pipeline::FitSourceRegion(3840, 2160, 1280, 720, margin, &x, &y, &w, &h);
+  };
+  // Empty request: the whole surface.
+  fit(5, 5, 0, 0, 0);
+  EXPECT_TRUE(x == 0 && y == 0 && w == 3840 && h == 2160);
+  // The margin grows it on every side; it is then widened to 16:9 around
+  // the same centre.
+  fit(1000, 500, 1600, 900, 80);
+  EXPECT_TRUE(x == 857 && y == 420 && w == 1885 && h == 1060);
+  // A tall request is widened to the output aspect ratio.
+  fit(2000, 200, 400, 1000, 0);
+  EXPECT_EQ(h, 1000);
+  EXPECT_EQ(w, 1778);
+  EXPECT_EQ(2 * x + w, 2 * 2000 + 400);
+  // Smaller than the output: grown to it, never upscaled.
+  fit(100, 100, 64, 64, 0);
+  EXPECT_TRUE(w == 1280 && h == 720);
+  // Pushed back inside the surface at the edges.
+  fit(3800, 2100, 640, 360, 0);
+  EXPECT_TRUE(x == 3840 - 1280 && y == 2160 - 720);
+  fit(-500, -500, 640, 360, 0);
+  EXPECT_TRUE(x == 0 && y == 0);
+  // Larger than the surface: clipped to it.
+  fit(0, 0, 8000, 4500, 0);
+  EXPECT_TRUE(x == 0 && y == 0 && w == 3840 && h == 2160);
+}
+
+PIXEL_TEST(ScaleFilterWeightsAreNormalized) {
+  const int32_t sizes[][4] = {{3840, 2160, 640, 360}, {1920, 1080, 1280, 720}, {333, 177, 101, 53},
+                              {50, 40, 49, 39},       {1, 1, 3, 2},           {7, 5, 3, 1}};
+  for (const auto& s : sizes) {
+    for (ScalerMode mode : kFilterModes) {
+      ScalePlan plan;
+      pixel_pipeline::BuildScalePlan(s[0], s[1], s[2], s[3], &plan, mode);
+      ExpectAxisWellFormed(plan.horizontal, s[0], s[2]);
+      ExpectAxisWellFormed(plan.vertical, s[1], s[3]);
+    }
+  }
+}
+
+PIXEL_TEST(ScaleBoxAveragesWholeBlocks) {
+  // 4x4 -> 2x2: every output is the rounded mean of one 2x2 block.
+  std::vector<uint8_t> src(4 * 4 * 4);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>((i * 37) % 251);
+  }
+  const std::vector<uint8_t> out = Scale(src, 4, 4, 2, 2, ScalerMode::kBox);
+  for (int32_t y = 0; y < 2; ++y) {
+    for (int32_t x = 0; x < 2; ++x) {
+      for (int32_t c = 0; c < 3; ++c) {
+        int32_t sum = 0;
+        for (int32_t dy = 0; dy < 2; ++dy) {
+          for (int32_t dx = 0; dx < 2; ++dx) {
+            sum += src[static_cast<size_t>(((y * 2 + dy) * 4 + x * 2 + dx) * 4 + c)];
+          }
+        }
+        EXPECT_EQ(static_cast<int32_t>(out[static_cast<size_t>((y * 2 + x) * 4 + c)]), (sum + 2) / 4);
+      }
+      EXPECT_EQ(static_cast<int32_t>(out[static_cast<size_t>((y * 2 + x) * 4 + 3)]), 255);
+    }
+  }
+}
+
+PIXEL_TEST(ScaleFiltersPreserveFlatColor) {
+  std::vector<uint8_t> src(static_cast<size_t>(333) * 177 * 4);
+  for (size_t i = 0; i < src.size(); i += 4) {
+    src[i] = 17;
+    src[i + 1] = 128;
+    src[i + 2] = 250;
+  }
+  for (ScalerMode mode : kFilterModes) {
+    const std::vector<uint8_t> out = Scale(src, 333, 177, 101, 53, mode);
+    for (size_t i = 0; i < out.size(); i += 4) {
+      EXPECT_TRUE(out[i] == 17 && out[i + 1] == 128 && out[i + 2] == 250 && out[i + 3] == 255);
+    }
+  }
+}
+
+PIXEL_TEST(ScaleSimdFiltersMatchScalarExactly) {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  const pixel_pipeline::CpuFeatures& cpu = pixel_pipeline::GetCpuFeatures();
+  if (!cpu.sse41) {
+    std::printf("[pixel-pipeline]      skip sse4.1 scaler (unsupported)\n");
+    return;
+  }
+  const int32_t srcW = 1001;
+  const std::vector<uint8_t> src = MakeTextSurface(srcW, 9);
+  std::vector<const uint8_t*> rows;
+  for (int32_t k = 0; k < 8; ++k) {
+    rows.push_back(&src[static_cast<size_t>(k) * static_cast<size_t>(srcW) * 4]);
+  }
+  const int16_t weights[] = {1000, 3000, 5000, 4000, 2000, 1384, 0, 0};
+  const size_t bytes = static_cast<size_t>(srcW) * 4;
+  std::vector<int16_t> expected(bytes + 4, 0);
+  std::vector<int16_t> actual(bytes + 4, 0);
+  pixel_pipeline::FilterVerticalScalar(rows.data(), weights, 8, bytes, expected.data());
+  pixel_pipeline::FilterVerticalSse41(rows.data(), weights, 8, bytes, actual.data());
+  EXPECT_TRUE(expected == actual);
+  if (cpu.avx2) {
+    std::fill(actual.begin(), actual.end(), 0);
+    pixel_pipeline::FilterVerticalAvx2(rows.data(), weights, 8, bytes, actual.data());
+    EXPECT_TRUE(expected == actual);
+  }
+
+  for (ScalerMode mode : kFilterModes) {
+    ScalePlan plan;
+    pixel_pipeline::BuildScalePlan(srcW, 9, 377, 3, &plan, mode);
+    std::vector<uint8_t> scalarRow(377 * 4);
+    std::vector<uint8_t> simdRow(377 * 4);
+    pixel_pipeline::FilterHorizontalScalar(expected.data(), plan.horizontal, 377, scalarRow.data());
+    pixel_pipeline::FilterHorizontalSse41(expected.data(), plan.horizontal, 377, simdRow.data());
+    EXPECT_TRUE(scalarRow == simdRow);
+  }
+#endif
+}
+
+PIXEL_TEST(ScaleReduceHalfRoundsBlockMeans) {
+  const int32_t srcW = 37;
+  const int32_t srcH = 41;
+  const std::vector<uint8_t> src = MakeTextSurface(srcW, srcH);
+  const int32_t dstW = srcW / 2;
+  const int32_t dstH = srcH / 2;
+  std::vector<uint8_t> out(static_cast<size_t>(dstW) * static_cast<size_t>(dstH) * 4);
+  pixel_pipeline::ThreadPool pool;
+  pool.EnsureWorkers(2);
+  pixel_pipeline::ReduceRgbaHalf(src.data(), srcW * 4, srcW, srcH, out.data(), dstW * 4, &pool, 3);
+  for (int32_t y = 0; y < dstH; ++y) {
+    for (int32_t x = 0; x < dstW; ++x) {
+      for (int32_t c = 0; c < 4; ++c) {
+        int32_t sum = 0;
+        for (int32_t dy = 0; dy < 2; ++dy) {
+          for (int32_t dx = 0; dx < 2; ++dx) {
+            sum += src[(static_cast<size_t>(y * 2 + dy) * srcW + static_cast<size_t>(x * 2 + dx)) * 4 + c];
+          }
+        }
+        EXPECT_EQ(static_cast<int32_t>(out[(static_cast<size_t>(y) * dstW + static_cast<size_t>(x)) * 4 + c]),
+                  (sum + 2) / 4);
+      }
+    }
+  }
+}
+
+PIXEL_TEST(ScaleReduceHalfSimdMatchesScalar) {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  if (!pixel_pipeline::GetCpuFeatures().sse41) {
+    std::printf("[pixel-pipeline]      skip sse41 (unsupported)\n");
+    return;
+  }
+  std::vector<uint8_t> rows(2 * 1001 * 4);
+  uint32_t seed = 0xC0FFEEu;
+  for (uint8_t& v : rows) {
+    seed = seed * 1664525u + 1013904223u;
+    v = static_cast<uint8_t>(seed >> 24);
+  }
+  // Extremes, which would overflow a non-widening sum.
+  for (size_t i = 0; i < 64; ++i) {
+    rows[i] = rows[1001 * 4 + i] = 255;
+  }
+  for (int32_t dstW : {1, 3, 4, 5, 8, 13, 500}) {
+    std::vector<uint8_t> scalar(static_cast<size_t>(dstW) * 4);
+    std::vector<uint8_t> simd(scalar.size());
+    pixel_pipeline::ReduceHalfRowScalar(rows.data(), rows.data() + 1001 * 4, dstW, scalar.data());
+    pixel_pipeline::ReduceHalfRowSse41(rows.data(), rows.data() + 1001 * 4, dstW, simd.data());
+    EXPECT_TRUE(scalar == simd);
+  }
+#else
+  std::printf("[pixel-pipeline]      skip sse41 (not x86)\n");
+#endif
+}
+
+PIXEL_TEST(ScaleGoldenTextDownscale) {
+  // Hashes of the 1920x1080 -> 640x360 and 1280x720 -> 854x480 text fixture.
+  // Filter output is integer-only, so these hold on every ISA; update them only
+  // for an intentional change to the filters.
+  struct Golden {
+    int32_t srcW, srcH, dstW, dstH;
+    ScalerMode mode;
+    uint32_t hash;
+  };
+  const Golden goldens[] = {
+      {1920, 1080, 640, 360, ScalerMode::kNearest, 0xD6188A4Du},
+      {1920, 1080, 640, 360, ScalerMode::kBox, 0x9E1F9F87u},
+      {1920, 1080, 640, 360, ScalerMode::kBilinear, 0xDFBDF95Cu},
+      {1280, 720, 854, 480, ScalerMode::kBox, 0xC608A114u},
+      {1280, 720, 854, 480, ScalerMode::kBilinear, 0xFC3B3B86u},
+  };
+  for (const Golden& g : goldens) {
+    const std::vector<uint8_t> out = Scale(MakeTextSurface(g.srcW, g.srcH), g.srcW, g.srcH, g.dstW, g.dstH, g.mode);
+    const uint32_t hash = Fnv1a(out);
+    if (hash != g.hash) {
+      std::printf("[pixel-pipeline]      %s %dx%d->%dx%d hash 0x%08Xu\n", pixel_pipeline::ScalerModeName(g.mode), g.srcW,
+                  g.srcH, g.dstW, g.dstH, hash);
+    }
+    EXPECT_EQ(hash, g.hash);
+  }
+}
+
+PIXEL_TEST(ScaleFilteredPipelineMatchesRowSampler) {
+  const int32_t srcW = 1920;
+  const int32_t srcH = 1080;
+  const std::vector<uint8_t> src = MakeTextSurface(srcW, srcH);
+  for (ScalerMode mode : kFilterModes) {
+    pixel_pipeline::FramePipeline pipeline;
+    pixel_pipeline::BuildFramePipeline(srcW, srcH, 640, 360, false, pixel_pipeline::ToneMapConfig(), &pipeline, mode);
+    std::vector<uint8_t> fused(640 * 360 * 4);
+    pixel_pipeline::ProcessFrame(src.data(), srcW * 4, fused.data(), 640 * 4, pipeline);
+    std::vector<uint8_t> expected = Scale(src, srcW, srcH, 640, 360, mode);
+    pixel_pipeline::ApplyPreparedToneMap(expected.data(), expected.data(), expected.size() / 4, pipeline.toneMap);
+    EXPECT_TRUE(fused == expected);
+  }
+}
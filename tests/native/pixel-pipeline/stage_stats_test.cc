@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <string>
+
+#include "stage_stats.h"
+#include "test_harness.h"
+
+using pixel_pipeline::CaptureStage;
+using pixel_pipeline::StageStats;
+
+namespace {
+
+int32_t Index(CaptureStage stage) {
+  return static_cast<int32_t>(stage);
+}
+
+}  // namespace
+
+PIXEL_TEST(StageStatsRecordsOnlyStagesThatRan) {
+  StageStats stats;
+  StageStats::Frame frame;
+  frame.Set(CaptureStage::kCapture, 2.0);
+  frame.Set(CaptureStage::kProcess, 3.0);
+  frame.Set(CaptureStage::kScale, 1.0);
+  stats.RecordFrame(frame, 16.0);
+  stats.Record(CaptureStage::kMarshal, 0.5);
+  stats.RecordFailure();
+
+  const StageStats::Snapshot snapshot = stats.Snap();
+  EXPECT_EQ(snapshot.frames, static_cast<uint64_t>(1));
+  EXPECT_EQ(snapshot.failures, static_cast<uint64_t>(1));
+  EXPECT_EQ(snapshot.overBudgetFrames, static_cast<uint64_t>(0));
+  EXPECT_EQ(snapshot.stages[Index(CaptureStage::kCapture)].count, static_cast<uint64_t>(1));
+  EXPECT_EQ(snapshot.stages[Index(CaptureStage::kCursor)].count, static_cast<uint64_t>(0));
+  EXPECT_EQ(snapshot.stages[Index(CaptureStage::kScale)].count, static_cast<uint64_t>(1));
+  EXPECT_EQ(snapshot.stages[Index(CaptureStage::kMarshal)].count, static_cast<uint64_t>(1));
+  // Scale splits process and marshal happens later, so neither adds to the total.
+  EXPECT_TRUE(snapshot.total.maxMs == 5.0);
+}
+
+PIXEL_TEST(StageStatsAttributesOverBudgetFramesToTheSlowestStage) {
+  StageStats stats;
+  for (int i = 0; i < 3; ++i) {
+    StageStats::Frame frame;
+    frame.Set(CaptureStage::kCapture, 4.0);
+    frame.Set(CaptureStage::kCursor, 0.2);
+    frame.Set(CaptureStage::kProcess, i == 0 ? 2.0 : 14.0);
+    // Split stages never take the blame, however large.
+    frame.Set(CaptureStage::kToneMap, 40.0);
+    stats.RecordFrame(frame, 10.0);
+  }
+  StageStats::Frame captureBound;
+  captureBound.Set(CaptureStage::kCapture, 12.0);
+  stats.RecordFrame(captureBound, 10.0);
+
+  StageStats::Snapshot snapshot = stats.Snap();
+  EXPECT_EQ(snapshot.frames, static_cast<uint64_t>(4));
+  EXPECT_EQ(snapshot.overBudgetFrames, static_cast<uint64_t>(3));
+  EXPECT_EQ(snapshot.overBudgetByStage[Index(CaptureStage::kProcess)], static_cast<uint64_t>(2));
+  EXPECT_EQ(snapshot.overBudgetByStage[Index(CaptureStage::kCapture)], static_cast<uint64_t>(1));
+  EXPECT_EQ(snapshot.overBudgetByStage[Index(CaptureStage::kToneMap)], static_cast<uint64_t>(0));
+
+  stats.Reset();
+  snapshot = stats.Snap();
+  EXPECT_EQ(snapshot.frames, static_cast<uint64_t>(0));
+  EXPECT_EQ(snapshot.overBudgetFrames, static_cast<uint64_t>(0));
+  EXPECT_EQ(snapshot.overBudgetByStage[Index(CaptureStage::kProcess)], static_cast<uint64_t>(0));
+  EXPECT_EQ(snapshot.stages[Index(CaptureStage::kCapture)].count, static_cast<uint64_t>(0));
+  EXPECT_EQ(snapshot.total.count, static_cast<uint64_t>(0));
+}
+
+PIXEL_TEST(StageStatsNamesEveryStage) {
+  EXPECT_TRUE(std::string(pixel_pipeline::CaptureStageName(CaptureStage::kToneMap)) == "tonemap");
+  EXPECT_TRUE(std::string(pixel_pipeline::CaptureStageName(CaptureStage::kMarshal)) == "marshal");
+  EXPECT_TRUE(pixel_pipeline::IsFrameStage(CaptureStage::kDecode));
+  EXPECT_TRUE(!pixel_pipeline::IsFrameStage(CaptureStage::kConvert));
+}
@@ -0,0 +1,64 @@
+#include <cstdint>
+#include <vector>
+
+#include "synthetic_source.h"
+#include "test_harness.h"
+
+namespace {
+
+std::vector<uint8_t> Render(int32_t width, int32_t height, uint32_t frame) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * static_cast<size_t>(height) * 4, 0xAB);
+  pixel_pipeline::RenderSyntheticFrame(pixels.data(), width, height, width * 4, frame);
+  return pixels;
+}
+
+}  // namespace
+
+PIXEL_TEST(SyntheticFramesAreDeterministicAndMove) {
+  const std::vector<uint8_t> first = Render(320, 180, 7);
+  EXPECT_TRUE(first == Render(320, 180, 7));
+  EXPECT_TRUE(first != Render(320, 180, 8));
+  for (size_t i = 3; i < first.size(); i += 4) {
+    EXPECT_EQ(first[i], 0);
+  }
+}
+
+PIXEL_TEST(SyntheticFrameDrawsCursorAndText) {
+  const int32_t width = 320;
+  const int32_t height = 180;
+  int32_t x0 = 0;
+  int32_t y0 = 0;
+  int32_t x1 = 0;
+  int32_t y1 = 0;
+  pixel_pipeline::SyntheticCursorPosition(width, height, 0, &x0, &y0);
+  pixel_pipeline::SyntheticCursorPosition(width, height, 30, &x1, &y1);
+  EXPECT_TRUE(x0 != x1 || y0 != y1);
+
+  // Cursor tip is outlined black, its interior white.
+  const std::vector<uint8_t> frame = Render(width, height, 0);
+  const uint8_t* tip = &frame[(static_cast<size_t>(y0) * width + x0) * 4];
+  EXPECT_TRUE(tip[0] == 0 && tip[1] == 0 && tip[2] == 0);
+  const uint8_t* fill = &frame[(static_cast<size_t>(y0 + 8) * width + x0 + 4) * 4];
+  EXPECT_TRUE(fill[0] == 255 && fill[1] == 255 && fill[2] == 255);
+
+  size_t glyphPixels = 0;
+  for (size_t i = 0; i < frame.size(); i += 4) {
+    glyphPixels += frame[i] == 250 && frame[i + 1] == 250 && frame[i + 2] == 250;
+  }
+  EXPECT_TRUE(glyphPixels > 500);
+}
+
+PIXEL_TEST(SyntheticFrameHonorsStride) {
+  const int32_t width = 33;
+  const int32_t height = 9;
+  const int32_t stride = width * 4 + 12;
+  std::vector<uint8_t> padded(static_cast<size_t>(stride) * height, 0xCD);
+  pixel_pipeline::RenderSyntheticFrame(padded.data(), width, height, stride, 3);
+  const std::vector<uint8_t> packed = Render(width, height, 3);
+  for (int32_t y = 0; y < height; ++y) {
+    for (int32_t i = 0; i < width * 4; ++i) {
+      EXPECT_EQ(padded[static_cast<size_t>(y) * stride + i], packed[static_cast<size_t>(y) * width * 4 + i]);
+    }
+    EXPECT_EQ(padded[static_cast<size_t>(y) * stride + width * 4], 0xCD);
+  }
+}
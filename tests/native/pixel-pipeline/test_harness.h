@@ -0,0 +1,71 @@
+#ifndef CURSORCINE_TESTS_NATIVE_PIXEL_PIPELINE_TEST_HARNESS_H_
+#define CURSORCINE_TESTS_NATIVE_PIXEL_PIPELINE_TEST_HARNESS_H_
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace pixel_pipeline_test {
+
+struct TestCase {
+  const char* name;
+  void (*fn)();
+};
+
+inline std::vector<TestCase>& Registry() {
+  static std::vector<TestCase> tests;
+  return tests;
+}
+
+inline int& FailureCount() {
+  static int failures = 0;
+  return failures;
+}
+
+struct Registrar {
+  Registrar(const char* name, void (*fn)()) { Registry().push_back({name, fn}); }
+};
+
+inline void ReportFailure(const char* file, int line, const std::string& message) {
+  std::fprintf(stderr, "  %s:%d: %s\n", file, line, message.c_str());
+  FailureCount() += 1;
+}
+
+}  // namespace pixel_pipeline_test
+
+#define PIXEL_TEST(name)                                                          \
+  static void name();                                                             \
+  static const pixel_pipeline_test::Registrar name##_registrar(#name, &name);    \
+  static void name()
+
+#define EXPECT_TRUE(cond)                                                                   \
+  do {                                                                                      \
+    if (!(cond)) {                                                                          \
+      pixel_pipeline_test::ReportFailure(__FILE__, __LINE__, std::string("expected ") + #cond); \
+    }                                                                                       \
+  } while (0)
+
+#define EXPECT_EQ(a, b)                                                                                  \
+  do {                                                                                                   \
+    const auto expectA = (a);                                                                            \
+    const auto expectB = (b);                                                                            \
+    if (!(expectA == expectB)) {                                                                         \
+      pixel_pipeline_test::ReportFailure(__FILE__, __LINE__,                                             \
+                                         std::string(#a " == " #b " (") + std::to_string(expectA) + " vs " + \
+                                             std::to_string(expectB) + ")");                             \
+    }                                                                                                    \
+  } while (0)
+
+#define EXPECT_LE(a, b)                                                                                  \
+  do {                                                                                                   \
+    const auto expectA = (a);                                                                            \
+    const auto expectB = (b);                                                                            \
+    if (!(expectA <= expectB)) {                                                                         \
+      pixel_pipeline_test::ReportFailure(__FILE__, __LINE__,                                             \
+                                         std::string(#a " <= " #b " (") + std::to_string(expectA) + " vs " + \
+                                             std::to_string(expectB) + ")");                             \
+    }                                                                                                    \
+  } while (0)
+
+#endif  // CURSORCINE_TESTS_NATIVE_PIXEL_PIPELINE_TEST_HARNESS_H_
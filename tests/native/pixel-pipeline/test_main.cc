@@ -0,0 +1,25 @@
+#include <cstdio>
+#include <cstring>
+
+#include "test_harness.h"
+
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  int ran = 0;
+  int failedTests = 0;
+  for (const pixel_pipeline_test::TestCase& test : pixel_pipeline_test::Registry()) {
+    if (filter && std::strstr(test.name, filter) == nullptr) {
+      continue;
+    }
+    const int before = pixel_pipeline_test::FailureCount();
+    test.fn();
+    ran += 1;
+    const bool passed = pixel_pipeline_test::FailureCount() == before;
+    if (!passed) {
+      failedTests += 1;
+    }
+    std::printf("[pixel-pipeline] %s %s\n", passed ? "ok  " : "FAIL", test.name);
+  }
+  std::printf("[pixel-pipeline] %d tests, %d failed\n", ran, failedTests);
+  return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "test_harness.h"
+#include "thread_pool.h"
+
+namespace {
+
+using pixel_pipeline::ThreadPool;
+
+}  // namespace
+
+PIXEL_TEST(ThreadPoolRunsEveryTaskExactlyOnce) {
+  ThreadPool pool;
+  pool.EnsureWorkers(3);
+  EXPECT_EQ(pool.WorkerCount(), 3);
+  for (int32_t threads : {1, 2, 4, 8}) {
+    std::vector<std::atomic<int32_t>> hits(97);
+    pool.ParallelFor(97, threads, [&](int32_t task) { hits[static_cast<size_t>(task)].fetch_add(1); });
+    int32_t wrong = 0;
+    for (const auto& hit : hits) {
+      wrong += hit.load() == 1 ? 0 : 1;
+    }
+    EXPECT_EQ(wrong, 0);
+  }
+}
+
+PIXEL_TEST(ThreadPoolUsesWorkersAndCapsGrowth) {
+  ThreadPool pool;
+  pool.EnsureWorkers(ThreadPool::kMaxWorkers + 10);
+  EXPECT_EQ(pool.WorkerCount(), ThreadPool::kMaxWorkers);
+  pool.EnsureWorkers(2);
+  EXPECT_EQ(pool.WorkerCount(), ThreadPool::kMaxWorkers);
+
+  const std::thread::id caller = std::this_thread::get_id();
+  std::atomic<int32_t> offCaller{0};
+  pool.ParallelFor(64, 4, [&](int32_t) {
+    if (std::this_thread::get_id() != caller) {
+      offCaller.fetch_add(1);
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  });
+  EXPECT_TRUE(offCaller.load() > 0);
+}
+
+PIXEL_TEST(ThreadPoolServesConcurrentCallers) {
+  ThreadPool pool;
+  pool.EnsureWorkers(4);
+  std::atomic<int64_t> total{0};
+  std::vector<std::thread> callers;
+  for (int32_t c = 0; c < 4; ++c) {
+    callers.emplace_back([&] {
+      for (int32_t round = 0; round < 200; ++round) {
+        pool.ParallelFor(16, 3, [&](int32_t task) { total.fetch_add(task + 1); });
+      }
+    });
+  }
+  for (std::thread& caller : callers) {
+    caller.join();
+  }
+  // 4 callers * 200 rounds * (1 + ... + 16)
+  EXPECT_EQ(total.load(), static_cast<int64_t>(4 * 200 * 136));
+}
@@ -0,0 +1,224 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "cpu_features.h"
+#include "frame_pipeline.h"
+#include "test_harness.h"
+#include "thread_pool.h"
+#include "tile_change.h"
+
+namespace {
+
+using pixel_pipeline::CursorOverlay;
+using pixel_pipeline::CursorSprite;
+using pixel_pipeline::DirtyRect;
+using pixel_pipeline::FramePipeline;
+using pixel_pipeline::PixelFormat;
+using pixel_pipeline::ScalerMode;
+using pixel_pipeline::TileChangeTracker;
+
+std::vector<uint8_t> MakeSurface(int32_t width, int32_t height, uint32_t seed) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+  for (uint8_t& v : pixels) {
+    seed = seed * 1664525u + 1013904223u;
+    v = static_cast<uint8_t>(seed >> 24);
+  }
+  return pixels;
+}
+
+void FillRect(std::vector<uint8_t>* surface, int32_t width, const DirtyRect& rect, uint8_t value) {
+  for (int32_t y = rect.y; y < rect.y + rect.height; ++y) {
+    uint8_t* row = surface->data() + (static_cast<size_t>(y) * width + rect.x) * 4;
+    std::memset(row, value, static_cast<size_t>(rect.width) * 4);
+  }
+}
+
+CursorSprite MakeCursor() {
+  CursorSprite sprite;
+  sprite.width = 13;
+  sprite.height = 19;
+  sprite.pixels.assign(static_cast<size_t>(sprite.width) * sprite.height * 4, 0);
+  for (size_t i = 0; i < sprite.pixels.size(); i += 4) {
+    const uint8_t alpha = (i / 4) % 3 == 0 ? 0 : 200;
+    sprite.pixels[i] = sprite.pixels[i + 1] = sprite.pixels[i + 2] = alpha / 2;
+    sprite.pixels[i + 3] = alpha;
+  }
+  return sprite;
+}
+
+bool SameRect(const DirtyRect& a, int32_t x, int32_t y, int32_t width, int32_t height) {
+  return a.x == x && a.y == y && a.width == width && a.height == height;
+}
+
+// Processes frame A in full, then frame B through the tracker's changed
+// tiles plus the old and new cursor rects, and checks the result against a
+// full ProcessFrame of B.
+void ExpectRectsMatchFullFrame(int32_t srcW,
+                               int32_t srcH,
+                               int32_t dstW,
+                               int32_t dstH,
+                               ScalerMode scaler,
+                               PixelFormat format,
+                               int32_t threads) {
+  FramePipeline pipeline;
+  pixel_pipeline::BuildFramePipeline(
+      srcW, srcH, dstW, dstH, true, pixel_pipeline::ToneMapConfig(), &pipeline, scaler, format);
+  const int32_t stride = format == PixelFormat::kRgba8 ? dstW * 4 : dstW;
+  std::vector<uint8_t> a = MakeSurface(srcW, srcH, 0x5EEDu);
+  std::vector<uint8_t> b = a;
+  FillRect(&b, srcW, {70, 3, 40, 9}, 0x40);
+  FillRect(&b, srcW, {srcW - 5, srcH - 70, 5, 70}, 0xC3);
+  const CursorSprite sprite = MakeCursor();
+  CursorOverlay cursorA;
+  cursorA.sprite = &sprite;
+  cursorA.x = 7;
+  cursorA.y = dstH / 2 + 1;
+  CursorOverlay cursorB = cursorA;
+  cursorB.x = dstW - 9;
+  cursorB.y = 3;
+
+  TileChangeTracker tracker(srcW, srcH);
+  EXPECT_EQ(tracker.Update(a.data(), srcW * 4), tracker.tilesX() * tracker.tilesY());
+  std::vector<uint8_t> persistent(pipeline.output.byteLength, 0);
+  pixel_pipeline::ProcessFrame(a.data(), srcW * 4, persistent.data(), stride, pipeline, &cursorA);
+
+  pixel_pipeline::ThreadPool* pool = pixel_pipeline::ThreadPool::Shared();
+  pool->EnsureWorkers(threads - 1);
+  EXPECT_TRUE(tracker.Update(b.data(), srcW * 4, pool, threads) > 0);
+  std::vector<DirtyRect> sourceRects;
+  tracker.ChangedRects(&sourceRects);
+  std::vector<DirtyRect> rects;
+  for (const DirtyRect& rect : sourceRects) {
+    rects.push_back(pixel_pipeline::MapSourceRectToOutput(pipeline, rect));
+  }
+  rects.push_back(pixel_pipeline::CursorOutputRect(pipeline, cursorA));
+  rects.push_back(pixel_pipeline::CursorOutputRect(pipeline, cursorB));
+  pixel_pipeline::NormalizeOutputRects(pipeline, &rects);
+  size_t covered = 0;
+  for (const DirtyRect& rect : rects) {
+    covered += static_cast<size_t>(rect.width) * static_cast<size_t>(rect.height);
+  }
+  EXPECT_TRUE(covered < static_cast<size_t>(dstW) * static_cast<size_t>(dstH));
+  pixel_pipeline::ProcessTimings timings;
+  pixel_pipeline::ProcessFrameRects(
+      b.data(), srcW * 4, persistent.data(), stride, pipeline, rects, pool, threads, &cursorB, &timings);
+  // Stage stats for tile sessions come from these.
+  EXPECT_TRUE(timings.scaleNs.load() + timings.toneMapNs.load() + timings.convertNs.load() > 0);
+
+  std::vector<uint8_t> full(pipeline.output.byteLength, 0);
+  pixel_pipeline::ProcessFrame(b.data(), srcW * 4, full.data(), stride, pipeline, &cursorB);
+  EXPECT_TRUE(persistent == full);
+}
+
+}  // namespace
+
+PIXEL_TEST(TileHashSimdMatchesScalar) {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  if (!pixel_pipeline::GetCpuFeatures().sse41) {
+    std::printf("[pixel-pipeline]      skip sse41 (unsupported)\n");
+    return;
+  }
+  const std::vector<uint8_t> surface = MakeSurface(301, 40, 0xABCDu);
+  // Tile widths around the 16-pixel chunk, with and without a tail, and rows
+  // that end in a narrower tile.
+  for (int32_t pixels : {1, 5, 15, 16, 17, 31, 64, 70, 256, 301}) {
+    for (int32_t rows : {1, 3, 40}) {
+      EXPECT_EQ(
+          pixel_pipeline::HashTile(pixel_pipeline::HashTileRowSse41, surface.data(), 301 * 4, pixels * 4, rows),
+          pixel_pipeline::HashTile(pixel_pipeline::HashTileRowScalar, surface.data(), 301 * 4, pixels * 4, rows));
+    }
+    alignas(16) uint32_t simd[20 * pixel_pipeline::kTileHashLanes];
+    alignas(16) uint32_t scalar[20 * pixel_pipeline::kTileHashLanes];
+    const int32_t tiles = (301 + pixels - 1) / pixels;
+    if (tiles > 20) {
+      continue;
+    }
+    for (int32_t t = 0; t < tiles; ++t) {
+      pixel_pipeline::InitTileHashLanes(simd + t * pixel_pipeline::kTileHashLanes);
+      pixel_pipeline::InitTileHashLanes(scalar + t * pixel_pipeline::kTileHashLanes);
+    }
+    for (int32_t y = 0; y < 40; ++y) {
+      pixel_pipeline::HashTileRowSse41(surface.data() + y * 301 * 4, 301 * 4, pixels * 4, simd);
+      pixel_pipeline::HashTileRowScalar(surface.data() + y * 301 * 4, 301 * 4, pixels * 4, scalar);
+    }
+    EXPECT_TRUE(std::memcmp(simd, scalar, static_cast<size_t>(tiles) * pixel_pipeline::kTileHashLanes * 4) == 0);
+  }
+#else
+  std::printf("[pixel-pipeline]      skip sse41 (not x86)\n");
+#endif
+}
+
+PIXEL_TEST(TileHashSeesEverySingleWordChange) {
+  std::vector<uint8_t> tile = MakeSurface(64, 64, 0x77u);
+  auto hash = [&tile] {
+    return pixel_pipeline::HashTile(pixel_pipeline::HashTileRowScalar, tile.data(), 64 * 4, 64 * 4, 64);
+  };
+  const uint64_t base = hash();
+  for (size_t word = 0; word < tile.size() / 4; word += 37) {
+    for (uint8_t flip : {0x01, 0x80}) {
+      tile[word * 4 + 3] ^= flip;
+      EXPECT_TRUE(hash() != base);
+      tile[word * 4 + 3] ^= flip;
+    }
+  }
+  // The top bits of two words in one lane, which a plain xor-multiply chain
+  // would cancel.
+  tile[3] ^= 0x80;
+  tile[pixel_pipeline::kTileHashLanes * 4 + 3] ^= 0x80;
+  EXPECT_TRUE(hash() != base);
+}
+
+PIXEL_TEST(TileChangeTrackerFlagsChangedTilesOnly) {
+  const int32_t width = 200;
+  const int32_t height = 130;
+  std::vector<uint8_t> surface = MakeSurface(width, height, 0x1234u);
+  TileChangeTracker tracker(width, height, 64);
+  EXPECT_EQ(tracker.tilesX(), 4);
+  EXPECT_EQ(tracker.tilesY(), 3);
+  EXPECT_EQ(tracker.Update(surface.data(), width * 4), 12);
+  EXPECT_EQ(tracker.Update(surface.data(), width * 4), 0);
+  std::vector<DirtyRect> rects;
+  tracker.ChangedRects(&rects);
+  EXPECT_TRUE(rects.empty());
+
+  surface[(static_cast<size_t>(65) * width + 70) * 4] ^= 1;
+  EXPECT_EQ(tracker.Update(surface.data(), width * 4), 1);
+  EXPECT_TRUE(tracker.Changed(1, 1));
+  tracker.ChangedRects(&rects);
+  EXPECT_EQ(rects.size(), 1u);
+  EXPECT_TRUE(SameRect(rects[0], 64, 64, 64, 64));
+
+  // A 2x2 block of tiles merges into one rect; the right and bottom edge
+  // tiles are clipped to the surface.
+  FillRect(&surface, width, {130, 64, 70, 66}, 9);
+  EXPECT_EQ(tracker.Update(surface.data(), width * 4), 4);
+  tracker.ChangedRects(&rects);
+  EXPECT_EQ(rects.size(), 1u);
+  EXPECT_TRUE(SameRect(rects[0], 128, 64, 72, 66));
+
+  tracker.Reset();
+  EXPECT_EQ(tracker.Update(surface.data(), width * 4), 12);
+  tracker.ChangedRects(&rects);
+  EXPECT_EQ(rects.size(), 1u);
+  EXPECT_TRUE(SameRect(rects[0], 0, 0, width, height));
+}
+
+PIXEL_TEST(TileChangeCoalescesOverlappingRects) {
+  std::vector<DirtyRect> rects = {{0, 0, 10, 10}, {20, 0, 10, 10}, {5, 5, 20, 2}, {40, 40, 2, 2}, {42, 40, 2, 2}};
+  pixel_pipeline::CoalesceRects(&rects);
+  EXPECT_EQ(rects.size(), 3u);
+  pixel_pipeline::CoalesceRects(&rects, true);
+  EXPECT_EQ(rects.size(), 2u);
+}
+
+PIXEL_TEST(TileChangeRectsMatchFullFrame) {
+  ExpectRectsMatchFullFrame(301, 203, 301, 203, ScalerMode::kNearest, PixelFormat::kRgba8, 1);
+  ExpectRectsMatchFullFrame(400, 300, 150, 111, ScalerMode::kNearest, PixelFormat::kRgba8, 3);
+  ExpectRectsMatchFullFrame(400, 300, 150, 111, ScalerMode::kBox, PixelFormat::kRgba8, 2);
+  ExpectRectsMatchFullFrame(400, 300, 211, 157, ScalerMode::kBilinear, PixelFormat::kRgba8, 1);
+  ExpectRectsMatchFullFrame(301, 203, 301, 203, ScalerMode::kNearest, PixelFormat::kNv12, 2);
+  ExpectRectsMatchFullFrame(400, 300, 151, 113, ScalerMode::kNearest, PixelFormat::kI420, 1);
+  ExpectRectsMatchFullFrame(400, 300, 151, 113, ScalerMode::kBox, PixelFormat::kNv12, 2);
+}
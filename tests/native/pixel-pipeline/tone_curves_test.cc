@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "test_harness.h"
+#include "tone_curves.h"
+#include "tone_map.h"
+#include "tone_map_lut.h"
+
+namespace {
+
+using pixel_pipeline::ToneMapConfig;
+using pixel_pipeline::ToneMapLut;
+using pixel_pipeline::ToneMapProfile;
+
+const ToneMapProfile kCurveProfiles[] = {ToneMapProfile::kBt2390Pq, ToneMapProfile::kHlg, ToneMapProfile::kHable};
+
+bool Near(double a, double b, double tolerance) {
+  return std::fabs(a - b) <= tolerance;
+}
+
+std::vector<double> Curve(ToneMapProfile profile, float masteringPeakNits, float targetNits) {
+  ToneMapConfig cfg;
+  cfg.profile = profile;
+  cfg.masteringPeakNits = masteringPeakNits;
+  cfg.targetNits = targetNits;
+  std::vector<double> curve(256);
+  pixel_pipeline::BuildToneCurve(true, cfg, curve.data());
+  return curve;
+}
+
+}  // namespace
+
+PIXEL_TEST(ToneCurvesProfileNamesRoundTrip) {
+  for (ToneMapProfile profile : {ToneMapProfile::kRec709Rolloff, ToneMapProfile::kBt2390Pq, ToneMapProfile::kHlg,
+                                 ToneMapProfile::kHable}) {
+    ToneMapProfile parsed = ToneMapProfile::kRec709Rolloff;
+    EXPECT_TRUE(pixel_pipeline::ParseToneMapProfile(pixel_pipeline::ToneMapProfileName(profile), &parsed));
+    EXPECT_TRUE(parsed == profile);
+  }
+  EXPECT_TRUE(!pixel_pipeline::ParseToneMapProfile("aces", nullptr));
+}
+
+PIXEL_TEST(ToneCurvesTransferFunctionsMatchReferenceLevels) {
+  // ST 2084 reference points: 100 nits ~ 0.5081, 1000 nits ~ 0.7518.
+  EXPECT_TRUE(Near(pixel_pipeline::PqInverseEotf(100.0), 0.5081, 1e-3));
+  EXPECT_TRUE(Near(pixel_pipeline::PqInverseEotf(1000.0), 0.7518, 1e-3));
+  EXPECT_TRUE(Near(pixel_pipeline::PqEotf(1.0), 10000.0, 1e-6));
+  EXPECT_TRUE(Near(pixel_pipeline::PqEotf(0.0), 0.0, 1e-9));
+  for (double signal = 0.05; signal < 1.0; signal += 0.05) {
+    EXPECT_TRUE(Near(pixel_pipeline::PqInverseEotf(pixel_pipeline::PqEotf(signal)), signal, 1e-9));
+  }
+  // HLG is continuous at the log/sqrt boundary and reaches 1 at full signal.
+  EXPECT_TRUE(Near(pixel_pipeline::HlgInverseOetf(0.5), 1.0 / 12.0, 1e-6));
+  EXPECT_TRUE(Near(pixel_pipeline::HlgInverseOetf(0.5 + 1e-9), 1.0 / 12.0, 1e-6));
+  EXPECT_TRUE(Near(pixel_pipeline::HlgInverseOetf(1.0), 1.0, 1e-6));
+  EXPECT_TRUE(Near(pixel_pipeline::HlgSystemGamma(1000.0), 1.2, 1e-9));
+}
+
+PIXEL_TEST(ToneCurvesEetfKeepsShadowsAndLandsOnTargetPeak) {
+  const double source = pixel_pipeline::PqInverseEotf(1000.0);
+  const double target = pixel_pipeline::PqInverseEotf(100.0);
+  // Below the knee (1.5 * target - 0.5 of the source range) nothing changes.
+  const double knee = (1.5 * target / source - 0.5) * source;
+  EXPECT_TRUE(Near(pixel_pipeline::Bt2390Eetf(knee * 0.9, source, target), knee * 0.9, 1e-12));
+  EXPECT_TRUE(Near(pixel_pipeline::Bt2390Eetf(source, source, target), target, 1e-9));
+  double previous = 0.0;
+  for (double signal = 0.0; signal <= source; signal += source / 64.0) {
+    const double mapped = pixel_pipeline::Bt2390Eetf(signal, source, target);
+    EXPECT_TRUE(mapped >= previous);
+    EXPECT_TRUE(mapped <= target + 1e-9);
+    previous = mapped;
+  }
+  // A target at or above the source peak is a no-op.
+  EXPECT_TRUE(Near(pixel_pipeline::Bt2390Eetf(0.6, target, source), 0.6, 1e-12));
+}
+
+PIXEL_TEST(ToneCurvesProfilesAreMonotonicAndSpanTheRange) {
+  for (ToneMapProfile profile : kCurveProfiles) {
+    for (float mastering : {400.0f, 1000.0f, 4000.0f}) {
+      const std::vector<double> curve = Curve(profile, mastering, 100.0f);
+      EXPECT_TRUE(Near(curve[0], 0.0, 1e-6));
+      EXPECT_TRUE(Near(curve[255], 1.0, 1e-6));
+      for (int v = 1; v < 256; ++v) {
+        EXPECT_TRUE(curve[v] >= curve[v - 1]);
+      }
+    }
+  }
+  // PQ: the code for 100 nits lands well below white when mastered at 1000
+  // nits, because the EETF leaves headroom for the highlights above it.
+  const std::vector<double> pq = Curve(ToneMapProfile::kBt2390Pq, 1000.0f, 100.0f);
+  const int code100 = static_cast<int>(std::lround(pixel_pipeline::PqInverseEotf(100.0) * 255.0));
+  EXPECT_TRUE(pq[code100] < 0.95);
+  EXPECT_TRUE(pq[code100] > 0.5);
+  // Highlights between 100 and 1000 nits are squeezed into the top codes
+  // rather than all clipping at 100 nits.
+  const int code400 = static_cast<int>(std::lround(pixel_pipeline::PqInverseEotf(400.0) * 255.0));
+  const int code1000 = static_cast<int>(std::lround(pixel_pipeline::PqInverseEotf(1000.0) * 255.0));
+  EXPECT_TRUE(pq[code400] * 255.0 < 253.0);
+  EXPECT_TRUE(pq[code1000] * 255.0 > 254.5);
+}
+
+PIXEL_TEST(ToneCurvesProfilesRunThroughTables) {
+  std::vector<uint8_t> src(256 * 4);
+  for (int v = 0; v < 256; ++v) {
+    src[v * 4] = static_cast<uint8_t>(255 - v);
+    src[v * 4 + 1] = static_cast<uint8_t>(v / 2);
+    src[v * 4 + 2] = static_cast<uint8_t>(v);
+    src[v * 4 + 3] = 0;
+  }
+  for (ToneMapProfile profile : kCurveProfiles) {
+    for (float saturation : {1.0f, 1.4f}) {
+      ToneMapConfig cfg;
+      cfg.profile = profile;
+      cfg.saturation = saturation;
+      ToneMapLut lut;
+      pixel_pipeline::BuildToneMapLut(true, cfg, &lut);
+      EXPECT_TRUE(!lut.identity);
+      EXPECT_TRUE(lut.preferTables);
+      const std::vector<double> curve = Curve(profile, cfg.masteringPeakNits, cfg.targetNits);
+      std::vector<uint8_t> dst(src.size());
+      pixel_pipeline::ApplyPreparedToneMap(src.data(), dst.data(), 256, lut);
+      std::vector<uint8_t> viaApply(src.size());
+      pixel_pipeline::ApplyToneMap(src.data(), viaApply.data(), 256, true, cfg);
+      EXPECT_TRUE(viaApply == dst);
+      int worst = 0;
+      for (int v = 0; v < 256; ++v) {
+        // Float reference: curve per channel, then the saturation mix.
+        double r = curve[v];
+        double g = curve[v / 2];
+        double b = curve[255 - v];
+        const double luma = 0.2126 * r + 0.7152 * g + 0.0722 * b;
+        r = luma + (r - luma) * saturation;
+        g = luma + (g - luma) * saturation;
+        b = luma + (b - luma) * saturation;
+        const double expected[3] = {r, g, b};
+        for (int c = 0; c < 3; ++c) {
+          const int ref = static_cast<int>(std::lround(std::min(1.0, std::max(0.0, expected[c])) * 255.0));
+          worst = std::max(worst, std::abs(ref - dst[v * 4 + c]));
+        }
+        EXPECT_EQ(dst[v * 4 + 3], 255);
+      }
+      EXPECT_LE(worst, 1);
+    }
+  }
+  // SDR sources skip the profile curve entirely.
+  ToneMapConfig sdr;
+  sdr.profile = ToneMapProfile::kHable;
+  ToneMapLut lut;
+  pixel_pipeline::BuildToneMapLut(false, sdr, &lut);
+  EXPECT_TRUE(lut.identity);
+}
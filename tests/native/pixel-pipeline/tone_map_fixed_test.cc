@@ -0,0 +1,144 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "cpu_features.h"
+#include "test_harness.h"
+#include "tone_map.h"
+#include "tone_map_fixed.h"
+#include "tone_map_lut.h"
+
+namespace {
+
+using pixel_pipeline::ToneMapArithmetic;
+using pixel_pipeline::ToneMapConfig;
+using pixel_pipeline::ToneMapFixed;
+using pixel_pipeline::ToneMapFixedError;
+using pixel_pipeline::ToneMapProfile;
+
+std::vector<uint8_t> MakeNoise(size_t pixelCount) {
+  std::vector<uint8_t> pixels(pixelCount * 4);
+  uint32_t seed = 0x2545F491u;
+  for (uint8_t& v : pixels) {
+    seed = seed * 1664525u + 1013904223u;
+    v = static_cast<uint8_t>(seed >> 24);
+  }
+  return pixels;
+}
+
+ToneMapConfig MakeConfig(float rolloff, float saturation, ToneMapProfile profile = ToneMapProfile::kRec709Rolloff) {
+  ToneMapConfig cfg;
+  cfg.rolloff = rolloff;
+  cfg.saturation = saturation;
+  cfg.profile = profile;
+  cfg.arithmetic = ToneMapArithmetic::kFixed;
+  return cfg;
+}
+
+uint64_t Fnv1a(const std::vector<uint8_t>& bytes) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (uint8_t b : bytes) {
+    hash = (hash ^ b) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+}  // namespace
+
+PIXEL_TEST(ToneMapFixedWithinOneLsbOfFloat) {
+  for (bool hdrLikely : {false, true}) {
+    for (float rolloff : {0.0f, 0.35f, 1.0f}) {
+      for (float saturation : {0.0f, 0.5f, 1.0f, 1.4f, 2.0f}) {
+        const ToneMapFixedError error =
+            pixel_pipeline::MeasureToneMapFixedError(hdrLikely, MakeConfig(rolloff, saturation), 3);
+        EXPECT_EQ(error.samples, static_cast<int64_t>(86 * 86 * 86 * 3));
+        // Without saturation the table holds the reference bytes themselves.
+        EXPECT_LE(error.maxError, saturation == 1.0f ? 0 : 1);
+        EXPECT_TRUE(error.mismatchRate < 0.01);
+      }
+    }
+  }
+  for (ToneMapProfile profile : {ToneMapProfile::kBt2390Pq, ToneMapProfile::kHlg, ToneMapProfile::kHable}) {
+    for (float saturation : {1.0f, 1.3f}) {
+      EXPECT_LE(pixel_pipeline::MeasureToneMapFixedError(true, MakeConfig(0.0f, saturation, profile), 5).maxError, 1);
+    }
+  }
+}
+
+PIXEL_TEST(ToneMapFixedSimdMatchesScalarExactly) {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  if (!pixel_pipeline::GetCpuFeatures().sse41) {
+    std::printf("[pixel-pipeline]      skip sse41 (unsupported)\n");
+    return;
+  }
+  // 1031 pixels leaves a scalar tail; the identity curve takes the shuffle
+  // path, the others the table reads.
+  const std::vector<uint8_t> src = MakeNoise(1031);
+  const ToneMapConfig configs[] = {
+      MakeConfig(0.0f, 1.6f),
+      MakeConfig(0.35f, 1.0f),
+      MakeConfig(0.35f, 0.4f),
+      MakeConfig(1.0f, 2.0f),
+      MakeConfig(0.0f, 1.2f, ToneMapProfile::kBt2390Pq),
+  };
+  for (const ToneMapConfig& cfg : configs) {
+    ToneMapFixed fixed;
+    pixel_pipeline::BuildToneMapFixed(true, cfg, &fixed);
+    std::vector<uint8_t> scalar(src.size());
+    std::vector<uint8_t> simd(src.size());
+    pixel_pipeline::ToneMapFixedScalar(src.data(), scalar.data(), src.size() / 4, fixed);
+    pixel_pipeline::ToneMapFixedSse41(src.data(), simd.data(), src.size() / 4, fixed);
+    EXPECT_TRUE(scalar == simd);
+  }
+#else
+  std::printf("[pixel-pipeline]      skip sse41 (not x86)\n");
+#endif
+}
+
+PIXEL_TEST(ToneMapFixedMatchesGoldenOutput) {
+  // Integer-only, so these hold on every compiler and platform.
+  const std::vector<uint8_t> src = MakeNoise(4096);
+  ToneMapFixed fixed;
+  std::vector<uint8_t> dst(src.size());
+  pixel_pipeline::BuildToneMapFixed(true, MakeConfig(0.35f, 1.2f), &fixed);
+  EXPECT_EQ(fixed.lumaR + fixed.lumaG + fixed.lumaB, 32768);
+  EXPECT_EQ(fixed.curve[255], 24178);
+  pixel_pipeline::ApplyToneMapFixed(src.data(), dst.data(), src.size() / 4, fixed);
+  EXPECT_EQ(Fnv1a(dst), 0x8137821BC7A5E2E8ull);
+  pixel_pipeline::BuildToneMapFixed(false, MakeConfig(0.0f, 0.5f), &fixed);
+  EXPECT_TRUE(fixed.identityCurve);
+  pixel_pipeline::ApplyToneMapFixed(src.data(), dst.data(), src.size() / 4, fixed);
+  EXPECT_EQ(Fnv1a(dst), 0x0C78236102523E73ull);
+}
+
+PIXEL_TEST(ToneMapFixedSelectedByArithmetic) {
+  ToneMapArithmetic arithmetic = ToneMapArithmetic::kFloat;
+  EXPECT_TRUE(pixel_pipeline::ParseToneMapArithmetic("fixed", &arithmetic));
+  EXPECT_TRUE(arithmetic == ToneMapArithmetic::kFixed);
+  EXPECT_TRUE(!pixel_pipeline::ParseToneMapArithmetic("q15", &arithmetic));
+
+  const std::vector<uint8_t> src = MakeNoise(777);
+  const ToneMapConfig cfg = MakeConfig(0.5f, 1.3f);
+  ToneMapFixed fixed;
+  pixel_pipeline::BuildToneMapFixed(true, cfg, &fixed);
+  std::vector<uint8_t> expected(src.size());
+  pixel_pipeline::ToneMapFixedScalar(src.data(), expected.data(), src.size() / 4, fixed);
+
+  pixel_pipeline::ToneMapLut lut;
+  pixel_pipeline::BuildToneMapLut(true, cfg, &lut);
+  EXPECT_TRUE(lut.fixedPoint);
+  std::vector<uint8_t> prepared(src.size());
+  pixel_pipeline::ApplyPreparedToneMap(src.data(), prepared.data(), src.size() / 4, lut);
+  EXPECT_TRUE(prepared == expected);
+  std::vector<uint8_t> direct(src.size());
+  pixel_pipeline::ApplyToneMap(src.data(), direct.data(), src.size() / 4, true, cfg);
+  EXPECT_TRUE(direct == expected);
+  // In place, like the float kernels.
+  std::vector<uint8_t> inPlace = src;
+  pixel_pipeline::ApplyToneMapFixed(inPlace.data(), inPlace.data(), inPlace.size() / 4, fixed);
+  EXPECT_TRUE(inPlace == expected);
+
+  // Rolloff alone keeps the exact byte table.
+  pixel_pipeline::BuildToneMapLut(true, MakeConfig(0.5f, 1.0f), &lut);
+  EXPECT_TRUE(!lut.fixedPoint && lut.preferTables);
+}
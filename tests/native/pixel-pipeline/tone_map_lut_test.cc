@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "test_harness.h"
+#include "tone_map.h"
+#include "tone_map_lut.h"
+
+namespace {
+
+using pixel_pipeline::ToneMapConfig;
+using pixel_pipeline::ToneMapLut;
+
+std::vector<uint8_t> MakeNoise(size_t pixelCount) {
+  std::vector<uint8_t> pixels(pixelCount * 4);
+  uint32_t seed = 0x2545F491u;
+  for (uint8_t& v : pixels) {
+    seed = seed * 1664525u + 1013904223u;
+    v = static_cast<uint8_t>(seed >> 24);
+  }
+  return pixels;
+}
+
+int Compare(bool hdrLikely, float rolloff, float saturation, const std::vector<uint8_t>& src) {
+  ToneMapConfig cfg;
+  cfg.rolloff = rolloff;
+  cfg.saturation = saturation;
+  ToneMapLut lut;
+  pixel_pipeline::BuildToneMapLut(hdrLikely, cfg, &lut);
+  std::vector<uint8_t> expected(src.size());
+  std::vector<uint8_t> actual(src.size());
+  pixel_pipeline::ToneMapBgraToRgbaScalar(
+      src.data(), expected.data(), src.size() / 4, pixel_pipeline::ResolveToneMapParams(hdrLikely, cfg));
+  pixel_pipeline::ApplyToneMapLut(src.data(), actual.data(), src.size() / 4, lut);
+  int worst = 0;
+  for (size_t i = 0; i < src.size(); ++i) {
+    worst = std::max(worst, std::abs(static_cast<int>(expected[i]) - static_cast<int>(actual[i])));
+  }
+  return worst;
+}
+
+}  // namespace
+
+PIXEL_TEST(ToneMapLutRolloffOnlyIsBitExact) {
+  const std::vector<uint8_t> src = MakeNoise(4096);
+  for (float rolloff : {0.1f, 0.35f, 0.6f, 1.0f}) {
+    EXPECT_EQ(Compare(true, rolloff, 1.0f, src), 0);
+  }
+  EXPECT_EQ(Compare(false, 0.6f, 1.0f, src), 0);
+}
+
+PIXEL_TEST(ToneMapLutSaturationMatchesFloatWithinOneLsb) {
+  const std::vector<uint8_t> src = MakeNoise(4096);
+  for (bool hdrLikely : {false, true}) {
+    for (float rolloff : {0.0f, 0.25f, 1.0f}) {
+      for (float saturation : {0.0f, 0.5f, 0.9f, 1.4f, 2.0f}) {
+        EXPECT_LE(Compare(hdrLikely, rolloff, saturation, src), 1);
+      }
+    }
+  }
+}
+
+PIXEL_TEST(ToneMapLutFlagsFollowConfig) {
+  ToneMapLut lut;
+  pixel_pipeline::BuildToneMapLut(false, ToneMapConfig(), &lut);
+  EXPECT_TRUE(lut.identity && !lut.separable);
+  ToneMapConfig cfg;
+  cfg.rolloff = 0.5f;
+  pixel_pipeline::BuildToneMapLut(true, cfg, &lut);
+  EXPECT_TRUE(!lut.identity && !lut.separable);
+  cfg.saturation = 1.3f;
+  pixel_pipeline::BuildToneMapLut(true, cfg, &lut);
+  EXPECT_TRUE(!lut.identity && lut.separable);
+}
+
+PIXEL_TEST(ToneMapLutSupportsInPlaceConversion) {
+  const std::vector<uint8_t> src = MakeNoise(1031);
+  ToneMapConfig cfg;
+  cfg.rolloff = 0.4f;
+  cfg.saturation = 1.2f;
+  ToneMapLut lut;
+  pixel_pipeline::BuildToneMapLut(true, cfg, &lut);
+  std::vector<uint8_t> expected(src.size());
+  pixel_pipeline::ApplyToneMapLut(src.data(), expected.data(), src.size() / 4, lut);
+  std::vector<uint8_t> inPlace = src;
+  pixel_pipeline::ApplyToneMapLut(inPlace.data(), inPlace.data(), inPlace.size() / 4, lut);
+  EXPECT_TRUE(inPlace == expected);
+}
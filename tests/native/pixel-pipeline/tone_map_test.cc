@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "test_harness.h"
+#include "tone_map.h"
+
+namespace {
+
+using pixel_pipeline::ToneMapConfig;
+using pixel_pipeline::ToneMapFn;
+using pixel_pipeline::ToneMapKernel;
+using pixel_pipeline::ToneMapParams;
+
+const ToneMapKernel kSimdKernels[] = {ToneMapKernel::kSse41, ToneMapKernel::kAvx2, ToneMapKernel::kNeon};
+
+// Every BGR triple on a 16-step lattice plus the full 0..255 ramp on each
+// channel, followed by deterministic noise; 4099 pixels so the SIMD tail runs.
+std::vector<uint8_t> MakeBgraFixture() {
+  std::vector<uint8_t> pixels;
+  for (int b = 0; b < 256; b += 17) {
+    for (int g = 0; g < 256; g += 17) {
+      for (int r = 0; r < 256; r += 17) {
+        pixels.insert(pixels.end(), {static_cast<uint8_t>(b), static_cast<uint8_t>(g), static_cast<uint8_t>(r), 0});
+      }
+    }
+  }
+  for (int v = 0; v < 256; ++v) {
+    const uint8_t c = static_cast<uint8_t>(v);
+    pixels.insert(pixels.end(), {c, 0, 0, 7, 0, c, 0, 7, 0, 0, c, 7});
+  }
+  uint32_t seed = 0x9E3779B9u;
+  while (pixels.size() < 4099 * 4) {
+    seed = seed * 1664525u + 1013904223u;
+    pixels.push_back(static_cast<uint8_t>(seed >> 24));
+  }
+  return pixels;
+}
+
+int MaxChannelDelta(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+  int worst = 0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    worst = std::max(worst, std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+  }
+  return worst;
+}
+
+std::vector<ToneMapParams> ParamMatrix() {
+  std::vector<ToneMapParams> out;
+  const float rolloffs[] = {0.0f, 0.25f, 0.6f, 1.0f};
+  const float saturations[] = {0.0f, 0.5f, 1.0f, 1.4f, 2.0f};
+  for (bool hdrLikely : {false, true}) {
+    for (float rolloff : rolloffs) {
+      for (float saturation : saturations) {
+        ToneMapConfig cfg;
+        cfg.rolloff = rolloff;
+        cfg.saturation = saturation;
+        out.push_back(pixel_pipeline::ResolveToneMapParams(hdrLikely, cfg));
+      }
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+PIXEL_TEST(ToneMapScalarIdentitySwizzlesExactly) {
+  const std::vector<uint8_t> src = MakeBgraFixture();
+  std::vector<uint8_t> dst(src.size());
+  const ToneMapParams params = pixel_pipeline::ResolveToneMapParams(false, ToneMapConfig());
+  EXPECT_TRUE(!params.applyRolloff && !params.applySaturation);
+  pixel_pipeline::ToneMapBgraToRgbaScalar(src.data(), dst.data(), src.size() / 4, params);
+  for (size_t i = 0; i < src.size(); i += 4) {
+    EXPECT_EQ(dst[i], src[i + 2]);
+    EXPECT_EQ(dst[i + 1], src[i + 1]);
+    EXPECT_EQ(dst[i + 2], src[i]);
+    EXPECT_EQ(dst[i + 3], 255);
+  }
+}
+
+PIXEL_TEST(ToneMapRolloffOnlyAppliesToHdrSources) {
+  ToneMapConfig cfg;
+  cfg.rolloff = 0.5f;
+  EXPECT_TRUE(!pixel_pipeline::ResolveToneMapParams(false, cfg).applyRolloff);
+  EXPECT_TRUE(pixel_pipeline::ResolveToneMapParams(true, cfg).applyRolloff);
+  cfg.rolloff = 4.0f;
+  cfg.saturation = -1.0f;
+  const ToneMapParams clamped = pixel_pipeline::ResolveToneMapParams(true, cfg);
+  EXPECT_TRUE(clamped.rolloff == 1.0f);
+  EXPECT_TRUE(clamped.saturation == 0.0f);
+}
+
+PIXEL_TEST(ToneMapSimdKernelsMatchScalarWithinOneLsb) {
+  const std::vector<uint8_t> src = MakeBgraFixture();
+  const size_t pixelCount = src.size() / 4;
+  std::vector<uint8_t> expected(src.size());
+  std::vector<uint8_t> actual(src.size());
+  for (ToneMapKernel kernel : kSimdKernels) {
+    const ToneMapFn fn = pixel_pipeline::GetToneMapKernel(kernel);
+    if (!fn) {
+      std::printf("[pixel-pipeline]      skip %s (unsupported)\n", pixel_pipeline::ToneMapKernelName(kernel));
+      continue;
+    }
+    for (const ToneMapParams& params : ParamMatrix()) {
+      pixel_pipeline::ToneMapBgraToRgbaScalar(src.data(), expected.data(), pixelCount, params);
+      fn(src.data(), actual.data(), pixelCount, params);
+      EXPECT_LE(MaxChannelDelta(expected, actual), 1);
+    }
+  }
+}
+
+PIXEL_TEST(ToneMapKernelsSupportInPlaceConversion) {
+  const std::vector<uint8_t> src = MakeBgraFixture();
+  ToneMapConfig cfg;
+  cfg.rolloff = 0.35f;
+  cfg.saturation = 1.2f;
+  const ToneMapParams params = pixel_pipeline::ResolveToneMapParams(true, cfg);
+  std::vector<uint8_t> expected(src.size());
+  pixel_pipeline::ToneMapBgraToRgbaScalar(src.data(), expected.data(), src.size() / 4, params);
+  for (ToneMapKernel kernel : {ToneMapKernel::kScalar, ToneMapKernel::kSse41, ToneMapKernel::kAvx2, ToneMapKernel::kNeon}) {
+    const ToneMapFn fn = pixel_pipeline::GetToneMapKernel(kernel);
+    if (!fn) {
+      continue;
+    }
+    std::vector<uint8_t> inPlace = src;
+    fn(inPlace.data(), inPlace.data(), inPlace.size() / 4, params);
+    EXPECT_LE(MaxChannelDelta(expected, inPlace), 1);
+  }
+}
+
+PIXEL_TEST(ToneMapActiveKernelIsSupported) {
+  const ToneMapKernel active = pixel_pipeline::ActiveToneMapKernel();
+  EXPECT_TRUE(pixel_pipeline::GetToneMapKernel(active) != nullptr);
+  std::printf("[pixel-pipeline]      active tone-map kernel: %s\n", pixel_pipeline::ToneMapKernelName(active));
+}
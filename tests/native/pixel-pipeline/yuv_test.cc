@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "cpu_features.h"
+#include "test_harness.h"
+#include "yuv.h"
+
+namespace {
+
+using pixel_pipeline::FrameLayout;
+using pixel_pipeline::PixelFormat;
+using pixel_pipeline::YuvCoefficients;
+using pixel_pipeline::YuvRange;
+
+std::vector<uint8_t> MakeRgbaRow(int32_t width, uint32_t seed) {
+  std::vector<uint8_t> row(static_cast<size_t>(width) * 4);
+  for (uint8_t& v : row) {
+    seed = seed * 1664525u + 1013904223u;
+    v = static_cast<uint8_t>(seed >> 24);
+  }
+  return row;
+}
+
+struct YuvRows {
+  std::vector<uint8_t> y0;
+  std::vector<uint8_t> y1;
+  std::vector<uint8_t> chroma;  // NV12-style interleaved when step is 2
+};
+
+YuvRows Convert(pixel_pipeline::RgbaToYuvRowsFn fn,
+                const std::vector<uint8_t>& row0,
+                const std::vector<uint8_t>& row1,
+                int32_t width,
+                int32_t chromaStep,
+                const YuvCoefficients& coeffs) {
+  YuvRows out;
+  const size_t chromaW = static_cast<size_t>(width + 1) / 2;
+  out.y0.assign(static_cast<size_t>(width), 0);
+  out.y1.assign(static_cast<size_t>(width), 0);
+  out.chroma.assign(chromaW * 2, 0);
+  uint8_t* u = out.chroma.data();
+  uint8_t* v = chromaStep == 2 ? u + 1 : u + chromaW;
+  fn(row0.data(), row1.data(), width, out.y0.data(), out.y1.data(), u, v, chromaStep, coeffs);
+  return out;
+}
+
+// Textbook BT.709 in double precision for one RGB triple.
+void ReferenceYuv(double r, double g, double b, YuvRange range, double* y, double* u, double* v) {
+  const bool limited = range == YuvRange::kLimited;
+  const double luma = 0.2126 * r + 0.7152 * g + 0.0722 * b;
+  const double cb = (b - luma) / 1.8556;
+  const double cr = (r - luma) / 1.5748;
+  *y = limited ? 16.0 + luma * 219.0 / 255.0 : luma;
+  *u = 128.0 + (limited ? cb * 224.0 / 255.0 : cb);
+  *v = 128.0 + (limited ? cr * 224.0 / 255.0 : cr);
+}
+
+}  // namespace
+
+PIXEL_TEST(YuvLayoutPacksPlanesTightly) {
+  const FrameLayout rgba = pixel_pipeline::ComputeFrameLayout(PixelFormat::kRgba8, 640, 360);
+  EXPECT_EQ(rgba.planeCount, 1);
+  EXPECT_EQ(rgba.byteLength, static_cast<size_t>(640 * 360 * 4));
+
+  const FrameLayout nv12 = pixel_pipeline::ComputeFrameLayout(PixelFormat::kNv12, 640, 360);
+  EXPECT_EQ(nv12.planeCount, 2);
+  EXPECT_EQ(nv12.planes[1].offset, static_cast<size_t>(640 * 360));
+  EXPECT_EQ(nv12.planes[1].stride, 640);
+  EXPECT_EQ(nv12.planes[1].height, 180);
+  // 4:2:0 is 1.5 bytes per pixel: 62.5% smaller than RGBA8.
+  EXPECT_EQ(nv12.byteLength * 8, rgba.byteLength * 3);
+
+  const FrameLayout i420 = pixel_pipeline::ComputeFrameLayout(PixelFormat::kI420, 5, 3);
+  EXPECT_EQ(i420.planeCount, 3);
+  EXPECT_EQ(i420.planes[1].offset, static_cast<size_t>(15));
+  EXPECT_EQ(i420.planes[1].stride, 3);
+  EXPECT_EQ(i420.planes[1].height, 2);
+  EXPECT_EQ(i420.planes[2].offset, static_cast<size_t>(21));
+  EXPECT_EQ(i420.byteLength, static_cast<size_t>(27));
+
+  PixelFormat parsed = PixelFormat::kRgba8;
+  EXPECT_TRUE(pixel_pipeline::ParsePixelFormat("I420", &parsed) && parsed == PixelFormat::kI420);
+  EXPECT_TRUE(!pixel_pipeline::ParsePixelFormat("nv21", &parsed));
+}
+
+PIXEL_TEST(YuvReferenceLevelsAreExact) {
+  const std::vector<uint8_t> white(8, 255);
+  const std::vector<uint8_t> black = {0, 0, 0, 255, 0, 0, 0, 255};
+  const std::vector<uint8_t> grey = {77, 77, 77, 255, 77, 77, 77, 255};
+  for (YuvRange range : {YuvRange::kLimited, YuvRange::kFull}) {
+    const bool limited = range == YuvRange::kLimited;
+    const YuvCoefficients coeffs = pixel_pipeline::ResolveYuvCoefficients(range);
+    const YuvRows w = Convert(pixel_pipeline::RgbaToYuvRowsScalar, white, white, 2, 1, coeffs);
+    const YuvRows k = Convert(pixel_pipeline::RgbaToYuvRowsScalar, black, black, 2, 1, coeffs);
+    const YuvRows g = Convert(pixel_pipeline::RgbaToYuvRowsScalar, grey, grey, 2, 1, coeffs);
+    EXPECT_EQ(w.y0[0], limited ? 235 : 255);
+    EXPECT_EQ(k.y0[1], limited ? 16 : 0);
+    EXPECT_EQ(g.y1[0], limited ? 82 : 77);
+    for (const YuvRows* rows : {&w, &k, &g}) {
+      EXPECT_EQ(rows->chroma[0], 128);
+      EXPECT_EQ(rows->chroma[1], 128);
+    }
+  }
+}
+
+PIXEL_TEST(YuvScalarMatchesBt709WithinOneLsb) {
+  const int32_t width = 256;
+  const std::vector<uint8_t> row = MakeRgbaRow(width, 0x1234u);
+  for (YuvRange range : {YuvRange::kLimited, YuvRange::kFull}) {
+    const YuvCoefficients coeffs = pixel_pipeline::ResolveYuvCoefficients(range);
+    // Same row twice with duplicated pixels, so every 2x2 block is one colour.
+    std::vector<uint8_t> doubled(static_cast<size_t>(width) * 8);
+    for (int32_t x = 0; x < width; ++x) {
+      std::copy_n(row.begin() + x * 4, 4, doubled.begin() + x * 8);
+      std::copy_n(row.begin() + x * 4, 4, doubled.begin() + x * 8 + 4);
+    }
+    const YuvRows out = Convert(pixel_pipeline::RgbaToYuvRowsScalar, doubled, doubled, width * 2, 1, coeffs);
+    double worst = 0.0;
+    for (int32_t x = 0; x < width; ++x) {
+      double y = 0.0;
+      double u = 0.0;
+      double v = 0.0;
+      ReferenceYuv(row[x * 4], row[x * 4 + 1], row[x * 4 + 2], range, &y, &u, &v);
+      worst = std::max(worst, std::fabs(out.y0[x * 2] - y));
+      worst = std::max(worst, std::fabs(out.chroma[x] - u));
+      worst = std::max(worst, std::fabs(out.chroma[width + x] - v));
+    }
+    EXPECT_LE(worst, 1.0);
+  }
+}
+
+PIXEL_TEST(YuvSimdMatchesScalarExactly) {
+#if defined(PIXEL_PIPELINE_ARCH_X86)
+  if (!pixel_pipeline::GetCpuFeatures().sse41) {
+    std::printf("[pixel-pipeline]      skip sse41 (unsupported)\n");
+    return;
+  }
+  for (YuvRange range : {YuvRange::kLimited, YuvRange::kFull}) {
+    const YuvCoefficients coeffs = pixel_pipeline::ResolveYuvCoefficients(range);
+    // Widths around the 8-pixel step, odd ones included for the tail.
+    for (int32_t width : {1, 2, 7, 8, 9, 15, 16, 17, 33, 641}) {
+      const std::vector<uint8_t> row0 = MakeRgbaRow(width, 0xBEEFu + width);
+      const std::vector<uint8_t> row1 = MakeRgbaRow(width, 0xF00Du + width);
+      for (int32_t step : {1, 2}) {
+        const YuvRows expected = Convert(pixel_pipeline::RgbaToYuvRowsScalar, row0, row1, width, step, coeffs);
+        const YuvRows actual = Convert(pixel_pipeline::RgbaToYuvRowsSse41, row0, row1, width, step, coeffs);
+        EXPECT_TRUE(actual.y0 == expected.y0);
+        EXPECT_TRUE(actual.y1 == expected.y1);
+        EXPECT_TRUE(actual.chroma == expected.chroma);
+      }
+    }
+  }
+#else
+  std::printf("[pixel-pipeline]      skip sse41 (not x86)\n");
+#endif
+}
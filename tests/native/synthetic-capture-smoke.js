@@ -0,0 +1,799 @@
+#!/usr/bin/env node
+
+// Drives both capture addons against the synthetic frame source
+// (CURSORCINE_NATIVE_TEST_SYNTHETIC_SOURCE=1), so the session, pool and async
+// read paths run on any platform. Run via scripts/run-native-synthetic-tests.js.
+
+const assert = require('assert');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const OUTPUT_WIDTH = 640;
+const OUTPUT_HEIGHT = 360;
+const FRAME_BYTES = OUTPUT_WIDTH * OUTPUT_HEIGHT * 4;
+
+const results = [];
+
+function log(message) {
+  process.stdout.write('[native-synthetic] ' + message + '\n');
+}
+
+async function check(name, fn) {
+  try {
+    await fn();
+    results.push({ name, ok: true });
+    log('ok   ' + name);
+  } catch (error) {
+    results.push({ name, ok: false });
+    log('FAIL ' + name + ': ' + (error && error.stack ? error.stack : String(error)));
+  }
+}
+
+function start(bridge, extra = {}) {
+  const started = bridge.startCapture({
+    sourceId: 'synthetic-smoke-source',
+    displayId: 'synthetic-display',
+    displayHint: {
+      bounds: { x: 0, y: 0, width: 1280, height: 720 },
+      scaleFactor: 1,
+      isHdrLikely: true
+    },
+    maxOutputPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT,
+    toneMap: { profile: 'rec709-rolloff-v1', rolloff: 0.35 },
+    ...extra
+  });
+  assert.strictEqual(started.ok, true, JSON.stringify(started));
+  assert.strictEqual(started.source, 'synthetic');
+  assert.strictEqual(started.width, OUTPUT_WIDTH);
+  assert.strictEqual(started.height, OUTPUT_HEIGHT);
+  return started.nativeSessionId;
+}
+
+function assertFrame(result) {
+  assert.strictEqual(result.ok, true, JSON.stringify(result));
+  assert.strictEqual(result.width, OUTPUT_WIDTH);
+  assert.strictEqual(result.height, OUTPUT_HEIGHT);
+  assert.strictEqual(result.pixelFormat, 'RGBA8');
+  assert.ok(result.stageMs && result.stageMs.process >= 0);
+}
+
+async function runBridge(label, bridge) {
+  await check(label + '.probe', () => {
+    const probe = bridge.probe({});
+    assert.strictEqual(probe.supported, true, JSON.stringify(probe));
+    // Both addons compile the same capture_addon.cc; only the name differs.
+    assert.strictEqual(probe.nativeBackend, label === 'legacy' ? 'windows-gdi-capture' : 'windows-wgc-hdr-mvp');
+    assert.ok(probe.backends.includes('synthetic') && probe.backends.includes('replay'));
+  });
+
+  await check(label + '.backend.invalid', () => {
+    const started = bridge.startCapture({ backend: 'webcam' });
+    assert.strictEqual(started.reason, 'INVALID_BACKEND');
+  });
+
+  await check(label + '.backend.replay', () => {
+    // Two recorded 1280x720 BGRA frames; replay loops back to the first.
+    const frameBytes = 1280 * 720 * 4;
+    const replayPath = path.join(os.tmpdir(), 'cursorcine-replay-' + process.pid + '-' + label + '.bgra');
+    fs.writeFileSync(replayPath, Buffer.concat([Buffer.alloc(frameBytes, 0x20), Buffer.alloc(frameBytes, 0xc0)]));
+    try {
+      const missing = bridge.startCapture({ backend: 'replay', replayPath: replayPath + '.missing' });
+      assert.strictEqual(missing.reason, 'START_FAILED');
+
+      const started = bridge.startCapture({
+        backend: 'replay',
+        replayPath,
+        displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1 },
+        maxOutputPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT
+      });
+      assert.strictEqual(started.ok, true, JSON.stringify(started));
+      assert.strictEqual(started.source, 'replay');
+      assert.strictEqual(started.replayFrames, 2);
+      const frames = [0, 1, 2].map(() => {
+        const result = bridge.readFrame({ nativeSessionId: started.nativeSessionId });
+        assertFrame(result);
+        return Buffer.from(result.bytes);
+      });
+      assert.strictEqual(frames[0][0], 0x20);
+      assert.strictEqual(frames[1][0], 0xc0);
+      assert.deepStrictEqual(frames[2], frames[0]);
+      bridge.stopCapture({ nativeSessionId: started.nativeSessionId });
+    } finally {
+      fs.unlinkSync(replayPath);
+    }
+  });
+
+  await check(label + '.changeDetection', () => {
+    // Frames A, A, B: B differs from A in one 100x50 block.
+    const frameBytes = 1280 * 720 * 4;
+    const a = Buffer.alloc(frameBytes);
+    for (let i = 0; i < frameBytes; i += 1) {
+      a[i] = (i * 7) & 0xff;
+    }
+    const b = Buffer.from(a);
+    for (let y = 100; y < 150; y += 1) {
+      b.fill(0x55, (y * 1280 + 200) * 4, (y * 1280 + 300) * 4);
+    }
+    const replayPath = path.join(os.tmpdir(), 'cursorcine-tiles-' + process.pid + '-' + label + '.bgra');
+    fs.writeFileSync(replayPath, Buffer.concat([a, a, b]));
+    const options = {
+      backend: 'replay',
+      replayPath,
+      displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1 },
+      maxOutputPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT
+    };
+    try {
+      const started = bridge.startCapture({ ...options, changeDetection: { tileSize: 32 } });
+      assert.strictEqual(started.ok, true, JSON.stringify(started));
+      assert.deepStrictEqual(started.changeDetection, { tileSize: 32, tiles: 40 * 23 });
+      const sid = started.nativeSessionId;
+      const first = bridge.readFrame({ nativeSessionId: sid });
+      assertFrame(first);
+      assert.deepStrictEqual(first.dirtyRects, [{ x: 0, y: 0, width: OUTPUT_WIDTH, height: OUTPUT_HEIGHT }]);
+      assert.strictEqual(first.unchanged, false);
+      const second = bridge.readFrame({ nativeSessionId: sid });
+      assert.strictEqual(second.unchanged, true);
+      assert.deepStrictEqual(second.dirtyRects, []);
+      assert.ok(Buffer.from(second.bytes).equals(Buffer.from(first.bytes)));
+
+      const stride = OUTPUT_WIDTH * 4 + 64;
+      const target = new Uint8Array(stride * OUTPUT_HEIGHT);
+      const third = bridge.readFrameInto({ nativeSessionId: sid, target, stride });
+      assert.strictEqual(third.ok, true, JSON.stringify(third));
+      assert.strictEqual(third.unchanged, false);
+      // The block lands at (100, 50)-(150, 75) in the half-size output; only
+      // the tiles around it are dirty.
+      const area = third.dirtyRects.reduce((sum, r) => sum + r.width * r.height, 0);
+      assert.ok(area > 0 && area < (OUTPUT_WIDTH * OUTPUT_HEIGHT) / 10, JSON.stringify(third.dirtyRects));
+      assert.ok(third.dirtyRects.some((r) => r.x <= 100 && r.y <= 50 && r.x + r.width >= 150 && r.y + r.height >= 75));
+      // Only the first frame is sampled for the split stages, and it was
+      // processed in full, so its tone-map time is real.
+      const { tonemap } = bridge.getStats({ nativeSessionId: sid }).stages;
+      assert.strictEqual(tonemap.count, 1);
+      assert.ok(tonemap.mean > 0, JSON.stringify(tonemap));
+      bridge.stopCapture({ nativeSessionId: sid });
+
+      // Same output as a session that processes every frame in full.
+      const plain = bridge.startCapture(options);
+      const frames = [0, 1, 2].map(() => bridge.readFrame({ nativeSessionId: plain.nativeSessionId }));
+      assert.strictEqual(frames[2].dirtyRects, undefined);
+      for (let y = 0; y < OUTPUT_HEIGHT; y += 1) {
+        const row = Buffer.from(target.buffer, y * stride, OUTPUT_WIDTH * 4);
+        assert.ok(row.equals(frames[2].bytes.subarray(y * OUTPUT_WIDTH * 4, (y + 1) * OUTPUT_WIDTH * 4)), 'row ' + y);
+      }
+      bridge.stopCapture({ nativeSessionId: plain.nativeSessionId });
+    } finally {
+      fs.unlinkSync(replayPath);
+    }
+  });
+
+  await check(label + '.setViewport', async () => {
+    // One 1280x720 frame with a distinct value in every pixel column/row.
+    const frame = Buffer.alloc(1280 * 720 * 4);
+    for (let y = 0; y < 720; y += 1) {
+      for (let x = 0; x < 1280; x += 1) {
+        const i = (y * 1280 + x) * 4;
+        frame[i] = x & 0xff;
+        frame[i + 1] = y & 0xff;
+        frame[i + 2] = (x >> 8) | ((y >> 8) << 4);
+        frame[i + 3] = 0xff;
+      }
+    }
+    const replayPath = path.join(os.tmpdir(), 'cursorcine-viewport-' + process.pid + '-' + label + '.bgra');
+    fs.writeFileSync(replayPath, frame);
+    const options = {
+      backend: 'replay',
+      replayPath,
+      displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1 }
+    };
+    try {
+      const started = bridge.startCapture({ ...options, maxOutputPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT });
+      const sid = started.nativeSessionId;
+      assert.strictEqual(bridge.setViewport({ nativeSessionId: 0 }).reason, 'INVALID_SESSION');
+      const set = bridge.setViewport({ nativeSessionId: sid, x: 500, y: 300, width: 320, height: 180, margin: 0 });
+      assert.strictEqual(set.ok, true, JSON.stringify(set));
+      // Grown to the output size (no upscaling) around the same centre.
+      assert.deepStrictEqual(set.viewport, { x: 340, y: 210, width: 640, height: 360 });
+      assert.strictEqual(set.captureWidth, 1280);
+      const cropped = bridge.readFrame({ nativeSessionId: sid });
+      assertFrame(cropped);
+      assert.deepStrictEqual(cropped.viewport, set.viewport);
+
+      // 1:1 crop of what a full-resolution session produces.
+      const full = bridge.startCapture({ ...options, maxOutputPixels: 1280 * 720 });
+      const reference = bridge.readFrame({ nativeSessionId: full.nativeSessionId });
+      assert.strictEqual(reference.viewport, undefined);
+      for (let y = 0; y < OUTPUT_HEIGHT; y += 1) {
+        const start = ((y + 210) * 1280 + 340) * 4;
+        const expected = reference.bytes.subarray(start, start + OUTPUT_WIDTH * 4);
+        const row = cropped.bytes.subarray(y * OUTPUT_WIDTH * 4, (y + 1) * OUTPUT_WIDTH * 4);
+        assert.ok(row.equals(expected), 'row ' + y);
+      }
+      bridge.stopCapture({ nativeSessionId: full.nativeSessionId });
+
+      const reset = bridge.setViewport({ nativeSessionId: sid });
+      assert.deepStrictEqual(reset.viewport, { x: 0, y: 0, width: 1280, height: 720 });
+      assert.strictEqual(bridge.readFrame({ nativeSessionId: sid }).viewport, undefined);
+      bridge.stopCapture({ nativeSessionId: sid });
+    } finally {
+      fs.unlinkSync(replayPath);
+    }
+
+    // Continuous frames carry the region they were captured from.
+    const continuous = bridge.startCapture({
+      sourceId: 'synthetic-smoke-source',
+      displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1 },
+      maxOutputPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT,
+      continuous: true,
+      targetFps: 50
+    });
+    const region = bridge.setViewport({
+      nativeSessionId: continuous.nativeSessionId,
+      x: 0,
+      y: 0,
+      width: 800,
+      height: 450
+    });
+    await new Promise((resolve) => setTimeout(resolve, 150));
+    const latest = bridge.readLatest({ nativeSessionId: continuous.nativeSessionId });
+    assertFrame(latest);
+    assert.deepStrictEqual(latest.viewport, region.viewport);
+    bridge.stopCapture({ nativeSessionId: continuous.nativeSessionId });
+  });
+
+  await check(label + '.outputs', async () => {
+    // 2x box reduction of a packed RGBA frame, as the pyramid computes it.
+    const reduce = (bytes, width, height) => {
+      const w = width >> 1;
+      const h = height >> 1;
+      const out = Buffer.alloc(w * h * 4);
+      for (let y = 0; y < h; y += 1) {
+        for (let x = 0; x < w; x += 1) {
+          for (let c = 0; c < 4; c += 1) {
+            const i = ((y * 2) * width + x * 2) * 4 + c;
+            const sum = bytes[i] + bytes[i + 4] + bytes[i + width * 4] + bytes[i + width * 4 + 4];
+            out[(y * w + x) * 4 + c] = (sum + 2) >> 2;
+          }
+        }
+      }
+      return { bytes: out, width: w, height: h };
+    };
+    // Listed out of order; the 100x50 budget skips 160x90 below 320x180.
+    const outputs = [{ maxPixels: 320 * 180 }, { maxPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT }, { maxPixels: 100 * 50 }];
+    const started = bridge.startCapture({
+      sourceId: 'synthetic-smoke-source',
+      displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1 },
+      outputs
+    });
+    assert.strictEqual(started.ok, true, JSON.stringify(started));
+    assert.deepStrictEqual(
+      started.outputs.map((level) => [level.width, level.height, level.stride]),
+      [[640, 360, 2560], [320, 180, 1280], [80, 45, 320]]
+    );
+    const sid = started.nativeSessionId;
+    const verify = (frame) => {
+      assertFrame(frame);
+      assert.strictEqual(frame.levels.length, 3);
+      assert.strictEqual(frame.levels[0].bytes, frame.bytes);
+      let expected = { bytes: frame.bytes, width: frame.width, height: frame.height };
+      for (const [index, steps] of [[1, 1], [2, 2]]) {
+        for (let step = 0; step < steps; step += 1) {
+          expected = reduce(expected.bytes, expected.width, expected.height);
+        }
+        const level = frame.levels[index];
+        assert.strictEqual(level.width, expected.width);
+        assert.strictEqual(level.bytes.length, level.byteLength);
+        assert.ok(level.bytes.equals(expected.bytes), 'level ' + index);
+      }
+    };
+    verify(bridge.readFrame({ nativeSessionId: sid }));
+    verify(await bridge.readFrameAsync({ nativeSessionId: sid }));
+    // Targets only take the main frame.
+    const into = bridge.readFrameInto({ nativeSessionId: sid, target: new Uint8Array(FRAME_BYTES) });
+    assertFrame(into);
+    assert.strictEqual(into.levels, undefined);
+    bridge.stopCapture({ nativeSessionId: sid });
+
+    for (const extra of [{ outputFormat: 'NV12' }, { continuous: true }, { outputs: [{ maxPixels: 0 }] }]) {
+      const refused = bridge.startCapture({
+        sourceId: 'synthetic-smoke-source',
+        displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1 },
+        outputs,
+        ...extra
+      });
+      assert.strictEqual(refused.ok, false, JSON.stringify(extra));
+      assert.strictEqual(refused.reason, 'START_FAILED');
+    }
+  });
+
+  await check(label + '.readFrame', () => {
+    const sid = start(bridge);
+    const result = bridge.readFrame({ nativeSessionId: sid });
+    assertFrame(result);
+    assert.strictEqual(result.bytes.length, FRAME_BYTES);
+    assert.ok(result.bytes.some((v) => v !== 0));
+    assert.strictEqual(bridge.stopCapture({ nativeSessionId: sid }).ok, true);
+  });
+
+  await check(label + '.readFrameInto', () => {
+    const sid = start(bridge);
+    const target = new SharedArrayBuffer(FRAME_BYTES + 64);
+    const result = bridge.readFrameInto({ nativeSessionId: sid, target, offset: 64 });
+    assertFrame(result);
+    assert.strictEqual(result.byteLength, FRAME_BYTES);
+    assert.strictEqual(new Uint8Array(target)[64 + 3], 255);
+    bridge.stopCapture({ nativeSessionId: sid });
+  });
+
+  await check(label + '.threads.matchesSerial', async () => {
+    const serial = start(bridge);
+    const banded = start(bridge, { threads: 4 });
+    const one = bridge.readFrame({ nativeSessionId: serial });
+    // Same frame index in both sessions, so the synthetic pattern is identical.
+    const four = await bridge.readFrameAsync({ nativeSessionId: banded });
+    assertFrame(four);
+    assert.deepStrictEqual(Buffer.from(four.bytes), Buffer.from(one.bytes));
+    bridge.stopCapture({ nativeSessionId: serial });
+    bridge.stopCapture({ nativeSessionId: banded });
+  });
+
+  await check(label + '.outputFormat.yuv', async () => {
+    const rgbaSid = start(bridge);
+    const rgba = bridge.readFrame({ nativeSessionId: rgbaSid }).bytes;
+    bridge.stopCapture({ nativeSessionId: rgbaSid });
+    const lumaBytes = OUTPUT_WIDTH * OUTPUT_HEIGHT;
+    for (const outputFormat of ['NV12', 'I420']) {
+      const sid = start(bridge, { outputFormat });
+      const result = bridge.readFrame({ nativeSessionId: sid });
+      assert.strictEqual(result.ok, true, JSON.stringify(result));
+      assert.strictEqual(result.pixelFormat, outputFormat);
+      assert.strictEqual(result.yuvRange, 'limited');
+      assert.strictEqual(result.bytes.length, (FRAME_BYTES * 3) / 8);
+      assert.strictEqual(result.planes.length, outputFormat === 'NV12' ? 2 : 3);
+      assert.deepStrictEqual(result.planes[0], { offset: 0, stride: OUTPUT_WIDTH, width: OUTPUT_WIDTH, height: OUTPUT_HEIGHT });
+      assert.strictEqual(result.planes[1].offset, lumaBytes);
+      // Same frame index as the RGBA session: luma is its BT.709 limited-range Y.
+      for (const i of [0, 1234, lumaBytes - 1]) {
+        const y = 16 + ((0.2126 * rgba[i * 4] + 0.7152 * rgba[i * 4 + 1] + 0.0722 * rgba[i * 4 + 2]) * 219) / 255;
+        assert.ok(Math.abs(result.bytes[i] - y) <= 1, i + ': ' + result.bytes[i] + ' vs ' + y);
+      }
+      // Targets take the packed frame; stride does not apply.
+      const target = Buffer.alloc(result.bytes.length + 16);
+      const into = await bridge.readFrameAsync({ nativeSessionId: sid, target, offset: 16, stride: 4096 });
+      assert.strictEqual(into.ok, true, JSON.stringify(into));
+      assert.strictEqual(into.byteLength, result.bytes.length);
+      assert.strictEqual(into.stride, OUTPUT_WIDTH);
+      bridge.stopCapture({ nativeSessionId: sid });
+    }
+  });
+
+  await check(label + '.toneMap.profile', async () => {
+    const base = {
+      displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1, isHdrLikely: true },
+      maxOutputPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT
+    };
+    const reference = bridge.startCapture(base);
+    assert.strictEqual(reference.toneMap.profile, 'rec709-rolloff-v1');
+    const referenceFrame = Buffer.from(bridge.readFrame({ nativeSessionId: reference.nativeSessionId }).bytes);
+    bridge.stopCapture({ nativeSessionId: reference.nativeSessionId });
+    for (const profile of ['bt2390-pq', 'hlg', 'hable']) {
+      const started = bridge.startCapture({ ...base, toneMap: { profile, masteringPeakNits: 4000, targetNits: 200 } });
+      assert.strictEqual(started.ok, true, JSON.stringify(started));
+      assert.deepStrictEqual(
+        { profile: started.toneMap.profile, peak: started.toneMap.masteringPeakNits, target: started.toneMap.targetNits },
+        { profile, peak: 4000, target: 200 }
+      );
+      assert.strictEqual(started.toneMap.kernel, 'lut');
+      const frame = bridge.readFrame({ nativeSessionId: started.nativeSessionId });
+      assertFrame(frame);
+      assert.notDeepStrictEqual(Buffer.from(frame.bytes), referenceFrame);
+      bridge.stopCapture({ nativeSessionId: started.nativeSessionId });
+    }
+    const unknown = bridge.startCapture({ ...base, toneMap: { profile: 'aces' } });
+    assert.strictEqual(unknown.toneMap.profile, 'rec709-rolloff-v1');
+    bridge.stopCapture({ nativeSessionId: unknown.nativeSessionId });
+  });
+
+  await check(label + '.toneMap.arithmetic', async () => {
+    const toneMap = { rolloff: 0.35, saturation: 1.3 };
+    const floatSid = start(bridge, { toneMap });
+    const floatFrame = bridge.readFrame({ nativeSessionId: floatSid });
+    bridge.stopCapture({ nativeSessionId: floatSid });
+    const started = bridge.startCapture({
+      displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1, isHdrLikely: true },
+      maxOutputPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT,
+      toneMap: { ...toneMap, arithmetic: 'fixed' }
+    });
+    assert.strictEqual(started.ok, true, JSON.stringify(started));
+    assert.strictEqual(started.toneMap.arithmetic, 'fixed');
+    assert.strictEqual(started.toneMap.kernel, 'fixed');
+    assert.ok(started.toneMap.fixedError.max <= 1, JSON.stringify(started.toneMap.fixedError));
+    const frame = bridge.readFrame({ nativeSessionId: started.nativeSessionId });
+    assertFrame(frame);
+    const fixedBytes = Buffer.from(frame.bytes);
+    const floatBytes = Buffer.from(floatFrame.bytes);
+    for (let i = 0; i < fixedBytes.length; i += 1) {
+      assert.ok(Math.abs(fixedBytes[i] - floatBytes[i]) <= 1, 'byte ' + i);
+    }
+    bridge.stopCapture({ nativeSessionId: started.nativeSessionId });
+    const unknown = bridge.startCapture({ toneMap: { arithmetic: 'q15' } });
+    assert.strictEqual(unknown.toneMap.arithmetic, 'float');
+    bridge.stopCapture({ nativeSessionId: unknown.nativeSessionId });
+  });
+
+  await check(label + '.sourceFormat.hdr', async () => {
+    const whiteRow = Math.floor(OUTPUT_HEIGHT / 8) * OUTPUT_WIDTH * 4;
+    const redRow = Math.floor((OUTPUT_HEIGHT * 3) / 8) * OUTPUT_WIDTH * 4;
+    for (const sourceFormat of ['rgba16f', 'rgb10a2']) {
+      const started = bridge.startCapture({
+        displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1 },
+        maxOutputPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT,
+        toneMap: { rolloff: 1 },
+        sourceFormat
+      });
+      assert.strictEqual(started.ok, true, JSON.stringify(started));
+      assert.strictEqual(started.sourceFormat, sourceFormat);
+      assert.strictEqual(started.hdrActive, true);
+      const frame = bridge.readFrame({ nativeSessionId: started.nativeSessionId });
+      assertFrame(frame);
+      // Synthetic ramps: white over the top quarter, red below it.
+      let brightest = 0;
+      for (let x = 0; x < OUTPUT_WIDTH; x += 1) {
+        brightest = Math.max(brightest, frame.bytes[whiteRow + x * 4]);
+        assert.strictEqual(frame.bytes[redRow + x * 4 + 1], 0);
+      }
+      assert.ok(brightest > 100, String(brightest));
+      if (sourceFormat === 'rgba16f') {
+        // Highlights 8x SDR white are compressed, not clipped.
+        assert.ok(brightest < 255, String(brightest));
+      }
+      bridge.stopCapture({ nativeSessionId: started.nativeSessionId });
+    }
+    const invalid = bridge.startCapture({
+      displayHint: { bounds: { x: 0, y: 0, width: 64, height: 64 }, scaleFactor: 1 },
+      sourceFormat: 'rgb565'
+    });
+    assert.strictEqual(invalid.ok, false);
+    assert.strictEqual(invalid.reason, 'START_FAILED');
+  });
+
+  await check(label + '.readFrameAsync.pooled', async () => {
+    const sid = start(bridge);
+    const sync = bridge.readFrame({ nativeSessionId: sid });
+    const pending = bridge.readFrameAsync({ nativeSessionId: sid });
+    assert.ok(pending instanceof Promise);
+    const result = await pending;
+    assertFrame(result);
+    assert.strictEqual(result.bytes.length, FRAME_BYTES);
+    // The synthetic source advances every frame.
+    assert.notDeepStrictEqual(Buffer.from(result.bytes), Buffer.from(sync.bytes));
+    bridge.stopCapture({ nativeSessionId: sid });
+  });
+
+  await check(label + '.readFrameAsync.target', async () => {
+    const sid = start(bridge);
+    const stride = OUTPUT_WIDTH * 4 + 32;
+    const target = Buffer.alloc(stride * OUTPUT_HEIGHT);
+    const result = await bridge.readFrameAsync({ nativeSessionId: sid, target, stride });
+    assertFrame(result);
+    assert.strictEqual(result.stride, stride);
+    assert.strictEqual(result.bytes, undefined);
+    assert.strictEqual(target[stride + 3], 255);
+    assert.strictEqual(target[stride - 1], 0);
+    bridge.stopCapture({ nativeSessionId: sid });
+  });
+
+  await check(label + '.readFrameAsync.invalid', async () => {
+    const sid = start(bridge);
+    const missing = await bridge.readFrameAsync({ nativeSessionId: 999999 });
+    assert.strictEqual(missing.reason, 'INVALID_SESSION');
+    const tooSmall = await bridge.readFrameAsync({ nativeSessionId: sid, target: new ArrayBuffer(16) });
+    assert.strictEqual(tooSmall.reason, 'INVALID_TARGET');
+    assert.strictEqual(tooSmall.requiredBytes, FRAME_BYTES);
+    const exhausted = await (() => {
+      process.env.CURSORCINE_NATIVE_TEST_FORCE_POOL_EXHAUSTED = '1';
+      const pending = bridge.readFrameAsync({ nativeSessionId: sid });
+      return pending.finally(() => {
+        delete process.env.CURSORCINE_NATIVE_TEST_FORCE_POOL_EXHAUSTED;
+      });
+    })();
+    assert.strictEqual(exhausted.reason, 'POOL_EXHAUSTED');
+    bridge.stopCapture({ nativeSessionId: sid });
+  });
+
+  await check(label + '.readFrameAsync.stopWhileInFlight', async () => {
+    const sid = start(bridge, { framePoolDepth: 16 });
+    const pending = [];
+    for (let i = 0; i < 32; i += 1) {
+      pending.push(bridge.readFrameAsync({ nativeSessionId: sid }));
+    }
+    assert.strictEqual(bridge.stopCapture({ nativeSessionId: sid }).ok, true);
+    const settled = await Promise.all(pending);
+    const reasons = new Set(settled.map((r) => (r.ok ? 'ok' : r.reason)));
+    for (const reason of reasons) {
+      assert.ok(['ok', 'CANCELLED', 'POOL_EXHAUSTED'].includes(reason), reason);
+    }
+    assert.ok(reasons.has('CANCELLED'), JSON.stringify([...reasons]));
+    const after = await bridge.readFrameAsync({ nativeSessionId: sid });
+    assert.strictEqual(after.reason, 'INVALID_SESSION');
+  });
+
+  await check(label + '.continuous.readLatest', async () => {
+    const started = bridge.startCapture({
+      sourceId: 'synthetic-smoke-source',
+      displayHint: { bounds: { x: 0, y: 0, width: 1280, height: 720 }, scaleFactor: 1 },
+      maxOutputPixels: OUTPUT_WIDTH * OUTPUT_HEIGHT,
+      continuous: true,
+      targetFps: 20
+    });
+    assert.strictEqual(started.continuous, true, JSON.stringify(started));
+    assert.strictEqual(started.targetFps, 20);
+    const sid = started.nativeSessionId;
+    assert.strictEqual(bridge.readFrame({ nativeSessionId: sid }).reason, 'CONTINUOUS_SESSION');
+    assert.strictEqual((await bridge.readFrameAsync({ nativeSessionId: sid })).reason, 'CONTINUOUS_SESSION');
+
+    await new Promise((resolve) => setTimeout(resolve, 120));
+    const first = bridge.readLatest({ nativeSessionId: sid });
+    assertFrame(first);
+    assert.strictEqual(first.bytes.length, FRAME_BYTES);
+    assert.ok(first.sequence >= 1);
+    // Frames the capture thread produced before this first read were dropped.
+    assert.strictEqual(first.droppedFrames, first.sequence - 1);
+    // A re-read either finds nothing new or a strictly newer frame, never the same one twice.
+    const repeat = bridge.readLatest({ nativeSessionId: sid });
+    assert.ok(repeat.reason === 'NO_NEW_FRAME' || (repeat.ok && repeat.sequence > first.sequence),
+      JSON.stringify({ reason: repeat.reason, sequence: repeat.sequence, first: first.sequence }));
+
+    await new Promise((resolve) => setTimeout(resolve, 80));
+    const target = new SharedArrayBuffer(FRAME_BYTES);
+    const second = bridge.readLatest({ nativeSessionId: sid, target });
+    assertFrame(second);
+    assert.ok(second.sequence > first.sequence);
+    assert.strictEqual(second.byteLength, FRAME_BYTES);
+    assert.strictEqual(new Uint8Array(target)[3], 255);
+    assert.strictEqual(bridge.stopCapture({ nativeSessionId: sid }).ok, true);
+  });
+
+  await check(label + '.continuous.pacing', async () => {
+    const started = bridge.startCapture({
+      sourceId: 'synthetic-smoke-source',
+      displayHint: { bounds: { x: 0, y: 0, width: OUTPUT_WIDTH, height: OUTPUT_HEIGHT }, scaleFactor: 1 },
+      continuous: true,
+      targetFps: 50
+    });
+    assert.strictEqual(started.dropPolicy, 'latest-only', JSON.stringify(started));
+    const sid = started.nativeSessionId;
+    const before = Date.now();
+    await new Promise((resolve) => setTimeout(resolve, 400));
+    const latest = bridge.readLatest({ nativeSessionId: sid });
+    assertFrame(latest);
+    // Stamped when capture started, not when the result was marshalled.
+    assert.ok(latest.timestampMs >= before - 5 && latest.timestampMs <= Date.now(), String(latest.timestampMs));
+
+    const stats = bridge.getPacingStats({ nativeSessionId: sid });
+    assert.strictEqual(stats.ok, true, JSON.stringify(stats));
+    assert.strictEqual(stats.targetFps, 50);
+    assert.ok(stats.frames >= 10, JSON.stringify(stats));
+    assert.strictEqual(stats.intervalMs.count, stats.frames - 1);
+    assert.strictEqual(stats.intervalMs.counts.reduce((sum, n) => sum + n, 0), stats.intervalMs.count);
+    // 20 ms deadlines; generous bounds for loaded single-core CI runners.
+    assert.ok(stats.intervalMs.p50 >= 15 && stats.intervalMs.p50 <= 25, JSON.stringify(stats.intervalMs));
+    assert.ok(stats.jitterMs.count === stats.frames && stats.jitterMs.p50 < 5, JSON.stringify(stats.jitterMs));
+    bridge.stopCapture({ nativeSessionId: sid });
+    assert.strictEqual(bridge.getPacingStats({ nativeSessionId: sid }).reason, 'INVALID_SESSION');
+  });
+
+  await check(label + '.getStats', async () => {
+    const started = bridge.startCapture({
+      sourceId: 'synthetic-smoke-source',
+      displayHint: { bounds: { x: 0, y: 0, width: OUTPUT_WIDTH, height: OUTPUT_HEIGHT }, scaleFactor: 1 },
+      targetFps: 40
+    });
+    assert.strictEqual(started.ok, true, JSON.stringify(started));
+    const sid = started.nativeSessionId;
+    // Into one reused target, so the frame pool never runs dry.
+    const target = new ArrayBuffer(FRAME_BYTES);
+    for (let i = 0; i < 17; i += 1) {
+      assertFrame(bridge.readFrameInto({ nativeSessionId: sid, target }));
+    }
+    const stats = bridge.getStats({ nativeSessionId: sid, reset: true });
+    assert.strictEqual(stats.ok, true, JSON.stringify(stats));
+    assert.strictEqual(stats.frames, 17);
+    assert.strictEqual(stats.failures, 0);
+    assert.strictEqual(stats.budgetMs, 25);
+    assert.strictEqual(stats.totalMs.count, 17);
+    assert.strictEqual(stats.stages.capture.count, 17);
+    assert.strictEqual(stats.stages.process.count, 17);
+    assert.strictEqual(stats.stages.marshal.count, 17);
+    // Synthetic frames have no cursor or decode; the split stages are sampled.
+    assert.strictEqual(stats.stages.cursor.count, 0);
+    assert.strictEqual(stats.stages.decode.count, 0);
+    assert.strictEqual(stats.stages.scale.count, 2);
+    assert.strictEqual(stats.stages.convert.count, 0);
+    assert.ok(stats.stages.process.p99 >= stats.stages.process.p50, JSON.stringify(stats.stages.process));
+    assert.strictEqual(Object.values(stats.overBudgetByStage).reduce((sum, n) => sum + n, 0), stats.overBudgetFrames);
+    assert.strictEqual(bridge.getStats({ nativeSessionId: sid }).frames, 0);
+    bridge.stopCapture({ nativeSessionId: sid });
+    assert.strictEqual(bridge.getStats({ nativeSessionId: sid }).reason, 'INVALID_SESSION');
+  });
+
+  await check(label + '.frameDelta', () => {
+    const { decodeFrameDelta } = require('../../src/core/frame-delta');
+    const sid = start(bridge);
+    const base = Buffer.from(bridge.readFrame({ nativeSessionId: sid }).bytes);
+    const frame = Buffer.from(bridge.readFrame({ nativeSessionId: sid }).bytes);
+    bridge.stopCapture({ nativeSessionId: sid });
+    // A cursor-sized change stays tiny; the synthetic pattern's motion may not.
+    const moved = Buffer.from(base);
+    moved.fill(7, 4096, 4096 + 64 * 4);
+    const small = bridge.encodeFrameDelta({ base, frame: moved, maxBytes: 1024 });
+    assert.strictEqual(small.ok, true, JSON.stringify(small));
+    assert.ok(small.encodedBytes < 512, String(small.encodedBytes));
+    assert.strictEqual(small.changedTiles, 4);
+
+    const encoded = bridge.encodeFrameDelta({ base, frame, maxBytes: FRAME_BYTES * 2 });
+    assert.strictEqual(encoded.ok, true, JSON.stringify(encoded));
+    assert.strictEqual(encoded.frameBytes, FRAME_BYTES);
+    const native = Buffer.from(base);
+    assert.strictEqual(bridge.decodeFrameDelta({ base: native, delta: encoded.bytes }).ok, true);
+    assert.ok(native.equals(frame));
+    const js = new Uint8Array(base);
+    assert.strictEqual(decodeFrameDelta(new Uint8Array(encoded.bytes), js), true);
+    assert.ok(Buffer.from(js).equals(frame));
+
+    assert.strictEqual(bridge.encodeFrameDelta({ base, frame, maxBytes: 16 }).reason, 'DELTA_TOO_LARGE');
+    assert.strictEqual(bridge.encodeFrameDelta({ base, frame: frame.subarray(4) }).reason, 'SIZE_MISMATCH');
+    const misfit = bridge.decodeFrameDelta({ base: base.subarray(4), delta: encoded.bytes });
+    assert.strictEqual(misfit.reason, 'INVALID_DELTA');
+  });
+
+  await check(label + '.sharedRing', async () => {
+    const name = 'cursorcine-smoke-' + label + '-' + process.pid;
+    const startOptions = {
+      sourceId: 'synthetic-smoke-source',
+      displayHint: { bounds: { x: 0, y: 0, width: OUTPUT_WIDTH, height: OUTPUT_HEIGHT }, scaleFactor: 1 },
+      sharedRing: { name, slots: 3 }
+    };
+    const oneShot = bridge.startCapture(startOptions);
+    assert.strictEqual(oneShot.ok, false);
+    assert.ok(/continuous/.test(oneShot.message), oneShot.message);
+    const started = bridge.startCapture({ ...startOptions, continuous: true, targetFps: 20 });
+    assert.strictEqual(started.ok, true, JSON.stringify(started));
+    assert.deepStrictEqual(started.sharedRing, { name, slots: 3 });
+    const sid = started.nativeSessionId;
+    // The name is taken while the session owns it.
+    assert.strictEqual(bridge.startCapture({ ...startOptions, continuous: true }).ok, false);
+
+    const ring = bridge.openFrameRing({ name });
+    assert.strictEqual(ring.ok, true, JSON.stringify(ring));
+    assert.strictEqual(ring.slots, 3);
+    assert.strictEqual(ring.width, OUTPUT_WIDTH);
+    assert.strictEqual(ring.byteLength, FRAME_BYTES);
+    assert.strictEqual(ring.pixelFormat, 'RGBA8');
+    await new Promise((resolve) => setTimeout(resolve, 150));
+    const first = bridge.readFrameRing({ ringId: ring.ringId });
+    assertFrame(first);
+    assert.strictEqual(first.bytes.length, FRAME_BYTES);
+    assert.ok(first.latencyMs >= 0 && first.latencyMs < 1000, String(first.latencyMs));
+    // A re-read either finds nothing new or a strictly newer frame, never the same one twice.
+    const repeat = bridge.readFrameRing({ ringId: ring.ringId });
+    assert.ok(repeat.reason === 'NO_NEW_FRAME' || (repeat.ok && repeat.sequence > first.sequence),
+      JSON.stringify({ reason: repeat.reason, sequence: repeat.sequence, first: first.sequence }));
+    const last = repeat.ok ? repeat : first;
+    // The session's own readLatest reads the same ring independently.
+    assertFrame(bridge.readLatest({ nativeSessionId: sid }));
+
+    await new Promise((resolve) => setTimeout(resolve, 120));
+    const target = new SharedArrayBuffer(FRAME_BYTES);
+    const second = bridge.readFrameRing({ ringId: ring.ringId, target });
+    assertFrame(second);
+    assert.ok(second.sequence > last.sequence);
+    assert.strictEqual(second.droppedFrames - last.droppedFrames, second.sequence - last.sequence - 1);
+    assert.strictEqual(new Uint8Array(target)[3], 255);
+    assert.ok(bridge.getPacingStats({ nativeSessionId: sid }).published >= second.sequence);
+
+    assert.strictEqual(bridge.closeFrameRing({ ringId: ring.ringId }).ok, true);
+    assert.strictEqual(bridge.readFrameRing({ ringId: ring.ringId }).reason, 'INVALID_RING');
+    bridge.stopCapture({ nativeSessionId: sid });
+    assert.strictEqual(bridge.openFrameRing({ name }).reason, 'RING_UNAVAILABLE');
+  });
+
+  await check(label + '.encoderPipe', async () => {
+    // Node stands in for ffmpeg: it counts the rawvideo bytes on its stdin
+    // and records the expanded arguments.
+    const report = path.join(os.tmpdir(), 'cursorcine-encoder-' + label + '-' + process.pid + '.txt');
+    const reader =
+      "let n = 0; process.stdin.on('data', (c) => { n += c.length; }).on('end', () => " +
+      "require('fs').writeFileSync(process.argv[1], n + ' ' + process.argv.slice(2).join(' ')));";
+    const startOptions = {
+      sourceId: 'synthetic-smoke-source',
+      displayHint: { bounds: { x: 0, y: 0, width: OUTPUT_WIDTH, height: OUTPUT_HEIGHT }, scaleFactor: 1 },
+      encoderPipe: { command: process.execPath, args: ['-e', reader, report, '{width}x{height}', '{pix_fmt}', '{fps}'] }
+    };
+    assert.ok(/continuous/.test(bridge.startCapture(startOptions).message));
+    const missing = bridge.startCapture({ ...startOptions, continuous: true, encoderPipe: { depth: 2 } });
+    assert.ok(/command or path/.test(missing.message), missing.message);
+
+    const started = bridge.startCapture({ ...startOptions, continuous: true, targetFps: 30 });
+    assert.strictEqual(started.ok, true, JSON.stringify(started));
+    assert.strictEqual(started.encoderPipe.pixelFormat, 'rgba');
+    assert.strictEqual(started.encoderPipe.frameBytes, FRAME_BYTES);
+    assert.ok(started.encoderPipe.pid > 0);
+    const sid = started.nativeSessionId;
+    await new Promise((resolve) => setTimeout(resolve, 250));
+    // Frames only go to the encoder until readLatest attaches a reader; after
+    // that they reach readLatest too.
+    assert.ok(bridge.getStats({ nativeSessionId: sid }).encoderPipe.framesWritten > 0);
+    assert.strictEqual(bridge.getPacingStats({ nativeSessionId: sid }).published, 0);
+    const attach = bridge.readLatest({ nativeSessionId: sid });
+    assert.ok(attach.ok || attach.reason === 'NO_NEW_FRAME', JSON.stringify(attach.reason));
+    await new Promise((resolve) => setTimeout(resolve, 120));
+    assertFrame(bridge.readLatest({ nativeSessionId: sid }));
+
+    const stopped = bridge.stopCapture({ nativeSessionId: sid });
+    const encoder = stopped.encoderPipe;
+    assert.strictEqual(encoder.exitCode, 0, JSON.stringify(encoder));
+    assert.strictEqual(encoder.failed, false);
+    assert.ok(encoder.framesWritten > 0);
+    assert.strictEqual(encoder.bytesWritten, encoder.framesWritten * FRAME_BYTES);
+    assert.ok(encoder.writeCalls <= encoder.framesWritten);
+    assert.strictEqual(fs.readFileSync(report, 'utf8'), encoder.bytesWritten + ' 640x360 rgba 30');
+    fs.unlinkSync(report);
+  });
+
+  await check(label + '.continuous.queue', async () => {
+    const started = bridge.startCapture({
+      sourceId: 'synthetic-smoke-source',
+      displayHint: { bounds: { x: 0, y: 0, width: OUTPUT_WIDTH, height: OUTPUT_HEIGHT }, scaleFactor: 1 },
+      continuous: true,
+      targetFps: 100,
+      dropPolicy: 'queue-4'
+    });
+    assert.strictEqual(started.dropPolicy, 'queue-4', JSON.stringify(started));
+    const sid = started.nativeSessionId;
+    await new Promise((resolve) => setTimeout(resolve, 150));
+    const first = bridge.readLatest({ nativeSessionId: sid });
+    assertFrame(first);
+    assert.ok(first.droppedFrames > 0, JSON.stringify(first));
+    assert.ok(first.queued >= 3, JSON.stringify(first.queued));
+    // Queued frames come out oldest first; the drain is bounded because the
+    // capture thread keeps publishing while we read.
+    let previous = first;
+    for (let i = 0; i < first.queued; i += 1) {
+      const next = bridge.readLatest({ nativeSessionId: sid });
+      assert.strictEqual(next.ok, true, next.reason);
+      assert.ok(next.sequence > previous.sequence);
+      assert.ok(next.timestampMs >= previous.timestampMs);
+      previous = next;
+    }
+    bridge.stopCapture({ nativeSessionId: sid });
+  });
+
+  await check(label + '.continuous.notContinuous', () => {
+    const sid = start(bridge);
+    assert.strictEqual(bridge.readLatest({ nativeSessionId: sid }).reason, 'NOT_CONTINUOUS');
+    bridge.stopCapture({ nativeSessionId: sid });
+  });
+}
+
+async function main() {
+  if (process.env.CURSORCINE_NATIVE_TEST_SYNTHETIC_SOURCE !== '1') {
+    log('CURSORCINE_NATIVE_TEST_SYNTHETIC_SOURCE=1 is required');
+    process.exitCode = 1;
+    return;
+  }
+  await runBridge('legacy', require('../../native/windows-hdr-capture'));
+  await runBridge('wgc', require('../../native/windows-wgc-hdr-capture'));
+
+  const failed = results.filter((r) => !r.ok).length;
+  log(results.length + ' checks, ' + failed + ' failed');
+  if (failed > 0) {
+    process.exitCode = 1;
+  }
+}
+
+main().catch((error) => {
+  log('fatal ' + (error && error.stack ? error.stack : String(error)));
+  process.exitCode = 1;
+});
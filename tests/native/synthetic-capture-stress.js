@@ -0,0 +1,199 @@
+#!/usr/bin/env node
+
+// Concurrent-session stress test for the capture addons on the portable
+// backends (`backend: 'synthetic'`, or `replay` of a generated recording with
+// CURSORCINE_NATIVE_STRESS_BACKEND=replay), so it runs on any platform. For 1,
+// 2 and 4 sessions it keeps readFrameAsync in flight on every session and
+// reports aggregate frames/s and scaling against one session. Meanwhile the JS
+// thread keeps calling startCapture/stopCapture and readFrame on a small
+// session; those calls must not wait behind another session's capture.
+//
+// Scaling is reported, not asserted, unless CURSORCINE_NATIVE_STRESS_MIN_SCALING
+// is set (it is bounded by CPU count and UV_THREADPOOL_SIZE).
+
+const assert = require('assert');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const DURATION_MS = Math.max(200, Number(process.env.CURSORCINE_NATIVE_STRESS_MS || 1500));
+const MIN_SCALING = Number(process.env.CURSORCINE_NATIVE_STRESS_MIN_SCALING || 0);
+const SESSION_COUNTS = [1, 2, 4];
+const BACKEND = process.env.CURSORCINE_NATIVE_STRESS_BACKEND || 'synthetic';
+const REPLAY_FRAMES = 4;
+
+function log(message) {
+  process.stdout.write('[native-stress] ' + message + '\n');
+}
+
+function nowMs() {
+  return Number(process.hrtime.bigint()) / 1e6;
+}
+
+function percentile(values, p) {
+  if (!values.length) {
+    return 0;
+  }
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+}
+
+// REPLAY_FRAMES distinct noise frames, so replayed frames are not all alike.
+function writeReplayFile(width, height) {
+  const replayPath = path.join(os.tmpdir(), 'cursorcine-stress-' + process.pid + '.bgra');
+  const frame = Buffer.alloc(width * height * 4);
+  const fd = fs.openSync(replayPath, 'w');
+  let seed = 0x12345678;
+  for (let i = 0; i < REPLAY_FRAMES; i += 1) {
+    for (let j = 0; j < frame.length; j += 1) {
+      seed = (Math.imul(seed, 1664525) + 1013904223) >>> 0;
+      frame[j] = seed >>> 24;
+    }
+    fs.writeSync(fd, frame);
+  }
+  fs.closeSync(fd);
+  return replayPath;
+}
+
+let replayPath = '';
+
+function startSession(bridge, width, height, maxOutputPixels, backend = 'synthetic') {
+  const started = bridge.startCapture({
+    sourceId: 'synthetic-stress-source',
+    backend,
+    replayPath,
+    displayHint: {
+      bounds: { x: 0, y: 0, width, height },
+      scaleFactor: 1,
+      isHdrLikely: true
+    },
+    maxOutputPixels,
+    scaler: 'box',
+    toneMap: { rolloff: 0.35, saturation: 1.2 }
+  });
+  assert.strictEqual(started.ok, true, JSON.stringify(started));
+  return started.nativeSessionId;
+}
+
+async function runRound(bridge, sessionCount) {
+  const sessions = [];
+  for (let i = 0; i < sessionCount; i += 1) {
+    sessions.push(startSession(bridge, 1920, 1080, 1280 * 720, BACKEND));
+  }
+  const probeSession = startSession(bridge, 64, 64, 64 * 64);
+
+  const counts = new Array(sessionCount).fill(0);
+  const failures = [];
+  const syncLatencies = [];
+  const deadline = nowMs() + DURATION_MS;
+
+  const pumps = sessions.map(async (sid, index) => {
+    while (nowMs() < deadline) {
+      const result = await bridge.readFrameAsync({ nativeSessionId: sid });
+      if (result.ok) {
+        counts[index] += 1;
+      } else if (result.reason !== 'POOL_EXHAUSTED') {
+        failures.push(result.reason);
+      }
+    }
+  });
+
+  const churn = setInterval(() => {
+    const t0 = nowMs();
+    const sid = startSession(bridge, 64, 64, 64 * 64);
+    const read = bridge.readFrame({ nativeSessionId: probeSession });
+    const stopped = bridge.stopCapture({ nativeSessionId: sid });
+    syncLatencies.push(nowMs() - t0);
+    if (!read.ok && read.reason !== 'POOL_EXHAUSTED') {
+      failures.push('sync:' + read.reason);
+    }
+    if (!stopped.ok) {
+      failures.push('stop:' + stopped.reason);
+    }
+  }, 5);
+
+  await Promise.all(pumps);
+  clearInterval(churn);
+  for (const sid of sessions) {
+    bridge.stopCapture({ nativeSessionId: sid });
+  }
+  bridge.stopCapture({ nativeSessionId: probeSession });
+
+  assert.deepStrictEqual(failures, []);
+  for (const count of counts) {
+    assert.ok(count > 0, 'every session must make progress: ' + JSON.stringify(counts));
+  }
+  const frames = counts.reduce((sum, count) => sum + count, 0);
+  return {
+    framesPerSec: (frames * 1000) / DURATION_MS,
+    perSession: counts,
+    syncP50Ms: percentile(syncLatencies, 0.5),
+    syncMaxMs: percentile(syncLatencies, 1)
+  };
+}
+
+async function runBridge(label, bridge) {
+  let baseline = 0;
+  for (const sessionCount of SESSION_COUNTS) {
+    const round = await runRound(bridge, sessionCount);
+    if (sessionCount === 1) {
+      baseline = round.framesPerSec;
+    }
+    const scaling = baseline > 0 ? round.framesPerSec / baseline : 0;
+    log(
+      label + ' sessions=' + sessionCount +
+      ' frames/s=' + round.framesPerSec.toFixed(1) +
+      ' scaling=x' + scaling.toFixed(2) +
+      ' perSession=' + JSON.stringify(round.perSession) +
+      ' start/read/stop p50=' + round.syncP50Ms.toFixed(2) + 'ms max=' + round.syncMaxMs.toFixed(2) + 'ms'
+    );
+    if (MIN_SCALING > 0 && sessionCount === 2) {
+      assert.ok(scaling >= MIN_SCALING, label + ' 2-session scaling x' + scaling.toFixed(2) + ' < x' + MIN_SCALING);
+    }
+  }
+}
+
+// Portable sessions must not make the platform look supported: after the
+// rounds above, the addon still reports desktop capture as unavailable and
+// answers NOT_WINDOWS for ids that name no session.
+function checkPlatformSupport(label, addonPath) {
+  if (process.platform === 'win32' || process.env.CURSORCINE_NATIVE_TEST_SYNTHETIC_SOURCE === '1') {
+    return;
+  }
+  // eslint-disable-next-line global-require, import/no-dynamic-require
+  const addon = require(addonPath);
+  const probe = addon.probe({});
+  assert.strictEqual(probe.supported, false, label + ' probe: ' + JSON.stringify(probe));
+  assert.deepStrictEqual(probe.backends, ['synthetic', 'replay']);
+  assert.strictEqual(addon.readFrame({ nativeSessionId: 1 << 30 }).reason, 'NOT_WINDOWS');
+  assert.strictEqual(addon.getStats({ nativeSessionId: 1 << 30 }).reason, 'NOT_WINDOWS');
+  assert.strictEqual(addon.stopCapture({ nativeSessionId: 1 << 30 }).skipped, true);
+  log(label + ' platform support unchanged by portable sessions');
+}
+
+async function main() {
+  log(
+    'cpus=' + os.cpus().length +
+    ' threadpool=' + (process.env.UV_THREADPOOL_SIZE || 4) +
+    ' durationMs=' + DURATION_MS +
+    ' backend=' + BACKEND
+  );
+  if (BACKEND === 'replay') {
+    replayPath = writeReplayFile(1920, 1080);
+  }
+  try {
+    await runBridge('legacy', require('../../native/windows-hdr-capture'));
+    checkPlatformSupport('legacy', '../../native/windows-hdr-capture/build/Release/windows_hdr_capture.node');
+    await runBridge('wgc', require('../../native/windows-wgc-hdr-capture'));
+    checkPlatformSupport('wgc', '../../native/windows-wgc-hdr-capture/build/Release/windows_wgc_hdr_capture.node');
+  } finally {
+    if (replayPath) {
+      fs.unlinkSync(replayPath);
+    }
+  }
+}
+
+main().catch((error) => {
+  log('FAIL ' + (error && error.stack ? error.stack : String(error)));
+  process.exitCode = 1;
+});
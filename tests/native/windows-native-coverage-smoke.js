@@ -72,6 +72,31 @@ function exerciseSessionPaths(label, bridge, nativeSessionId) {
     timeoutMs: 10
   }));
 
+  const frameBytes = 640 * 360 * 4;
+  safeCall(label + '.readFrameInto.shared', () => bridge.readFrameInto({
+    nativeSessionId,
+    target: new SharedArrayBuffer(frameBytes + 64),
+    offset: 64
+  }));
+  safeCall(label + '.readFrameInto.paddedStride', () => bridge.readFrameInto({
+    nativeSessionId,
+    target: Buffer.alloc(frameBytes * 2),
+    stride: 640 * 4 * 2
+  }));
+  safeCall(label + '.readFrameInto.tooSmall', () => bridge.readFrameInto({
+    nativeSessionId,
+    target: new ArrayBuffer(16)
+  }));
+  safeCall(label + '.readFrameInto.badStride', () => bridge.readFrameInto({
+    nativeSessionId,
+    target: new ArrayBuffer(frameBytes),
+    stride: 4
+  }));
+  safeCall(label + '.readFrameInto.invalidTarget', () => bridge.readFrameInto({
+    nativeSessionId,
+    target: 'not-a-buffer'
+  }));
+
   safeCall(label + '.stopCapture.invalidZero', () => bridge.stopCapture({
     nativeSessionId: 0
   }));
@@ -121,6 +146,18 @@ function exerciseInjectedFailures(label, bridge) {
     }
     return started;
   });
+
+  safeCall(label + '.inject.forcePoolExhausted', () => {
+    const started = bridge.startCapture(startPayload);
+    const sid = Number(started && started.nativeSessionId ? started.nativeSessionId : 0);
+    if (sid > 0) {
+      safeCall(label + '.inject.forcePoolExhausted.read', () => withEnv('CURSORCINE_NATIVE_TEST_FORCE_POOL_EXHAUSTED', '1', () => (
+        bridge.readFrame({ nativeSessionId: sid, timeoutMs: 10 })
+      )));
+      safeCall(label + '.inject.forcePoolExhausted.stop', () => bridge.stopCapture({ nativeSessionId: sid }));
+    }
+    return started;
+  });
 }
 
 function exerciseStartVariants(label, bridge) {
@@ -211,6 +248,32 @@ function exerciseStartVariants(label, bridge) {
     return started;
   });
 
+  safeCall(label + '.startCapture.framePoolHeld', () => {
+    const started = bridge.startCapture({
+      sourceId: 'coverage-smoke-source',
+      displayId: 'coverage-display',
+      maxOutputPixels: 640 * 360,
+      framePoolDepth: 2
+    });
+    const sid = Number(started && started.nativeSessionId ? started.nativeSessionId : 0);
+    if (sid > 0) {
+      // Holding every pooled frame must surface POOL_EXHAUSTED, not a new slab.
+      const held = [];
+      for (let i = 0; i < 3; i += 1) {
+        const frame = safeCall(label + '.startCapture.framePoolHeld.read' + i, () => bridge.readFrame({
+          nativeSessionId: sid,
+          timeoutMs: 10
+        }));
+        held.push(frame);
+      }
+      safeCall(label + '.startCapture.framePoolHeld.stop', () => bridge.stopCapture({ nativeSessionId: sid }));
+      log(label + '.startCapture.framePoolHeld.reasons', held.map((frame) => (
+        frame && frame.ok ? String(frame.bufferMode || '') : String((frame && frame.reason) || '')
+      )));
+    }
+    return started;
+  });
+
   safeCall(label + '.startCapture.offscreenReadFail', () => {
     const started = bridge.startCapture({
       sourceId: 'coverage-smoke-source',
@@ -233,6 +296,89 @@ function exerciseStartVariants(label, bridge) {
   });
 }
 
+async function safeCallAsync(name, fn) {
+  try {
+    const result = await fn();
+    log(name + ':ok', result);
+    return result;
+  } catch (error) {
+    log(name + ':err', { message: error && error.message ? error.message : String(error) });
+    return null;
+  }
+}
+
+async function exerciseAsyncReads(label, bridge) {
+  if (!bridge || typeof bridge.readFrameAsync !== 'function') {
+    log(label + '.readFrameAsync:missing', {});
+    return;
+  }
+  await safeCallAsync(label + '.readFrameAsync.invalidZero', () => bridge.readFrameAsync({ nativeSessionId: 0 }));
+  await safeCallAsync(label + '.readFrameAsync.invalidMissing', () => bridge.readFrameAsync({
+    nativeSessionId: 999999
+  }));
+
+  const started = safeCall(label + '.readFrameAsync.start', () => bridge.startCapture({
+    sourceId: 'coverage-smoke-source',
+    displayId: 'coverage-display',
+    maxOutputPixels: 640 * 360
+  }));
+  const sid = Number(started && started.nativeSessionId ? started.nativeSessionId : 0);
+  if (sid <= 0) {
+    return;
+  }
+  await safeCallAsync(label + '.readFrameAsync.pooled', () => bridge.readFrameAsync({ nativeSessionId: sid }));
+  await safeCallAsync(label + '.readFrameAsync.target', () => bridge.readFrameAsync({
+    nativeSessionId: sid,
+    target: new SharedArrayBuffer(640 * 360 * 4)
+  }));
+  await safeCallAsync(label + '.readFrameAsync.tooSmall', () => bridge.readFrameAsync({
+    nativeSessionId: sid,
+    target: new ArrayBuffer(16)
+  }));
+  await safeCallAsync(label + '.readFrameAsync.forcePoolExhausted', () => withEnv(
+    'CURSORCINE_NATIVE_TEST_FORCE_POOL_EXHAUSTED',
+    '1',
+    () => bridge.readFrameAsync({ nativeSessionId: sid })
+  ));
+  const inFlight = [];
+  for (let i = 0; i < 8; i += 1) {
+    inFlight.push(bridge.readFrameAsync({ nativeSessionId: sid }));
+  }
+  safeCall(label + '.readFrameAsync.stopWhileInFlight', () => bridge.stopCapture({ nativeSessionId: sid }));
+  await safeCallAsync(label + '.readFrameAsync.settled', async () => (
+    (await Promise.all(inFlight)).map((frame) => (frame && frame.ok ? 'ok' : String((frame && frame.reason) || '')))
+  ));
+}
+
+async function exerciseContinuous(label, bridge) {
+  if (!bridge || typeof bridge.readLatest !== 'function') {
+    log(label + '.readLatest:missing', {});
+    return;
+  }
+  const started = safeCall(label + '.continuous.start', () => bridge.startCapture({
+    sourceId: 'coverage-smoke-source',
+    displayId: 'coverage-display',
+    maxOutputPixels: 640 * 360,
+    continuous: true,
+    targetFps: 30
+  }));
+  const sid = Number(started && started.nativeSessionId ? started.nativeSessionId : 0);
+  if (sid <= 0) {
+    return;
+  }
+  safeCall(label + '.continuous.readFrameRefused', () => bridge.readFrame({ nativeSessionId: sid }));
+  await new Promise((resolve) => setTimeout(resolve, 100));
+  safeCall(label + '.continuous.readLatest', () => bridge.readLatest({ nativeSessionId: sid }));
+  safeCall(label + '.continuous.readLatestAgain', () => bridge.readLatest({ nativeSessionId: sid }));
+  await new Promise((resolve) => setTimeout(resolve, 50));
+  safeCall(label + '.continuous.readLatestInto', () => bridge.readLatest({
+    nativeSessionId: sid,
+    target: new SharedArrayBuffer(640 * 360 * 4)
+  }));
+  safeCall(label + '.continuous.stop', () => bridge.stopCapture({ nativeSessionId: sid }));
+  safeCall(label + '.continuous.readLatestStopped', () => bridge.readLatest({ nativeSessionId: sid }));
+}
+
 function runBridge(label, bridge) {
   if (!bridge) {
     log(label + ':missing', {});
@@ -270,6 +416,10 @@ async function main() {
 
   runBridge('legacy', legacyBridge);
   runBridge('wgc', wgcBridge);
+  await exerciseAsyncReads('legacy', legacyBridge);
+  await exerciseAsyncReads('wgc', wgcBridge);
+  await exerciseContinuous('legacy', legacyBridge);
+  await exerciseContinuous('wgc', wgcBridge);
 }
 
 main().catch((error) => {
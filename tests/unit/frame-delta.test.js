@@ -0,0 +1,67 @@
+const {
+  FRAME_DELTA_HEADER_BYTES,
+  readFrameDeltaHeader,
+  decodeFrameDelta,
+  createFrameDeltaDecoder
+} = require('../../src/core/frame-delta');
+
+function header(frameBytes, changedTiles, literalBytes) {
+  const bytes = [0x43, 0x44, 0x46, 0x31];
+  for (const value of [frameBytes, changedTiles, literalBytes]) {
+    bytes.push(value & 0xff, (value >>> 8) & 0xff, (value >>> 16) & 0xff, (value >>> 24) & 0xff);
+  }
+  return bytes;
+}
+
+describe('frame delta header', () => {
+  it('reads the header', () => {
+    expect(readFrameDeltaHeader(new Uint8Array(header(8294400, 3, 96)))).toEqual({
+      frameBytes: 8294400,
+      changedTiles: 3,
+      literalBytes: 96
+    });
+    expect(readFrameDeltaHeader(new Uint8Array(FRAME_DELTA_HEADER_BYTES))).toBe(null);
+  });
+});
+
+describe('frame delta decoder', () => {
+  const decode = decodeFrameDelta;
+
+  it('applies skip/literal tokens over the base', () => {
+    const frame = new Uint8Array(300).fill(1);
+    // skip 2, write [7, 8]; skip 200 (two-byte varint), write [9].
+    const delta = new Uint8Array([...header(300, 2, 3), 2, 2, 7, 8, 0xc8, 0x01, 1, 9]);
+    expect(decode(delta, frame)).toBe(true);
+    expect(Array.from(frame.subarray(0, 5))).toEqual([1, 1, 7, 8, 1]);
+    expect(frame[204]).toBe(9);
+    expect(frame[205]).toBe(1);
+  });
+
+  it('treats a header-only delta as an unchanged frame', () => {
+    const frame = new Uint8Array(64).fill(5);
+    expect(decode(new Uint8Array(header(64, 0, 0)), frame)).toBe(true);
+    expect(frame.every((v) => v === 5)).toBe(true);
+  });
+
+  it('rejects deltas that do not fit the base', () => {
+    const frame = new Uint8Array(16);
+    expect(decode(new Uint8Array(header(32, 0, 0)), frame)).toBe(false);
+    expect(decode(new Uint8Array([...header(16, 1, 4), 14, 4, 1, 2, 3, 4]), frame)).toBe(false);
+    expect(decode(new Uint8Array([...header(16, 1, 4), 0, 4, 1, 2]), frame)).toBe(false);
+  });
+});
+
+describe('stateful frame delta decoder', () => {
+  it('applies deltas over the last base and drops it on a mismatch', () => {
+    const decoder = createFrameDeltaDecoder();
+    expect(decoder.applyDelta(new Uint8Array(header(4, 0, 0)))).toBe(null);
+
+    decoder.setBase(new Uint8Array([1, 2, 3, 4]));
+    const frame = decoder.applyDelta(new Uint8Array([...header(4, 1, 1), 1, 1, 9]));
+    expect(Array.from(frame)).toEqual([1, 9, 3, 4]);
+    expect(Array.from(decoder.applyDelta(new Uint8Array([...header(4, 1, 1), 3, 1, 7])))).toEqual([1, 9, 3, 7]);
+
+    expect(decoder.applyDelta(new Uint8Array(header(8, 0, 0)))).toBe(null);
+    expect(decoder.applyDelta(new Uint8Array(header(4, 0, 0)))).toBe(null);
+  });
+});